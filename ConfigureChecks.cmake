@@ -188,6 +188,88 @@ check_cxx_source_compiles("
   }
 " HAVE_ISO_STRDUP)
 
+# Determine whether your system supports copy_file_range().
+
+check_cxx_source_compiles("
+  #include <sys/types.h>
+  #include <unistd.h>
+  int main() {
+    loff_t inOffset = 0;
+    loff_t outOffset = 0;
+    copy_file_range(0, &inOffset, 1, &outOffset, 0, 0);
+    return 0;
+  }
+" HAVE_COPY_FILE_RANGE)
+
+# Determine whether your system can list the extended attributes of a file.
+
+check_cxx_source_compiles("
+  #include <sys/types.h>
+  #include <sys/xattr.h>
+  int main() {
+    listxattr(0, 0, 0);
+    return 0;
+  }
+" HAVE_LISTXATTR)
+
+if(NOT HAVE_LISTXATTR)
+  check_cxx_source_compiles("
+    #include <sys/xattr.h>
+    int main() {
+      listxattr(0, 0, 0, 0);
+      return 0;
+    }
+  " HAVE_MAC_LISTXATTR)
+endif()
+
+# Determine which vector instructions can be used to search byte vectors.
+
+check_cxx_source_compiles("
+  #include <emmintrin.h>
+  int main() {
+    const __m128i x = _mm_set1_epi8(1);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(x, x));
+  }
+" HAVE_SSE2)
+
+if(HAVE_SSE2)
+  check_cxx_source_compiles("
+    #include <immintrin.h>
+    __attribute__((target(\"avx2\"))) int test() {
+      const __m256i x = _mm256_set1_epi8(1);
+      return _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, x));
+    }
+    int main() {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports(\"avx2\") ? test() : 0;
+    }
+  " HAVE_GCC_AVX2)
+
+  # Carry-less multiplication computes the checksums of Ogg pages.
+
+  check_cxx_source_compiles("
+    #include <immintrin.h>
+    __attribute__((target(\"pclmul,ssse3\"))) int test() {
+      const __m128i x = _mm_shuffle_epi8(_mm_set1_epi8(1), _mm_set1_epi8(0));
+      return _mm_cvtsi128_si32(_mm_clmulepi64_si128(x, x, 0x00));
+    }
+    int main() {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports(\"pclmul\") ? test() : 0;
+    }
+  " HAVE_GCC_PCLMUL)
+endif()
+
+# Determine whether POSIX threads are available.  They are used to read many
+# files at once, and Win32 threads are used on Windows.
+
+if(NOT WIN32)
+  find_package(Threads)
+  if(CMAKE_USE_PTHREADS_INIT)
+    set(HAVE_PTHREAD 1)
+  endif()
+endif()
+
 # Determine whether zlib is installed.
 
 if(NOT ZLIB_SOURCE)
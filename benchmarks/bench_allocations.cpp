@@ -0,0 +1,195 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+// Counts the heap allocations made while opening files and while doing the
+// ByteVector operations that the parsers use most.
+//
+// Usage: bench_allocations [file...]
+
+#include <new>
+#include <cstdlib>
+
+#include <fileref.h>
+#include <tbytevector.h>
+#include <tbytevectorlist.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  unsigned long long allocations = 0;
+  unsigned long long allocatedBytes = 0;
+
+  void *allocate(size_t size)
+  {
+    ++allocations;
+    allocatedBytes += size;
+
+    void *p = std::malloc(size > 0 ? size : 1);
+    if(!p)
+      throw std::bad_alloc();
+    return p;
+  }
+}
+
+// Every allocation of the library goes through these, the shared library's
+// included.
+
+#if __cplusplus >= 201103L
+# define THROWS_BAD_ALLOC
+# define THROWS_NOTHING noexcept
+#else
+# define THROWS_BAD_ALLOC throw(std::bad_alloc)
+# define THROWS_NOTHING throw()
+#endif
+
+void *operator new(size_t size) THROWS_BAD_ALLOC { return allocate(size); }
+void *operator new[](size_t size) THROWS_BAD_ALLOC { return allocate(size); }
+void operator delete(void *p) THROWS_NOTHING { std::free(p); }
+void operator delete[](void *p) THROWS_NOTHING { std::free(p); }
+
+// C++14 compilers may call the sized forms instead, so they are replaced
+// too.
+
+#if __cplusplus >= 201402L
+void operator delete(void *p, size_t) THROWS_NOTHING { std::free(p); }
+void operator delete[](void *p, size_t) THROWS_NOTHING { std::free(p); }
+#endif
+
+namespace
+{
+  class AllocationCount
+  {
+  public:
+    AllocationCount() : startAllocations(allocations), startBytes(allocatedBytes) {}
+
+    void print(const std::string &label, unsigned int iterations) const
+    {
+      const unsigned long long count = allocations - startAllocations;
+      const unsigned long long bytes = allocatedBytes - startBytes;
+
+      std::cout << std::left << std::setw(40) << label << std::right
+                << std::setw(14) << std::fixed << std::setprecision(1)
+                << static_cast<double>(count) / iterations
+                << std::setw(14) << static_cast<double>(bytes) / iterations << std::endl;
+    }
+
+    static void printHeader()
+    {
+      std::cout << std::left << std::setw(40) << "operation" << std::right
+                << std::setw(14) << "allocations"
+                << std::setw(14) << "bytes" << std::endl;
+    }
+
+  private:
+    const unsigned long long startAllocations;
+    const unsigned long long startBytes;
+  };
+
+  const unsigned int Iterations = 10000;
+
+  void runByteVector()
+  {
+    const ByteVector block(4096, 'x');
+    volatile unsigned int sink = 0;
+
+    {
+      AllocationCount c;
+      for(unsigned int i = 0; i < Iterations; ++i)
+        sink += ByteVector::fromUInt(i).size();
+      c.print("ByteVector::fromUInt()", Iterations);
+    }
+    {
+      AllocationCount c;
+      for(unsigned int i = 0; i < Iterations; ++i)
+        sink += block.mid(i % 4000, 4).toUInt();
+      c.print("ByteVector::mid(4).toUInt()", Iterations);
+    }
+    {
+      AllocationCount c;
+      for(unsigned int i = 0; i < Iterations; ++i)
+        sink += block.mid(i % 4000, 8).size();
+      c.print("ByteVector::mid(8)", Iterations);
+    }
+    {
+      AllocationCount c;
+      for(unsigned int i = 0; i < Iterations; ++i) {
+        ByteVector v("ID3", 3);
+        v.append(ByteVector::fromShort(4));
+        sink += v.size();
+      }
+      c.print("ByteVector(\"ID3\") + append()", Iterations);
+    }
+    {
+      AllocationCount c;
+      for(unsigned int i = 0; i < Iterations; ++i) {
+        ByteVector v = block;
+        sink += v.size();
+      }
+      c.print("ByteVector copy (4 KiB)", Iterations);
+    }
+    {
+      AllocationCount c;
+      for(unsigned int i = 0; i < Iterations / 100; ++i) {
+        ByteVector v;
+        for(unsigned int j = 0; j < 1000; ++j)
+          v.append(static_cast<char>(j));
+        sink += v.size();
+      }
+      c.print("ByteVector::append() x 1000", Iterations / 100);
+    }
+    {
+      AllocationCount c;
+      for(unsigned int i = 0; i < Iterations / 10; ++i)
+        sink += ByteVectorList::split(block.mid(0, 400), "x", 1, 0).size();
+      c.print("ByteVectorList::split()", Iterations / 10);
+    }
+  }
+
+  void runFile(const char *name)
+  {
+    const unsigned int count = 100;
+
+    Bench::Measurement m;
+    AllocationCount c;
+    for(unsigned int i = 0; i < count; ++i) {
+      FileRef f(name);
+    }
+    c.print(name, count);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  AllocationCount::printHeader();
+
+  runByteVector();
+
+  for(int i = 1; i < argc; ++i)
+    runFile(argv[i]);
+
+  return 0;
+}
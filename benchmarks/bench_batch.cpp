@@ -0,0 +1,78 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// Compares reading the tags and audio properties of many files one by one
+// with FileRef and at once with FileRef::readBatch().
+//
+// Usage: bench_batch [threads] file...
+
+#include <fileref.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+int main(int argc, char *argv[])
+{
+  if(argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " [threads] file..." << std::endl;
+    return 1;
+  }
+
+  const unsigned int threads = static_cast<unsigned int>(std::atoi(argv[1]));
+
+  List<FileName> fileNames;
+  for(int i = 2; i < argc; ++i)
+    fileNames.append(argv[i]);
+
+  Bench::Measurement::printHeader();
+
+  unsigned int serialCount = 0;
+  {
+    Bench::Measurement m;
+    for(List<FileName>::ConstIterator it = fileNames.begin(); it != fileNames.end(); ++it) {
+      const FileRef ref(*it);
+      if(!FileRef::Metadata(ref).isNull())
+        ++serialCount;
+    }
+    m.print("FileRef one by one");
+  }
+
+  unsigned int batchCount = 0;
+  {
+    Bench::Measurement m;
+    const FileRef::MetadataList results = FileRef::readBatch(fileNames, true, AudioProperties::Average, threads);
+    for(FileRef::MetadataList::ConstIterator it = results.begin(); it != results.end(); ++it) {
+      if(!it->isNull())
+        ++batchCount;
+    }
+    m.print("FileRef::readBatch()");
+  }
+
+  std::cout << serialCount << " / " << batchCount << " of " << fileNames.size()
+            << " files read" << std::endl;
+
+  return 0;
+}
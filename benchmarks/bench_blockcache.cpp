@@ -0,0 +1,74 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// Compares the reads issued while opening files with a plain FileStream and
+// with a BlockCacheStream on top of it.
+//
+// Usage: bench_blockcache file...
+
+#include <fileref.h>
+#include <tfilestream.h>
+#include <tblockcachestream.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  void run(const std::string &label, const char *name, unsigned int maximumPages)
+  {
+    Bench::Measurement m;
+
+    FileStream file(name, true);
+    BlockCacheStream stream(&file);
+    stream.setCacheSize(0, maximumPages);
+    {
+      FileRef f(&stream, true, AudioProperties::Average);
+    }
+
+    m.print(label);
+    std::cout << std::setw(40) << "" << "  " << stream.cacheMisses() << " underlying reads, "
+              << stream.cacheHits() << " hits, " << stream.bytesRead() << " bytes" << std::endl;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " file..." << std::endl;
+    return 1;
+  }
+
+  Bench::Measurement::printHeader();
+
+  for(int i = 1; i < argc; ++i) {
+    std::cout << argv[i] << std::endl;
+    run("  uncached", argv[i], 0);
+    run("  cached", argv[i], 64);
+  }
+
+  return 0;
+}
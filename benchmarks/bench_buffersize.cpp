@@ -0,0 +1,97 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// Compares the number of read and write system calls issued by File::find(),
+// File::rfind(), File::insert() and File::removeBlock() with the old fixed
+// 1 KiB buffer and with the default growing buffer.
+//
+// Usage: bench_buffersize [file size in MiB]
+
+#include <tfile.h>
+#include <tbytevector.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  class PlainFile : public File
+  {
+  public:
+    PlainFile(FileName name) : File(name) {}
+    Tag *tag() const { return 0; }
+    AudioProperties *audioProperties() const { return 0; }
+    bool save() { return false; }
+  };
+
+  void run(const std::string &label, bool fixed, long size)
+  {
+    const std::string name = Bench::tempFileName(".bin");
+    const ByteVector missing("TagLib benchmark pattern");
+
+    Bench::createFile(name, size);
+    {
+      PlainFile file(name.c_str());
+      if(fixed)
+        file.setBufferSize(1024, 1024);
+
+      {
+        Bench::Measurement m;
+        file.find(missing);
+        m.print(label + " find()", size);
+      }
+      {
+        Bench::Measurement m;
+        file.rfind(missing);
+        m.print(label + " rfind()", size);
+      }
+      {
+        Bench::Measurement m;
+        file.insert(ByteVector(4096, 'x'), 0);
+        m.print(label + " insert() 4 KiB at 0", size);
+      }
+      {
+        Bench::Measurement m;
+        file.removeBlock(0, 4096);
+        m.print(label + " removeBlock() 4 KiB at 0", size);
+      }
+    }
+    std::remove(name.c_str());
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const long size = Bench::sizeArgument(argc, argv, 1, 32 * 1024 * 1024);
+
+  std::cout << "File size: " << size / (1024 * 1024) << " MiB" << std::endl;
+  Bench::Measurement::printHeader();
+
+  run("fixed 1 KiB", true, size);
+  run("growing", false, size);
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+// Measures the throughput of the Ogg page checksum: ByteVector::checksum() on
+// blocks of the sizes that Ogg pages have, and the renumbering of pages, once
+// by rendering them again and once by patching the checksum of the header.
+//
+// Usage: bench_checksum [size in MiB]
+
+#include <algorithm>
+
+#include <tbytevector.h>
+#include <tcrc.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  ByteVector makeData(unsigned int size)
+  {
+    ByteVector data(size);
+    for(unsigned int i = 0; i < size; ++i)
+      data[i] = static_cast<char>((i * 2654435761U) >> 13);
+    return data;
+  }
+
+  void runChecksum(const ByteVector &data, unsigned int blockSize, long size)
+  {
+    const unsigned int blocks = data.size() / blockSize;
+    const unsigned int repeat = static_cast<unsigned int>(size / data.size());
+
+    volatile unsigned int sink = 0;
+    std::ostringstream label;
+    label << "checksum(" << blockSize << ")";
+
+    Bench::Measurement m;
+    for(unsigned int r = 0; r < repeat; ++r) {
+      for(unsigned int i = 0; i < blocks; ++i)
+        sink += data.mid(i * blockSize, blockSize).checksum();
+    }
+    m.print(label.str(), static_cast<unsigned long long>(blockSize) * blocks * repeat);
+  }
+
+  // Changes the sequence number of every 4 KiB page, as Ogg::File does when a
+  // packet takes more or fewer pages than before.
+
+  void runRenumber(const ByteVector &data, long size)
+  {
+    const unsigned int pageSize = 4096;
+    const unsigned int pages = data.size() / pageSize;
+    const unsigned int repeat = static_cast<unsigned int>(size / data.size());
+
+    volatile unsigned int sink = 0;
+    const ByteVector oldNumber = ByteVector::fromUInt(1, false);
+    const ByteVector newNumber = ByteVector::fromUInt(2, false);
+
+    {
+      Bench::Measurement m;
+      for(unsigned int r = 0; r < repeat; ++r) {
+        for(unsigned int i = 0; i < pages; ++i) {
+          ByteVector page = data.mid(i * pageSize, pageSize);
+          std::copy(newNumber.begin(), newNumber.end(), page.begin() + 18);
+          sink += page.checksum();
+        }
+      }
+      m.print("renumber by checksum()", static_cast<unsigned long long>(pageSize) * pages * repeat);
+    }
+    {
+      Bench::Measurement m;
+      for(unsigned int r = 0; r < repeat; ++r) {
+        for(unsigned int i = 0; i < pages; ++i)
+          sink += CRC::replace(i, pageSize, 18, oldNumber.data(), newNumber.data(), 4);
+      }
+      m.print("renumber by CRC::replace()", static_cast<unsigned long long>(pageSize) * pages * repeat);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const long size = Bench::sizeArgument(argc, argv, 1, 256 * 1024 * 1024);
+  const ByteVector data = makeData(1024 * 1024);
+
+  Bench::Measurement::printHeader();
+
+  const unsigned int blockSizes[] = { 64, 255, 4096, 65307 };
+  for(unsigned int i = 0; i < sizeof(blockSizes) / sizeof(blockSizes[0]); ++i)
+    runChecksum(data, blockSizes[i], size);
+
+  runRenumber(data, size);
+
+  return 0;
+}
@@ -0,0 +1,123 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+// Measures the throughput of ByteVector::find()/rfind() and of File::find()/
+// rfind() scanning a whole file for a pattern that is not in it, as the
+// format detection code does when a file is damaged or not of its type.
+//
+// Usage: bench_find [size in MiB]
+
+#include <tfile.h>
+#include <tbytevector.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  class PlainFile : public File
+  {
+  public:
+    explicit PlainFile(FileName name) : File(name) {}
+    Tag *tag() const { return 0; }
+    AudioProperties *audioProperties() const { return 0; }
+    bool save() { return false; }
+  };
+
+  // Data in which the first byte of the patterns is common but the patterns
+  // themselves never occur.
+
+  ByteVector makeData(unsigned int size)
+  {
+    ByteVector data(size);
+    for(unsigned int i = 0; i < size; ++i)
+      data[i] = static_cast<char>("OgSxyz\xff\x00"[(i * 2654435761U) % 8]);
+    return data;
+  }
+
+  void runVector(const ByteVector &data, const ByteVector &pattern, const std::string &label,
+                 unsigned int repeat)
+  {
+    volatile int sink = 0;
+    {
+      Bench::Measurement m;
+      for(unsigned int i = 0; i < repeat; ++i)
+        sink += data.find(pattern);
+      m.print("ByteVector::find(" + label + ")",
+              static_cast<unsigned long long>(data.size()) * repeat);
+    }
+    {
+      Bench::Measurement m;
+      for(unsigned int i = 0; i < repeat; ++i)
+        sink += data.rfind(pattern);
+      m.print("ByteVector::rfind(" + label + ")",
+              static_cast<unsigned long long>(data.size()) * repeat);
+    }
+  }
+
+  void runFile(const std::string &name, const ByteVector &pattern, const std::string &label,
+               long size)
+  {
+    PlainFile file(name.c_str());
+    {
+      Bench::Measurement m;
+      file.find(pattern);
+      m.print("File::find(" + label + ")", size);
+    }
+    {
+      Bench::Measurement m;
+      file.rfind(pattern);
+      m.print("File::rfind(" + label + ")", size);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const long size = Bench::sizeArgument(argc, argv, 1, 64 * 1024 * 1024);
+
+  const ByteVector data = makeData(1024 * 1024);
+  const unsigned int repeat = static_cast<unsigned int>(size / data.size());
+
+  const std::string name = Bench::tempFileName(".find");
+  {
+    std::ofstream out(name.c_str(), std::ios::binary | std::ios::trunc);
+    for(unsigned int i = 0; i < repeat; ++i)
+      out.write(data.data(), data.size());
+  }
+
+  Bench::Measurement::printHeader();
+
+  const char *patterns[][2] = {
+    { "OggS", "OggS" }, { "fLaC", "fLaC" }, { "\xff\xfb", "FF FB" }
+  };
+  for(unsigned int i = 0; i < sizeof(patterns) / sizeof(patterns[0]); ++i) {
+    runVector(data, patterns[i][0], patterns[i][1], repeat);
+    runFile(name, patterns[i][0], patterns[i][1], size);
+  }
+
+  std::remove(name.c_str());
+  return 0;
+}
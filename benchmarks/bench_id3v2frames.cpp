@@ -0,0 +1,178 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+// Measures an ID3v2 tag with many frames, like those of files that carry
+// hundreds of TXXX, PRIV or APIC frames: adding the frames, finding the first
+// frame with an ID, asking for the frames with an ID and removing the frames
+// one by one, the last first.  Then measures opening an MP3 file whose tag
+// has 5 MiB of artwork, and one whose tag has none, to read the title and to
+// render the tag again, with the frames parsed when the tag is read and on
+// demand.
+//
+// Usage: bench_id3v2frames [number of frames]
+
+#include <id3v2tag.h>
+#include <mpegfile.h>
+#include <textidentificationframe.h>
+#include <privateframe.h>
+#include <attachedpictureframe.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  void fill(ID3v2::Tag &tag, long count)
+  {
+    for(long i = 0; i < count; ++i) {
+      if(i % 2 == 0) {
+        ID3v2::UserTextIdentificationFrame *frame = new ID3v2::UserTextIdentificationFrame();
+        frame->setDescription(String::number(static_cast<int>(i)));
+        tag.addFrame(frame);
+      }
+      else {
+        tag.addFrame(new ID3v2::PrivateFrame());
+      }
+    }
+  }
+
+  // Writes an MP3 file with a few text frames, and artwork of pictureSize
+  // bytes unless it is 0.
+
+  void createFile(const std::string &name, unsigned int pictureSize)
+  {
+    Bench::createFile(name, 64 * 1024);
+
+    MPEG::File file(name.c_str(), false);
+    ID3v2::Tag *tag = file.ID3v2Tag(true);
+    tag->setTitle("Title");
+    tag->setArtist("Artist");
+    tag->setAlbum("Album");
+
+    if(pictureSize > 0) {
+      ID3v2::AttachedPictureFrame *picture = new ID3v2::AttachedPictureFrame();
+      picture->setMimeType("image/jpeg");
+      picture->setPicture(ByteVector(pictureSize, 'x'));
+      tag->addFrame(picture);
+    }
+
+    file.save(MPEG::File::ID3v2, false);
+  }
+
+  class Factory : public ID3v2::FrameFactory
+  {
+  public:
+    explicit Factory(bool onDemand)
+    {
+      setParseFramesOnDemand(onDemand);
+    }
+  };
+
+  void open(const std::string &label, const std::string &name, unsigned int repeat,
+            bool onDemand)
+  {
+    Factory factory(onDemand);
+    volatile size_t sink = 0;
+    {
+      Bench::Measurement m;
+      for(unsigned int r = 0; r < repeat; ++r) {
+        MPEG::File file(name.c_str(), &factory, false);
+        sink += file.ID3v2Tag()->title().size();
+      }
+      m.print("open " + label);
+    }
+    {
+      Bench::Measurement m;
+      for(unsigned int r = 0; r < repeat; ++r) {
+        MPEG::File file(name.c_str(), &factory, false);
+        file.ID3v2Tag()->setTitle("New Title");
+        sink += file.ID3v2Tag()->render().size();
+      }
+      m.print("open and render " + label);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const long count = argc > 1 && std::atol(argv[1]) > 0 ? std::atol(argv[1]) : 20000;
+  volatile size_t sink = 0;
+
+  Bench::Measurement::printHeader();
+
+  ID3v2::Tag tag;
+  {
+    Bench::Measurement m;
+    fill(tag, count);
+    m.print("add frames");
+  }
+  {
+    Bench::Measurement m;
+    for(long i = 0; i < count; ++i)
+      sink += tag.title().size() + tag.album().size() + tag.track();
+    m.print("title, album and track");
+  }
+  {
+    Bench::Measurement m;
+    for(long i = 0; i < count; ++i)
+      sink += tag.frameList("PRIV").size() + tag.frameListMap().size();
+    m.print("frame list and map");
+  }
+  {
+    const ID3v2::FrameList frames = tag.frameList();
+    Bench::Measurement m;
+    for(ID3v2::FrameList::ConstIterator it = frames.end(); it != frames.begin();)
+      tag.removeFrame(*--it);
+    sink += tag.frameList().size();
+    m.print("remove frames, last first");
+  }
+  {
+    ID3v2::Tag other;
+    fill(other, count);
+    Bench::Measurement m;
+    other.removeFrames("TXXX");
+    other.removeFrames("PRIV");
+    m.print("remove frames by ID");
+  }
+
+  const std::string withArtwork = Bench::tempFileName("-artwork.mp3");
+  const std::string withoutArtwork = Bench::tempFileName("-plain.mp3");
+
+  createFile(withArtwork, 5 * 1024 * 1024);
+  createFile(withoutArtwork, 0);
+
+  open("with artwork", withArtwork, 100, false);
+  open("without artwork", withoutArtwork, 100, false);
+  open("with artwork, on demand", withArtwork, 100, true);
+  open("without artwork, on demand", withoutArtwork, 100, true);
+
+  std::remove(withArtwork.c_str());
+  std::remove(withoutArtwork.c_str());
+
+  return 0;
+}
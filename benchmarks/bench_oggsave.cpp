@@ -0,0 +1,161 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+// Measures saving an Ogg Vorbis file whose comment header grows by more than
+// a page, which makes every following page be renumbered, and shrinks again.
+// The file is made from the header pages of the given file followed by
+// synthetic 4 KiB audio pages, up to the given size.
+//
+// Usage: bench_oggsave file.ogg [size in MiB]
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <fileref.h>
+#include <tag.h>
+#include <tbytevector.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  struct RawPage
+  {
+    ByteVector data;
+    bool header;
+  };
+
+  std::vector<RawPage> readPages(const char *fileName)
+  {
+    std::ifstream in(fileName, std::ios::binary);
+    const std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const ByteVector file(content.data(), static_cast<unsigned int>(content.size()));
+
+    std::vector<RawPage> pages;
+    unsigned int offset = 0;
+    while(offset + 27 <= file.size() && file.containsAt("OggS", offset)) {
+      const unsigned int segmentCount = static_cast<unsigned char>(file[offset + 26]);
+      unsigned int size = 27 + segmentCount;
+      for(unsigned int i = 0; i < segmentCount; ++i)
+        size += static_cast<unsigned char>(file[offset + 27 + i]);
+
+      RawPage page;
+      page.data = file.mid(offset, size);
+      page.header = (page.data.toLongLong(6, false) == 0);
+      pages.push_back(page);
+
+      offset += size;
+    }
+    return pages;
+  }
+
+  void writePage(std::ofstream &out, ByteVector page, unsigned int number, bool last)
+  {
+    page[5] = static_cast<char>(last ? (page[5] | 0x04) : (page[5] & ~0x04));
+
+    const ByteVector n = ByteVector::fromUInt(number, false);
+    std::copy(n.begin(), n.end(), page.begin() + 18);
+    std::fill(page.begin() + 22, page.begin() + 26, '\0');
+
+    const ByteVector checksum = ByteVector::fromUInt(page.checksum(), false);
+    std::copy(checksum.begin(), checksum.end(), page.begin() + 22);
+
+    out.write(page.data(), page.size());
+  }
+
+  void createFile(const std::string &name, const std::vector<RawPage> &pages, long size)
+  {
+    std::ofstream out(name.c_str(), std::ios::binary | std::ios::trunc);
+
+    unsigned int number = 0;
+    long written = 0;
+    for(size_t i = 0; i < pages.size() && pages[i].header; ++i) {
+      writePage(out, pages[i].data, number++, false);
+      written += pages[i].data.size();
+    }
+
+    // One packet of 16 segments per page, taking the rest of the header from
+    // the first audio page of the file.
+
+    const RawPage *audio = &pages[0];
+    while(audio->header)
+      ++audio;
+
+    ByteVector page = audio->data.mid(0, 26);
+    page.append(static_cast<char>(16));
+    page.append(ByteVector(15, '\xff'));
+    page.append(static_cast<char>(254));
+    for(unsigned int i = 0; i < 15 * 255 + 254; ++i)
+      page.append(static_cast<char>((i * 2654435761U) >> 13));
+
+    long long granule = 0;
+    while(written < size) {
+      granule += 1024;
+      const ByteVector g = ByteVector::fromLongLong(granule, false);
+      std::copy(g.begin(), g.end(), page.begin() + 6);
+
+      written += page.size();
+      writePage(out, page, number++, written >= size);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " file.ogg [size in MiB]" << std::endl;
+    return 1;
+  }
+
+  const long size = Bench::sizeArgument(argc, argv, 2, 256 * 1024 * 1024);
+
+  const std::vector<RawPage> pages = readPages(argv[1]);
+  if(pages.empty() || pages.back().header) {
+    std::cerr << argv[1] << " has no audio pages" << std::endl;
+    return 1;
+  }
+
+  const std::string name = Bench::tempFileName(".ogg");
+  createFile(name, pages, size);
+
+  Bench::Measurement::printHeader();
+
+  const char *labels[] = { "save, comment grows by pages", "save, comment shrinks again" };
+  const unsigned int titleSizes[] = { 256 * 1024, 16 };
+
+  for(unsigned int i = 0; i < 2; ++i) {
+    FileRef file(name.c_str());
+    file.tag()->setTitle(String(std::string(titleSizes[i], 'x')));
+
+    Bench::Measurement m;
+    file.save();
+    m.print(labels[i], size);
+  }
+
+  std::remove(name.c_str());
+  return 0;
+}
@@ -0,0 +1,101 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// Measures the throughput of File::insert() and File::removeBlock() when they
+// have to shift the rest of the file, for small and large blocks at several
+// offsets.  The throughput is the number of bytes moved per second.
+//
+// Usage: bench_shift [file size in MiB]
+
+#include <tfile.h>
+#include <tbytevector.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  class PlainFile : public File
+  {
+  public:
+    PlainFile(FileName name) : File(name) {}
+    Tag *tag() const { return 0; }
+    AudioProperties *audioProperties() const { return 0; }
+    bool save() { return false; }
+  };
+
+  std::string sizeLabel(unsigned int size)
+  {
+    std::ostringstream s;
+    if(size >= 1024 * 1024)
+      s << size / (1024 * 1024) << " MiB";
+    else
+      s << size / 1024 << " KiB";
+    return s.str();
+  }
+
+  void run(const std::string &name, long size, unsigned int blockSize, int percent)
+  {
+    const unsigned long offset = static_cast<unsigned long>(size / 100 * percent);
+    const unsigned long moved  = static_cast<unsigned long>(size) - offset;
+
+    std::ostringstream label;
+    label << sizeLabel(blockSize) << " at " << percent << "%";
+
+    PlainFile file(name.c_str());
+    {
+      Bench::Measurement m;
+      file.insert(ByteVector(blockSize, 'x'), offset);
+      m.print("insert() " + label.str(), moved);
+    }
+    {
+      Bench::Measurement m;
+      file.removeBlock(offset, blockSize);
+      m.print("removeBlock() " + label.str(), moved);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const long size = Bench::sizeArgument(argc, argv, 1, 256 * 1024 * 1024);
+  const unsigned int blockSizes[] = { 4 * 1024, 4 * 1024 * 1024 };
+  const int offsets[] = { 0, 25, 50, 75 };
+
+  const std::string name = Bench::tempFileName(".bin");
+  Bench::createFile(name, size);
+
+  std::cout << "File size: " << size / (1024 * 1024) << " MiB" << std::endl;
+  Bench::Measurement::printHeader();
+
+  for(size_t i = 0; i < sizeof(blockSizes) / sizeof(blockSizes[0]); ++i) {
+    for(size_t j = 0; j < sizeof(offsets) / sizeof(offsets[0]); ++j)
+      run(name, size, blockSizes[i], offsets[j]);
+  }
+
+  std::remove(name.c_str());
+  return 0;
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+// Measures the cost of the text of a tag: strings are made from encoded bytes
+// as the tag parsers do, and then either only read back in their encoding as
+// the renderers do when a field is saved unchanged, or decoded completely.
+//
+// Usage: bench_strings [size in MiB]
+
+#include <vector>
+
+#include <tbytevector.h>
+#include <tstring.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // A field of a typical tag: some ASCII text with a few accented letters.
+
+  String makeText(unsigned int index)
+  {
+    String text = "Track title number ";
+    text += String::number(static_cast<int>(index));
+    text += L" \x00e9\x00e8\x00e0 ";
+    text += "from an album with a long name";
+    return text;
+  }
+
+  void run(const std::string &label, String::Type type, long size)
+  {
+    std::vector<ByteVector> fields;
+    unsigned long long fieldBytes = 0;
+    for(unsigned int i = 0; i < 1024; ++i) {
+      fields.push_back(makeText(i).data(type));
+      fieldBytes += fields.back().size();
+    }
+
+    const unsigned int repeat = static_cast<unsigned int>(size / fieldBytes) + 1;
+    volatile size_t sink = 0;
+
+    {
+      Bench::Measurement m;
+      for(unsigned int r = 0; r < repeat; ++r) {
+        for(size_t i = 0; i < fields.size(); ++i)
+          sink += String(fields[i], type).data(type).size();
+      }
+      m.print(label + " parse and render", fieldBytes * repeat);
+    }
+    {
+      Bench::Measurement m;
+      for(unsigned int r = 0; r < repeat; ++r) {
+        for(size_t i = 0; i < fields.size(); ++i)
+          sink += String(fields[i], type).size();
+      }
+      m.print(label + " parse and decode", fieldBytes * repeat);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const long size = Bench::sizeArgument(argc, argv, 1, 256 * 1024 * 1024);
+
+  Bench::Measurement::printHeader();
+
+  run("Latin-1", String::Latin1, size);
+  run("UTF-8", String::UTF8, size);
+  run("UTF-16", String::UTF16, size);
+  run("UTF-16BE", String::UTF16BE, size);
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+// Measures the conversion of tag text between the encodings of String::Type
+// and the UTF-16 that String keeps: long lyrics in English, in French, in
+// Russian and in Japanese, decoded from and encoded to each encoding that can
+// hold them.
+//
+// Usage: bench_unicode [size in MiB]
+
+#include <tbytevector.h>
+#include <tstring.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // Builds about size characters of text from a line that is repeated.
+
+  String makeText(const wchar_t *line, unsigned int size)
+  {
+    const String l(line);
+    String text;
+    while(text.size() < size) {
+      text += l;
+      text += L'\n';
+    }
+    return text;
+  }
+
+  const char *typeName(String::Type type)
+  {
+    switch(type) {
+    case String::Latin1:  return "Latin-1";
+    case String::UTF8:    return "UTF-8";
+    case String::UTF16:   return "UTF-16";
+    case String::UTF16BE: return "UTF-16BE";
+    default:              return "UTF-16LE";
+    }
+  }
+
+  void run(const std::string &language, const String &text, String::Type type, long size)
+  {
+    const ByteVector encoded = text.data(type);
+    const unsigned int repeat = static_cast<unsigned int>(size / encoded.size()) + 1;
+    volatile size_t sink = 0;
+
+    {
+      Bench::Measurement m;
+      for(unsigned int r = 0; r < repeat; ++r)
+        sink += String(encoded, type).size();
+      m.print(language + " decode " + typeName(type),
+              static_cast<unsigned long long>(encoded.size()) * repeat);
+    }
+    {
+      Bench::Measurement m;
+      for(unsigned int r = 0; r < repeat; ++r)
+        sink += text.data(type).size();
+      m.print(language + " encode " + typeName(type),
+              static_cast<unsigned long long>(encoded.size()) * repeat);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const long size = Bench::sizeArgument(argc, argv, 1, 64 * 1024 * 1024);
+  const unsigned int length = 8192;
+
+  const String english = makeText(
+    L"And the song goes on and on, through the night until the morning comes", length);
+  const String french = makeText(
+    L"L'\x00e9t\x00e9 o\x00f9 nous chantions, c'\x00e9tait d\x00e9j\x00e0 l'hiver \x00e0 No\x00ebl", length);
+  const String russian = makeText(
+    L"\x041f\x0435\x0441\x043d\x044f \x043e \x043b\x044e\x0431\x0432\x0438 "
+    L"\x0438 \x0432\x0435\x0441\x043d\x0435, 2016", length);
+  const String japanese = makeText(
+    L"\x591c\x660e\x3051\x307e\x3067\x6b4c\x3063\x3066\x3044\x305f (Live)", length);
+
+  Bench::Measurement::printHeader();
+
+  const String::Type unicode[] = { String::UTF8, String::UTF16, String::UTF16BE };
+
+  run("English", english, String::Latin1, size);
+  run("French", french, String::Latin1, size);
+  for(unsigned int i = 0; i < 3; ++i) {
+    run("English", english, unicode[i], size);
+    run("French", french, unicode[i], size);
+    run("Russian", russian, unicode[i], size);
+    run("Japanese", japanese, unicode[i], size);
+  }
+
+  return 0;
+}
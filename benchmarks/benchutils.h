@@ -0,0 +1,190 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_BENCHUTILS_H
+#define TAGLIB_BENCHUTILS_H
+
+// Helpers shared by the benchmark programs.  Not a part of the TagLib API.
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <sys/time.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+namespace Bench
+{
+  /*!
+   * Counters of the I/O issued by this process.  On Linux these are the real
+   * numbers of read and write system calls taken from /proc/self/io.  On other
+   * systems they are not available and stay zero.
+   */
+  struct IOCounters
+  {
+    IOCounters() : readCalls(0), writeCalls(0), bytesRead(0), bytesWritten(0) {}
+
+    unsigned long long readCalls;
+    unsigned long long writeCalls;
+    unsigned long long bytesRead;
+    unsigned long long bytesWritten;
+  };
+
+  inline IOCounters ioCounters()
+  {
+    IOCounters counters;
+
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    unsigned long long value;
+    while(io >> key >> value) {
+      if(key == "syscr:")
+        counters.readCalls = value;
+      else if(key == "syscw:")
+        counters.writeCalls = value;
+      else if(key == "rchar:")
+        counters.bytesRead = value;
+      else if(key == "wchar:")
+        counters.bytesWritten = value;
+    }
+
+    return counters;
+  }
+
+  /*!
+   * Returns a monotonic-enough wall clock time in seconds.
+   */
+  inline double now()
+  {
+#ifdef _WIN32
+    return static_cast<double>(GetTickCount64()) / 1000.0;
+#else
+    timeval tv;
+    gettimeofday(&tv, 0);
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1000000.0;
+#endif
+  }
+
+  /*!
+   * Returns the path of a scratch file in the temporary directory.
+   */
+  inline std::string tempFileName(const std::string &suffix)
+  {
+    char name[1024];
+#ifdef _WIN32
+    char tempDir[MAX_PATH + 1];
+    GetTempPathA(sizeof(tempDir), tempDir);
+    _snprintf(name, sizeof(name), "%s\\taglib-bench%s", tempDir, suffix.c_str());
+#else
+    snprintf(name, sizeof(name), "%s/taglib-bench%s", P_tmpdir, suffix.c_str());
+#endif
+    return name;
+  }
+
+  /*!
+   * Creates the file \a name of \a size bytes filled with a repeating pattern.
+   */
+  inline void createFile(const std::string &name, long size)
+  {
+    std::ofstream out(name.c_str(), std::ios::binary | std::ios::trunc);
+
+    char block[65536];
+    for(size_t i = 0; i < sizeof(block); ++i)
+      block[i] = static_cast<char>(i % 251);
+
+    while(size > 0) {
+      const long n = size < static_cast<long>(sizeof(block)) ? size : static_cast<long>(sizeof(block));
+      out.write(block, n);
+      size -= n;
+    }
+  }
+
+  /*!
+   * Parses the size in MiB given as \a argv[\a index], or returns
+   * \a defaultSize if it is not given.
+   */
+  inline long sizeArgument(int argc, char *argv[], int index, long defaultSize)
+  {
+    if(argc > index) {
+      const long size = std::atol(argv[index]);
+      if(size > 0)
+        return size * 1024 * 1024;
+    }
+    return defaultSize;
+  }
+
+  /*!
+   * Measures the wall time and I/O of one benchmarked operation.
+   */
+  class Measurement
+  {
+  public:
+    Measurement() : startTime(now()), startCounters(ioCounters()) {}
+
+    /*!
+     * Prints one row of the result table, labelled \a label.  If \a bytes is
+     * not zero, the throughput is printed too.
+     */
+    void print(const std::string &label, unsigned long long bytes = 0) const
+    {
+      const double seconds = now() - startTime;
+      const IOCounters counters = ioCounters();
+
+      std::cout << std::left << std::setw(40) << label << std::right
+                << std::setw(10) << (counters.readCalls  - startCounters.readCalls)
+                << std::setw(10) << (counters.writeCalls - startCounters.writeCalls)
+                << std::setw(12) << std::fixed << std::setprecision(2) << seconds * 1000.0;
+
+      if(bytes > 0 && seconds > 0.0)
+        std::cout << std::setw(12) << std::setprecision(1)
+                  << static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds;
+
+      std::cout << std::endl;
+    }
+
+    static void printHeader()
+    {
+      std::cout << std::left << std::setw(40) << "operation" << std::right
+                << std::setw(10) << "reads"
+                << std::setw(10) << "writes"
+                << std::setw(12) << "ms"
+                << std::setw(12) << "MiB/s" << std::endl;
+    }
+
+  private:
+    const double startTime;
+    const IOCounters startCounters;
+  };
+}
+
+#endif
@@ -39,6 +39,7 @@
 #include <tag.h>
 #include <string.h>
 #include <id3v2framefactory.h>
+#include <tthread.h>
 
 #include "tag_c.h"
 
@@ -46,10 +47,24 @@ using namespace TagLib;
 
 namespace
 {
+  // The strings handed out since the last taglib_tag_free_strings(), which
+  // may be called from any thread.
+
   List<char *> strings;
+  Mutex stringsMutex;
+
   bool unicodeStrings = true;
   bool stringManagementEnabled = true;
 
+  char *manageString(char *s)
+  {
+    if(stringManagementEnabled) {
+      MutexLocker locker(stringsMutex);
+      strings.append(s);
+    }
+    return s;
+  }
+
   char *stringToCharArray(const String &s)
   {
     const std::string str = s.to8Bit(unicodeStrings);
@@ -150,6 +165,19 @@ BOOL taglib_file_save(TagLib_File *file)
   return reinterpret_cast<File *>(file)->save();
 }
 
+BOOL taglib_file_save_atomic(TagLib_File *file)
+{
+  File *f = reinterpret_cast<File *>(file);
+
+  const File::SaveMode previousMode = f->saveMode();
+  f->setSaveMode(File::Atomic);
+
+  const BOOL saved = f->save();
+
+  f->setSaveMode(previousMode);
+  return saved;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // TagLib::Tag wrapper
 ////////////////////////////////////////////////////////////////////////////////
@@ -157,46 +185,31 @@ BOOL taglib_file_save(TagLib_File *file)
 char *taglib_tag_title(const TagLib_Tag *tag)
 {
   const Tag *t = reinterpret_cast<const Tag *>(tag);
-  char *s = stringToCharArray(t->title());
-  if(stringManagementEnabled)
-    strings.append(s);
-  return s;
+  return manageString(stringToCharArray(t->title()));
 }
 
 char *taglib_tag_artist(const TagLib_Tag *tag)
 {
   const Tag *t = reinterpret_cast<const Tag *>(tag);
-  char *s = stringToCharArray(t->artist());
-  if(stringManagementEnabled)
-    strings.append(s);
-  return s;
+  return manageString(stringToCharArray(t->artist()));
 }
 
 char *taglib_tag_album(const TagLib_Tag *tag)
 {
   const Tag *t = reinterpret_cast<const Tag *>(tag);
-  char *s = stringToCharArray(t->album());
-  if(stringManagementEnabled)
-    strings.append(s);
-  return s;
+  return manageString(stringToCharArray(t->album()));
 }
 
 char *taglib_tag_comment(const TagLib_Tag *tag)
 {
   const Tag *t = reinterpret_cast<const Tag *>(tag);
-  char *s = stringToCharArray(t->comment());
-  if(stringManagementEnabled)
-    strings.append(s);
-  return s;
+  return manageString(stringToCharArray(t->comment()));
 }
 
 char *taglib_tag_genre(const TagLib_Tag *tag)
 {
   const Tag *t = reinterpret_cast<const Tag *>(tag);
-  char *s = stringToCharArray(t->genre());
-  if(stringManagementEnabled)
-    strings.append(s);
-  return s;
+  return manageString(stringToCharArray(t->genre()));
 }
 
 unsigned int taglib_tag_year(const TagLib_Tag *tag)
@@ -258,6 +271,8 @@ void taglib_tag_free_strings()
   if(!stringManagementEnabled)
     return;
 
+  MutexLocker locker(stringsMutex);
+
   for(List<char *>::ConstIterator it = strings.begin(); it != strings.end(); ++it)
     free(*it);
   strings.clear();
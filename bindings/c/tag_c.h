@@ -147,6 +147,13 @@ TAGLIB_C_EXPORT const TagLib_AudioProperties *taglib_file_audioproperties(const
  */
 TAGLIB_C_EXPORT BOOL taglib_file_save(TagLib_File *file);
 
+/*!
+ * Saves the \a file to disk by writing a new copy of it next to the original
+ * and renaming it over the original, so that the file is never left half
+ * written.  Falls back to saving in place if that is not possible.
+ */
+TAGLIB_C_EXPORT BOOL taglib_file_save_atomic(TagLib_File *file);
+
 /******************************************************************************
  * Tag API
  ******************************************************************************/
@@ -248,6 +255,9 @@ TAGLIB_C_EXPORT void taglib_tag_set_track(TagLib_Tag *tag, unsigned int track);
 
 /*!
  * Frees all of the strings that have been created by the tag.
+ *
+ * \note This frees the strings returned on every thread, so it should not be
+ * called while another thread is still using one of them.
  */
 TAGLIB_C_EXPORT void taglib_tag_free_strings(void);
 
@@ -24,6 +24,23 @@
 /* Defined if your compiler supports ISO _strdup */
 #cmakedefine   HAVE_ISO_STRDUP 1
 
+/* Defined if your system supports copy_file_range() */
+#cmakedefine   HAVE_COPY_FILE_RANGE 1
+
+/* Defined if your system can list the extended attributes of a file */
+#cmakedefine   HAVE_LISTXATTR 1
+#cmakedefine   HAVE_MAC_LISTXATTR 1
+
+/* Defined if SSE2, and AVX2 detected at run time, can search byte vectors */
+#cmakedefine   HAVE_SSE2 1
+#cmakedefine   HAVE_GCC_AVX2 1
+
+/* Defined if carry-less multiplication detected at run time can compute CRCs */
+#cmakedefine   HAVE_GCC_PCLMUL 1
+
+/* Defined if POSIX threads are available */
+#cmakedefine   HAVE_PTHREAD 1
+
 /* Defined if zlib is installed */
 #cmakedefine   HAVE_ZLIB 1
 
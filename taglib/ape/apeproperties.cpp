@@ -74,7 +74,7 @@ APE::Properties::Properties(File *file, long streamLength, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
-  read(file, streamLength);
+  read(file, streamLength, style);
 }
 
 APE::Properties::~Properties()
@@ -133,6 +133,11 @@ unsigned int APE::Properties::sampleFrames() const
 
 namespace
 {
+  // With ReadStyle Fast, the descriptor is only looked for within as many
+  // bytes as APE::File::isSupported() checks.
+
+  const unsigned int DescriptorSearchSize = 1024;
+
   int headerVersion(const ByteVector &header)
   {
     if(header.size() < 6 || !header.startsWith("MAC "))
@@ -142,7 +147,7 @@ namespace
   }
 }
 
-void APE::Properties::read(File *file, long streamLength)
+void APE::Properties::read(File *file, long streamLength, ReadStyle style)
 {
   // First, we assume that the file pointer is set at the first descriptor.
   long offset = file->tell();
@@ -150,9 +155,19 @@ void APE::Properties::read(File *file, long streamLength)
 
   // Next, we look for the descriptor.
   if(version < 0) {
-    offset = file->find("MAC ", offset);
-    file->seek(offset);
-    version = headerVersion(file->readBlock(6));
+    if(style == Fast) {
+      file->seek(offset);
+      const int found = file->readBlock(DescriptorSearchSize).find("MAC ");
+      offset = (found >= 0) ? offset + found : -1;
+    }
+    else {
+      offset = file->find("MAC ", offset);
+    }
+
+    if(offset >= 0) {
+      file->seek(offset);
+      version = headerVersion(file->readBlock(6));
+    }
   }
 
   if(version < 0) {
@@ -129,7 +129,7 @@ namespace TagLib {
       Properties(const Properties &);
       Properties &operator=(const Properties &);
 
-      void read(File *file, long streamLength);
+      void read(File *file, long streamLength, ReadStyle style);
 
       void analyzeCurrent(File *file);
       void analyzeOld(File *file);
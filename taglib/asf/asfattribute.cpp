@@ -33,6 +33,14 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // With File::SkipPictures, only this much of a WM/Picture attribute is
+  // read, which is normally enough to reach the image data.
+
+  const unsigned int PictureFieldsSize = 1024;
+}
+
 class ASF::Attribute::AttributePrivate : public RefCounter
 {
 public:
@@ -234,11 +242,25 @@ String ASF::Attribute::parse(ASF::File &f, int kind)
 
   case BytesType:
   case GuidType:
+    if(d->type == BytesType && name == "WM/Picture"
+       && f.pictureReading() == File::SkipPictures && size > PictureFieldsSize) {
+
+      // Only the start of a large picture is read, and the image data is left
+      // in the file.  The fields before it may be longer than what is read.
+
+      const long offset = f.tell();
+      d->pictureValue.parse(f.readBlock(PictureFieldsSize), &f, offset, size);
+      if(d->pictureValue.isValid()) {
+        f.seek(offset + size);
+        break;
+      }
+      f.seek(offset);
+    }
     d->byteVectorValue = f.readBlock(size);
     break;
   }
 
-  if(d->type == BytesType && name == "WM/Picture") {
+  if(d->type == BytesType && name == "WM/Picture" && !d->pictureValue.isValid()) {
     d->pictureValue.parse(d->byteVectorValue);
     if(d->pictureValue.isValid()) {
       d->byteVectorValue.clear();
@@ -480,7 +480,7 @@ bool ASF::File::isSupported(IOStream *stream)
   // An ASF file has to start with the designated GUID.
 
   const ByteVector id = Utils::readHeader(stream, 16, false);
-  return (id == headerGuid);
+  return (Utils::findASFSignature(id) == 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -495,6 +495,17 @@ ASF::File::File(FileName file, bool, Properties::ReadStyle) :
     read();
 }
 
+ASF::File::File(FileName file, bool, Properties::ReadStyle,
+                PictureReading pictureReading) :
+  TagLib::File(file),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read();
+}
+
 ASF::File::File(IOStream *stream, bool, Properties::ReadStyle) :
   TagLib::File(stream),
   d(new FilePrivate())
@@ -503,6 +514,17 @@ ASF::File::File(IOStream *stream, bool, Properties::ReadStyle) :
     read();
 }
 
+ASF::File::File(IOStream *stream, bool, Properties::ReadStyle,
+                PictureReading pictureReading) :
+  TagLib::File(stream),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read();
+}
+
 ASF::File::~File()
 {
   delete d;
@@ -545,6 +567,8 @@ bool ASF::File::save()
     return false;
   }
 
+  SaveScope scope(this);
+
   if(!d->contentDescriptionObject) {
     d->contentDescriptionObject = new FilePrivate::ContentDescriptionObject();
     d->objects.append(d->contentDescriptionObject);
@@ -614,7 +638,7 @@ bool ASF::File::save()
 
   d->headerSize = data.size() + 30;
 
-  return true;
+  return scope.finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,6 +57,17 @@ namespace TagLib {
       File(FileName file, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an ASF file from \a file.  This is the same as the
+       * constructor above, except that \a pictureReading sets whether the
+       * embedded pictures are read.
+       *
+       * \see TagLib::File::pictureReading()
+       */
+      File(FileName file, bool readProperties,
+           Properties::ReadStyle propertiesStyle,
+           PictureReading pictureReading);
+
       /*!
        * Constructs an ASF file from \a stream.
        *
@@ -70,6 +81,17 @@ namespace TagLib {
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an ASF file from \a stream.  This is the same as the
+       * constructor above, except that \a pictureReading sets whether the
+       * embedded pictures are read.
+       *
+       * \see TagLib::File::pictureReading()
+       */
+      File(IOStream *stream, bool readProperties,
+           Properties::ReadStyle propertiesStyle,
+           PictureReading pictureReading);
+
       /*!
        * Destroys this instance of the File.
        */
@@ -41,7 +41,7 @@ public:
   Type type;
   String mimeType;
   String description;
-  ByteVector picture;
+  Payload picture;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -79,6 +79,7 @@ String ASF::Picture::mimeType() const
 void ASF::Picture::setMimeType(const String &value)
 {
   d->mimeType = value;
+  d->picture.setMimeType(value);
 }
 
 ASF::Picture::Type ASF::Picture::type() const
@@ -102,13 +103,28 @@ void ASF::Picture::setDescription(const String &desc)
 }
 
 ByteVector ASF::Picture::picture() const
+{
+  return d->picture.data();
+}
+
+Payload ASF::Picture::payload() const
 {
   return d->picture;
 }
 
 void ASF::Picture::setPicture(const ByteVector &p)
 {
-  d->picture = p;
+  d->picture = Payload(p, d->mimeType);
+}
+
+void ASF::Picture::setPayload(const Payload &payload)
+{
+  d->picture = payload;
+
+  if(payload.mimeType().isEmpty())
+    d->picture.setMimeType(d->mimeType);
+  else
+    d->mimeType = payload.mimeType();
 }
 
 int ASF::Picture::dataSize() const
@@ -141,10 +157,19 @@ ByteVector ASF::Picture::render() const
     ByteVector::fromUInt(d->picture.size(), false) +
     renderString(d->mimeType) +
     renderString(d->description) +
-    d->picture;
+    d->picture.data();
 }
 
 void ASF::Picture::parse(const ByteVector& bytes)
+{
+  parse(bytes, 0, 0, bytes.size());
+}
+
+// If file is not null, bytes only holds the start of the size bytes of the
+// picture, which are at offset in file, and the image data is left there.
+
+void ASF::Picture::parse(const ByteVector &bytes, TagLib::File *file, long offset,
+                         unsigned int size)
 {
   d->valid = false;
   if(bytes.size() < 9)
@@ -167,10 +192,13 @@ void ASF::Picture::parse(const ByteVector& bytes)
   d->description = String(bytes.mid(pos, endPos - pos), String::UTF16LE);
   pos = endPos+2;
 
-  if(dataLen + pos != bytes.size())
+  if(dataLen + pos != size)
     return;
 
-  d->picture = bytes.mid(pos, dataLen);
+  if(file)
+    d->picture = Payload(file, offset + pos, dataLen, d->mimeType);
+  else
+    d->picture = Payload(bytes.mid(pos, dataLen), d->mimeType);
   d->valid = true;
   return;
 }
@@ -264,6 +264,16 @@ namespace
 
     return String();
   }
+
+  String reverseTranslateKey(const String &key)
+  {
+    for(size_t i = 0; i < keyTranslationSize; ++i) {
+      if(key == keyTranslation[i][1])
+        return keyTranslation[i][0];
+    }
+
+    return String();
+  }
 }
 
 PropertyMap ASF::Tag::properties() const
@@ -316,14 +326,6 @@ void ASF::Tag::removeUnsupportedProperties(const StringList &props)
 
 PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
 {
-  static Map<String, String> reverseKeyMap;
-  if(reverseKeyMap.isEmpty()) {
-    int numKeys = sizeof(keyTranslation) / sizeof(keyTranslation[0]);
-    for(int i = 0; i < numKeys; i++) {
-      reverseKeyMap[keyTranslation[i][1]] = keyTranslation[i][0];
-    }
-  }
-
   PropertyMap origProps = properties();
   PropertyMap::ConstIterator it = origProps.begin();
   for(; it != origProps.end(); ++it) {
@@ -341,7 +343,7 @@ PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
         d->copyright.clear();
       }
       else {
-        d->attributeListMap.erase(reverseKeyMap[it->first]);
+        d->attributeListMap.erase(reverseTranslateKey(it->first));
       }
     }
   }
@@ -349,8 +351,8 @@ PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
   PropertyMap ignoredProps;
   it = props.begin();
   for(; it != props.end(); ++it) {
-    if(reverseKeyMap.contains(it->first)) {
-      String name = reverseKeyMap[it->first];
+    const String name = reverseTranslateKey(it->first);
+    if(!name.isEmpty()) {
       removeItem(name);
       StringList::ConstIterator it2 = it->second.begin();
       for(; it2 != it->second.end(); ++it2) {
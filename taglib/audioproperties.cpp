@@ -78,7 +78,11 @@ using namespace TagLib;
 
 class AudioProperties::AudioPropertiesPrivate
 {
+public:
+  AudioPropertiesPrivate() :
+    estimated(false) {}
 
+  bool estimated;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -87,7 +91,7 @@ class AudioProperties::AudioPropertiesPrivate
 
 AudioProperties::~AudioProperties()
 {
-
+  delete d;
 }
 
 int AudioProperties::lengthInSeconds() const
@@ -100,12 +104,22 @@ int AudioProperties::lengthInMilliseconds() const
   VIRTUAL_FUNCTION_WORKAROUND(lengthInMilliseconds, 0)
 }
 
+bool AudioProperties::isEstimated() const
+{
+  return d->estimated;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // protected methods
 ////////////////////////////////////////////////////////////////////////////////
 
 AudioProperties::AudioProperties(ReadStyle) :
-  d(0)
+  d(new AudioPropertiesPrivate())
 {
 
 }
+
+void AudioProperties::setEstimated(bool estimated)
+{
+  d->estimated = estimated;
+}
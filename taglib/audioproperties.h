@@ -103,6 +103,14 @@ namespace TagLib {
      */
     virtual int channels() const = 0;
 
+    /*!
+     * Returns true if the length and the bitrate are estimates.  This happens
+     * when the properties are read with ReadStyle Fast and the start of the
+     * stream does not tell its length, so that it is worked out from the size
+     * of the file instead of reading the end of the stream.
+     */
+    bool isEstimated() const;
+
   protected:
 
     /*!
@@ -114,6 +122,13 @@ namespace TagLib {
      */
     AudioProperties(ReadStyle style);
 
+    /*!
+     * Marks the length and the bitrate as estimates.
+     *
+     * \see isEstimated()
+     */
+    void setEstimated(bool estimated);
+
   private:
     AudioProperties(const AudioProperties &);
     AudioProperties &operator=(const AudioProperties &);
@@ -29,9 +29,12 @@
 
 #include <tfile.h>
 #include <tfilestream.h>
+#include <tmappedfilestream.h>
+#include <tblockcachestream.h>
 #include <tstring.h>
 #include <tdebug.h>
 #include <trefcounter.h>
+#include <tthread.h>
 
 #include "fileref.h"
 #include "asffile.h"
@@ -52,21 +55,72 @@
 #include "s3mfile.h"
 #include "itfile.h"
 #include "xmfile.h"
+#include "id3v2header.h"
+#include "mpegutils.h"
+#include "tagutils.h"
+
+#include <algorithm>
+#include <vector>
 
 using namespace TagLib;
 
 namespace
 {
-  typedef List<const FileRef::FileTypeResolver *> ResolverList;
-  ResolverList fileTypeResolvers;
+  typedef std::vector<const FileRef::FileTypeResolver *> ResolverList;
+
+  // The resolvers are looked up on every FileRef without locking.  A change
+  // publishes a new list, and the lists that other threads may still be
+  // walking are kept until exit.  Only the lists are freed then; the
+  // resolvers belong to the caller, which is why this is not a List, whose
+  // destructor may delete its pointers.
+
+  void *volatile fileTypeResolvers = 0;
+
+  class ResolverHistory
+  {
+  public:
+    ~ResolverHistory()
+    {
+      Thread::storePointer(&fileTypeResolvers, 0);
+
+      for(std::vector<ResolverList *>::const_iterator it = lists.begin(); it != lists.end(); ++it)
+        delete *it;
+    }
+
+    Mutex mutex;
+    std::vector<ResolverList *> lists;
+  };
+
+  ResolverHistory &resolverHistory()
+  {
+    static ResolverHistory history;
+    return history;
+  }
+
+  const ResolverList *currentResolvers()
+  {
+    return static_cast<const ResolverList *>(Thread::loadPointer(&fileTypeResolvers));
+  }
+
+  // Must be called with the history locked.
+
+  void publishResolvers(ResolverHistory &history, ResolverList *resolvers)
+  {
+    history.lists.push_back(resolvers);
+    Thread::storePointer(&fileTypeResolvers, resolvers);
+  }
 
   // Detect the file type by user-defined resolvers.
 
   File *detectByResolvers(FileName fileName, bool readAudioProperties,
                           AudioProperties::ReadStyle audioPropertiesStyle)
   {
-    ResolverList::ConstIterator it = fileTypeResolvers.begin();
-    for(; it != fileTypeResolvers.end(); ++it) {
+    const ResolverList *resolvers = currentResolvers();
+    if(!resolvers)
+      return 0;
+
+    ResolverList::const_iterator it = resolvers->begin();
+    for(; it != resolvers->end(); ++it) {
       File *file = (*it)->createFile(fileName, readAudioProperties, audioPropertiesStyle);
       if(file)
         return file;
@@ -78,7 +132,8 @@ namespace
   // Detect the file type based on the file extension.
 
   File* detectByExtension(IOStream *stream, bool readAudioProperties,
-                          AudioProperties::ReadStyle audioPropertiesStyle)
+                          AudioProperties::ReadStyle audioPropertiesStyle,
+                        File::PictureReading pictureReading)
   {
 #ifdef _WIN32
     const String s = stream->name().toString();
@@ -101,29 +156,29 @@ namespace
     // .oga can be any audio in the Ogg container. So leave it to content-based detection.
 
     if(ext == "MP3")
-      return new MPEG::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
+      return new MPEG::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle, pictureReading);
     if(ext == "OGG")
-      return new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
     if(ext == "FLAC")
-      return new FLAC::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
+      return new FLAC::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle, pictureReading);
     if(ext == "MPC")
       return new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
     if(ext == "WV")
       return new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
     if(ext == "SPX")
-      return new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
     if(ext == "OPUS")
-      return new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
     if(ext == "TTA")
-      return new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new TrueAudio::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle, pictureReading);
     if(ext == "M4A" || ext == "M4R" || ext == "M4B" || ext == "M4P" || ext == "MP4" || ext == "3G2" || ext == "M4V")
-      return new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new MP4::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
     if(ext == "WMA" || ext == "ASF")
-      return new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new ASF::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
     if(ext == "AIF" || ext == "AIFF" || ext == "AFC" || ext == "AIFC")
-      return new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
     if(ext == "WAV")
-      return new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
     if(ext == "APE")
       return new APE::File(stream, readAudioProperties, audioPropertiesStyle);
     // module, nst and wow are possible but uncommon extensions
@@ -139,43 +194,155 @@ namespace
     return 0;
   }
 
+  // The file types that can be told apart by their content.  When two of
+  // them match equally well, the one that comes first wins.
+
+  enum ContentType {
+    MPEGContent,
+    VorbisContent,
+    OggFLACContent,
+    FLACContent,
+    MPCContent,
+    WavPackContent,
+    SpeexContent,
+    OpusContent,
+    TrueAudioContent,
+    MP4Content,
+    ASFContent,
+    AIFFContent,
+    WAVContent,
+    APEContent,
+    UnknownContent
+  };
+
+  // Signatures that may be anywhere near the start of the data are searched
+  // for in this many bytes, the same as the isSupported() functions do.
+
+  const unsigned int SignatureSearchSize = 1024;
+
+  // The number of bytes read at the start of the stream or after an ID3v2
+  // tag.  This also holds the header of the MPEG frame that follows any
+  // frame found in the first SignatureSearchSize bytes.
+
+  const unsigned int ContentWindowSize = SignatureSearchSize + MPEG::FrameLookahead;
+
+  // Reads the start of the stream, or the start of the data after an ID3v2
+  // tag if there is one, and matches the signatures of all the content types
+  // against it.  These are the checks of the isSupported() functions, but
+  // the stream is read once or twice rather than once per type.
+  //
+  // The data of an ID3v2 tag, such as an embedded picture, may hold any of
+  // the signatures, so the tag itself is never searched.
+  //
+  // The signature that is found nearest to the start of the data is the most
+  // reliable one, since an MPEG frame sync or an ID that is searched for may
+  // as well be part of the data of another type.
+
+  ContentType detectContentType(IOStream *stream)
+  {
+    if(!stream || !stream->isOpen())
+      return UnknownContent;
+
+    const long originalPosition = stream->tell();
+
+    stream->seek(0);
+    ByteVector data = stream->readBlock(ContentWindowSize);
+
+    if(data.startsWith(ID3v2::Header::fileIdentifier())) {
+      const long tagSize = ID3v2::Header(data.mid(0, ID3v2::Header::size())).completeTagSize();
+      if(tagSize > 0) {
+        stream->seek(tagSize);
+        data = stream->readBlock(ContentWindowSize);
+      }
+    }
+
+    stream->seek(originalPosition);
+
+    const ByteVector dataStart = data.mid(0, SignatureSearchSize);
+
+    long offsets[UnknownContent];
+
+    offsets[MPEGContent]      = Utils::findMPEGSignature(data, SignatureSearchSize);
+    offsets[VorbisContent]    = Utils::findOggSignature(dataStart, "\x01vorbis");
+    offsets[OggFLACContent]   = Utils::findOggSignature(dataStart, "fLaC");
+    offsets[FLACContent]      = Utils::findFLACSignature(dataStart);
+    offsets[MPCContent]       = Utils::findMPCSignature(data);
+    offsets[WavPackContent]   = Utils::findWavPackSignature(data);
+    offsets[SpeexContent]     = Utils::findOggSignature(dataStart, "Speex   ");
+    offsets[OpusContent]      = Utils::findOggSignature(dataStart, "OpusHead");
+    offsets[TrueAudioContent] = Utils::findTrueAudioSignature(data);
+    offsets[MP4Content]       = Utils::findMP4Signature(data);
+    offsets[ASFContent]       = Utils::findASFSignature(data);
+    offsets[AIFFContent]      = Utils::findAIFFSignature(data);
+    offsets[WAVContent]       = Utils::findWAVSignature(data);
+    offsets[APEContent]       = Utils::findAPESignature(dataStart);
+
+    ContentType type = UnknownContent;
+
+    for(int i = 0; i < UnknownContent; ++i) {
+      if(offsets[i] >= 0 && (type == UnknownContent || offsets[i] < offsets[type]))
+        type = static_cast<ContentType>(i);
+    }
+
+    return type;
+  }
+
   // Detect the file type based on the actual content of the stream.
 
   File *detectByContent(IOStream *stream, bool readAudioProperties,
-                        AudioProperties::ReadStyle audioPropertiesStyle)
+                        AudioProperties::ReadStyle audioPropertiesStyle,
+                        File::PictureReading pictureReading)
   {
     File *file = 0;
 
-    if(MPEG::File::isSupported(stream))
-      file = new MPEG::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Vorbis::File::isSupported(stream))
-      file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::FLAC::File::isSupported(stream))
-      file = new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(FLAC::File::isSupported(stream))
-      file = new FLAC::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
-    else if(MPC::File::isSupported(stream))
+    switch(detectContentType(stream)) {
+    case MPEGContent:
+      file = new MPEG::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case VorbisContent:
+      file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case OggFLACContent:
+      file = new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case FLACContent:
+      file = new FLAC::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case MPCContent:
       file = new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(WavPack::File::isSupported(stream))
+      break;
+    case WavPackContent:
       file = new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Speex::File::isSupported(stream))
-      file = new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Opus::File::isSupported(stream))
-      file = new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(TrueAudio::File::isSupported(stream))
-      file = new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(MP4::File::isSupported(stream))
-      file = new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ASF::File::isSupported(stream))
-      file = new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(RIFF::AIFF::File::isSupported(stream))
-      file = new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(RIFF::WAV::File::isSupported(stream))
-      file = new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(APE::File::isSupported(stream))
+      break;
+    case SpeexContent:
+      file = new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case OpusContent:
+      file = new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case TrueAudioContent:
+      file = new TrueAudio::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case MP4Content:
+      file = new MP4::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case ASFContent:
+      file = new ASF::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case AIFFContent:
+      file = new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case WAVContent:
+      file = new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
+      break;
+    case APEContent:
       file = new APE::File(stream, readAudioProperties, audioPropertiesStyle);
+      break;
+    default:
+      break;
+    }
 
-    // isSupported() only does a quick check, so double check the file here.
+    // The signatures are only a quick check, so double check the file here.
 
     if(file) {
       if(file->isValid())
@@ -260,6 +427,118 @@ namespace
   }
 }
 
+namespace
+{
+  // The work shared by the threads of FileRef::readBatch().  Each thread takes
+  // the next file until there are none left.
+
+  template <class T>
+  struct Batch
+  {
+    Batch(const List<T> &inputs, bool readAudioProperties,
+          AudioProperties::ReadStyle audioPropertiesStyle) :
+      inputs(inputs.begin(), inputs.end()),
+      results(inputs.size()),
+      readAudioProperties(readAudioProperties),
+      audioPropertiesStyle(audioPropertiesStyle),
+      next(0) {}
+
+    const std::vector<T> inputs;
+    std::vector<FileRef::Metadata> results;
+    const bool readAudioProperties;
+    const AudioProperties::ReadStyle audioPropertiesStyle;
+    Mutex mutex;
+    size_t next;
+  };
+
+  FileRef openBatchFile(FileName fileName, bool readAudioProperties,
+                        AudioProperties::ReadStyle audioPropertiesStyle)
+  {
+    return FileRef(fileName, readAudioProperties, audioPropertiesStyle,
+                   FileRef::CachedStream, File::SkipPictures);
+  }
+
+  FileRef openBatchFile(IOStream *stream, bool readAudioProperties,
+                        AudioProperties::ReadStyle audioPropertiesStyle)
+  {
+    return FileRef(stream, readAudioProperties, audioPropertiesStyle, File::SkipPictures);
+  }
+
+  template <class T>
+  void readBatchFiles(void *data)
+  {
+    Batch<T> *batch = static_cast<Batch<T> *>(data);
+
+    for(;;) {
+      size_t i;
+      {
+        MutexLocker locker(batch->mutex);
+        i = batch->next++;
+      }
+
+      if(i >= batch->inputs.size())
+        return;
+
+      const FileRef ref = openBatchFile(
+        batch->inputs[i], batch->readAudioProperties, batch->audioPropertiesStyle);
+      batch->results[i] = FileRef::Metadata(ref);
+    }
+  }
+
+  template <class T>
+  FileRef::MetadataList readBatchInParallel(const List<T> &inputs, bool readAudioProperties,
+                                            AudioProperties::ReadStyle audioPropertiesStyle,
+                                            unsigned int threads)
+  {
+    Batch<T> batch(inputs, readAudioProperties, audioPropertiesStyle);
+
+    if(threads == 0)
+      threads = Thread::hardwareConcurrency();
+    if(threads > inputs.size())
+      threads = inputs.size();
+
+    Thread::run(threads, &readBatchFiles<T>, &batch);
+
+    FileRef::MetadataList results;
+    for(std::vector<FileRef::Metadata>::const_iterator it = batch.results.begin();
+        it != batch.results.end(); ++it) {
+      results.append(*it);
+    }
+
+    return results;
+  }
+}
+
+class FileRef::Metadata::MetadataPrivate : public RefCounter
+{
+public:
+  MetadataPrivate() :
+    RefCounter(),
+    isNull(true),
+    year(0),
+    track(0),
+    hasAudioProperties(false),
+    lengthInMilliseconds(0),
+    bitrate(0),
+    sampleRate(0),
+    channels(0) {}
+
+  bool isNull;
+  String title;
+  String artist;
+  String album;
+  String comment;
+  String genre;
+  unsigned int year;
+  unsigned int track;
+  PropertyMap properties;
+  bool hasAudioProperties;
+  int lengthInMilliseconds;
+  int bitrate;
+  int sampleRate;
+  int channels;
+};
+
 class FileRef::FileRefPrivate : public RefCounter
 {
 public:
@@ -290,13 +569,35 @@ FileRef::FileRef(FileName fileName, bool readAudioProperties,
                  AudioProperties::ReadStyle audioPropertiesStyle) :
   d(new FileRefPrivate())
 {
-  parse(fileName, readAudioProperties, audioPropertiesStyle);
+  parse(fileName, readAudioProperties, audioPropertiesStyle, DefaultStream, File::ReadPictures);
+}
+
+FileRef::FileRef(FileName fileName, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle, StreamType streamType) :
+  d(new FileRefPrivate())
+{
+  parse(fileName, readAudioProperties, audioPropertiesStyle, streamType, File::ReadPictures);
+}
+
+FileRef::FileRef(FileName fileName, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle, StreamType streamType,
+                 File::PictureReading pictureReading) :
+  d(new FileRefPrivate())
+{
+  parse(fileName, readAudioProperties, audioPropertiesStyle, streamType, pictureReading);
 }
 
 FileRef::FileRef(IOStream* stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle) :
   d(new FileRefPrivate())
 {
-  parse(stream, readAudioProperties, audioPropertiesStyle);
+  parse(stream, readAudioProperties, audioPropertiesStyle, File::ReadPictures);
+}
+
+FileRef::FileRef(IOStream* stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle,
+                 File::PictureReading pictureReading) :
+  d(new FileRefPrivate())
+{
+  parse(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
 }
 
 FileRef::FileRef(File *file) :
@@ -349,12 +650,53 @@ bool FileRef::save()
   return d->file->save();
 }
 
+bool FileRef::save(File::SaveMode mode)
+{
+  if(isNull()) {
+    debug("FileRef::save() - Called without a valid file.");
+    return false;
+  }
+
+  const File::SaveMode previousMode = d->file->saveMode();
+  d->file->setSaveMode(mode);
+
+  const bool saved = d->file->save();
+
+  d->file->setSaveMode(previousMode);
+  return saved;
+}
+
 const FileRef::FileTypeResolver *FileRef::addFileTypeResolver(const FileRef::FileTypeResolver *resolver) // static
 {
-  fileTypeResolvers.prepend(resolver);
+  ResolverHistory &history = resolverHistory();
+  MutexLocker locker(history.mutex);
+
+  const ResolverList *current = currentResolvers();
+  ResolverList *resolvers = current ? new ResolverList(*current) : new ResolverList();
+  resolvers->insert(resolvers->begin(), resolver);
+
+  publishResolvers(history, resolvers);
   return resolver;
 }
 
+void FileRef::removeFileTypeResolver(const FileRef::FileTypeResolver *resolver) // static
+{
+  ResolverHistory &history = resolverHistory();
+  MutexLocker locker(history.mutex);
+
+  const ResolverList *current = currentResolvers();
+  if(!current || std::find(current->begin(), current->end(), resolver) == current->end())
+    return;
+
+  ResolverList *resolvers = new ResolverList();
+  for(ResolverList::const_iterator it = current->begin(); it != current->end(); ++it) {
+    if(*it != resolver)
+      resolvers->push_back(*it);
+  }
+
+  publishResolvers(history, resolvers);
+}
+
 StringList FileRef::defaultFileExtensions()
 {
   StringList l;
@@ -419,18 +761,167 @@ bool FileRef::operator!=(const FileRef &ref) const
   return (ref.d->file != d->file);
 }
 
+FileRef::MetadataList FileRef::readBatch(const List<FileName> &fileNames,
+                                        bool readAudioProperties,
+                                        AudioProperties::ReadStyle audioPropertiesStyle,
+                                        unsigned int threads) // static
+{
+  return readBatchInParallel(fileNames, readAudioProperties, audioPropertiesStyle, threads);
+}
+
+FileRef::MetadataList FileRef::readBatch(const List<IOStream *> &streams,
+                                        bool readAudioProperties,
+                                        AudioProperties::ReadStyle audioPropertiesStyle,
+                                        unsigned int threads) // static
+{
+  return readBatchInParallel(streams, readAudioProperties, audioPropertiesStyle, threads);
+}
+
 File *FileRef::create(FileName fileName, bool readAudioProperties,
                       AudioProperties::ReadStyle audioPropertiesStyle) // static
 {
   return createInternal(fileName, readAudioProperties, audioPropertiesStyle);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// FileRef::Metadata public members
+////////////////////////////////////////////////////////////////////////////////
+
+FileRef::Metadata::Metadata() :
+  d(new MetadataPrivate())
+{
+}
+
+FileRef::Metadata::Metadata(const Metadata &other) :
+  d(other.d)
+{
+  d->ref();
+}
+
+FileRef::Metadata::Metadata(const FileRef &ref) :
+  d(new MetadataPrivate())
+{
+  if(ref.isNull())
+    return;
+
+  d->isNull = false;
+
+  // Some tags add empty fields when they are read through Tag, so take the
+  // properties first.
+
+  d->properties = ref.file()->properties();
+
+  const Tag *tag = ref.tag();
+  if(tag) {
+    d->title   = tag->title();
+    d->artist  = tag->artist();
+    d->album   = tag->album();
+    d->comment = tag->comment();
+    d->genre   = tag->genre();
+    d->year    = tag->year();
+    d->track   = tag->track();
+  }
+
+  const AudioProperties *properties = ref.audioProperties();
+  if(properties) {
+    d->hasAudioProperties   = true;
+    d->lengthInMilliseconds = properties->lengthInMilliseconds();
+    d->bitrate              = properties->bitrate();
+    d->sampleRate           = properties->sampleRate();
+    d->channels             = properties->channels();
+  }
+}
+
+FileRef::Metadata::~Metadata()
+{
+  if(d->deref())
+    delete d;
+}
+
+FileRef::Metadata &FileRef::Metadata::operator=(const Metadata &other)
+{
+  Metadata copy(other);
+  std::swap(d, copy.d);
+  return *this;
+}
+
+bool FileRef::Metadata::isNull() const
+{
+  return d->isNull;
+}
+
+String FileRef::Metadata::title() const
+{
+  return d->title;
+}
+
+String FileRef::Metadata::artist() const
+{
+  return d->artist;
+}
+
+String FileRef::Metadata::album() const
+{
+  return d->album;
+}
+
+String FileRef::Metadata::comment() const
+{
+  return d->comment;
+}
+
+String FileRef::Metadata::genre() const
+{
+  return d->genre;
+}
+
+unsigned int FileRef::Metadata::year() const
+{
+  return d->year;
+}
+
+unsigned int FileRef::Metadata::track() const
+{
+  return d->track;
+}
+
+PropertyMap FileRef::Metadata::properties() const
+{
+  return d->properties;
+}
+
+bool FileRef::Metadata::hasAudioProperties() const
+{
+  return d->hasAudioProperties;
+}
+
+int FileRef::Metadata::lengthInMilliseconds() const
+{
+  return d->lengthInMilliseconds;
+}
+
+int FileRef::Metadata::bitrate() const
+{
+  return d->bitrate;
+}
+
+int FileRef::Metadata::sampleRate() const
+{
+  return d->sampleRate;
+}
+
+int FileRef::Metadata::channels() const
+{
+  return d->channels;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
 void FileRef::parse(FileName fileName, bool readAudioProperties,
-                    AudioProperties::ReadStyle audioPropertiesStyle)
+                    AudioProperties::ReadStyle audioPropertiesStyle, StreamType streamType,
+                    File::PictureReading pictureReading)
 {
   // Try user-defined resolvers.
 
@@ -440,14 +931,20 @@ void FileRef::parse(FileName fileName, bool readAudioProperties,
 
   // Try to resolve file types based on the file extension.
 
-  d->stream = new FileStream(fileName);
-  d->file = detectByExtension(d->stream, readAudioProperties, audioPropertiesStyle);
+  if(streamType == MappedStream)
+    d->stream = new MappedFileStream(fileName);
+  else if(streamType == CachedStream)
+    d->stream = new BlockCacheStream(fileName);
+  else
+    d->stream = new FileStream(fileName);
+
+  d->file = detectByExtension(d->stream, readAudioProperties, audioPropertiesStyle, pictureReading);
   if(d->file)
     return;
 
   // At last, try to resolve file types based on the actual content.
 
-  d->file = detectByContent(d->stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByContent(d->stream, readAudioProperties, audioPropertiesStyle, pictureReading);
   if(d->file)
     return;
 
@@ -458,17 +955,18 @@ void FileRef::parse(FileName fileName, bool readAudioProperties,
 }
 
 void FileRef::parse(IOStream *stream, bool readAudioProperties,
-                    AudioProperties::ReadStyle audioPropertiesStyle)
+                    AudioProperties::ReadStyle audioPropertiesStyle,
+                    File::PictureReading pictureReading)
 {
   // User-defined resolvers won't work with a stream.
 
   // Try to resolve file types based on the file extension.
 
-  d->file = detectByExtension(stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByExtension(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
   if(d->file)
     return;
 
   // At last, try to resolve file types based on the actual content of the file.
 
-  d->file = detectByContent(stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByContent(stream, readAudioProperties, audioPropertiesStyle, pictureReading);
 }
@@ -28,6 +28,7 @@
 
 #include "tfile.h"
 #include "tstringlist.h"
+#include "tpropertymap.h"
 
 #include "taglib_export.h"
 #include "audioproperties.h"
@@ -108,6 +109,155 @@ namespace TagLib {
                                audioPropertiesStyle = AudioProperties::Average) const = 0;
     };
 
+    /*!
+     * The kinds of stream FileRef can use to open a file by name.
+     */
+    enum StreamType {
+      //! Open the file with FileStream, for reading and writing if possible.
+      DefaultStream,
+      //! Open the file read only with MappedFileStream.
+      MappedStream,
+      //! Open the file with a BlockCacheStream on top of a FileStream.
+      CachedStream
+    };
+
+    //! The metadata of one file, as returned by readBatch()
+
+    /*!
+     * This is a copy of what a FileRef returns for a file, which stays valid
+     * after the file has been closed.  It is implicitly shared.
+     */
+
+    class TAGLIB_EXPORT Metadata
+    {
+    public:
+      /*!
+       * Constructs null metadata.
+       */
+      Metadata();
+
+      /*!
+       * Makes a shallow, implicitly shared copy of \a other.
+       */
+      Metadata(const Metadata &other);
+
+      /*!
+       * Copies the metadata of the file of \a ref.  Null if \a ref is null.
+       */
+      explicit Metadata(const FileRef &ref);
+
+      /*!
+       * Destroys this instance.
+       */
+      ~Metadata();
+
+      /*!
+       * Makes this a shallow, implicitly shared copy of \a other.
+       */
+      Metadata &operator=(const Metadata &other);
+
+      /*!
+       * Returns true if the file could not be opened or its type is not
+       * supported.
+       */
+      bool isNull() const;
+
+      /*!
+       * Returns the title of the file's tag.
+       *
+       * \see Tag::title()
+       */
+      String title() const;
+
+      /*!
+       * Returns the artist of the file's tag.
+       *
+       * \see Tag::artist()
+       */
+      String artist() const;
+
+      /*!
+       * Returns the album of the file's tag.
+       *
+       * \see Tag::album()
+       */
+      String album() const;
+
+      /*!
+       * Returns the comment of the file's tag.
+       *
+       * \see Tag::comment()
+       */
+      String comment() const;
+
+      /*!
+       * Returns the genre of the file's tag.
+       *
+       * \see Tag::genre()
+       */
+      String genre() const;
+
+      /*!
+       * Returns the year of the file's tag, or 0 if there is none.
+       *
+       * \see Tag::year()
+       */
+      unsigned int year() const;
+
+      /*!
+       * Returns the track number of the file's tag, or 0 if there is none.
+       *
+       * \see Tag::track()
+       */
+      unsigned int track() const;
+
+      /*!
+       * Returns all the tag data of the file.
+       *
+       * \see File::properties()
+       */
+      PropertyMap properties() const;
+
+      /*!
+       * Returns true if the audio properties were read.
+       */
+      bool hasAudioProperties() const;
+
+      /*!
+       * Returns the length of the file in milliseconds.
+       *
+       * \see AudioProperties::lengthInMilliseconds()
+       */
+      int lengthInMilliseconds() const;
+
+      /*!
+       * Returns the average bit rate of the file in kb/s.
+       *
+       * \see AudioProperties::bitrate()
+       */
+      int bitrate() const;
+
+      /*!
+       * Returns the sample rate in Hz.
+       *
+       * \see AudioProperties::sampleRate()
+       */
+      int sampleRate() const;
+
+      /*!
+       * Returns the number of audio channels.
+       *
+       * \see AudioProperties::channels()
+       */
+      int channels() const;
+
+    private:
+      class MetadataPrivate;
+      MetadataPrivate *d;
+    };
+
+    typedef List<Metadata> MetadataList;
+
     /*!
      * Creates a null FileRef.
      */
@@ -127,6 +277,38 @@ namespace TagLib {
                      AudioProperties::ReadStyle
                      audioPropertiesStyle = AudioProperties::Average);
 
+    /*!
+     * Create a FileRef from \a fileName and open it with a stream of type
+     * \a streamType.  Otherwise this is the same as the constructor above.
+     *
+     * Opening a file with MappedStream avoids most of the I/O overhead when
+     * only reading tags, but the file can not be saved.  CachedStream serves
+     * the many small reads of the parsers from memory, and the file can still
+     * be saved.
+     *
+     * \see MappedFileStream
+     * \see BlockCacheStream
+     */
+    FileRef(FileName fileName,
+            bool readAudioProperties,
+            AudioProperties::ReadStyle audioPropertiesStyle,
+            StreamType streamType);
+
+    /*!
+     * Create a FileRef from \a fileName, like the constructor above, and read
+     * the embedded pictures of the file as given by \a pictureReading.  With
+     * File::SkipPictures, the picture data is only read from the file when it
+     * is asked for, which saves most of the reading and memory when only the
+     * text of the tags is needed.  File type resolvers ignore this setting.
+     *
+     * \see File::pictureReading()
+     */
+    FileRef(FileName fileName,
+            bool readAudioProperties,
+            AudioProperties::ReadStyle audioPropertiesStyle,
+            StreamType streamType,
+            File::PictureReading pictureReading);
+
     /*!
      * Construct a FileRef from an opened \a IOStream.  If \a readAudioProperties
      * is true then the audio properties will be read using \a audioPropertiesStyle.
@@ -144,6 +326,18 @@ namespace TagLib {
                      AudioProperties::ReadStyle
                      audioPropertiesStyle = AudioProperties::Average);
 
+    /*!
+     * Construct a FileRef from an opened \a IOStream, like the constructor
+     * above, and read the embedded pictures of the file as given by
+     * \a pictureReading.
+     *
+     * \see File::pictureReading()
+     */
+    FileRef(IOStream* stream,
+            bool readAudioProperties,
+            AudioProperties::ReadStyle audioPropertiesStyle,
+            File::PictureReading pictureReading);
+
     /*!
      * Construct a FileRef using \a file.  The FileRef now takes ownership of the
      * pointer and will delete the File when it passes out of scope.
@@ -201,6 +395,15 @@ namespace TagLib {
      */
     bool save();
 
+    /*!
+     * Saves the file using \a mode, e.g. File::Atomic to write a new copy of
+     * the file and rename it over the original.  The save mode of the file is
+     * restored afterwards.  Returns true on success.
+     *
+     * \see File::setSaveMode()
+     */
+    bool save(File::SaveMode mode);
+
     /*!
      * Adds a FileTypeResolver to the list of those used by TagLib.  Each
      * additional FileTypeResolver is added to the front of a list of resolvers
@@ -215,6 +418,18 @@ namespace TagLib {
      */
     static const FileTypeResolver *addFileTypeResolver(const FileTypeResolver *resolver);
 
+    /*!
+     * Removes \a resolver from the list of resolvers that are tried.  Does
+     * nothing if it was never added.
+     *
+     * Resolvers may be added and removed while other threads are opening
+     * files, but a removed resolver must not be destroyed while such a thread
+     * may still be calling it.
+     *
+     * \see addFileTypeResolver()
+     */
+    static void removeFileTypeResolver(const FileTypeResolver *resolver);
+
     /*!
      * As is mentioned elsewhere in this class's documentation, the default file
      * type resolution code provided by TagLib only works by comparing file
@@ -233,6 +448,39 @@ namespace TagLib {
      */
     static StringList defaultFileExtensions();
 
+    /*!
+     * Reads the tags and, if \a readAudioProperties is true, the audio
+     * properties of all the files in \a fileNames, and returns them in the
+     * same order.  Files that can not be read give null Metadata.
+     *
+     * The files are read by up to \a threads threads at once, one file per
+     * thread, so that no more than \a threads files are open at a time.  If
+     * \a threads is 0, the number of processors is used.  The files are opened
+     * like FileRef(fileName, readAudioProperties, audioPropertiesStyle,
+     * CachedStream, File::SkipPictures) would, so file type resolvers are used
+     * as well.  The embedded pictures are not read, since Metadata does not
+     * include them.
+     *
+     * This function is thread safe, but file type resolvers must not be
+     * added while it runs, and the resolvers themselves must be thread safe.
+     */
+    static MetadataList readBatch(const List<FileName> &fileNames,
+                                  bool readAudioProperties = true,
+                                  AudioProperties::ReadStyle
+                                  audioPropertiesStyle = AudioProperties::Average,
+                                  unsigned int threads = 0);
+
+    /*!
+     * Reads the tags and audio properties from all the \a streams, like the
+     * function above.  The streams must all be different, and stay open until
+     * this function returns.  They are not deleted.
+     */
+    static MetadataList readBatch(const List<IOStream *> &streams,
+                                  bool readAudioProperties = true,
+                                  AudioProperties::ReadStyle
+                                  audioPropertiesStyle = AudioProperties::Average,
+                                  unsigned int threads = 0);
+
     /*!
      * Returns true if the file (and as such other pointers) are null.
      */
@@ -275,8 +523,10 @@ namespace TagLib {
                         AudioProperties::ReadStyle audioPropertiesStyle = AudioProperties::Average);
 
   private:
-    void parse(FileName fileName, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle);
-    void parse(IOStream *stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle);
+    void parse(FileName fileName, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle,
+               StreamType streamType, File::PictureReading pictureReading);
+    void parse(IOStream *stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle,
+               File::PictureReading pictureReading);
 
     class FileRefPrivate;
     FileRefPrivate *d;
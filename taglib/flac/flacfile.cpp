@@ -51,10 +51,15 @@ namespace
 
   enum { FlacXiphIndex = 0, FlacID3v2Index = 1, FlacID3v1Index = 2 };
 
-  const long MinPaddingLength = 4096;
-  const long MaxPaddingLegnth = 1024 * 1024;
+  const unsigned int MinPaddingLength = 4096;
+  const unsigned int MaxPaddingLength = 1024 * 1024;
 
   const char LastBlockFlag = '\x80';
+
+  // With File::SkipPictures, only this much of a picture block is read, which
+  // is normally enough to reach the image data.
+
+  const unsigned int PictureFieldsSize = 1024;
 }
 
 class FLAC::File::FilePrivate
@@ -104,7 +109,7 @@ bool FLAC::File::isSupported(IOStream *stream)
   // A FLAC file has an ID "fLaC" somewhere. An ID3v2 tag may precede.
 
   const ByteVector buffer = Utils::readHeader(stream, bufferSize(), true);
-  return (buffer.find("fLaC") >= 0);
+  return (Utils::findFLACSignature(buffer) >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -128,6 +133,18 @@ FLAC::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
     read(readProperties);
 }
 
+FLAC::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
+                 bool readProperties, Properties::ReadStyle,
+                 PictureReading pictureReading) :
+  TagLib::File(file),
+  d(new FilePrivate(frameFactory))
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties);
+}
+
 FLAC::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
                  bool readProperties, Properties::ReadStyle) :
   TagLib::File(stream),
@@ -137,6 +154,18 @@ FLAC::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
     read(readProperties);
 }
 
+FLAC::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
+                 bool readProperties, Properties::ReadStyle,
+                 PictureReading pictureReading) :
+  TagLib::File(stream),
+  d(new FilePrivate(frameFactory))
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties);
+}
+
 FLAC::File::~File()
 {
   delete d;
@@ -179,6 +208,8 @@ bool FLAC::File::save()
     return false;
   }
 
+  SaveScope scope(this);
+
   // Create new vorbis comments
   if(!hasXiphComment())
     Tag::duplicate(&d->tag, xiphComment(true), false);
@@ -211,22 +242,11 @@ bool FLAC::File::save()
 
   // Compute the amount of padding, and append that to data.
 
-  long originalLength = d->streamStart - d->flacStart;
-  long paddingLength = originalLength - data.size() - 4;
-
-  if(paddingLength <= 0) {
-    paddingLength = MinPaddingLength;
-  }
-  else {
-    // Padding won't increase beyond 1% of the file size or 1MB.
-
-    long threshold = length() / 100;
-    threshold = std::max(threshold, MinPaddingLength);
-    threshold = std::min(threshold, MaxPaddingLegnth);
-
-    if(paddingLength > threshold)
-      paddingLength = MinPaddingLength;
-  }
+  const long originalLength = d->streamStart - d->flacStart;
+  const long minimumLength = minimumPadding(MinPaddingLength);
+  const long paddingLength = Utils::paddingSize(
+    originalLength - 4, data.size(), minimumLength,
+    Utils::paddingThreshold(length(), minimumLength, maximumPadding(MaxPaddingLength)));
 
   ByteVector paddingHeader = ByteVector::fromUInt(paddingLength);
   paddingHeader[0] = static_cast<char>(MetadataBlock::Padding | LastBlockFlag);
@@ -251,7 +271,10 @@ bool FLAC::File::save()
     if(d->ID3v2Location < 0)
       d->ID3v2Location = 0;
 
-    data = ID3v2Tag()->render();
+    ID3v2::Tag *tag = ID3v2Tag();
+    tag->setPadding(minimumPadding(tag->minimumPadding()), maximumPadding(tag->maximumPadding()));
+
+    data = tag->render();
     insert(data, d->ID3v2Location, d->ID3v2OriginalSize);
 
     d->flacStart   += (static_cast<long>(data.size()) - d->ID3v2OriginalSize);
@@ -304,7 +327,7 @@ bool FLAC::File::save()
     }
   }
 
-  return true;
+  return scope.finish();
 }
 
 ID3v2::Tag *FLAC::File::ID3v2Tag(bool create)
@@ -438,7 +461,7 @@ void FLAC::File::read(bool readProperties)
     return;
 
   if(!d->xiphCommentData.isEmpty())
-    d->tag.set(FlacXiphIndex, new Ogg::XiphComment(d->xiphCommentData));
+    d->tag.set(FlacXiphIndex, new Ogg::XiphComment(d->xiphCommentData, pictureReading()));
   else
     d->tag.set(FlacXiphIndex, new Ogg::XiphComment());
 
@@ -489,6 +512,11 @@ void FLAC::File::scan()
 
     seek(nextBlockOffset);
     const ByteVector header = readBlock(4);
+    if(header.size() != 4) {
+      debug("FLAC::File::scan() -- Failed to read a metadata block header");
+      setValid(false);
+      return;
+    }
 
     // Header format (from spec):
     // <1> Last-metadata-block flag
@@ -522,8 +550,16 @@ void FLAC::File::scan()
       return;
     }
 
-    const ByteVector data = readBlock(blockLength);
-    if(data.size() != blockLength) {
+    // With SkipPictures, only the start of a large picture block is read, and
+    // the image data is left in the file.
+
+    const bool skipPicture = blockType == MetadataBlock::Picture
+      && pictureReading() == SkipPictures && blockLength > PictureFieldsSize;
+
+    const unsigned int readLength = skipPicture ? PictureFieldsSize : blockLength;
+
+    ByteVector data = readBlock(readLength);
+    if(data.size() != readLength) {
       debug("FLAC::File::scan() -- Failed to read a metadata block");
       setValid(false);
       return;
@@ -543,7 +579,21 @@ void FLAC::File::scan()
     }
     else if(blockType == MetadataBlock::Picture) {
       FLAC::Picture *picture = new FLAC::Picture();
-      if(picture->parse(data)) {
+      bool parsed = false;
+
+      if(skipPicture) {
+        parsed = picture->parse(data, this, nextBlockOffset + 4, blockLength);
+
+        // The fields before the image data may be longer than what was read.
+
+        if(!parsed)
+          data.append(readBlock(blockLength - readLength));
+      }
+
+      if(!parsed && data.size() == blockLength)
+        parsed = picture->parse(data);
+
+      if(parsed) {
         block = picture;
       }
       else {
@@ -109,6 +109,18 @@ namespace TagLib {
            bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs a FLAC file from \a file.  This is the same as the
+       * constructor above, except that \a pictureReading sets whether the
+       * embedded pictures are read.
+       *
+       * \see TagLib::File::pictureReading()
+       */
+      File(FileName file, ID3v2::FrameFactory *frameFactory,
+           bool readProperties,
+           Properties::ReadStyle propertiesStyle,
+           PictureReading pictureReading);
+
       /*!
        * Constructs a FLAC file from \a stream.  If \a readProperties is true the
        * file's audio properties will also be read.
@@ -126,6 +138,18 @@ namespace TagLib {
            bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs a FLAC file from \a stream.  This is the same as the
+       * constructor above, except that \a pictureReading sets whether the
+       * embedded pictures are read.
+       *
+       * \see TagLib::File::pictureReading()
+       */
+      File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
+           bool readProperties,
+           Properties::ReadStyle propertiesStyle,
+           PictureReading pictureReading);
+
       /*!
        * Destroys this instance of the File.
        */
@@ -47,7 +47,7 @@ public:
   int height;
   int colorDepth;
   int numColors;
-  ByteVector data;
+  Payload data;
 };
 
 FLAC::Picture::Picture() :
@@ -72,6 +72,12 @@ int FLAC::Picture::code() const
 }
 
 bool FLAC::Picture::parse(const ByteVector &data)
+{
+  return parse(data, 0, 0, data.size());
+}
+
+bool FLAC::Picture::parse(const ByteVector &data, TagLib::File *file, long offset,
+                          unsigned int size)
 {
   if(data.size() < 32) {
     debug("A picture block must contain at least 5 bytes.");
@@ -107,11 +113,14 @@ bool FLAC::Picture::parse(const ByteVector &data)
   pos += 4;
   unsigned int dataLength = data.toUInt(pos);
   pos += 4;
-  if(pos + dataLength > data.size()) {
+  if(pos + dataLength > size) {
     debug("Invalid picture block.");
     return false;
   }
-  d->data = data.mid(pos, dataLength);
+  if(file)
+    d->data = Payload(file, offset + pos, dataLength, d->mimeType);
+  else
+    d->data = Payload(data.mid(pos, dataLength), d->mimeType);
 
   return true;
 }
@@ -130,8 +139,9 @@ ByteVector FLAC::Picture::render() const
   result.append(ByteVector::fromUInt(d->height));
   result.append(ByteVector::fromUInt(d->colorDepth));
   result.append(ByteVector::fromUInt(d->numColors));
-  result.append(ByteVector::fromUInt(d->data.size()));
-  result.append(d->data);
+  const ByteVector data = d->data.data();
+  result.append(ByteVector::fromUInt(data.size()));
+  result.append(data);
   return result;
 }
 
@@ -153,6 +163,7 @@ String FLAC::Picture::mimeType() const
 void FLAC::Picture::setMimeType(const String &mimeType)
 {
   d->mimeType = mimeType;
+  d->data.setMimeType(mimeType);
 }
 
 String FLAC::Picture::description() const
@@ -206,12 +217,27 @@ void FLAC::Picture::setNumColors(int numColors)
 }
 
 ByteVector FLAC::Picture::data() const
+{
+  return d->data.data();
+}
+
+Payload FLAC::Picture::payload() const
 {
   return d->data;
 }
 
 void FLAC::Picture::setData(const ByteVector &data)
 {
-  d->data = data;
+  d->data = Payload(data, d->mimeType);
+}
+
+void FLAC::Picture::setPayload(const Payload &payload)
+{
+  d->data = payload;
+
+  if(payload.mimeType().isEmpty())
+    d->data.setMimeType(d->mimeType);
+  else
+    d->mimeType = payload.mimeType();
 }
 
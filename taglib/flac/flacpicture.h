@@ -29,11 +29,14 @@
 #include "tlist.h"
 #include "tstring.h"
 #include "tbytevector.h"
+#include "tpayload.h"
 #include "taglib_export.h"
 #include "flacmetadatablock.h"
 
 namespace TagLib {
 
+  class File;
+
   namespace FLAC {
 
     class TAGLIB_EXPORT Picture : public MetadataBlock
@@ -168,14 +171,38 @@ namespace TagLib {
 
       /*!
        * Returns the image data.
+       *
+       * \note If the file was opened with File::SkipPictures, the data is read
+       * from the file each time this is called.
+       *
+       * \see payload()
        */
       ByteVector data() const;
 
+      /*!
+       * Returns the image data as a Payload, which tells its size and where it
+       * is without reading it if the file was opened with File::SkipPictures.
+       * The MIME type of the payload is the same as mimeType().
+       *
+       * \see data()
+       * \see PayloadStream
+       */
+      Payload payload() const;
+
       /*!
        * Sets the image data.
        */
       void setData(const ByteVector &data);
 
+      /*!
+       * Sets the image data to \a payload.  If the payload has a MIME type,
+       * it replaces the MIME type of this picture.  A payload that refers to a
+       * stream is not read until the picture is rendered.
+       *
+       * \see payload()
+       */
+      void setPayload(const Payload &payload);
+
       /*!
        * Returns the FLAC metadata block type.
        */
@@ -192,9 +219,19 @@ namespace TagLib {
       bool parse(const ByteVector &rawData);
 
     private:
+      friend class File;
+
       Picture(const Picture &item);
       Picture &operator=(const Picture &item);
 
+      /*!
+       * Parses the picture block of \a size bytes that \a rawData starts
+       * with.  If \a file is not null, \a rawData only needs to reach the
+       * image data, which is left at \a offset + its position in \a file.
+       */
+      bool parse(const ByteVector &rawData, TagLib::File *file, long offset,
+                 unsigned int size);
+
       class PicturePrivate;
       PicturePrivate *d;
     };
@@ -95,6 +95,9 @@ bool IT::File::save()
     debug("IT::File::save() - Cannot save to a read only file.");
     return false;
   }
+
+  SaveScope scope(this);
+
   seek(4);
   writeString(d->tag.title(), 25);
   writeByte(0);
@@ -196,7 +199,7 @@ bool IT::File::save()
     seek(messageOffset);
     writeBlock(message);
   }
-  return true;
+  return scope.finish();
 }
 
 void IT::File::read(bool)
@@ -94,6 +94,9 @@ bool Mod::File::save()
     debug("Mod::File::save() - Cannot save to a read only file.");
     return false;
   }
+
+  SaveScope scope(this);
+
   seek(0);
   writeString(d->tag.title(), 20);
   StringList lines = d->tag.comment().split("\n");
@@ -107,7 +110,7 @@ bool Mod::File::save()
     writeString(String(), 22);
     seek(8, Current);
   }
-  return true;
+  return scope.finish();
 }
 
 void Mod::File::read(bool)
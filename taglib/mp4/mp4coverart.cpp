@@ -30,6 +30,25 @@
 
 using namespace TagLib;
 
+namespace
+{
+  String mimeTypeOf(MP4::CoverArt::Format format)
+  {
+    switch(format) {
+    case MP4::CoverArt::JPEG:
+      return "image/jpeg";
+    case MP4::CoverArt::PNG:
+      return "image/png";
+    case MP4::CoverArt::BMP:
+      return "image/bmp";
+    case MP4::CoverArt::GIF:
+      return "image/gif";
+    default:
+      return String();
+    }
+  }
+}
+
 class MP4::CoverArt::CoverArtPrivate : public RefCounter
 {
 public:
@@ -38,7 +57,7 @@ public:
     format(MP4::CoverArt::JPEG) {}
 
   Format format;
-  ByteVector data;
+  Payload data;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -47,9 +66,19 @@ public:
 
 MP4::CoverArt::CoverArt(Format format, const ByteVector &data) :
   d(new CoverArtPrivate())
+{
+  d->format = format;
+  d->data = Payload(data, mimeTypeOf(format));
+}
+
+MP4::CoverArt::CoverArt(Format format, const Payload &data) :
+  d(new CoverArtPrivate())
 {
   d->format = format;
   d->data = data;
+
+  if(data.mimeType().isEmpty())
+    d->data.setMimeType(mimeTypeOf(format));
 }
 
 MP4::CoverArt::CoverArt(const CoverArt &item) :
@@ -88,6 +117,12 @@ MP4::CoverArt::format() const
 
 ByteVector
 MP4::CoverArt::data() const
+{
+  return d->data.data();
+}
+
+Payload
+MP4::CoverArt::payload() const
 {
   return d->data;
 }
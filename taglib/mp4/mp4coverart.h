@@ -28,6 +28,7 @@
 
 #include "tlist.h"
 #include "tbytevector.h"
+#include "tpayload.h"
 #include "taglib_export.h"
 #include "mp4atom.h"
 
@@ -50,6 +51,14 @@ namespace TagLib {
       };
 
       CoverArt(Format format, const ByteVector &data);
+
+      /*!
+       * Constructs a cover art item whose image data is \a data, which may
+       * still be in a file or stream.  If the payload has no MIME type, it is
+       * given the one that matches \a format.
+       */
+      CoverArt(Format format, const Payload &data);
+
       ~CoverArt();
 
       CoverArt(const CoverArt &item);
@@ -67,9 +76,22 @@ namespace TagLib {
       //! Format of the image
       Format format() const;
 
-      //! The image data
+      /*!
+       * Returns the image data.  If the file was opened with
+       * File::SkipPictures, the data is read from the file each time this is
+       * called.
+       */
       ByteVector data() const;
 
+      /*!
+       * Returns the image data as a Payload, which tells its size and where it
+       * is without reading it if the file was opened with File::SkipPictures.
+       * The MIME type of the payload is the one that matches format().
+       *
+       * \see PayloadStream
+       */
+      Payload payload() const;
+
     private:
       class CoverArtPrivate;
       CoverArtPrivate *d;
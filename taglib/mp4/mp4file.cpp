@@ -80,7 +80,7 @@ bool MP4::File::isSupported(IOStream *stream)
   // An MP4 file has to have an "ftyp" box first.
 
   const ByteVector id = Utils::readHeader(stream, 8, false);
-  return id.containsAt("ftyp", 4);
+  return (Utils::findMP4Signature(id) == 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -95,6 +95,17 @@ MP4::File::File(FileName file, bool readProperties, AudioProperties::ReadStyle)
     read(readProperties);
 }
 
+MP4::File::File(FileName file, bool readProperties, AudioProperties::ReadStyle,
+                PictureReading pictureReading) :
+  TagLib::File(file),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties);
+}
+
 MP4::File::File(IOStream *stream, bool readProperties, AudioProperties::ReadStyle) :
   TagLib::File(stream),
   d(new FilePrivate())
@@ -103,6 +114,17 @@ MP4::File::File(IOStream *stream, bool readProperties, AudioProperties::ReadStyl
     read(readProperties);
 }
 
+MP4::File::File(IOStream *stream, bool readProperties, AudioProperties::ReadStyle,
+                PictureReading pictureReading) :
+  TagLib::File(stream),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties);
+}
+
 MP4::File::~File()
 {
   delete d;
@@ -172,7 +194,9 @@ MP4::File::save()
     return false;
   }
 
-  return d->tag->save();
+  SaveScope scope(this);
+
+  return d->tag->save() && scope.finish();
 }
 
 bool
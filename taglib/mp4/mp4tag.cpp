@@ -23,6 +23,9 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+#include <climits>
+
 #include <tdebug.h>
 #include <tstring.h>
 #include <tpropertymap.h>
@@ -32,6 +35,14 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // With File::SkipPictures, the pictures up to this size are still read, as
+  // the other formats read this much of the fields of their pictures anyway.
+
+  const unsigned int SmallPictureSize = 1024;
+}
+
 class MP4::Tag::TagPrivate
 {
 public:
@@ -283,26 +294,67 @@ MP4::Tag::parseFreeForm(const MP4::Atom *atom)
 void
 MP4::Tag::parseCovr(const MP4::Atom *atom)
 {
+  // With SkipPictures, only the headers of the 'data' atoms are read, and the
+  // images larger than SmallPictureSize are left in the file.
+
+  const bool skipPictures = d->file->pictureReading() == TagLib::File::SkipPictures;
+  const long offset = atom->offset + 8;
+
   MP4::CoverArtList value;
-  ByteVector data = d->file->readBlock(atom->length - 8);
+  ByteVector data;
+  unsigned int size;
+  if(skipPictures) {
+    // As with a single read, an atom that the file ends within is cut short.
+    size = static_cast<unsigned int>(
+      std::max<long>(std::min<long>(atom->length - 8, d->file->length() - offset), 0));
+  }
+  else {
+    data = d->file->readBlock(atom->length - 8);
+    size = data.size();
+  }
   unsigned int pos = 0;
-  while(pos < data.size()) {
-    const int length = static_cast<int>(data.toUInt(pos));
+  while(pos < size) {
+    ByteVector header;
+    if(skipPictures) {
+      d->file->seek(offset + pos);
+      header = d->file->readBlock(16);
+    }
+    else {
+      header = data.mid(pos, 16);
+    }
+    const int length = static_cast<int>(header.toUInt(0U));
     if(length < 12) {
       debug("MP4: Too short atom");
       break;;
     }
 
-    const ByteVector name = data.mid(pos + 4, 4);
-    const int flags = static_cast<int>(data.toUInt(pos + 8));
+    const ByteVector name = header.mid(4, 4);
+    const int flags = static_cast<int>(header.toUInt(8U));
     if(name != "data") {
       debug("MP4: Unexpected atom \"" + name + "\", expecting \"data\"");
       break;
     }
     if(flags == TypeJPEG || flags == TypePNG || flags == TypeBMP ||
        flags == TypeGIF || flags == TypeImplicit) {
-      value.append(MP4::CoverArt(MP4::CoverArt::Format(flags),
-                                 data.mid(pos + 16, length - 16)));
+      if(skipPictures) {
+        // The image ends with the 'data' atom, or with the 'covr' atom if that
+        // ends before.
+        const unsigned int atomLength = std::min<unsigned int>(length, size - pos);
+        const unsigned int imageSize = atomLength > 16 ? atomLength - 16 : 0;
+        if(imageSize > SmallPictureSize) {
+          value.append(MP4::CoverArt(MP4::CoverArt::Format(flags),
+                                     Payload(d->file, offset + pos + 16, imageSize)));
+        }
+        else {
+          d->file->seek(offset + pos + 16);
+          value.append(MP4::CoverArt(MP4::CoverArt::Format(flags),
+                                     d->file->readBlock(imageSize)));
+        }
+      }
+      else {
+        value.append(MP4::CoverArt(MP4::CoverArt::Format(flags),
+                                   data.mid(pos + 16, length - 16)));
+      }
     }
     else {
       debug("MP4: Unknown covr format " + String::number(flags));
@@ -317,7 +369,15 @@ ByteVector
 MP4::Tag::padIlst(const ByteVector &data, int length) const
 {
   if(length == -1) {
-    length = ((data.size() + 1023) & ~1023) - data.size();
+    // Unless the file sets a padding size, round 'ilst' up to a multiple of
+    // 1024 bytes.  The padding size includes the 'free' atom's header.
+
+    const unsigned int alignedSize = ((data.size() + 1023) & ~1023) - data.size() + 8;
+    const unsigned int paddingSize = d->file->minimumPadding(alignedSize);
+    if(paddingSize < 8)
+      return ByteVector();
+
+    length = paddingSize - 8;
   }
   return renderAtom("free", ByteVector(length, '\1'));
 }
@@ -669,8 +729,12 @@ MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
     }
   }
 
+  // The space left over is kept as a 'free' atom unless it's too small to
+  // hold one or larger than the maximum padding.
+
   long delta = data.size() - length;
-  if(delta > 0 || (delta < 0 && delta > -8)) {
+  const unsigned long maximumPadding = d->file->maximumPadding(UINT_MAX);
+  if(delta > 0 || (delta < 0 && (delta > -8 || static_cast<unsigned long>(-delta) > maximumPadding))) {
     data.append(padIlst(data));
     delta = data.size() - length;
   }
@@ -887,6 +951,16 @@ namespace
 
     return String();
   }
+
+  String reverseTranslateKey(const String &key)
+  {
+    for(size_t i = 0; i < keyTranslationSize; ++i) {
+      if(key == keyTranslation[i][1])
+        return keyTranslation[i][0];
+    }
+
+    return String();
+  }
 }
 
 PropertyMap MP4::Tag::properties() const
@@ -928,25 +1002,17 @@ void MP4::Tag::removeUnsupportedProperties(const StringList &props)
 
 PropertyMap MP4::Tag::setProperties(const PropertyMap &props)
 {
-  static Map<String, String> reverseKeyMap;
-  if(reverseKeyMap.isEmpty()) {
-    int numKeys = sizeof(keyTranslation) / sizeof(keyTranslation[0]);
-    for(int i = 0; i < numKeys; i++) {
-      reverseKeyMap[keyTranslation[i][1]] = keyTranslation[i][0];
-    }
-  }
-
   PropertyMap origProps = properties();
   for(PropertyMap::ConstIterator it = origProps.begin(); it != origProps.end(); ++it) {
     if(!props.contains(it->first) || props[it->first].isEmpty()) {
-      d->items.erase(reverseKeyMap[it->first]);
+      d->items.erase(reverseTranslateKey(it->first));
     }
   }
 
   PropertyMap ignoredProps;
   for(PropertyMap::ConstIterator it = props.begin(); it != props.end(); ++it) {
-    if(reverseKeyMap.contains(it->first)) {
-      String name = reverseKeyMap[it->first];
+    const String name = reverseTranslateKey(it->first);
+    if(!name.isEmpty()) {
       if((it->first == "TRACKNUMBER" || it->first == "DISCNUMBER") && !it->second.isEmpty()) {
         StringList parts = StringList::split(it->second.front(), "/");
         if(!parts.isEmpty()) {
@@ -85,7 +85,7 @@ bool MPC::File::isSupported(IOStream *stream)
   // have keys to do a quick check.
 
   const ByteVector id = Utils::readHeader(stream, 4, false);
-  return (id == "MPCK" || id.startsWith("MP+"));
+  return (Utils::findMPCSignature(id) == 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -148,6 +148,8 @@ bool MPC::File::save()
     return false;
   }
 
+  SaveScope scope(this);
+
   // Possibly strip ID3v2 tag
 
   if(!d->ID3v2Header && d->ID3v2Location >= 0) {
@@ -225,7 +227,7 @@ bool MPC::File::save()
     }
   }
 
-  return true;
+  return scope.finish();
 }
 
 ID3v1::Tag *MPC::File::ID3v1Tag(bool create)
@@ -25,6 +25,7 @@
 
 #include <tdebug.h>
 #include <tfile.h>
+#include <tthread.h>
 
 #include "id3v1tag.h"
 #include "id3v1genres.h"
@@ -35,7 +36,10 @@ using namespace ID3v1;
 namespace
 {
   const ID3v1::StringHandler defaultStringHandler;
-  const ID3v1::StringHandler *stringHandler = &defaultStringHandler;
+
+  Thread::SharedHandler<ID3v1::StringHandler> stringHandler = {
+    const_cast<ID3v1::StringHandler *>(&defaultStringHandler), &defaultStringHandler
+  };
 }
 
 class ID3v1::Tag::TagPrivate
@@ -107,14 +111,16 @@ ID3v1::Tag::~Tag()
 
 ByteVector ID3v1::Tag::render() const
 {
+  const StringHandler *handler = stringHandler.get();
+
   ByteVector data;
 
   data.append(fileIdentifier());
-  data.append(stringHandler->render(d->title).resize(30));
-  data.append(stringHandler->render(d->artist).resize(30));
-  data.append(stringHandler->render(d->album).resize(30));
-  data.append(stringHandler->render(d->year).resize(4));
-  data.append(stringHandler->render(d->comment).resize(28));
+  data.append(handler->render(d->title).resize(30));
+  data.append(handler->render(d->artist).resize(30));
+  data.append(handler->render(d->album).resize(30));
+  data.append(handler->render(d->year).resize(4));
+  data.append(handler->render(d->comment).resize(28));
   data.append(char(0));
   data.append(char(d->track));
   data.append(char(d->genre));
@@ -209,10 +215,7 @@ void ID3v1::Tag::setGenreNumber(unsigned int i)
 
 void ID3v1::Tag::setStringHandler(const StringHandler *handler)
 {
-  if(handler)
-    stringHandler = handler;
-  else
-    stringHandler = &defaultStringHandler;
+  stringHandler.set(handler);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -236,18 +239,20 @@ void ID3v1::Tag::read()
 
 void ID3v1::Tag::parse(const ByteVector &data)
 {
+  const StringHandler *handler = stringHandler.get();
+
   int offset = 3;
 
-  d->title = stringHandler->parse(data.mid(offset, 30));
+  d->title = handler->parse(data.mid(offset, 30));
   offset += 30;
 
-  d->artist = stringHandler->parse(data.mid(offset, 30));
+  d->artist = handler->parse(data.mid(offset, 30));
   offset += 30;
 
-  d->album = stringHandler->parse(data.mid(offset, 30));
+  d->album = handler->parse(data.mid(offset, 30));
   offset += 30;
 
-  d->year = stringHandler->parse(data.mid(offset, 4));
+  d->year = handler->parse(data.mid(offset, 4));
   offset += 4;
 
   // Check for ID3v1.1 -- Note that ID3v1 *does not* support "track zero" -- this
@@ -258,7 +263,7 @@ void ID3v1::Tag::parse(const ByteVector &data)
   if(data[offset + 28] == 0 && data[offset + 29] != 0) {
     // ID3v1.1 detected
 
-    d->comment = stringHandler->parse(data.mid(offset, 28));
+    d->comment = handler->parse(data.mid(offset, 28));
     d->track   = static_cast<unsigned char>(data[offset + 29]);
   }
   else
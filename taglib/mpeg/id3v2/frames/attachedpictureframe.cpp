@@ -41,7 +41,7 @@ public:
   String mimeType;
   AttachedPictureFrame::Type type;
   String description;
-  ByteVector data;
+  Payload data;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,6 +90,7 @@ String AttachedPictureFrame::mimeType() const
 void AttachedPictureFrame::setMimeType(const String &m)
 {
   d->mimeType = m;
+  d->data.setMimeType(m);
 }
 
 AttachedPictureFrame::Type AttachedPictureFrame::type() const
@@ -113,13 +114,28 @@ void AttachedPictureFrame::setDescription(const String &desc)
 }
 
 ByteVector AttachedPictureFrame::picture() const
+{
+  return d->data.data();
+}
+
+Payload AttachedPictureFrame::payload() const
 {
   return d->data;
 }
 
 void AttachedPictureFrame::setPicture(const ByteVector &p)
 {
-  d->data = p;
+  d->data = Payload(p, d->mimeType);
+}
+
+void AttachedPictureFrame::setPayload(const Payload &payload)
+{
+  d->data = payload;
+
+  if(payload.mimeType().isEmpty())
+    d->data.setMimeType(d->mimeType);
+  else
+    d->mimeType = payload.mimeType();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -147,7 +163,7 @@ void AttachedPictureFrame::parseFields(const ByteVector &data)
   d->type = (TagLib::ID3v2::AttachedPictureFrame::Type)data[pos++];
   d->description = readStringField(data, d->textEncoding, &pos);
 
-  d->data = data.mid(pos);
+  d->data = Payload(data.mid(pos), d->mimeType);
 }
 
 ByteVector AttachedPictureFrame::renderFields() const
@@ -162,7 +178,7 @@ ByteVector AttachedPictureFrame::renderFields() const
   data.append(char(d->type));
   data.append(d->description.data(encoding));
   data.append(textDelimiter(encoding));
-  data.append(d->data);
+  data.append(d->data.data());
 
   return data;
 }
@@ -208,7 +224,7 @@ void AttachedPictureFrameV22::parseFields(const ByteVector &data)
   d->type = (TagLib::ID3v2::AttachedPictureFrame::Type)data[pos++];
   d->description = readStringField(data, d->textEncoding, &pos);
 
-  d->data = data.mid(pos);
+  d->data = Payload(data.mid(pos), d->mimeType);
 }
 
 AttachedPictureFrameV22::AttachedPictureFrameV22(const ByteVector &data, Header *h)
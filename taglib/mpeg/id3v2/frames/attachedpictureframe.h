@@ -28,6 +28,7 @@
 
 #include "id3v2frame.h"
 #include "id3v2header.h"
+#include "tpayload.h"
 #include "taglib_export.h"
 
 namespace TagLib {
@@ -187,11 +188,35 @@ namespace TagLib {
        * \note ByteVector has a data() method that returns a const char * which
        * should make it easy to export this data to external programs.
        *
+       * \note If the file was opened with File::SkipPictures, the data is read
+       * from the file each time this is called.
+       *
        * \see setPicture()
        * \see mimeType()
+       * \see payload()
        */
       ByteVector picture() const;
 
+      /*!
+       * Returns the image data as a Payload, which tells its size and where it
+       * is without reading it if the file was opened with File::SkipPictures.
+       * The MIME type of the payload is the same as mimeType().
+       *
+       * \see picture()
+       * \see PayloadStream
+       */
+      Payload payload() const;
+
+      /*!
+       * Sets the image data to \a payload.  If the payload has a MIME type,
+       * it replaces the MIME type of this frame.  A payload that refers to a
+       * stream is not read until the frame is rendered.
+       *
+       * \see payload()
+       * \see setPicture()
+       */
+      void setPayload(const Payload &payload);
+
       /*!
        * Sets the image data to \a p.  \a p should be of the type specified in
        * this frame's mime-type specification.
@@ -43,7 +43,7 @@ public:
   String mimeType;
   String fileName;
   String description;
-  ByteVector data;
+  Payload data;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -99,6 +99,7 @@ String GeneralEncapsulatedObjectFrame::mimeType() const
 void GeneralEncapsulatedObjectFrame::setMimeType(const String &type)
 {
   d->mimeType = type;
+  d->data.setMimeType(type);
 }
 
 String GeneralEncapsulatedObjectFrame::fileName() const
@@ -122,13 +123,28 @@ void GeneralEncapsulatedObjectFrame::setDescription(const String &desc)
 }
 
 ByteVector GeneralEncapsulatedObjectFrame::object() const
+{
+  return d->data.data();
+}
+
+Payload GeneralEncapsulatedObjectFrame::payload() const
 {
   return d->data;
 }
 
 void GeneralEncapsulatedObjectFrame::setObject(const ByteVector &data)
 {
-  d->data = data;
+  d->data = Payload(data, d->mimeType);
+}
+
+void GeneralEncapsulatedObjectFrame::setPayload(const Payload &payload)
+{
+  d->data = payload;
+
+  if(payload.mimeType().isEmpty())
+    d->data.setMimeType(d->mimeType);
+  else
+    d->mimeType = payload.mimeType();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -150,7 +166,7 @@ void GeneralEncapsulatedObjectFrame::parseFields(const ByteVector &data)
   d->fileName = readStringField(data, d->textEncoding, &pos);
   d->description = readStringField(data, d->textEncoding, &pos);
 
-  d->data = data.mid(pos);
+  d->data = Payload(data.mid(pos), d->mimeType);
 }
 
 ByteVector GeneralEncapsulatedObjectFrame::renderFields() const
@@ -170,7 +186,7 @@ ByteVector GeneralEncapsulatedObjectFrame::renderFields() const
   data.append(textDelimiter(encoding));
   data.append(d->description.data(encoding));
   data.append(textDelimiter(encoding));
-  data.append(d->data);
+  data.append(d->data.data());
 
   return data;
 }
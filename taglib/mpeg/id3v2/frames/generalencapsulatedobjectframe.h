@@ -31,6 +31,7 @@
 
 #include "id3v2frame.h"
 #include "id3v2header.h"
+#include "tpayload.h"
 #include "taglib_export.h"
 
 namespace TagLib {
@@ -151,6 +152,15 @@ namespace TagLib {
        */
       ByteVector object() const;
 
+      /*!
+       * Returns the object data as a Payload.  The MIME type of the payload is
+       * the same as mimeType().
+       *
+       * \see object()
+       * \see PayloadStream
+       */
+      Payload payload() const;
+
       /*!
        * Sets the object data to \a data.  \a data should be of the type specified in
        * this frame's mime-type specification.
@@ -161,6 +171,16 @@ namespace TagLib {
        */
       void setObject(const ByteVector &object);
 
+      /*!
+       * Sets the object data to \a payload.  If the payload has a MIME type,
+       * it replaces the MIME type of this frame.  A payload that refers to a
+       * stream is not read until the frame is rendered.
+       *
+       * \see payload()
+       * \see setObject()
+       */
+      void setPayload(const Payload &payload);
+
     protected:
       virtual void parseFields(const ByteVector &data);
       virtual ByteVector renderFields() const;
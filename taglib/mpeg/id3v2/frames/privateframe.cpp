@@ -37,7 +37,7 @@ using namespace ID3v2;
 class PrivateFrame::PrivateFramePrivate
 {
 public:
-  ByteVector data;
+  Payload data;
   String owner;
 };
 
@@ -74,6 +74,11 @@ String PrivateFrame::owner() const
 }
 
 ByteVector PrivateFrame::data() const
+{
+  return d->data.data();
+}
+
+Payload PrivateFrame::payload() const
 {
   return d->data;
 }
@@ -85,7 +90,12 @@ void PrivateFrame::setOwner(const String &s)
 
 void PrivateFrame::setData(const ByteVector & data)
 {
-  d->data = data;
+  d->data = Payload(data);
+}
+
+void PrivateFrame::setPayload(const Payload &payload)
+{
+  d->data = payload;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -105,7 +115,7 @@ void PrivateFrame::parseFields(const ByteVector &data)
   const int endOfOwner = data.find(textDelimiter(String::Latin1), 0, byteAlign);
 
   d->owner =  String(data.mid(0, endOfOwner));
-  d->data = data.mid(endOfOwner + 1);
+  d->data = Payload(data.mid(endOfOwner + 1));
 }
 
 ByteVector PrivateFrame::renderFields() const
@@ -114,7 +124,7 @@ ByteVector PrivateFrame::renderFields() const
 
   v.append(d->owner.data(String::Latin1));
   v.append(textDelimiter(String::Latin1));
-  v.append(d->data);
+  v.append(d->data.data());
 
   return v;
 }
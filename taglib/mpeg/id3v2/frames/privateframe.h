@@ -28,6 +28,7 @@
 #define TAGLIB_PRIVATEFRAME_H
 
 #include "id3v2frame.h"
+#include "tpayload.h"
 #include "taglib_export.h"
 
 namespace TagLib {
@@ -87,6 +88,22 @@ namespace TagLib {
        */
       void setData(const ByteVector &v);
 
+      /*!
+       * Returns the data as a Payload.
+       *
+       * \see data()
+       * \see PayloadStream
+       */
+      Payload payload() const;
+
+      /*!
+       * Sets the data to \a payload.  A payload that refers to a stream is not
+       * read until the frame is rendered.
+       *
+       * \see payload()
+       */
+      void setPayload(const Payload &payload);
+
     protected:
       // Reimplementations.
 
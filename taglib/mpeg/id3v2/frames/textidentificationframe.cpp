@@ -130,15 +130,21 @@ namespace
       {"MIX", "MIXER"},
   };
   const size_t involvedPeopleSize = sizeof(involvedPeople) / sizeof(involvedPeople[0]);
-}
 
-const KeyConversionMap &TextIdentificationFrame::involvedPeopleMap() // static
-{
-  static KeyConversionMap m;
-  if(m.isEmpty()) {
+  KeyConversionMap makeInvolvedPeopleMap()
+  {
+    KeyConversionMap m;
     for(size_t i = 0; i < involvedPeopleSize; ++i)
       m.insert(involvedPeople[i][1], involvedPeople[i][0]);
+    return m;
   }
+}
+
+const KeyConversionMap &TextIdentificationFrame::involvedPeopleMap() // static
+{
+  // Filled in by its initializer so that it is never seen half built by
+  // another thread.
+  static const KeyConversionMap m = makeInvolvedPeopleMap();
   return m;
 }
 
@@ -25,9 +25,11 @@
 
 #include <tdebug.h>
 #include <tzlib.h>
+#include <tthread.h>
 
 #include "id3v2framefactory.h"
 #include "id3v2synchdata.h"
+#include "id3v2utils.h"
 #include "id3v1genres.h"
 
 #include "frames/attachedpictureframe.h"
@@ -89,16 +91,20 @@ class FrameFactory::FrameFactoryPrivate
 {
 public:
   FrameFactoryPrivate() :
-    defaultEncoding(String::Latin1),
-    useDefaultEncoding(false) {}
+    defaultEncoding(-1),
+    onDemand(0) {}
 
-  String::Type defaultEncoding;
-  bool useDefaultEncoding;
+  // The encoding that frames are converted to, or -1 if they keep their own.
+  // The settings are single words since the factory is shared by all threads.
+
+  volatile int defaultEncoding;
+  volatile int onDemand;
 
   template <class T> void setTextEncoding(T *frame)
   {
-    if(useDefaultEncoding)
-      frame->setTextEncoding(defaultEncoding);
+    const int encoding = Thread::loadInt(&defaultEncoding);
+    if(encoding >= 0)
+      frame->setTextEncoding(static_cast<String::Type>(encoding));
   }
 };
 
@@ -135,8 +141,7 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
   // A quick sanity check -- make sure that the frameID is 4 uppercase Latin1
   // characters.  Also make sure that there is data in the frame.
 
-  if(frameID.size() != (version < 3 ? 3 : 4) ||
-     header->frameSize() <= static_cast<unsigned int>(header->dataLengthIndicator() ? 4 : 0) ||
+  if(!isValidFrameHeader(frameID, header->frameSize(), header->dataLengthIndicator(), version) ||
      header->frameSize() > data.size())
   {
     delete header;
@@ -154,11 +159,9 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
   }
 #endif
 
-  for(ByteVector::ConstIterator it = frameID.begin(); it != frameID.end(); it++) {
-    if( (*it < 'A' || *it > 'Z') && (*it < '0' || *it > '9') ) {
-      delete header;
-      return 0;
-    }
+  if(!isValidFrameID(frameID)) {
+    delete header;
+    return 0;
   }
 
   if(version > 3 && (tagHeader->unsynchronisation() || header->unsynchronisation())) {
@@ -272,8 +275,7 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   if(frameID == "USLT") {
     UnsynchronizedLyricsFrame *f = new UnsynchronizedLyricsFrame(data, header);
-    if(d->useDefaultEncoding)
-      f->setTextEncoding(d->defaultEncoding);
+    d->setTextEncoding(f);
     return f;
   }
 
@@ -281,8 +283,7 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   if(frameID == "SYLT") {
     SynchronizedLyricsFrame *f = new SynchronizedLyricsFrame(data, header);
-    if(d->useDefaultEncoding)
-      f->setTextEncoding(d->defaultEncoding);
+    d->setTextEncoding(f);
     return f;
   }
 
@@ -360,13 +361,23 @@ void FrameFactory::rebuildAggregateFrames(ID3v2::Tag *tag) const
 
 String::Type FrameFactory::defaultTextEncoding() const
 {
-  return d->defaultEncoding;
+  const int encoding = Thread::loadInt(&d->defaultEncoding);
+  return encoding >= 0 ? static_cast<String::Type>(encoding) : String::Latin1;
 }
 
 void FrameFactory::setDefaultTextEncoding(String::Type encoding)
 {
-  d->useDefaultEncoding = true;
-  d->defaultEncoding = encoding;
+  Thread::storeInt(&d->defaultEncoding, encoding);
+}
+
+bool FrameFactory::parseFramesOnDemand() const
+{
+  return Thread::loadInt(&d->onDemand) != 0;
+}
+
+void FrameFactory::setParseFramesOnDemand(bool onDemand)
+{
+  Thread::storeInt(&d->onDemand, onDemand ? 1 : 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -123,6 +123,39 @@ namespace TagLib {
        */
       void setDefaultTextEncoding(String::Type encoding);
 
+      /*!
+       * Returns true if the frames of the tags that are read with this factory
+       * are only created when they are first asked for.  The default is false.
+       *
+       * \see setParseFramesOnDemand()
+       */
+      bool parseFramesOnDemand() const;
+
+      /*!
+       * Sets whether the frames of the ID3v2.4 tags that are read with this
+       * factory are only created when they are first asked for, by ID or
+       * through one of the frame lists of the tag.  Reading a tag then only
+       * reads the frame headers and keeps the frames as they were read;
+       * large frames, such as embedded pictures, are left in the file until
+       * they are asked for.  This makes opening files faster when only a few
+       * of their frames are used.
+       *
+       * The frames that are never asked for are rendered to an ID3v2.4 tag
+       * exactly as they were read, and so are not converted to the default text
+       * encoding.  Other ID3v2 versions and tags that are unsynchronised as a
+       * whole are always read in full.
+       *
+       * As when all the frames are read at once, reading stops at the first
+       * frame whose header is not valid.
+       *
+       * \note updateFrame() is called when a frame is created, so a factory
+       * whose updateFrame() gives ID3v2.4 frames other IDs should not parse
+       * the frames on demand.
+       *
+       * \see parseFramesOnDemand()
+       */
+      void setParseFramesOnDemand(bool onDemand);
+
     protected:
       /*!
        * Constructs a frame factory.  Because this is a singleton this method is
@@ -24,19 +24,26 @@
  ***************************************************************************/
 
 #include <algorithm>
+#include <vector>
 
 #include <tfile.h>
+#include <tpayload.h>
 #include <tbytevector.h>
 #include <tpropertymap.h>
 #include <tdebug.h>
+#include <tagutils.h>
+#include <tthread.h>
 
 #include "id3v2tag.h"
 #include "id3v2header.h"
 #include "id3v2extendedheader.h"
 #include "id3v2footer.h"
 #include "id3v2synchdata.h"
+#include "id3v2framefactory.h"
+#include "id3v2utils.h"
 #include "id3v1genres.h"
 
+#include "frames/attachedpictureframe.h"
 #include "frames/textidentificationframe.h"
 #include "frames/commentsframe.h"
 #include "frames/urllinkframe.h"
@@ -50,10 +57,600 @@ using namespace ID3v2;
 namespace
 {
   const ID3v2::Latin1StringHandler defaultStringHandler;
-  const ID3v2::Latin1StringHandler *stringHandler = &defaultStringHandler;
 
-  const long MinPaddingSize = 1024;
-  const long MaxPaddingSize = 1024 * 1024;
+  Thread::SharedHandler<ID3v2::Latin1StringHandler> stringHandler = {
+    const_cast<ID3v2::Latin1StringHandler *>(&defaultStringHandler), &defaultStringHandler
+  };
+
+  const unsigned int MinPaddingSize = 1024;
+  const unsigned int MaxPaddingSize = 1024 * 1024;
+
+  const unsigned int NotFound = 0xffffffff;
+
+  // With File::SkipPictures, only this much of the fields of an attached
+  // picture frame is read, which is normally enough to reach the picture.
+
+  const unsigned int PictureFieldsSize = 1024;
+
+  const unsigned int ReadAheadSize = 64 * 1024;
+
+  // Returns true if the mime type and the description of the attached picture
+  // frame fields in data both end before pictureStart, where the picture of
+  // the frame made from these fields begins.  Otherwise the fields go on past
+  // the end of data and the picture that was found is not the picture.
+
+  bool picturePositionValid(const ByteVector &data, unsigned int pictureStart)
+  {
+    if(data.isEmpty())
+      return false;
+
+    const int mimeTypeEnd = data.find('\0', 1);
+    if(mimeTypeEnd < 1)
+      return false;
+
+    const String::Type encoding = String::Type(data[0]);
+    const unsigned int delimiterSize =
+      (encoding == String::UTF16 || encoding == String::UTF16BE) ? 2 : 1;
+
+    return pictureStart >= mimeTypeEnd + 2 + delimiterSize;
+  }
+
+  // Returned for the frame IDs that the tag has no frames with.
+
+  const FrameList emptyFrameList;
+
+  // The frames of a tag in the order in which they were added, indexed by
+  // their frame IDs and by the frames themselves, so that finding one takes
+  // constant time however many frames the tag has.  The FrameList and
+  // FrameListMap that Tag hands out are built when they are first asked for,
+  // and from then on kept up to date as frames are added and removed, since
+  // callers may hold on to them.  Each slot keeps the iterators of its frame
+  // in these lists, so that removing it doesn't walk them either.
+  //
+  // With FrameFactory::parseFramesOnDemand(), the frames that are read are
+  // kept as their data until they are asked for, and those that nobody asked
+  // for are written back as they were read.
+  //
+  // The const accessors make frames and build lists, so they hold a lock
+  // while they change the table, and a tag can be read by several threads
+  // at once like any other.  Adding and removing frames is not locked.
+
+  class FrameTable
+  {
+  public:
+    FrameTable() :
+      factory(0),
+      live(0),
+      listBuilt(true),
+      mapBuilt(false)
+    {
+      allFrames.setAutoDelete(false);
+    }
+
+    ~FrameTable()
+    {
+      for(std::vector<Slot>::const_iterator it = slots.begin(); it != slots.end(); ++it) {
+        delete it->frame;
+        delete it->pending;
+      }
+      for(std::vector<Entry *>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        delete *it;
+    }
+
+    // Sets the factory that makes the frames that are read, and the header
+    // of the tag that they were read from.
+
+    void setSource(const FrameFactory *frameFactory, const ByteVector &headerData)
+    {
+      factory = frameFactory;
+      header.setData(headerData);
+    }
+
+    // The factory may reject a frame that has only been read, so these are
+    // made until one of them is not rejected.
+
+    bool isEmpty() const
+    {
+      MutexLocker locker(mutex);
+
+      for(unsigned int i = 0; i < slots.size(); ++i) {
+        if(frameAt(i))
+          return false;
+      }
+      return true;
+    }
+
+    void append(Frame *frame)
+    {
+      const unsigned int position = appendSlot(frame->frameID(), frame, 0);
+      Entry *entry = entries[slots[position].entry];
+
+      insertPosition(frame, position);
+
+      if(listBuilt)
+        appendTo(allFrames, &Slot::listIterator, position);
+      if(entry->listBuilt)
+        appendTo(entry->list, &Slot::entryIterator, position);
+      if(mapBuilt)
+        appendTo(frameListMap[entry->id], &Slot::mapIterator, position);
+    }
+
+    // Appends a frame that has been read as data, but not yet made.  id is
+    // the ID of the frame that will be made from it.
+
+    void appendPending(const ByteVector &id, const Payload &data, bool verbatim)
+    {
+      PendingFrame *pending = new PendingFrame();
+      pending->data = data;
+      pending->verbatim = verbatim;
+
+      const unsigned int position = appendSlot(id, 0, pending);
+      entries[slots[position].entry]->listBuilt = false;
+      listBuilt = false;
+      mapBuilt = false;
+    }
+
+    // Returns false if the frame is not in the table.
+
+    bool remove(Frame *frame)
+    {
+      const unsigned int position = findPosition(frame);
+      if(position == NotFound)
+        return false;
+
+      Entry *entry = entries[slots[position].entry];
+
+      if(listBuilt)
+        eraseFrom(allFrames, &Slot::listIterator, position);
+      if(entry->listBuilt)
+        eraseFrom(entry->list, &Slot::entryIterator, position);
+      if(mapBuilt)
+        eraseFrom(frameListMap[entry->id], &Slot::mapIterator, position);
+
+      slots[position].frame = 0;
+      removed(position);
+      compactIfSparse();
+
+      return true;
+    }
+
+    // Removes all the frames with the ID, and returns them.
+
+    FrameList removeAll(const ByteVector &id)
+    {
+      const unsigned int index = findEntry(id, false);
+      if(index == NotFound)
+        return FrameList();
+
+      Entry *entry = entries[index];
+      const FrameList removedFrames = entryList(entry);
+
+      if(removedFrames.isEmpty())
+        return removedFrames;
+
+      // The list of all the frames is built only once all of them have been
+      // made, so it holds every frame of the ID.
+
+      for(std::vector<unsigned int>::const_iterator it = entry->positions.begin();
+          it != entry->positions.end(); ++it) {
+        if(slots[*it].frame) {
+          if(listBuilt)
+            eraseFrom(allFrames, &Slot::listIterator, *it);
+          slots[*it].frame = 0;
+          removed(*it);
+        }
+      }
+
+      entry->list.clear();
+      if(mapBuilt)
+        frameListMap[entry->id].clear();
+
+      compactIfSparse();
+
+      return removedFrames;
+    }
+
+    // Returns the first frame with the ID, or null if there is none.
+
+    Frame *first(const ByteVector &id) const
+    {
+      MutexLocker locker(mutex);
+
+      const unsigned int entryIndex = findEntry(id, false);
+      if(entryIndex == NotFound || entries[entryIndex]->count == 0)
+        return 0;
+
+      const std::vector<unsigned int> &positions = entries[entryIndex]->positions;
+      for(std::vector<unsigned int>::const_iterator it = positions.begin(); it != positions.end(); ++it) {
+        if(Frame *frame = frameAt(*it))
+          return frame;
+      }
+      return 0;
+    }
+
+    const FrameList &list() const
+    {
+      MutexLocker locker(mutex);
+      return allFramesList();
+    }
+
+    const FrameList &list(const ByteVector &id) const
+    {
+      MutexLocker locker(mutex);
+
+      const unsigned int index = findEntry(id, false);
+      if(index == NotFound)
+        return emptyFrameList;
+
+      return entryList(entries[index]);
+    }
+
+    const FrameListMap &map() const
+    {
+      MutexLocker locker(mutex);
+
+      if(!mapBuilt) {
+        allFramesList();
+        frameListMap.clear();
+        for(std::vector<Entry *>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+          if((*it)->count == 0)
+            continue;
+
+          // The list in the map gets its own items, so that it has its own
+          // iterators, rather than sharing those of the entry.
+
+          FrameList &mapList = frameListMap[(*it)->id];
+          const FrameList &frames = entryList(*it);
+          for(FrameList::ConstIterator frame = frames.begin(); frame != frames.end(); ++frame)
+            appendTo(mapList, &Slot::mapIterator, findPosition(*frame));
+        }
+        mapBuilt = true;
+      }
+      return frameListMap;
+    }
+
+    unsigned int slotCount() const
+    {
+      return static_cast<unsigned int>(slots.size());
+    }
+
+    // Returns the frame at position, making it if it has not been made yet,
+    // unless it can be written as it was read, in which case it returns null
+    // and sets data to its bytes.
+
+    Frame *frameAt(unsigned int position, ByteVector *data) const
+    {
+      MutexLocker locker(mutex);
+
+      const PendingFrame *pending = slots[position].pending;
+      if(pending && pending->verbatim) {
+        *data = pending->data.data();
+        return 0;
+      }
+
+      return frameAt(position);
+    }
+
+  private:
+    FrameTable(const FrameTable &);
+    FrameTable &operator=(const FrameTable &);
+
+    struct PendingFrame
+    {
+      Payload data;
+      bool verbatim;
+    };
+
+    // A slot holds a frame, the data of a frame that has not been made yet,
+    // or neither once the frame has been removed.  The iterators point to the
+    // frame in each of the lists that have been built.
+
+    struct Slot
+    {
+      Frame *frame;
+      PendingFrame *pending;
+      unsigned int entry;
+      FrameList::Iterator listIterator;
+      FrameList::Iterator entryIterator;
+      FrameList::Iterator mapIterator;
+    };
+
+    // The frames with one frame ID.  positions may still hold the positions of
+    // removed frames until the table is compacted.  Once list is built, it
+    // holds all of them, since the frames of the ID that had only been read
+    // were made to build it.
+
+    struct Entry
+    {
+      ByteVector id;
+      unsigned int key;
+      unsigned int count;
+      std::vector<unsigned int> positions;
+      FrameList list;
+      bool listBuilt;
+    };
+
+    struct PositionIndexItem
+    {
+      Frame *frame;
+      unsigned int position;
+    };
+
+    // Frame IDs are four characters, three in ID3v2.2, which make a key that
+    // tells them apart without comparing byte vectors.
+
+    static unsigned int idKey(const ByteVector &id)
+    {
+      if(id.isEmpty())
+        return 0;
+
+      const unsigned int size = std::min<unsigned int>(id.size(), 4);
+      unsigned int key = 0;
+      for(unsigned int i = 0; i < size; ++i)
+        key = (key << 8) | static_cast<unsigned char>(id[i]);
+      return (key << (8 * (4 - size))) ^ id.size();
+    }
+
+    static size_t hash(unsigned int key, size_t capacity)
+    {
+      return (key * 2654435761U) & (capacity - 1);
+    }
+
+    static size_t hash(const Frame *frame, size_t capacity)
+    {
+      const size_t address = reinterpret_cast<size_t>(frame) / sizeof(void *);
+      return (static_cast<unsigned int>(address) * 2654435761U) & (capacity - 1);
+    }
+
+    static size_t capacityFor(size_t count)
+    {
+      size_t capacity = 16;
+      while(capacity < count * 2)
+        capacity *= 2;
+      return capacity;
+    }
+
+    unsigned int appendSlot(const ByteVector &id, Frame *frame, PendingFrame *pending)
+    {
+      const unsigned int entryIndex = findEntry(id, true);
+      Entry *entry = entries[entryIndex];
+
+      Slot slot;
+      slot.frame = frame;
+      slot.pending = pending;
+      slot.entry = entryIndex;
+      slots.push_back(slot);
+      const unsigned int position = static_cast<unsigned int>(slots.size() - 1);
+
+      entry->positions.push_back(position);
+      ++entry->count;
+      ++live;
+
+      return position;
+    }
+
+    void removed(unsigned int position) const
+    {
+      Entry *entry = entries[slots[position].entry];
+      --entry->count;
+      --live;
+    }
+
+    // Returns the frame at position, making it first if it has only been read.
+
+    Frame *frameAt(unsigned int position) const
+    {
+      Slot &slot = slots[position];
+      if(!slot.pending)
+        return slot.frame;
+
+      Frame *frame = factory->createFrame(slot.pending->data.data(), &header);
+      delete slot.pending;
+      slot.pending = 0;
+
+      if(!frame) {
+        removed(position);
+        return 0;
+      }
+
+      slot.frame = frame;
+      insertPosition(frame, position);
+      return frame;
+    }
+
+    unsigned int findEntry(const ByteVector &id, bool create) const
+    {
+      const unsigned int key = idKey(id);
+
+      if(!entryIndex.empty()) {
+        for(size_t i = hash(key, entryIndex.size());; i = (i + 1) & (entryIndex.size() - 1)) {
+          const unsigned int index = entryIndex[i];
+          if(index == NotFound)
+            break;
+          const Entry *entry = entries[index];
+          if(entry->key == key && (id.size() <= 4 || entry->id == id))
+            return index;
+        }
+      }
+
+      if(!create)
+        return NotFound;
+
+      Entry *entry = new Entry();
+      entry->id = id;
+      entry->key = key;
+      entry->count = 0;
+      entry->listBuilt = true;
+      entries.push_back(entry);
+
+      const unsigned int index = static_cast<unsigned int>(entries.size() - 1);
+      if(entryIndex.size() < entries.size() * 2) {
+        entryIndex.assign(capacityFor(entries.size()), NotFound);
+        for(unsigned int j = 0; j < entries.size(); ++j)
+          insertEntry(j);
+      }
+      else {
+        insertEntry(index);
+      }
+
+      return index;
+    }
+
+    void insertEntry(unsigned int index) const
+    {
+      size_t i = hash(entries[index]->key, entryIndex.size());
+      while(entryIndex[i] != NotFound)
+        i = (i + 1) & (entryIndex.size() - 1);
+      entryIndex[i] = index;
+    }
+
+    const FrameList &allFramesList() const
+    {
+      if(!listBuilt) {
+        allFrames.clear();
+        for(unsigned int i = 0; i < slots.size(); ++i) {
+          if(frameAt(i))
+            appendTo(allFrames, &Slot::listIterator, i);
+        }
+        listBuilt = true;
+      }
+      return allFrames;
+    }
+
+    const FrameList &entryList(Entry *entry) const
+    {
+      if(!entry->listBuilt) {
+        entry->list.clear();
+        for(std::vector<unsigned int>::const_iterator it = entry->positions.begin();
+            it != entry->positions.end(); ++it) {
+          if(frameAt(*it))
+            appendTo(entry->list, &Slot::entryIterator, *it);
+        }
+        entry->listBuilt = true;
+      }
+      return entry->list;
+    }
+
+    // A list is shared with the copies that callers made of it until one of
+    // them is changed.  Changing it copies its items, which leaves the
+    // iterators kept in the slots pointing to the items of the copies, so
+    // they are set again.  This walks the list once per copy made.
+
+    void detach(FrameList &list, FrameList::Iterator Slot::*iterator) const
+    {
+      if(list.isEmpty())
+        return;
+
+      Frame *const *sharedItem = &*static_cast<const FrameList &>(list).begin();
+
+      FrameList::Iterator it = list.begin();
+      if(&*it == sharedItem)
+        return;
+
+      for(; it != list.end(); ++it)
+        slots[findPosition(*it)].*iterator = it;
+    }
+
+    void appendTo(FrameList &list, FrameList::Iterator Slot::*iterator,
+                  unsigned int position) const
+    {
+      detach(list, iterator);
+      list.append(slots[position].frame);
+      slots[position].*iterator = --list.end();
+    }
+
+    void eraseFrom(FrameList &list, FrameList::Iterator Slot::*iterator,
+                   unsigned int position)
+    {
+      detach(list, iterator);
+      list.erase(slots[position].*iterator);
+    }
+
+    // The position index is not told about removed frames; a frame that is
+    // found is checked against its slot.  A frame that is added again replaces
+    // its old item.
+
+    unsigned int findPosition(const Frame *frame) const
+    {
+      if(positionIndex.empty())
+        return NotFound;
+
+      for(size_t i = hash(frame, positionIndex.size());; i = (i + 1) & (positionIndex.size() - 1)) {
+        const PositionIndexItem &item = positionIndex[i];
+        if(!item.frame)
+          return NotFound;
+        if(item.frame == frame)
+          return slots[item.position].frame == frame ? item.position : NotFound;
+      }
+    }
+
+    void insertPosition(Frame *frame, unsigned int position) const
+    {
+      if(positionIndex.size() < slots.size() * 2) {
+        rebuildPositionIndex();
+        return;
+      }
+
+      size_t i = hash(frame, positionIndex.size());
+      while(positionIndex[i].frame && positionIndex[i].frame != frame)
+        i = (i + 1) & (positionIndex.size() - 1);
+      positionIndex[i].frame = frame;
+      positionIndex[i].position = position;
+    }
+
+    void rebuildPositionIndex() const
+    {
+      const PositionIndexItem empty = { 0, 0 };
+      positionIndex.assign(capacityFor(slots.size()), empty);
+      for(unsigned int i = 0; i < slots.size(); ++i) {
+        if(slots[i].frame)
+          insertPosition(slots[i].frame, i);
+      }
+    }
+
+    // Keeps the removed slots from outnumbering the frames.
+
+    void compactIfSparse()
+    {
+      if(slots.size() > 2 * live + 16)
+        compact();
+    }
+
+    void compact()
+    {
+      std::vector<Slot> kept;
+      kept.reserve(live);
+      for(std::vector<Slot>::const_iterator it = slots.begin(); it != slots.end(); ++it) {
+        if(it->frame || it->pending)
+          kept.push_back(*it);
+      }
+      slots.swap(kept);
+
+      for(std::vector<Entry *>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        (*it)->positions.clear();
+      for(unsigned int i = 0; i < slots.size(); ++i)
+        entries[slots[i].entry]->positions.push_back(i);
+
+      rebuildPositionIndex();
+    }
+
+    const FrameFactory *factory;
+    mutable Header header;
+
+    mutable std::vector<Slot> slots;
+    mutable unsigned int live;
+
+    mutable std::vector<Entry *> entries;
+    mutable std::vector<unsigned int> entryIndex;
+    mutable std::vector<PositionIndexItem> positionIndex;
+
+    mutable FrameList allFrames;
+    mutable bool listBuilt;
+    mutable FrameListMap frameListMap;
+    mutable bool mapBuilt;
+
+    mutable Mutex mutex;
+  };
 }
 
 class ID3v2::Tag::TagPrivate
@@ -64,10 +661,9 @@ public:
     file(0),
     tagOffset(0),
     extendedHeader(0),
-    footer(0)
-  {
-    frameList.setAutoDelete(true);
-  }
+    footer(0),
+    minimumPadding(MinPaddingSize),
+    maximumPadding(MaxPaddingSize) {}
 
   ~TagPrivate()
   {
@@ -84,8 +680,72 @@ public:
   ExtendedHeader *extendedHeader;
   Footer *footer;
 
-  FrameListMap frameListMap;
-  FrameList frameList;
+  FrameTable frames;
+
+  unsigned int minimumPadding;
+  unsigned int maximumPadding;
+};
+
+// Reads the body of a tag, either from memory or from a file in large blocks,
+// so that the parts that are not asked for, like the pictures, are skipped.
+
+class ID3v2::Tag::BodyReader
+{
+public:
+  explicit BodyReader(const ByteVector &data) :
+    file(0),
+    offset(0),
+    bodySize(data.size()),
+    block(data),
+    blockPosition(0) {}
+
+  BodyReader(File *file, long offset, unsigned int size) :
+    file(file),
+    offset(offset),
+    bodySize(size),
+    blockPosition(0) {}
+
+  unsigned int size() const
+  {
+    return bodySize;
+  }
+
+  // Returns the file that the body is read from, or null if it is in memory.
+
+  File *sourceFile() const
+  {
+    return file;
+  }
+
+  long fileOffset(unsigned int position) const
+  {
+    return offset + position;
+  }
+
+  // Returns the length bytes at position, or fewer if the body ends before.
+
+  ByteVector read(unsigned int position, unsigned int length)
+  {
+    if(position >= bodySize)
+      return ByteVector();
+
+    length = std::min(length, bodySize - position);
+
+    if(file && (position < blockPosition || position + length > blockPosition + block.size())) {
+      file->seek(offset + position);
+      block = file->readBlock(std::min(std::max(length, ReadAheadSize), bodySize - position));
+      blockPosition = position;
+    }
+
+    return block.mid(position - blockPosition, length);
+  }
+
+private:
+  File *const file;
+  const long offset;
+  const unsigned int bodySize;
+  ByteVector block;
+  unsigned int blockPosition;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -134,28 +794,25 @@ ID3v2::Tag::~Tag()
 
 String ID3v2::Tag::title() const
 {
-  if(!d->frameListMap["TIT2"].isEmpty())
-    return d->frameListMap["TIT2"].front()->toString();
-  return String();
+  const Frame *frame = d->frames.first("TIT2");
+  return frame ? frame->toString() : String();
 }
 
 String ID3v2::Tag::artist() const
 {
-  if(!d->frameListMap["TPE1"].isEmpty())
-    return d->frameListMap["TPE1"].front()->toString();
-  return String();
+  const Frame *frame = d->frames.first("TPE1");
+  return frame ? frame->toString() : String();
 }
 
 String ID3v2::Tag::album() const
 {
-  if(!d->frameListMap["TALB"].isEmpty())
-    return d->frameListMap["TALB"].front()->toString();
-  return String();
+  const Frame *frame = d->frames.first("TALB");
+  return frame ? frame->toString() : String();
 }
 
 String ID3v2::Tag::comment() const
 {
-  const FrameList &comments = d->frameListMap["COMM"];
+  const FrameList &comments = d->frames.list("COMM");
 
   if(comments.isEmpty())
     return String();
@@ -177,11 +834,9 @@ String ID3v2::Tag::genre() const
   // should be separated by " / " instead of " ".  For the moment to keep
   // the behavior the same as released versions it is being left with " ".
 
-  if(d->frameListMap["TCON"].isEmpty() ||
-     !dynamic_cast<TextIdentificationFrame *>(d->frameListMap["TCON"].front()))
-  {
+  TextIdentificationFrame *f = dynamic_cast<TextIdentificationFrame *>(d->frames.first("TCON"));
+  if(!f)
     return String();
-  }
 
   // ID3v2.4 lists genres as the fields in its frames field list.  If the field
   // is simply a number it can be assumed that it is an ID3v1 genre number.
@@ -189,9 +844,6 @@ String ID3v2::Tag::genre() const
   // appended to the genre string.  Multiple fields will be appended as the
   // string is built.
 
-  TextIdentificationFrame *f = static_cast<TextIdentificationFrame *>(
-    d->frameListMap["TCON"].front());
-
   StringList fields = f->fieldList();
 
   StringList genres;
@@ -216,16 +868,14 @@ String ID3v2::Tag::genre() const
 
 unsigned int ID3v2::Tag::year() const
 {
-  if(!d->frameListMap["TDRC"].isEmpty())
-    return d->frameListMap["TDRC"].front()->toString().substr(0, 4).toInt();
-  return 0;
+  const Frame *frame = d->frames.first("TDRC");
+  return frame ? frame->toString().substr(0, 4).toInt() : 0;
 }
 
 unsigned int ID3v2::Tag::track() const
 {
-  if(!d->frameListMap["TRCK"].isEmpty())
-    return d->frameListMap["TRCK"].front()->toString().toInt();
-  return 0;
+  const Frame *frame = d->frames.first("TRCK");
+  return frame ? frame->toString().toInt() : 0;
 }
 
 void ID3v2::Tag::setTitle(const String &s)
@@ -250,8 +900,8 @@ void ID3v2::Tag::setComment(const String &s)
     return;
   }
 
-  if(!d->frameListMap["COMM"].isEmpty())
-    d->frameListMap["COMM"].front()->setText(s);
+  if(Frame *frame = d->frames.first("COMM"))
+    frame->setText(s);
   else {
     CommentsFrame *f = new CommentsFrame(d->factory->defaultTextEncoding());
     addFrame(f);
@@ -305,7 +955,7 @@ void ID3v2::Tag::setTrack(unsigned int i)
 
 bool ID3v2::Tag::isEmpty() const
 {
-  return d->frameList.isEmpty();
+  return d->frames.isEmpty();
 }
 
 Header *ID3v2::Tag::header() const
@@ -325,45 +975,38 @@ Footer *ID3v2::Tag::footer() const
 
 const FrameListMap &ID3v2::Tag::frameListMap() const
 {
-  return d->frameListMap;
+  return d->frames.map();
 }
 
 const FrameList &ID3v2::Tag::frameList() const
 {
-  return d->frameList;
+  return d->frames.list();
 }
 
 const FrameList &ID3v2::Tag::frameList(const ByteVector &frameID) const
 {
-  return d->frameListMap[frameID];
+  return d->frames.list(frameID);
 }
 
 void ID3v2::Tag::addFrame(Frame *frame)
 {
-  d->frameList.append(frame);
-  d->frameListMap[frame->frameID()].append(frame);
+  d->frames.append(frame);
 }
 
 void ID3v2::Tag::removeFrame(Frame *frame, bool del)
 {
-  // remove the frame from the frame list
-  FrameList::Iterator it = d->frameList.find(frame);
-  d->frameList.erase(it);
-
-  // ...and from the frame list map
-  it = d->frameListMap[frame->frameID()].find(frame);
-  d->frameListMap[frame->frameID()].erase(it);
+  if(!d->frames.remove(frame))
+    debug("ID3v2::Tag::removeFrame() - The frame is not in this tag.");
 
-  // ...and delete as desired
   if(del)
     delete frame;
 }
 
 void ID3v2::Tag::removeFrames(const ByteVector &id)
 {
-  FrameList l = d->frameListMap[id];
+  const FrameList l = d->frames.removeAll(id);
   for(FrameList::ConstIterator it = l.begin(); it != l.end(); ++it)
-    removeFrame(*it, true);
+    delete *it;
 }
 
 PropertyMap ID3v2::Tag::properties() const
@@ -465,6 +1108,22 @@ ByteVector ID3v2::Tag::render() const
   return render(4);
 }
 
+void ID3v2::Tag::setPadding(unsigned int minimumSize, unsigned int maximumSize)
+{
+  d->minimumPadding = minimumSize;
+  d->maximumPadding = std::max(minimumSize, maximumSize);
+}
+
+unsigned int ID3v2::Tag::minimumPadding() const
+{
+  return d->minimumPadding;
+}
+
+unsigned int ID3v2::Tag::maximumPadding() const
+{
+  return d->maximumPadding;
+}
+
 void ID3v2::Tag::downgradeFrames(FrameList *frames, FrameList *newFrames) const
 {
 #ifdef NO_ITUNES_HACKS
@@ -483,7 +1142,8 @@ void ID3v2::Tag::downgradeFrames(FrameList *frames, FrameList *newFrames) const
   ID3v2::TextIdentificationFrame *frameTDRC = 0;
   ID3v2::TextIdentificationFrame *frameTIPL = 0;
   ID3v2::TextIdentificationFrame *frameTMCL = 0;
-  for(FrameList::ConstIterator it = d->frameList.begin(); it != d->frameList.end(); it++) {
+  const FrameList &frameList = d->frames.list();
+  for(FrameList::ConstIterator it = frameList.begin(); it != frameList.end(); it++) {
     ID3v2::Frame *frame = *it;
     ByteVector frameID = frame->header()->frameID();
     for(int i = 0; unsupportedFrames[i]; i++) {
@@ -586,9 +1246,17 @@ ByteVector ID3v2::Tag::render(int version) const
   FrameList newFrames;
   newFrames.setAutoDelete(true);
 
+  // The frames that were parsed on demand and have not been asked for since
+  // are written to an ID3v2.4 tag as they were read; they are null in
+  // frameList, with their data at the same index in verbatimData.
+
   FrameList frameList;
+  std::vector<ByteVector> verbatimData;
+
   if(version == 4) {
-    frameList = d->frameList;
+    verbatimData.resize(d->frames.slotCount());
+    for(unsigned int i = 0; i < d->frames.slotCount(); ++i)
+      frameList.append(d->frames.frameAt(i, &verbatimData[i]));
   }
   else {
     downgradeFrames(&frameList, &newFrames);
@@ -600,7 +1268,12 @@ ByteVector ID3v2::Tag::render(int version) const
 
   // Loop through the frames rendering them and adding them to the tagData.
 
-  for(FrameList::ConstIterator it = frameList.begin(); it != frameList.end(); it++) {
+  unsigned int index = 0;
+  for(FrameList::ConstIterator it = frameList.begin(); it != frameList.end(); it++, index++) {
+    if(!*it) {
+      tagData.append(verbatimData[index]);
+      continue;
+    }
     (*it)->header()->setVersion(version);
     if((*it)->header()->frameID().size() != 4) {
       debug("An ID3v2 frame of unsupported or unknown type \'"
@@ -620,22 +1293,9 @@ ByteVector ID3v2::Tag::render(int version) const
 
   // Compute the amount of padding, and append that to tagData.
 
-  long originalSize = d->header.tagSize();
-  long paddingSize = originalSize - (tagData.size() - Header::size());
-
-  if(paddingSize <= 0) {
-    paddingSize = MinPaddingSize;
-  }
-  else {
-    // Padding won't increase beyond 1% of the file size or 1MB.
-
-    long threshold = d->file ? d->file->length() / 100 : 0;
-    threshold = std::max(threshold, MinPaddingSize);
-    threshold = std::min(threshold, MaxPaddingSize);
-
-    if(paddingSize > threshold)
-      paddingSize = MinPaddingSize;
-  }
+  const long paddingSize = Utils::paddingSize(
+    d->header.tagSize(), tagData.size() - Header::size(), d->minimumPadding,
+    Utils::paddingThreshold(d->file ? d->file->length() : 0, d->minimumPadding, d->maximumPadding));
 
   tagData.resize(static_cast<unsigned int>(tagData.size() + paddingSize), '\0');
 
@@ -652,15 +1312,12 @@ ByteVector ID3v2::Tag::render(int version) const
 
 Latin1StringHandler const *ID3v2::Tag::latin1StringHandler()
 {
-  return stringHandler;
+  return stringHandler.get();
 }
 
 void ID3v2::Tag::setLatin1StringHandler(const Latin1StringHandler *handler)
 {
-  if(handler)
-    stringHandler = handler;
-  else
-    stringHandler = &defaultStringHandler;
+  stringHandler.set(handler);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -676,13 +1333,34 @@ void ID3v2::Tag::read()
     return;
 
   d->file->seek(d->tagOffset);
-  d->header.setData(d->file->readBlock(Header::size()));
+
+  const ByteVector headerData = d->file->readBlock(Header::size());
+  d->header.setData(headerData);
+  d->frames.setSource(d->factory, headerData);
 
   // If the tag size is 0, then this is an invalid tag (tags must contain at
   // least one frame)
 
-  if(d->header.tagSize() != 0)
-    parse(d->file->readBlock(d->header.tagSize()));
+  // The body is read as the frames are reached, unless the whole tag is
+  // unsynchronised, which only parse() undoes.
+
+  if(d->header.tagSize() != 0) {
+    if(d->header.majorVersion() == 4
+       || (d->header.majorVersion() == 3 && !d->header.unsynchronisation()))
+    {
+      // As with a single read, a body that the file ends within is cut short.
+
+      const long bodyOffset = d->tagOffset + Header::size();
+      const long available = std::max<long>(d->file->length() - bodyOffset, 0);
+
+      BodyReader body(d->file, bodyOffset,
+                      static_cast<unsigned int>(std::min<long>(d->header.tagSize(), available)));
+      parseFrames(body, d->file->pictureReading() == File::SkipPictures);
+    }
+    else {
+      parse(d->file->readBlock(d->header.tagSize()));
+    }
+  }
 
   // Look for duplicate ID3v2 tags and treat them as an extra blank of this one.
   // It leads to overwriting them with zero when saving the tag.
@@ -716,16 +1394,43 @@ void ID3v2::Tag::parse(const ByteVector &origData)
   if(d->header.unsynchronisation() && d->header.majorVersion() <= 3)
     data = SynchData::decode(data);
 
+  BodyReader body(data);
+  parseFrames(body, false);
+}
+
+void ID3v2::Tag::setTextFrame(const ByteVector &id, const String &value)
+{
+  if(value.isEmpty()) {
+    removeFrames(id);
+    return;
+  }
+
+  if(Frame *frame = d->frames.first(id))
+    frame->setText(value);
+  else {
+    const String::Type encoding = d->factory->defaultTextEncoding();
+    TextIdentificationFrame *f = new TextIdentificationFrame(id, encoding);
+    addFrame(f);
+    f->setText(value);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void ID3v2::Tag::parseFrames(BodyReader &body, bool skipPictures)
+{
   unsigned int frameDataPosition = 0;
-  unsigned int frameDataLength = data.size();
+  unsigned int frameDataLength = body.size();
 
   // check for extended header
 
   if(d->header.extendedHeader()) {
     if(!d->extendedHeader)
       d->extendedHeader = new ExtendedHeader();
-    d->extendedHeader->setData(data);
-    if(d->extendedHeader->size() <= data.size()) {
+    d->extendedHeader->setData(body.read(0, 4));
+    if(d->extendedHeader->size() <= body.size()) {
       frameDataPosition += d->extendedHeader->size();
       frameDataLength -= d->extendedHeader->size();
     }
@@ -740,15 +1445,29 @@ void ID3v2::Tag::parse(const ByteVector &origData)
 
   // parse frames
 
+  const unsigned int version = d->header.majorVersion();
+  const unsigned int headerSize = Frame::headerSize(version);
+
+  // Frames that are unsynchronised as a part of the whole tag can't be written
+  // back as they were read, since Tag does not write unsynchronised tags.
+
+  const bool onDemand = d->factory->parseFramesOnDemand()
+    && version == 4 && !d->header.unsynchronisation();
+
   // Make sure that there is at least enough room in the remaining frame data for
   // a frame header.
 
-  while(frameDataPosition < frameDataLength - Frame::headerSize(d->header.majorVersion())) {
+  while(frameDataPosition < frameDataLength - headerSize) {
+
+    const ByteVector headerData = body.read(frameDataPosition, headerSize);
+
+    if(headerData.size() < headerSize)
+      return;
 
     // If the next data is position is 0, assume that we've hit the padding
     // portion of the frame data.
 
-    if(data.at(frameDataPosition) == 0) {
+    if(headerData.at(0) == 0) {
       if(d->header.footerPresent()) {
         debug("Padding *and* a footer found.  This is not allowed by the spec.");
       }
@@ -756,8 +1475,49 @@ void ID3v2::Tag::parse(const ByteVector &origData)
       break;
     }
 
-    Frame *frame = d->factory->createFrame(data.mid(frameDataPosition),
-                                           &d->header);
+    const Frame::Header header(headerData, version);
+    const unsigned int remaining = body.size() - frameDataPosition;
+
+    // Compressed, encrypted or unsynchronised pictures can't be left in the
+    // file.
+
+    if(skipPictures
+       && headerData.startsWith("APIC")
+       && header.frameSize() > PictureFieldsSize
+       && header.frameSize() <= remaining - headerSize
+       && !header.compression()
+       && !header.encryption()
+       && !header.unsynchronisation()
+       && !header.dataLengthIndicator())
+    {
+      if(Frame *frame = readPictureFrame(body, frameDataPosition, header.frameSize())) {
+        d->frames.append(frame);
+        frameDataPosition += header.frameSize() + headerSize;
+        continue;
+      }
+    }
+
+    if(onDemand) {
+
+      // Only the header of the frame is read here, with the checks that
+      // createFrame() makes before it reads the frame.
+
+      if(!isValidFrameHeader(header.frameID(), header.frameSize(),
+                             header.dataLengthIndicator(), version)
+         || !isValidFrameID(header.frameID())
+         || header.frameSize() > remaining)
+      {
+        return;
+      }
+
+      appendFrameData(body, frameDataPosition, header);
+
+      frameDataPosition += header.frameSize() + headerSize;
+      continue;
+    }
+
+    Frame *frame = d->factory->createFrame(
+      body.read(frameDataPosition, header.frameSize() + headerSize), &d->header);
 
     if(!frame)
       return;
@@ -769,26 +1529,83 @@ void ID3v2::Tag::parse(const ByteVector &origData)
       return;
     }
 
-    frameDataPosition += frame->size() + Frame::headerSize(d->header.majorVersion());
+    frameDataPosition += frame->size() + headerSize;
     addFrame(frame);
   }
 
   d->factory->rebuildAggregateFrames(this);
 }
 
-void ID3v2::Tag::setTextFrame(const ByteVector &id, const String &value)
+Frame *ID3v2::Tag::readPictureFrame(BodyReader &body, unsigned int position,
+                                    unsigned int fieldsSize)
 {
-  if(value.isEmpty()) {
-    removeFrames(id);
-    return;
+  // The frame is made from the start of its fields only, with the size in its
+  // header changed to match, and the picture is then left in the file.
+
+  const unsigned int version = d->header.majorVersion();
+  const unsigned int headerSize = Frame::headerSize(version);
+
+  ByteVector data = body.read(position, headerSize + PictureFieldsSize);
+  if(data.size() < headerSize + PictureFieldsSize)
+    return 0;
+
+  const ByteVector sizeData = version == 4
+    ? SynchData::fromUInt(PictureFieldsSize)
+    : ByteVector::fromUInt(PictureFieldsSize);
+  std::copy(sizeData.begin(), sizeData.end(), data.begin() + 4);
+
+  Frame *frame = d->factory->createFrame(data, &d->header);
+
+  AttachedPictureFrame *pictureFrame = dynamic_cast<AttachedPictureFrame *>(frame);
+  if(!pictureFrame) {
+    delete frame;
+    return 0;
   }
 
-  if(!d->frameListMap[id].isEmpty())
-    d->frameListMap[id].front()->setText(value);
-  else {
-    const String::Type encoding = d->factory->defaultTextEncoding();
-    TextIdentificationFrame *f = new TextIdentificationFrame(id, encoding);
-    addFrame(f);
-    f->setText(value);
+  const unsigned int pictureStart = PictureFieldsSize - pictureFrame->picture().size();
+
+  if(!picturePositionValid(data.mid(headerSize), pictureStart)) {
+    delete frame;
+    return 0;
+  }
+
+  pictureFrame->header()->setFrameSize(fieldsSize);
+  pictureFrame->setPayload(Payload(body.sourceFile(),
+                                   body.fileOffset(position + headerSize + pictureStart),
+                                   fieldsSize - pictureStart, pictureFrame->mimeType()));
+
+  return pictureFrame;
+}
+
+void ID3v2::Tag::appendFrameData(BodyReader &body, unsigned int position,
+                                  const Frame::Header &header)
+{
+  const unsigned int size =
+    std::min(header.frameSize() + Frame::headerSize(4), body.size() - position);
+
+  // A large frame is left in the file until it is asked for.  The file reads
+  // it before it is saved, since saving may move it.
+
+  Payload data;
+  if(body.sourceFile() && size > ReadAheadSize)
+    data = Payload(body.sourceFile(), body.fileOffset(position), size);
+  else
+    data = Payload(body.read(position, size));
+
+  // TagLib up to version 1.1 wrote the year to TRDC frames, which the factory
+  // renames when it makes them, so they are made right away.
+
+  if(header.frameID() == "TRDC") {
+    if(Frame *frame = d->factory->createFrame(data.data(), &d->header))
+      addFrame(frame);
+    return;
   }
+
+  // A frame that is to be discarded once the tag is changed, or whose end is
+  // missing, is not written back as it was read.
+
+  const bool verbatim = !header.tagAlterPreservation()
+    && size == header.frameSize() + Frame::headerSize(4);
+
+  d->frames.appendPending(header.frameID(), data, verbatim);
 }
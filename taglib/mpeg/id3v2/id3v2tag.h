@@ -246,6 +246,13 @@ namespace TagLib {
        * This can be useful if for example you want iterate over the tag's frames
        * in the order that they occur in the tag.
        *
+       * \note With FrameFactory::parseFramesOnDemand(), the frames that are read
+       * from a file are only parsed when they are first asked for, here or by
+       * ID, and those that are never asked for are rendered to an ID3v2.4 tag
+       * exactly as they were read.  Parsing them is locked, so the tag may
+       * still be read from several threads at once, but not while it is
+       * changed.
+       *
        * \warning You should not modify this data structure directly, instead
        * use addFrame() and removeFrame().
        */
@@ -354,6 +361,30 @@ namespace TagLib {
       // BIC: combine with the above method
       ByteVector render(int version) const;
 
+      /*!
+       * Sets the padding that render() appends to the frames.  A tag that does
+       * not fit into its previous size gets \a minimumSize bytes of padding;
+       * left over space is kept as long as it does not exceed \a maximumSize
+       * or 1% of the file size.  The default is 1024 bytes up to 1 MiB.
+       *
+       * \see File::setPadding()
+       */
+      void setPadding(unsigned int minimumSize, unsigned int maximumSize);
+
+      /*!
+       * Returns the minimum padding size used by render().
+       *
+       * \see setPadding()
+       */
+      unsigned int minimumPadding() const;
+
+      /*!
+       * Returns the maximum padding size kept by render().
+       *
+       * \see setPadding()
+       */
+      unsigned int maximumPadding() const;
+
       /*!
        * Gets the current string handler that decides how the "Latin-1" data
        * will be converted to and from binary data.
@@ -402,6 +433,31 @@ namespace TagLib {
       Tag(const Tag &);
       Tag &operator=(const Tag &);
 
+      class BodyReader;
+
+      /*!
+       * Parses the frames of the tag body that \a body reads.  With
+       * \a skipPictures, the pictures of the large attached picture frames
+       * are left in the file.
+       */
+      void parseFrames(BodyReader &body, bool skipPictures);
+
+      /*!
+       * Makes the attached picture frame at \a position in \a body from the
+       * start of its fields, and leaves the rest of its \a fieldsSize bytes of
+       * fields in the file.  Returns a null pointer if the picture does not
+       * start within the fields that were read.
+       */
+      Frame *readPictureFrame(BodyReader &body, unsigned int position,
+                              unsigned int fieldsSize);
+
+      /*!
+       * Adds the frame at \a position in \a body, whose header has been read
+       * into \a header, to the frames that are made when they are asked for.
+       */
+      void appendFrameData(BodyReader &body, unsigned int position,
+                           const Frame::Header &header);
+
       class TagPrivate;
       TagPrivate *d;
     };
@@ -0,0 +1,76 @@
+/***************************************************************************
+    copyright            : (C) 2002 - 2008 by Scott Wheeler
+    email                : wheeler@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_ID3V2UTILS_H
+#define TAGLIB_ID3V2UTILS_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include "tbytevector.h"
+
+namespace TagLib
+{
+  namespace ID3v2
+  {
+    namespace
+    {
+
+      /*!
+       * Returns true if \a frameID has the length of the frame IDs of the tag
+       * version \a version, and the \a frameSize bytes of the frame hold more
+       * than the data length indicator, if the frame has one.  This is the
+       * first of the checks that FrameFactory::createFrame() makes before it
+       * creates a frame.
+       */
+      inline bool isValidFrameHeader(const ByteVector &frameID, unsigned int frameSize,
+                                     bool dataLengthIndicator, unsigned int version)
+      {
+        return frameID.size() == (version < 3 ? 3U : 4U)
+          && frameSize > (dataLengthIndicator ? 4U : 0U);
+      }
+
+      /*!
+       * Returns true if \a frameID is made of uppercase Latin1 letters and
+       * digits only.
+       */
+      inline bool isValidFrameID(const ByteVector &frameID)
+      {
+        for(ByteVector::ConstIterator it = frameID.begin(); it != frameID.end(); it++) {
+          if( (*it < 'A' || *it > 'Z') && (*it < '0' || *it > '9') )
+            return false;
+        }
+
+        return true;
+      }
+
+    }
+  }
+}
+
+#endif
+
+#endif
@@ -23,6 +23,8 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tagunion.h>
 #include <tagutils.h>
 #include <id3v2tag.h>
@@ -80,79 +82,71 @@ public:
 // static members
 ////////////////////////////////////////////////////////////////////////////////
 
-namespace
-{
-  // Dummy file class to make a stream work with MPEG::Header.
-
-  class AdapterFile : public TagLib::File
-  {
-  public:
-    AdapterFile(IOStream *stream) : File(stream) {}
-
-    Tag *tag() const { return 0; }
-    AudioProperties *audioProperties() const { return 0; }
-    bool save() { return false; }
-  };
-}
-
 bool MPEG::File::isSupported(IOStream *stream)
 {
-  if(!stream || !stream->isOpen())
-    return false;
-
   // An MPEG file has MPEG frame headers. An ID3v2 tag may precede.
 
   // MPEG frame headers are really confusing with irrelevant binary data.
-  // So we check if a frame header is really valid.
-
-  long headerOffset;
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), true, &headerOffset);
-
-  const long originalPosition = stream->tell();
-  AdapterFile file(stream);
-
-  for(unsigned int i = 0; i < buffer.size() - 1; ++i) {
-    if(isFrameSync(buffer, i)) {
-      const Header header(&file, headerOffset + i, true);
-      if(header.isValid()) {
-        stream->seek(originalPosition);
-        return true;
-      }
-    }
-  }
+  // So we check if a frame header is really valid.  The buffer holds the
+  // header of the frame that follows any frame found in the first
+  // bufferSize() bytes.
 
-  stream->seek(originalPosition);
-  return false;
+  const ByteVector buffer = Utils::readHeader(stream, bufferSize() + FrameLookahead, true);
+  return (Utils::findMPEGSignature(buffer, bufferSize()) >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-MPEG::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+MPEG::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 MPEG::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
+}
+
+MPEG::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
+                 bool readProperties, Properties::ReadStyle propertiesStyle,
+                 PictureReading pictureReading) :
+  TagLib::File(file),
+  d(new FilePrivate(frameFactory))
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties, propertiesStyle);
+}
+
+MPEG::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
+                 bool readProperties, Properties::ReadStyle propertiesStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate(frameFactory))
+{
+  if(isOpen())
+    read(readProperties, propertiesStyle);
 }
 
 MPEG::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle propertiesStyle,
+                 PictureReading pictureReading) :
   TagLib::File(stream),
   d(new FilePrivate(frameFactory))
 {
+  setPictureReading(pictureReading);
+
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 MPEG::File::~File()
@@ -217,6 +211,8 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplica
     return false;
   }
 
+  SaveScope scope(this);
+
   // Create the tags if we've been asked to.
 
   if(duplicateTags) {
@@ -245,7 +241,10 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplica
       if(d->ID3v2Location < 0)
         d->ID3v2Location = 0;
 
-      const ByteVector data = ID3v2Tag()->render(id3v2Version);
+      ID3v2::Tag *tag = ID3v2Tag();
+      tag->setPadding(minimumPadding(tag->minimumPadding()), maximumPadding(tag->maximumPadding()));
+
+      const ByteVector data = tag->render(id3v2Version);
       insert(data, d->ID3v2Location, d->ID3v2OriginalSize);
 
       if(d->APELocation >= 0)
@@ -317,7 +316,7 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplica
     }
   }
 
-  return true;
+  return scope.finish();
 }
 
 ID3v2::Tag *MPEG::File::ID3v2Tag(bool create)
@@ -347,6 +346,8 @@ bool MPEG::File::strip(int tags, bool freeMemory)
     return false;
   }
 
+  SaveScope scope(this);
+
   if((tags & ID3v2) && d->ID3v2Location >= 0) {
     removeBlock(d->ID3v2Location, d->ID3v2OriginalSize);
 
@@ -385,7 +386,7 @@ bool MPEG::File::strip(int tags, bool freeMemory)
       d->tag.set(APEIndex, 0);
   }
 
-  return true;
+  return scope.finish();
 }
 
 void MPEG::File::setID3v2FrameFactory(const ID3v2::FrameFactory *factory)
@@ -395,48 +396,33 @@ void MPEG::File::setID3v2FrameFactory(const ID3v2::FrameFactory *factory)
 
 long MPEG::File::nextFrameOffset(long position)
 {
-  ByteVector frameSyncBytes(2, '\0');
-
-  while(true) {
-    seek(position);
-    const ByteVector buffer = readBlock(bufferSize());
-    if(buffer.isEmpty())
-      return -1;
-
-    for(unsigned int i = 0; i < buffer.size(); ++i) {
-      frameSyncBytes[0] = frameSyncBytes[1];
-      frameSyncBytes[1] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        const Header header(this, position + i - 1, true);
-        if(header.isValid())
-          return position + i - 1;
-      }
-    }
-
-    position += bufferSize();
-  }
+  return scanForward(position, 0);
 }
 
 long MPEG::File::previousFrameOffset(long position)
 {
-  ByteVector frameSyncBytes(2, '\0');
+  // A frame is looked for before the last byte, and the blocks are read with
+  // enough data after them to check the frames near their end.
 
-  while(position > 0) {
-    const long bufferLength = std::min<long>(position, bufferSize());
-    position -= bufferLength;
+  long end = position - 1;
+  unsigned int bufferLength = initialBufferSize();
 
-    seek(position);
-    const ByteVector buffer = readBlock(bufferLength);
+  while(end > 0) {
+    const long start = std::max<long>(end - bufferLength, 0);
+    bufferLength = nextBufferSize(bufferLength);
 
-    for(int i = buffer.size() - 1; i >= 0; --i) {
-      frameSyncBytes[1] = frameSyncBytes[0];
-      frameSyncBytes[0] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        const Header header(this, position + i, true);
-        if(header.isValid())
-          return position + i + header.frameLength();
-      }
+    seek(start);
+    const ByteVector buffer = readBlock(end - start + FrameLookahead);
+    const long searchLength = std::min<long>(end - start, buffer.size());
+
+    for(long i = searchLength - 1; i >= 0; --i) {
+      const unsigned int offset = static_cast<unsigned int>(i);
+      if(static_cast<unsigned char>(buffer[offset]) == 0xFF
+         && checkFrame(buffer, offset, true) == ValidFrame)
+        return start + i + frameLength(buffer.data() + offset);
     }
+
+    end = start;
   }
 
   return -1;
@@ -466,6 +452,11 @@ long MPEG::File::lastFrameOffset()
   return previousFrameOffset(position);
 }
 
+MPEG::SeekIndex MPEG::File::seekIndex(Properties::ReadStyle style, unsigned int frameInterval)
+{
+  return SeekIndex(this, style, frameInterval);
+}
+
 bool MPEG::File::hasID3v1Tag() const
 {
   return (d->ID3v1Location >= 0);
@@ -485,7 +476,7 @@ bool MPEG::File::hasAPETag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPEG::File::read(bool readProperties)
+void MPEG::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v2 tag
 
@@ -514,7 +505,7 @@ void MPEG::File::read(bool readProperties)
   }
 
   if(readProperties)
-    d->properties = new Properties(this);
+    d->properties = new Properties(this, propertiesStyle);
 
   // Make sure that we have our default tag types available.
 
@@ -541,32 +532,64 @@ long MPEG::File::findID3v2()
 
   // Look for an ID3v2 tag until reaching the first valid MPEG frame.
 
-  ByteVector frameSyncBytes(2, '\0');
-  ByteVector tagHeaderBytes(3, '\0');
-  long position = 0;
+  long location = -1;
+  scanForward(0, &location);
+  return location;
+}
 
-  while(true) {
-    seek(position);
-    const ByteVector buffer = readBlock(bufferSize());
-    if(buffer.isEmpty())
-      return -1;
+long MPEG::File::scanForward(long position, long *tagLocation)
+{
+  // The file is read in growing blocks.  The part of a block that may start a
+  // frame or tag header which is continued in the next block is kept.
+
+  const ByteVector headerID = ID3v2::Header::fileIdentifier();
+
+  ByteVector buffer;
+  long bufferOffset = position;
+  unsigned int bufferLength = initialBufferSize();
+  bool atEnd = false;
+
+  while(!atEnd) {
+    seek(bufferOffset + buffer.size());
+    const ByteVector block = readBlock(bufferLength);
+    atEnd = block.isEmpty();
+    bufferLength = nextBufferSize(bufferLength);
+
+    buffer.append(block);
+
+    const int tag = tagLocation ? buffer.find(headerID) : -1;
+    const unsigned int searchLength = (tag >= 0) ? tag : buffer.size();
 
-    for(unsigned int i = 0; i < buffer.size(); ++i) {
-      frameSyncBytes[0] = frameSyncBytes[1];
-      frameSyncBytes[1] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        const Header header(this, position + i - 1, true);
-        if(header.isValid())
-          return -1;
+    unsigned int i = 0;
+    while(i < searchLength) {
+      const int sync = buffer.find('\xFF', i);
+      if(sync < 0 || static_cast<unsigned int>(sync) >= searchLength) {
+        i = searchLength;
+        break;
       }
 
-      tagHeaderBytes[0] = tagHeaderBytes[1];
-      tagHeaderBytes[1] = tagHeaderBytes[2];
-      tagHeaderBytes[2] = buffer[i];
-      if(tagHeaderBytes == headerID)
-        return position + i - 2;
+      i = sync;
+
+      const FrameCheck check = checkFrame(buffer, i, atEnd);
+      if(check == ValidFrame)
+        return bufferOffset + i;
+      if(check == NeedMoreData)
+        break;
+
+      ++i;
+    }
+
+    if(tag >= 0 && i == searchLength) {
+      *tagLocation = bufferOffset + tag;
+      return -1;
     }
 
-    position += bufferSize();
+    if(tagLocation)
+      i = std::min<unsigned int>(i, buffer.size() - std::min<unsigned int>(buffer.size(), headerID.size() - 1));
+
+    buffer = buffer.mid(i);
+    bufferOffset += i;
   }
+
+  return -1;
 }
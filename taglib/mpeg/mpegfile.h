@@ -31,6 +31,7 @@
 #include "tag.h"
 
 #include "mpegproperties.h"
+#include "mpegseekindex.h"
 
 namespace TagLib {
 
@@ -74,7 +75,8 @@ namespace TagLib {
        * Constructs an MPEG file from \a file.  If \a readProperties is true the
        * file's audio properties will also be read.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * If \a propertiesStyle is Properties::Accurate, all the frames are read
+       * to find the length of the stream.
        *
        * \deprecated This constructor will be dropped in favor of the one below
        * in a future version.
@@ -89,13 +91,26 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * If \a propertiesStyle is Properties::Accurate, all the frames are read
+       * to find the length of the stream.
        */
       // BIC: merge with the above constructor
       File(FileName file, ID3v2::FrameFactory *frameFactory,
            bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an MPEG file from \a file.  This is the same as the
+       * constructor above, except that \a pictureReading sets whether the
+       * embedded pictures are read.
+       *
+       * \see TagLib::File::pictureReading()
+       */
+      File(FileName file, ID3v2::FrameFactory *frameFactory,
+           bool readProperties,
+           Properties::ReadStyle propertiesStyle,
+           PictureReading pictureReading);
+
       /*!
        * Constructs an MPEG file from \a stream.  If \a readProperties is true the
        * file's audio properties will also be read.
@@ -106,12 +121,25 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * If \a propertiesStyle is Properties::Accurate, all the frames are read
+       * to find the length of the stream.
        */
       File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
            bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an MPEG file from \a stream.  This is the same as the
+       * constructor above, except that \a pictureReading sets whether the
+       * embedded pictures are read.
+       *
+       * \see TagLib::File::pictureReading()
+       */
+      File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
+           bool readProperties,
+           Properties::ReadStyle propertiesStyle,
+           PictureReading pictureReading);
+
       /*!
        * Destroys this instance of the File.
        */
@@ -349,6 +377,17 @@ namespace TagLib {
        */
       long lastFrameOffset();
 
+      /*!
+       * Builds a seek index of the stream with a seek point for every
+       * \a frameInterval frames.  Unless \a style is Properties::Accurate, the
+       * table of contents of a Xing header is used if there is one, and the
+       * frames are not read.
+       *
+       * \see SeekIndex
+       */
+      SeekIndex seekIndex(Properties::ReadStyle style = Properties::Average,
+                          unsigned int frameInterval = 100);
+
       /*!
        * Returns whether or not the file on disk actually has an ID3v1 tag.
        *
@@ -383,8 +422,9 @@ namespace TagLib {
       File(const File &);
       File &operator=(const File &);
 
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle propertiesStyle);
       long findID3v2();
+      long scanForward(long position, long *tagLocation);
 
       class FilePrivate;
       FilePrivate *d;
@@ -28,6 +28,7 @@
 
 #include "mpegproperties.h"
 #include "mpegfile.h"
+#include "mpegseekindex.h"
 #include "xingheader.h"
 #include "apetag.h"
 #include "apefooter.h"
@@ -76,7 +77,7 @@ MPEG::Properties::Properties(File *file, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
-  read(file);
+  read(file, style);
 }
 
 MPEG::Properties::~Properties()
@@ -153,7 +154,7 @@ bool MPEG::Properties::isOriginal() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPEG::Properties::read(File *file)
+void MPEG::Properties::read(File *file, ReadStyle style)
 {
   // Only the first valid frame is required if we have a VBR header.
 
@@ -195,20 +196,43 @@ void MPEG::Properties::read(File *file)
 
     d->bitrate = firstHeader.bitrate();
 
-    // Look for the last MPEG audio frame to calculate the stream length.
+    long streamLength;
 
-    const long lastFrameOffset = file->lastFrameOffset();
-    if(lastFrameOffset < 0) {
-      debug("MPEG::Properties::read() -- Could not find an MPEG frame in the stream.");
-      return;
+    if(style == Fast) {
+
+      // Take everything up to the tags at the end of the file as audio, which
+      // were found without reading the frames.
+
+      long streamEnd = file->length();
+      if(file->hasID3v1Tag())
+        streamEnd -= 128;
+      if(file->hasAPETag())
+        streamEnd -= file->APETag()->footer()->completeTagSize();
+
+      streamLength = streamEnd - firstFrameOffset;
+      setEstimated(true);
+    }
+    else {
+
+      // Look for the last MPEG audio frame to calculate the stream length.
+
+      const long lastFrameOffset = file->lastFrameOffset();
+      if(lastFrameOffset < 0) {
+        debug("MPEG::Properties::read() -- Could not find an MPEG frame in the stream.");
+        return;
+      }
+
+      const Header lastHeader(file, lastFrameOffset, false);
+      streamLength = lastFrameOffset - firstFrameOffset + lastHeader.frameLength();
     }
 
-    const Header lastHeader(file, lastFrameOffset, false);
-    const long streamLength = lastFrameOffset - firstFrameOffset + lastHeader.frameLength();
     if(streamLength > 0)
       d->length = static_cast<int>(streamLength * 8.0 / d->bitrate + 0.5);
   }
 
+  if(style == Accurate)
+    readAccurately(file);
+
   d->sampleRate        = firstHeader.sampleRate();
   d->channels          = firstHeader.channelMode() == Header::SingleChannel ? 1 : 2;
   d->version           = firstHeader.version();
@@ -218,3 +242,28 @@ void MPEG::Properties::read(File *file)
   d->isCopyrighted     = firstHeader.isCopyrighted();
   d->isOriginal        = firstHeader.isOriginal();
 }
+
+void MPEG::Properties::readAccurately(File *file)
+{
+  // Neither the VBR header nor the bitrate of the first frame can be trusted,
+  // so every frame is counted.
+
+  const SeekIndex index(file, Accurate, 0);
+
+  long long samples = index.totalSamples();
+
+  // LAME records the silence that the encoder added at both ends.
+
+  if(d->xingHeader) {
+    const long long padding = d->xingHeader->encoderDelay() + d->xingHeader->encoderPadding();
+    if(samples > padding)
+      samples -= padding;
+  }
+
+  if(samples > 0 && index.sampleRate() > 0) {
+    const double length = samples * 1000.0 / index.sampleRate();
+
+    d->length  = static_cast<int>(length + 0.5);
+    d->bitrate = static_cast<int>(index.totalBytes() * 8.0 / length + 0.5);
+  }
+}
@@ -51,6 +51,14 @@ namespace TagLib {
       /*!
        * Create an instance of MPEG::Properties with the data read from the
        * MPEG::File \a file.
+       *
+       * Usually the length is taken from the Xing or VBRI header, or else
+       * calculated from the bitrate of the first frame.  If \a style is
+       * Accurate, the headers of all the frames are read instead, and the
+       * encoder delay and padding that LAME records are left out of the
+       * length.  This reads the whole stream.  If \a style is Fast and there is
+       * no VBR header, the length is estimated from the size of the file
+       * instead of looking for the last frame.
        */
       Properties(File *file, ReadStyle style = Average);
 
@@ -141,7 +149,8 @@ namespace TagLib {
       Properties(const Properties &);
       Properties &operator=(const Properties &);
 
-      void read(File *file);
+      void read(File *file, ReadStyle style);
+      void readAccurately(File *file);
 
       class PropertiesPrivate;
       PropertiesPrivate *d;
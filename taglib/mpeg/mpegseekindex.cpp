@@ -0,0 +1,399 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <vector>
+
+#include <tbytevector.h>
+#include <tstring.h>
+#include <tdebug.h>
+#include <trefcounter.h>
+
+#include "mpegseekindex.h"
+#include "mpegfile.h"
+#include "mpegutils.h"
+#include "xingheader.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // The frames are walked in blocks of this size, so that a frame takes no
+  // read of its own.
+
+  const unsigned int FrameWalkBlockSize = 64 * 1024;
+
+  // Layout of a rendered index: the identifier, a version and a flags byte,
+  // then the totals, then the seek points as differences to the one before.
+
+  const char SeekIndexID[] = "MPSI";
+  const unsigned char SeekIndexVersion = 1;
+  const unsigned char ApproximateFlag = 0x01;
+
+  const unsigned int HeaderSize = 36;
+  const unsigned int SeekPointSize = 10;
+
+  int averageBitrate(long long bytes, long long samples, int sampleRate)
+  {
+    if(samples <= 0 || sampleRate <= 0)
+      return 0;
+
+    return static_cast<int>(bytes * 8.0 * sampleRate / (samples * 1000.0) + 0.5);
+  }
+}
+
+class MPEG::SeekIndex::SeekIndexPrivate : public RefCounter
+{
+public:
+  SeekIndexPrivate() :
+    approximate(false),
+    frameInterval(0),
+    sampleRate(0),
+    totalSamples(0),
+    totalBytes(0) {}
+
+  bool approximate;
+  unsigned int frameInterval;
+  int sampleRate;
+  long long totalSamples;
+  long long totalBytes;
+  std::vector<SeekPoint> points;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+MPEG::SeekIndex::SeekIndex() :
+  d(new SeekIndexPrivate())
+{
+}
+
+MPEG::SeekIndex::SeekIndex(File *file, AudioProperties::ReadStyle style,
+                           unsigned int frameInterval) :
+  d(new SeekIndexPrivate())
+{
+  read(file, style, frameInterval);
+}
+
+MPEG::SeekIndex::SeekIndex(const ByteVector &data) :
+  d(new SeekIndexPrivate())
+{
+  parse(data);
+}
+
+MPEG::SeekIndex::SeekIndex(const SeekIndex &index) :
+  d(index.d)
+{
+  d->ref();
+}
+
+MPEG::SeekIndex::~SeekIndex()
+{
+  if(d->deref())
+    delete d;
+}
+
+MPEG::SeekIndex &MPEG::SeekIndex::operator=(const SeekIndex &index)
+{
+  if(&index == this)
+    return *this;
+
+  if(d->deref())
+    delete d;
+
+  d = index.d;
+  d->ref();
+  return *this;
+}
+
+bool MPEG::SeekIndex::isValid() const
+{
+  return !d->points.empty();
+}
+
+bool MPEG::SeekIndex::isApproximate() const
+{
+  return d->approximate;
+}
+
+unsigned int MPEG::SeekIndex::frameInterval() const
+{
+  return d->frameInterval;
+}
+
+int MPEG::SeekIndex::sampleRate() const
+{
+  return d->sampleRate;
+}
+
+long long MPEG::SeekIndex::totalSamples() const
+{
+  return d->totalSamples;
+}
+
+long long MPEG::SeekIndex::totalBytes() const
+{
+  return d->totalBytes;
+}
+
+MPEG::SeekIndex::SeekPointList MPEG::SeekIndex::seekPoints() const
+{
+  SeekPointList l;
+  for(std::vector<SeekPoint>::const_iterator it = d->points.begin(); it != d->points.end(); ++it)
+    l.append(*it);
+
+  return l;
+}
+
+MPEG::SeekIndex::SeekPoint MPEG::SeekIndex::find(long long sample) const
+{
+  if(d->points.empty())
+    return SeekPoint(-1, 0, 0);
+
+  // Binary search for the last point that does not start after the sample.
+
+  size_t first = 0;
+  size_t last = d->points.size();
+
+  while(last - first > 1) {
+    const size_t middle = first + (last - first) / 2;
+    if(d->points[middle].sample <= sample)
+      first = middle;
+    else
+      last = middle;
+  }
+
+  return d->points[first];
+}
+
+ByteVector MPEG::SeekIndex::render() const
+{
+  ByteVector data(SeekIndexID);
+  data.append(static_cast<char>(SeekIndexVersion));
+  data.append(static_cast<char>(d->approximate ? ApproximateFlag : 0));
+  data.append(ByteVector(2, '\0'));
+  data.append(ByteVector::fromUInt(d->sampleRate));
+  data.append(ByteVector::fromUInt(d->frameInterval));
+  data.append(ByteVector::fromLongLong(d->totalSamples));
+  data.append(ByteVector::fromLongLong(d->totalBytes));
+  data.append(ByteVector::fromUInt(static_cast<unsigned int>(d->points.size())));
+
+  long long offset = 0;
+  long long sample = 0;
+
+  for(std::vector<SeekPoint>::const_iterator it = d->points.begin(); it != d->points.end(); ++it) {
+    const long long offsetStep = it->offset - offset;
+    const long long sampleStep = it->sample - sample;
+
+    if(offsetStep < 0 || offsetStep > 0xFFFFFFFFLL || sampleStep < 0 || sampleStep > 0xFFFFFFFFLL) {
+      debug("MPEG::SeekIndex::render() -- The seek points are too far apart to be rendered.");
+      return ByteVector();
+    }
+
+    data.append(ByteVector::fromUInt(static_cast<unsigned int>(offsetStep)));
+    data.append(ByteVector::fromUInt(static_cast<unsigned int>(sampleStep)));
+    data.append(ByteVector::fromShort(static_cast<short>(it->bitrate)));
+
+    offset = it->offset;
+    sample = it->sample;
+  }
+
+  return data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void MPEG::SeekIndex::read(File *file, AudioProperties::ReadStyle style,
+                           unsigned int frameInterval)
+{
+  const long firstFrameOffset = file->firstFrameOffset();
+  if(firstFrameOffset < 0) {
+    debug("MPEG::SeekIndex::read() -- Could not find an MPEG frame in the stream.");
+    return;
+  }
+
+  const Header firstHeader(file, firstFrameOffset, false);
+  if(!firstHeader.isValid() || firstHeader.sampleRate() <= 0)
+    return;
+
+  d->sampleRate = firstHeader.sampleRate();
+
+  file->seek(firstFrameOffset);
+  const ByteVector firstFrame = file->readBlock(firstHeader.frameLength());
+  if(firstFrame.size() < 4)
+    return;
+
+  const XingHeader xingHeader(firstFrame);
+
+  // The table of contents of a Xing header holds the position of every
+  // percent of the stream, as a fraction of the stream size in 1/256.
+
+  const ByteVector toc = xingHeader.tableOfContents();
+
+  if(style != AudioProperties::Accurate && xingHeader.isValid() && toc.size() == 100) {
+    bool ordered = true;
+    for(unsigned int i = 1; i < toc.size(); ++i) {
+      if(static_cast<unsigned char>(toc[i]) < static_cast<unsigned char>(toc[i - 1]))
+        ordered = false;
+    }
+
+    if(ordered) {
+      const long long totalSamples
+        = static_cast<long long>(xingHeader.totalFrames()) * firstHeader.samplesPerFrame();
+      const long long totalSize = xingHeader.totalSize();
+
+      for(unsigned int i = 0; i < toc.size(); ++i) {
+        const long long offset
+          = firstFrameOffset + static_cast<unsigned char>(toc[i]) * totalSize / 256;
+        d->points.push_back(SeekPoint(offset, totalSamples * i / 100, 0));
+      }
+
+      for(size_t i = 0; i < d->points.size(); ++i) {
+        const bool isLast = (i + 1 == d->points.size());
+        const long long nextOffset = isLast ? firstFrameOffset + totalSize : d->points[i + 1].offset;
+        const long long nextSample = isLast ? totalSamples : d->points[i + 1].sample;
+
+        d->points[i].bitrate = averageBitrate(nextOffset - d->points[i].offset,
+                                              nextSample - d->points[i].sample,
+                                              d->sampleRate);
+      }
+
+      d->approximate  = true;
+      d->totalSamples = totalSamples;
+      d->totalBytes   = totalSize;
+      return;
+    }
+
+    debug("MPEG::SeekIndex::read() -- The Xing table of contents is not in order.");
+  }
+
+  // Walk the frames from one header to the next, the way a decoder does.
+  // Damaged data between frames is skipped.  The frame that holds the VBR
+  // header is not audio.
+
+  long offset = firstFrameOffset;
+  if(xingHeader.isValid())
+    offset += firstHeader.frameLength();
+
+  long end = file->length();
+
+  const long lastFrameOffset = file->lastFrameOffset();
+  if(lastFrameOffset >= 0)
+    end = lastFrameOffset + Header(file, lastFrameOffset, false).frameLength();
+
+  const int samplesPerFrame = firstHeader.samplesPerFrame();
+
+  d->frameInterval = frameInterval;
+
+  ByteVector block;
+  long blockOffset = 0;
+
+  unsigned long long frames = 0;
+  long long pointBytes = 0;
+
+  while(offset < end) {
+    if(offset < blockOffset || offset + 4 > blockOffset + static_cast<long>(block.size())) {
+      file->seek(offset);
+      block = file->readBlock(FrameWalkBlockSize);
+      blockOffset = offset;
+
+      if(block.size() < 4)
+        break;
+    }
+
+    const char *header = block.data() + (offset - blockOffset);
+    const int length = frameLength(header);
+
+    if(length == 0 || !isSameStream(header, firstFrame.data())) {
+      offset = file->nextFrameOffset(offset + 1);
+      if(offset < 0)
+        break;
+
+      continue;
+    }
+
+    if(frameInterval > 0 && frames % frameInterval == 0) {
+      if(!d->points.empty()) {
+        SeekPoint &last = d->points.back();
+        last.bitrate = averageBitrate(d->totalBytes - pointBytes,
+                                      d->totalSamples - last.sample, d->sampleRate);
+      }
+
+      d->points.push_back(SeekPoint(offset, d->totalSamples, 0));
+      pointBytes = d->totalBytes;
+    }
+
+    ++frames;
+    d->totalSamples += samplesPerFrame;
+    d->totalBytes += length;
+    offset += length;
+  }
+
+  if(!d->points.empty()) {
+    SeekPoint &last = d->points.back();
+    last.bitrate = averageBitrate(d->totalBytes - pointBytes,
+                                  d->totalSamples - last.sample, d->sampleRate);
+  }
+}
+
+void MPEG::SeekIndex::parse(const ByteVector &data)
+{
+  if(data.size() < HeaderSize || !data.startsWith(SeekIndexID)) {
+    debug("MPEG::SeekIndex::parse() -- Not a seek index.");
+    return;
+  }
+
+  if(static_cast<unsigned char>(data[4]) != SeekIndexVersion) {
+    debug("MPEG::SeekIndex::parse() -- Unsupported seek index version.");
+    return;
+  }
+
+  const unsigned int count = data.toUInt(32U, true);
+  if((data.size() - HeaderSize) / SeekPointSize < count) {
+    debug("MPEG::SeekIndex::parse() -- The seek index is truncated.");
+    return;
+  }
+
+  d->approximate   = (data[5] & ApproximateFlag) != 0;
+  d->sampleRate    = static_cast<int>(data.toUInt(8U, true));
+  d->frameInterval = data.toUInt(12U, true);
+  d->totalSamples  = data.toLongLong(16U, true);
+  d->totalBytes    = data.toLongLong(24U, true);
+
+  long long offset = 0;
+  long long sample = 0;
+
+  d->points.reserve(count);
+
+  for(unsigned int i = 0; i < count; ++i) {
+    const unsigned int pos = HeaderSize + i * SeekPointSize;
+
+    offset += data.toUInt(pos, true);
+    sample += data.toUInt(pos + 4, true);
+    d->points.push_back(SeekPoint(offset, sample, data.toUShort(pos + 8, true)));
+  }
+}
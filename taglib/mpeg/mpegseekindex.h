@@ -0,0 +1,194 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MPEGSEEKINDEX_H
+#define TAGLIB_MPEGSEEKINDEX_H
+
+#include "taglib_export.h"
+#include "tlist.h"
+#include "audioproperties.h"
+
+#include "mpegheader.h"
+
+namespace TagLib {
+
+  class ByteVector;
+
+  namespace MPEG {
+
+    class File;
+
+    //! A table that maps sample positions of an MPEG stream to byte offsets
+
+    /*!
+     * This holds a seek point for every few frames of an MPEG stream, so that
+     * a player or a server can find the frame that holds a given sample
+     * without reading the frames before it.
+     *
+     * The index is either built by reading the header of every frame, which
+     * is exact, or taken from the table of contents in a Xing header, which
+     * only has 100 entries and is as good as the encoder that wrote it.
+     *
+     * The index can be rendered to a small block of data and read back, so
+     * that it only needs to be built once for a file.
+     */
+
+    class TAGLIB_EXPORT SeekIndex
+    {
+    public:
+
+      /*!
+       * A position in the stream.
+       */
+      struct SeekPoint {
+        SeekPoint(long long o, long long s, int b) : offset(o), sample(s), bitrate(b) {}
+        /*!
+         * The position in the file of the frame that starts at this point.
+         */
+        long long offset;
+        /*!
+         * The number of samples in the stream before this point.
+         */
+        long long sample;
+        /*!
+         * The average bitrate in kb/s from this point to the next one.
+         */
+        int bitrate;
+      };
+
+      /*!
+       * List of seek points.
+       */
+      typedef TagLib::List<SeekPoint> SeekPointList;
+
+      /*!
+       * Constructs an empty seek index.
+       */
+      SeekIndex();
+
+      /*!
+       * Builds the seek index of the MPEG stream in \a file, with a seek point
+       * for every \a frameInterval frames.
+       *
+       * If \a style is not AudioProperties::Accurate and the stream starts
+       * with a Xing header that has a table of contents, the index is taken
+       * from that table and \a frameInterval is not used.  Otherwise the
+       * headers of all the frames are read in a single pass.
+       *
+       * The first frame of the index is the first audio frame; a frame that
+       * holds a Xing or VBRI header is left out.  If \a frameInterval is 0,
+       * only the totals are counted.
+       */
+      SeekIndex(File *file, AudioProperties::ReadStyle style = AudioProperties::Average,
+                unsigned int frameInterval = 100);
+
+      /*!
+       * Reads a seek index from \a data, which was created by render().  If
+       * \a data is not a valid index, the index is empty.
+       */
+      explicit SeekIndex(const ByteVector &data);
+
+      /*!
+       * Makes a shallow copy of \a index.
+       */
+      SeekIndex(const SeekIndex &index);
+
+      /*!
+       * Destroys this SeekIndex instance.
+       */
+      virtual ~SeekIndex();
+
+      /*!
+       * Makes a shallow copy of \a index.
+       */
+      SeekIndex &operator=(const SeekIndex &index);
+
+      /*!
+       * Returns true if the index has at least one seek point.
+       */
+      bool isValid() const;
+
+      /*!
+       * Returns true if the index was taken from a Xing table of contents, in
+       * which case the seek points are estimates and do not have to fall on
+       * the start of a frame.
+       */
+      bool isApproximate() const;
+
+      /*!
+       * Returns the number of frames between two seek points, or 0 if the
+       * index was taken from a Xing table of contents.
+       */
+      unsigned int frameInterval() const;
+
+      /*!
+       * Returns the sample rate of the stream in Hz.
+       */
+      int sampleRate() const;
+
+      /*!
+       * Returns the number of samples in the stream.  This includes the
+       * encoder delay and padding.
+       *
+       * \see XingHeader::encoderDelay()
+       * \see XingHeader::encoderPadding()
+       */
+      long long totalSamples() const;
+
+      /*!
+       * Returns the number of bytes in the audio frames of the stream.
+       */
+      long long totalBytes() const;
+
+      /*!
+       * Returns the seek points, in the order of the stream.
+       */
+      SeekPointList seekPoints() const;
+
+      /*!
+       * Returns the last seek point at or before \a sample.  Decoding from
+       * this point reaches \a sample after the fewest frames.
+       *
+       * If the index is empty, the offset of the returned point is -1.
+       */
+      SeekPoint find(long long sample) const;
+
+      /*!
+       * Renders the index to a block of data that can be read back with
+       * SeekIndex(const ByteVector &).
+       */
+      ByteVector render() const;
+
+    private:
+      void read(File *file, AudioProperties::ReadStyle style, unsigned int frameInterval);
+      void parse(const ByteVector &data);
+
+      class SeekIndexPrivate;
+      SeekIndexPrivate *d;
+    };
+  }
+}
+
+#endif
@@ -54,6 +54,161 @@ namespace TagLib
         return (b1 == 0xFF && b2 != 0xFF && (b2 & 0xE0) == 0xE0);
       }
 
+      /*!
+       * Returns the bitrate in kb/s for the bitrate index of a frame header,
+       * or 0 if the index is not valid.  \a version is 0 for MPEG-1, 1 for
+       * MPEG-2 and 2 for MPEG-2.5, \a layer is 1 to 3.
+       */
+      inline int bitrate(int version, int layer, int bitrateIndex)
+      {
+        static const int bitrates[2][3][16] = {
+          { // Version 1
+            { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 }, // layer 1
+            { 0, 32, 48, 56, 64,  80,  96,  112, 128, 160, 192, 224, 256, 320, 384, 0 }, // layer 2
+            { 0, 32, 40, 48, 56,  64,  80,  96,  112, 128, 160, 192, 224, 256, 320, 0 }  // layer 3
+          },
+          { // Version 2 or 2.5
+            { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0 }, // layer 1
+            { 0, 8,  16, 24, 32, 40, 48, 56,  64,  80,  96,  112, 128, 144, 160, 0 }, // layer 2
+            { 0, 8,  16, 24, 32, 40, 48, 56,  64,  80,  96,  112, 128, 144, 160, 0 }  // layer 3
+          }
+        };
+
+        return bitrates[version == 0 ? 0 : 1][layer - 1][bitrateIndex];
+      }
+
+      /*!
+       * Returns the sample rate for the sample rate index of a frame header,
+       * or 0 if the index is not valid.
+       */
+      inline int sampleRate(int version, int sampleRateIndex)
+      {
+        static const int sampleRates[3][4] = {
+          { 44100, 48000, 32000, 0 }, // Version 1
+          { 22050, 24000, 16000, 0 }, // Version 2
+          { 11025, 12000, 8000,  0 }  // Version 2.5
+        };
+
+        return sampleRates[version][sampleRateIndex];
+      }
+
+      /*!
+       * Returns the number of samples in a frame.
+       */
+      inline int samplesPerFrame(int version, int layer)
+      {
+        static const int samplesPerFrame[3][2] = {
+          // MPEG1, 2/2.5
+          {  384,   384 }, // Layer I
+          { 1152,  1152 }, // Layer II
+          { 1152,   576 }  // Layer III
+        };
+
+        return samplesPerFrame[layer - 1][version == 0 ? 0 : 1];
+      }
+
+      /*!
+       * Returns the length of a frame in bytes.
+       */
+      inline int frameLength(int layer, int samplesPerFrame, int bitrate, int sampleRate,
+                             bool isPadded)
+      {
+        static const int paddingSize[3] = { 4, 1, 1 };
+
+        int length = samplesPerFrame * bitrate * 125 / sampleRate;
+        if(isPadded)
+          length += paddingSize[layer - 1];
+
+        return length;
+      }
+
+      /*!
+       * Returns the length of the frame whose header is the four bytes at
+       * \a data, or 0 if they are not a valid frame header.  This makes the
+       * same checks as MPEG::Header, without reading anything else.
+       *
+       * \note This does not check the length of the data, since this is an
+       * internal utility function.
+       */
+      inline int frameLength(const char *data)
+      {
+        const unsigned char b1 = data[1];
+        const unsigned char b2 = data[2];
+
+        if(static_cast<unsigned char>(data[0]) != 0xFF || b1 == 0xFF || (b1 & 0xE0) != 0xE0)
+          return 0;
+
+        static const int versions[4] = { 2, -1, 1, 0 };
+        const int version = versions[(b1 >> 3) & 0x03];
+        const int layer = 4 - ((b1 >> 1) & 0x03);
+
+        if(version < 0 || layer > 3)
+          return 0;
+
+        const int rate = bitrate(version, layer, (b2 >> 4) & 0x0F);
+        const int frequency = sampleRate(version, (b2 >> 2) & 0x03);
+
+        if(rate == 0 || frequency == 0)
+          return 0;
+
+        return frameLength(layer, samplesPerFrame(version, layer), rate, frequency,
+                           (b2 & 0x02) != 0);
+      }
+
+      /*!
+       * Returns true if the frame headers at \a data1 and \a data2 have the
+       * same MPEG version, layer and sample rate.  Two frames that follow each
+       * other should have, otherwise either or both of them are broken.
+       *
+       * \note This does not check the length of the data, since this is an
+       * internal utility function.
+       */
+      inline bool isSameStream(const char *data1, const char *data2)
+      {
+        // Sync bits, version, layer and sample rate: 0xfffe0c00.
+
+        static const unsigned char mask[4] = { 0xFF, 0xFE, 0x0C, 0x00 };
+
+        for(int i = 0; i < 3; ++i) {
+          if((data1[i] & mask[i]) != (data2[i] & mask[i]))
+            return false;
+        }
+
+        return true;
+      }
+
+      /*!
+       * Frame sync candidates are checked against the data that has already
+       * been read, including the header of the frame that should follow.  A
+       * frame is never longer than 2881 bytes, so that header is within this
+       * distance.
+       */
+      const unsigned int FrameLookahead = 4096;
+
+      enum FrameCheck { InvalidFrame, ValidFrame, NeedMoreData };
+
+      /*!
+       * Checks the frame at \a offset in \a data the same way as MPEG::Header
+       * with checkLength set.  If \a atEnd is false, the data may be continued.
+       */
+      inline FrameCheck checkFrame(const ByteVector &data, unsigned int offset, bool atEnd)
+      {
+        if(offset + 4 > data.size())
+          return atEnd ? InvalidFrame : NeedMoreData;
+
+        const int length = frameLength(data.data() + offset);
+        if(length == 0)
+          return InvalidFrame;
+
+        if(offset + length + 4 > data.size())
+          return atEnd ? InvalidFrame : NeedMoreData;
+
+        if(!isSameStream(data.data() + offset, data.data() + offset + length))
+          return InvalidFrame;
+
+        return ValidFrame;
+      }
+
     }
   }
 }
@@ -38,12 +38,19 @@ public:
   XingHeaderPrivate() :
     frames(0),
     size(0),
-    type(MPEG::XingHeader::Invalid) {}
+    type(MPEG::XingHeader::Invalid),
+    encoderDelay(0),
+    encoderPadding(0) {}
 
   unsigned int frames;
   unsigned int size;
 
   MPEG::XingHeader::HeaderType type;
+
+  int encoderDelay;
+  int encoderPadding;
+
+  ByteVector tableOfContents;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -81,6 +88,21 @@ MPEG::XingHeader::HeaderType MPEG::XingHeader::type() const
   return d->type;
 }
 
+int MPEG::XingHeader::encoderDelay() const
+{
+  return d->encoderDelay;
+}
+
+int MPEG::XingHeader::encoderPadding() const
+{
+  return d->encoderPadding;
+}
+
+ByteVector MPEG::XingHeader::tableOfContents() const
+{
+  return d->tableOfContents;
+}
+
 int MPEG::XingHeader::xingHeaderOffset(TagLib::MPEG::Header::Version /*v*/,
                                        TagLib::MPEG::Header::ChannelMode /*c*/)
 {
@@ -116,6 +138,30 @@ void MPEG::XingHeader::parse(const ByteVector &data)
     d->frames = data.toUInt(offset + 8,  true);
     d->size   = data.toUInt(offset + 12, true);
     d->type   = Xing;
+
+    const unsigned char flags = data[offset + 7];
+
+    if((flags & 0x04) && data.size() >= static_cast<unsigned long>(offset + 116))
+      d->tableOfContents = data.mid(offset + 16, 100);
+
+    // The LAME extension follows the optional TOC and quality fields.  Its
+    // encoder delay and padding are two 12-bit values at offset 21.  FFmpeg
+    // writes the same extension with its own encoder name.
+
+    long lameOffset = offset + 16;
+    if(flags & 0x04)
+      lameOffset += 100;
+    if(flags & 0x08)
+      lameOffset += 4;
+
+    if(data.size() >= static_cast<unsigned long>(lameOffset + 24)) {
+      const ByteVector encoder = data.mid(lameOffset, 4);
+      if(encoder == "LAME" || encoder == "Lavc" || encoder == "Lavf") {
+        const unsigned int bits = data.toUInt(lameOffset + 21, 3, true);
+        d->encoderDelay   = (bits >> 12) & 0x0FFF;
+        d->encoderPadding = bits & 0x0FFF;
+      }
+    }
   }
   else {
 
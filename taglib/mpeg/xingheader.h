@@ -105,6 +105,28 @@ namespace TagLib {
        */
       HeaderType type() const;
 
+      /*!
+       * Returns the number of samples that the encoder added at the start of
+       * the stream, as written by LAME in its extension of the Xing header.
+       * Returns 0 if it is not known.
+       */
+      int encoderDelay() const;
+
+      /*!
+       * Returns the number of samples that the encoder added at the end of
+       * the stream, as written by LAME in its extension of the Xing header.
+       * Returns 0 if it is not known.
+       */
+      int encoderPadding() const;
+
+      /*!
+       * Returns the table of contents of a Xing header: 100 bytes, one for
+       * every percent of the playing time, that hold the position in the
+       * stream as a fraction of totalSize() in 1/256.  Returns an empty
+       * ByteVector if there is no table of contents.
+       */
+      ByteVector tableOfContents() const;
+
       /*!
        * Returns the offset for the start of this Xing header, given the
        * version and channels of the frame
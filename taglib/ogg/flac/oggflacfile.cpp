@@ -75,7 +75,7 @@ bool Ogg::FLAC::File::isSupported(IOStream *stream)
   // An Ogg FLAC file has IDs "OggS" and "fLaC" somewhere.
 
   const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
-  return (buffer.find("OggS") >= 0 && buffer.find("fLaC") >= 0);
+  return (Utils::findOggSignature(buffer, "fLaC") >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -91,6 +91,18 @@ Ogg::FLAC::File::File(FileName file, bool readProperties,
     read(readProperties, propertiesStyle);
 }
 
+Ogg::FLAC::File::File(FileName file, bool readProperties,
+                      Properties::ReadStyle propertiesStyle,
+                      PictureReading pictureReading) :
+  Ogg::File(file),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties, propertiesStyle);
+}
+
 Ogg::FLAC::File::File(IOStream *stream, bool readProperties,
                       Properties::ReadStyle propertiesStyle) :
   Ogg::File(stream),
@@ -100,6 +112,18 @@ Ogg::FLAC::File::File(IOStream *stream, bool readProperties,
     read(readProperties, propertiesStyle);
 }
 
+Ogg::FLAC::File::File(IOStream *stream, bool readProperties,
+                      Properties::ReadStyle propertiesStyle,
+                      PictureReading pictureReading) :
+  Ogg::File(stream),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties, propertiesStyle);
+}
+
 Ogg::FLAC::File::~File()
 {
   delete d;
@@ -185,7 +209,7 @@ void Ogg::FLAC::File::read(bool readProperties, Properties::ReadStyle properties
 
 
   if(d->hasXiphComment)
-    d->comment = new Ogg::XiphComment(xiphCommentData());
+    d->comment = new Ogg::XiphComment(xiphCommentData(), pictureReading());
   else
     d->comment = new Ogg::XiphComment();
 
@@ -72,6 +72,17 @@ namespace TagLib {
       File(FileName file, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an Ogg FLAC file from \a file.  This is the same as the
+       * constructor above, except that \a pictureReading sets whether the
+       * embedded pictures are read.
+       *
+       * \see TagLib::File::pictureReading()
+       */
+      File(FileName file, bool readProperties,
+           Properties::ReadStyle propertiesStyle,
+           PictureReading pictureReading);
+
       /*!
        * Constructs an Ogg/FLAC file from \a stream.  If \a readProperties is true
        * the file's audio properties will also be read.
@@ -84,6 +95,17 @@ namespace TagLib {
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an Ogg FLAC file from \a stream.  This is the same as the
+       * constructor above, except that \a pictureReading sets whether the
+       * embedded pictures are read.
+       *
+       * \see TagLib::File::pictureReading()
+       */
+      File(IOStream *stream, bool readProperties,
+           Properties::ReadStyle propertiesStyle,
+           PictureReading pictureReading);
+
       /*!
        * Destroys this instance of the File.
        */
@@ -27,6 +27,8 @@
 #include <tmap.h>
 #include <tstring.h>
 #include <tdebug.h>
+#include <tagutils.h>
+#include <tcrc.h>
 
 #include "oggfile.h"
 #include "oggpage.h"
@@ -44,6 +46,127 @@ namespace
     else
       return page->firstPacketIndex() + page->packetCount() - 1;
   }
+
+  // Lays out the packets over exactly pageCount pages of about the same size,
+  // so that the pages that follow keep their sequence numbers.  Returns an
+  // empty list if they don't fit.
+
+  List<Ogg::Page *> paginateInto(const ByteVectorList &packets,
+                                 unsigned int pageCount,
+                                 unsigned int streamSerialNumber,
+                                 int firstPage,
+                                 bool firstPacketContinued)
+  {
+    List<Ogg::Page *> pages;
+
+    size_t totalSize = 0;
+    for(ByteVectorList::ConstIterator it = packets.begin(); it != packets.end(); ++it)
+      totalSize += it->size();
+
+    if(pageCount == 0 || totalSize < pageCount)
+      return pages;
+
+    // A page holds the pieces of the packets that fit into pageSize bytes.  The
+    // piece of a packet that continues on the next page must be a multiple of
+    // 255 bytes, and each packet that ends on a page takes one more lacing value.
+
+    const size_t pageSize = (totalSize + pageCount - 1) / pageCount;
+    const size_t alignedSize = (pageSize + 254) / 255 * 255;
+
+    if(alignedSize / 255 + packets.size() > 255)
+      return pages;
+
+    List<ByteVectorList> groups;
+    List<bool> continued;
+
+    ByteVectorList group;
+    size_t space = alignedSize;
+    bool groupContinued = firstPacketContinued;
+
+    for(ByteVectorList::ConstIterator it = packets.begin(); it != packets.end(); ++it) {
+      unsigned int pos = 0;
+      do {
+        const size_t left = it->size() - pos;
+        const size_t size = (left <= space) ? left : space / 255 * 255;
+
+        if(size > 0 || left == 0) {
+          group.append(it->mid(pos, static_cast<unsigned int>(size)));
+          pos += static_cast<unsigned int>(size);
+          space -= size;
+        }
+
+        if(pos < it->size()) {
+          groups.append(group);
+          continued.append(groupContinued);
+          group.clear();
+          space = alignedSize;
+          groupContinued = (pos > 0);
+        }
+      } while(pos < it->size());
+    }
+
+    if(!group.isEmpty()) {
+      groups.append(group);
+      continued.append(groupContinued);
+    }
+
+    if(groups.size() != pageCount)
+      return pages;
+
+    List<bool>::ConstIterator continuedIt = continued.begin();
+    int pageIndex = firstPage;
+
+    for(List<ByteVectorList>::ConstIterator it = groups.begin(); it != groups.end(); ++it) {
+      const bool firstContinued = *continuedIt;
+      const bool lastCompleted = (++continuedIt == continued.end()) || !*continuedIt;
+
+      const List<Ogg::Page *> page = Ogg::Page::paginate(
+        *it, Ogg::Page::SinglePagePerGroup, streamSerialNumber, pageIndex++,
+        firstContinued, lastCompleted);
+
+      for(List<Ogg::Page *>::ConstIterator pageIt = page.begin(); pageIt != page.end(); ++pageIt)
+        pages.append(*pageIt);
+    }
+
+    return pages;
+  }
+
+  // Adds delta to the sequence numbers of the pages from offset on.  Only the
+  // headers are read: the checksums are updated for the new numbers without
+  // reading the packets.
+
+  void renumberPages(Ogg::File *file, long offset, int delta)
+  {
+    while(true) {
+      file->seek(offset);
+      const ByteVector header = file->readBlock(27 + 255);
+
+      if(header.size() < 27 || !header.startsWith("OggS"))
+        break;
+
+      const unsigned int segmentCount = static_cast<unsigned char>(header[26]);
+      if(segmentCount < 1 || header.size() < 27 + segmentCount)
+        break;
+
+      unsigned int pageSize = 27 + segmentCount;
+      for(unsigned int i = 0; i < segmentCount; ++i)
+        pageSize += static_cast<unsigned char>(header[27 + i]);
+
+      const ByteVector number = ByteVector::fromUInt(header.toUInt(18, false) + delta, false);
+      const unsigned int checksum = CRC::replace(
+        header.toUInt(22, false), pageSize, 18, header.data() + 18, number.data(), 4);
+
+      file->seek(offset + 18);
+      file->writeBlock(number + ByteVector::fromUInt(checksum, false));
+
+      // The last page of the stream.
+
+      if(header[5] & 0x04)
+        break;
+
+      offset += pageSize;
+    }
+  }
 }
 
 class Ogg::File::FilePrivate
@@ -160,13 +283,15 @@ bool Ogg::File::save()
     return false;
   }
 
+  SaveScope scope(this);
+
   Map<unsigned int, ByteVector>::ConstIterator it;
   for(it = d->dirtyPackets.begin(); it != d->dirtyPackets.end(); ++it)
     writePacket(it->first, it->second);
 
   d->dirtyPackets.clear();
 
-  return true;
+  return scope.finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -185,6 +310,19 @@ Ogg::File::File(IOStream *stream) :
 {
 }
 
+ByteVector Ogg::File::paddedPacket(unsigned int i, const ByteVector &p)
+{
+  // Unlike ID3v2 and FLAC, the freed space is kept up to the maximum, not
+  // 1% of the file.
+
+  const long paddingSize = Utils::paddingSize(
+    packet(i).size(), p.size(), minimumPadding(0), maximumPadding(0));
+
+  ByteVector data(p);
+  data.resize(static_cast<unsigned int>(data.size() + paddingSize), '\0');
+  return data;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
@@ -270,6 +408,27 @@ void Ogg::File::writePacket(unsigned int i, const ByteVector &packet)
                                       lastPage->header()->lastPacketCompleted());
   pages.setAutoDelete(true);
 
+  // If padding is used to keep the packet in place, also try to keep the number
+  // of pages, which saves renumbering the rest of the stream.
+
+  const unsigned int originalPageCount
+    = lastPage->pageSequenceNumber() - firstPage->pageSequenceNumber() + 1;
+
+  if(pages.size() != originalPageCount &&
+     maximumPadding(0) > 0 &&
+     lastPage->header()->lastPacketCompleted())
+  {
+    List<Page *> samePages = paginateInto(packets,
+                                          originalPageCount,
+                                          firstPage->header()->streamSerialNumber(),
+                                          firstPage->pageSequenceNumber(),
+                                          firstPage->header()->firstPacketContinued());
+    if(!samePages.isEmpty()) {
+      samePages.setAutoDelete(true);
+      pages = samePages;
+    }
+  }
+
   // Write the pages.
 
   ByteVector data;
@@ -286,26 +445,8 @@ void Ogg::File::writePacket(unsigned int i, const ByteVector &packet)
   const int numberOfNewPages
     = pages.back()->pageSequenceNumber() - lastPage->pageSequenceNumber();
 
-  if(numberOfNewPages != 0) {
-    long pageOffset = originalOffset + data.size();
-
-    while(true) {
-      Page page(this, pageOffset);
-      if(!page.header()->isValid())
-        break;
-
-      page.setPageSequenceNumber(page.pageSequenceNumber() + numberOfNewPages);
-      const ByteVector data = page.render();
-
-      seek(pageOffset + 18);
-      writeBlock(data.mid(18, 8));
-
-      if(page.header()->lastPageOfStream())
-        break;
-
-      pageOffset += page.size();
-    }
-  }
+  if(numberOfNewPages != 0)
+    renumberPages(this, originalOffset + data.size(), numberOfNewPages);
 
   // Discard all the pages to keep them up-to-date by fetching them again.
 
@@ -102,6 +102,16 @@ namespace TagLib {
        */
       File(IOStream *stream);
 
+      /*!
+       * Returns \a p, the new content of packet \a i, followed by as many zero
+       * bytes as the padding set by setPadding() asks for.  This is meant for
+       * comment headers, whose formats ignore trailing data; keeping their
+       * size unchanged lets save() overwrite them in place.
+       *
+       * No padding is added unless setPadding() has been called.
+       */
+      ByteVector paddedPacket(unsigned int i, const ByteVector &p);
+
     private:
       File(const File &);
       File &operator=(const File &);
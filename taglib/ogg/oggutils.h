@@ -0,0 +1,135 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_OGGUTILS_H
+#define TAGLIB_OGGUTILS_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include "audioproperties.h"
+#include "oggfile.h"
+#include "oggpageheader.h"
+
+namespace TagLib
+{
+  namespace Ogg
+  {
+    namespace
+    {
+
+      /*!
+       * The number of bytes at the start of an Ogg file that is used to
+       * estimate its length.
+       */
+      const long EstimateHeadSize = 64 * 1024;
+
+      /*!
+       * Returns the absolute granule position of the last page of \a file, or
+       * -1 if it is not known.
+       *
+       * Unless \a style is AudioProperties::Fast, this is read from the last
+       * page.  Otherwise only the pages in the first EstimateHeadSize bytes are
+       * read.  If the stream ends within them, the position is exact.  If not,
+       * it is extrapolated to the end of the file from the bytes and samples
+       * of the audio pages read so far, and \a estimated is set to true.
+       */
+      inline long long lastGranulePosition(File *file, AudioProperties::ReadStyle style,
+                                           bool &estimated)
+      {
+        estimated = false;
+
+        if(style != AudioProperties::Fast) {
+          const PageHeader *last = file->lastPageHeader();
+          return last ? last->absoluteGranularPosition() : -1;
+        }
+
+        long offset = file->find("OggS");
+        if(offset < 0)
+          return -1;
+
+        const long end = offset + EstimateHeadSize;
+
+        // The header pages have the granule position of the first page; the
+        // audio starts after the last of them.
+
+        long long firstPosition = -1;
+        long long audioStartPosition = -1;
+        long audioStart = -1;
+
+        long long lastPosition = -1;
+        long lastEnd = -1;
+
+        while(offset < end) {
+          const PageHeader header(file, offset);
+          if(!header.isValid())
+            break;
+
+          offset += header.size() + header.dataSize();
+
+          const long long position = header.absoluteGranularPosition();
+          if(position < 0)
+            continue;
+
+          if(firstPosition < 0)
+            firstPosition = position;
+
+          if(position == firstPosition) {
+            audioStartPosition = position;
+            audioStart = offset;
+          }
+          else {
+            lastPosition = position;
+            lastEnd = offset;
+          }
+
+          if(header.lastPageOfStream())
+            return position;
+        }
+
+        // The whole stream has been read, but the last page was not marked.
+
+        if(offset >= file->length())
+          return lastPosition >= 0 ? lastPosition : firstPosition;
+
+        if(lastPosition < 0 || lastEnd <= audioStart || lastPosition <= audioStartPosition)
+          return -1;
+
+        const double bytesPerSample
+          = static_cast<double>(lastEnd - audioStart) / (lastPosition - audioStartPosition);
+
+        estimated = true;
+        return audioStartPosition
+          + static_cast<long long>((file->length() - audioStart) / bytesPerSample + 0.5);
+      }
+
+    }
+  }
+}
+
+#endif
+
+#endif
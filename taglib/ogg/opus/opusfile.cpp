@@ -63,27 +63,51 @@ bool Ogg::Opus::File::isSupported(IOStream *stream)
   // An Opus file has IDs "OggS" and "OpusHead" somewhere.
 
   const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
-  return (buffer.find("OggS") >= 0 && buffer.find("OpusHead") >= 0);
+  return (Utils::findOggSignature(buffer, "OpusHead") >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-Opus::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+Opus::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-Opus::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+Opus::File::File(FileName file, bool readProperties,
+                 Properties::ReadStyle propertiesStyle,
+                 PictureReading pictureReading) :
+  Ogg::File(file),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties, propertiesStyle);
+}
+
+Opus::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
+}
+
+Opus::File::File(IOStream *stream, bool readProperties,
+                 Properties::ReadStyle propertiesStyle,
+                 PictureReading pictureReading) :
+  Ogg::File(stream),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties, propertiesStyle);
 }
 
 Opus::File::~File()
@@ -116,7 +140,7 @@ bool Opus::File::save()
   if(!d->comment)
     d->comment = new Ogg::XiphComment();
 
-  setPacket(1, ByteVector("OpusTags", 8) + d->comment->render(false));
+  setPacket(1, paddedPacket(1, ByteVector("OpusTags", 8) + d->comment->render(false)));
 
   return Ogg::File::save();
 }
@@ -125,7 +149,7 @@ bool Opus::File::save()
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Opus::File::read(bool readProperties)
+void Opus::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   ByteVector opusHeaderData = packet(0);
 
@@ -143,8 +167,8 @@ void Opus::File::read(bool readProperties)
     return;
   }
 
-  d->comment = new Ogg::XiphComment(commentHeaderData.mid(8));
+  d->comment = new Ogg::XiphComment(commentHeaderData.mid(8), pictureReading());
 
   if(readProperties)
-    d->properties = new Properties(this);
+    d->properties = new Properties(this, propertiesStyle);
 }
@@ -31,6 +31,7 @@
 #include <tdebug.h>
 
 #include <oggpageheader.h>
+#include <oggutils.h>
 
 #include "opusproperties.h"
 #include "opusfile.h"
@@ -63,7 +64,7 @@ Opus::Properties::Properties(File *file, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
-  read(file);
+  read(file, style);
 }
 
 Opus::Properties::~Properties()
@@ -118,7 +119,7 @@ int Opus::Properties::opusVersion() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Opus::Properties::read(File *file)
+void Opus::Properties::read(File *file, ReadStyle style)
 {
   // Get the identification header from the Ogg implementation.
 
@@ -152,11 +153,12 @@ void Opus::Properties::read(File *file)
   pos += 1;
 
   const Ogg::PageHeader *first = file->firstPageHeader();
-  const Ogg::PageHeader *last  = file->lastPageHeader();
 
-  if(first && last) {
+  bool estimated = false;
+  const long long end = Ogg::lastGranulePosition(file, style, estimated);
+
+  if(first) {
     const long long start = first->absoluteGranularPosition();
-    const long long end   = last->absoluteGranularPosition();
 
     if(start >= 0 && end >= 0) {
       const long long frameCount = (end - start - preSkip);
@@ -165,6 +167,7 @@ void Opus::Properties::read(File *file)
         const double length = frameCount * 1000.0 / 48000.0;
         d->length  = static_cast<int>(length + 0.5);
         d->bitrate = static_cast<int>(file->length() * 8.0 / length + 0.5);
+        setEstimated(estimated);
       }
     }
     else {
@@ -173,5 +176,5 @@ void Opus::Properties::read(File *file)
     }
   }
   else
-    debug("Opus::Properties::read() -- Could not find valid first and last Ogg pages.");
+    debug("Opus::Properties::read() -- Could not find a valid first Ogg page.");
 }
@@ -63,27 +63,51 @@ bool Ogg::Speex::File::isSupported(IOStream *stream)
   // A Speex file has IDs "OggS" and "Speex   " somewhere.
 
   const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
-  return (buffer.find("OggS") >= 0 && buffer.find("Speex   ") >= 0);
+  return (Utils::findOggSignature(buffer, "Speex   ") >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-Speex::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+Speex::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-Speex::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+Speex::File::File(FileName file, bool readProperties,
+                  Properties::ReadStyle propertiesStyle,
+                  PictureReading pictureReading) :
+  Ogg::File(file),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties, propertiesStyle);
+}
+
+Speex::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
+}
+
+Speex::File::File(IOStream *stream, bool readProperties,
+                  Properties::ReadStyle propertiesStyle,
+                  PictureReading pictureReading) :
+  Ogg::File(stream),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties, propertiesStyle);
 }
 
 Speex::File::~File()
@@ -116,7 +140,7 @@ bool Speex::File::save()
   if(!d->comment)
     d->comment = new Ogg::XiphComment();
 
-  setPacket(1, d->comment->render());
+  setPacket(1, paddedPacket(1, d->comment->render()));
 
   return Ogg::File::save();
 }
@@ -125,7 +149,7 @@ bool Speex::File::save()
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Speex::File::read(bool readProperties)
+void Speex::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   ByteVector speexHeaderData = packet(0);
 
@@ -136,8 +160,8 @@ void Speex::File::read(bool readProperties)
 
   ByteVector commentHeaderData = packet(1);
 
-  d->comment = new Ogg::XiphComment(commentHeaderData);
+  d->comment = new Ogg::XiphComment(commentHeaderData, pictureReading());
 
   if(readProperties)
-    d->properties = new Properties(this);
+    d->properties = new Properties(this, propertiesStyle);
 }
@@ -59,11 +59,23 @@ namespace TagLib {
          * Constructs a Speex file from \a file.  If \a readProperties is true the
          * file's audio properties will also be read.
          *
-         * \note In the current implementation, \a propertiesStyle is ignored.
+         * If \a propertiesStyle is Properties::Fast, the end of the file is not
+         * read, so the length may be an estimate.
          */
         File(FileName file, bool readProperties = true,
              Properties::ReadStyle propertiesStyle = Properties::Average);
 
+        /*!
+         * Constructs a Speex file from \a file.  This is the same as the
+         * constructor above, except that \a pictureReading sets whether the
+         * embedded pictures are read.
+         *
+         * \see TagLib::File::pictureReading()
+         */
+        File(FileName file, bool readProperties,
+             Properties::ReadStyle propertiesStyle,
+             PictureReading pictureReading);
+
         /*!
          * Constructs a Speex file from \a stream.  If \a readProperties is true the
          * file's audio properties will also be read.
@@ -71,11 +83,23 @@ namespace TagLib {
          * \note TagLib will *not* take ownership of the stream, the caller is
          * responsible for deleting it after the File object.
          *
-         * \note In the current implementation, \a propertiesStyle is ignored.
+         * If \a propertiesStyle is Properties::Fast, the end of the file is not
+         * read, so the length may be an estimate.
          */
         File(IOStream *stream, bool readProperties = true,
              Properties::ReadStyle propertiesStyle = Properties::Average);
 
+        /*!
+         * Constructs a Speex file from \a stream.  This is the same as the
+         * constructor above, except that \a pictureReading sets whether the
+         * embedded pictures are read.
+         *
+         * \see TagLib::File::pictureReading()
+         */
+        File(IOStream *stream, bool readProperties,
+             Properties::ReadStyle propertiesStyle,
+             PictureReading pictureReading);
+
         /*!
          * Destroys this instance of the File.
          */
@@ -126,7 +150,7 @@ namespace TagLib {
         File(const File &);
         File &operator=(const File &);
 
-        void read(bool readProperties);
+        void read(bool readProperties, Properties::ReadStyle propertiesStyle);
 
         class FilePrivate;
         FilePrivate *d;
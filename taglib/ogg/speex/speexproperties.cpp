@@ -31,6 +31,7 @@
 #include <tdebug.h>
 
 #include <oggpageheader.h>
+#include <oggutils.h>
 
 #include "speexproperties.h"
 #include "speexfile.h"
@@ -69,7 +70,7 @@ Speex::Properties::Properties(File *file, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
-  read(file);
+  read(file, style);
 }
 
 Speex::Properties::~Properties()
@@ -121,7 +122,7 @@ int Speex::Properties::speexVersion() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Speex::Properties::read(File *file)
+void Speex::Properties::read(File *file, ReadStyle style)
 {
   // Get the identification header from the Ogg implementation.
 
@@ -171,11 +172,12 @@ void Speex::Properties::read(File *file)
   // unsigned int framesPerPacket = data.mid(pos, 4).toUInt(false);
 
   const Ogg::PageHeader *first = file->firstPageHeader();
-  const Ogg::PageHeader *last  = file->lastPageHeader();
 
-  if(first && last) {
+  bool estimated = false;
+  const long long end = Ogg::lastGranulePosition(file, style, estimated);
+
+  if(first) {
     const long long start = first->absoluteGranularPosition();
-    const long long end   = last->absoluteGranularPosition();
 
     if(start >= 0 && end >= 0 && d->sampleRate > 0) {
       const long long frameCount = end - start;
@@ -184,6 +186,7 @@ void Speex::Properties::read(File *file)
         const double length = frameCount * 1000.0 / d->sampleRate;
         d->length  = static_cast<int>(length + 0.5);
         d->bitrate = static_cast<int>(file->length() * 8.0 / length + 0.5);
+        setEstimated(estimated);
       }
     }
     else {
@@ -192,7 +195,7 @@ void Speex::Properties::read(File *file)
     }
   }
   else
-    debug("Speex::Properties::read() -- Could not find valid first and last Ogg pages.");
+    debug("Speex::Properties::read() -- Could not find a valid first Ogg page.");
 
   // Alternative to the actual average bitrate.
 
@@ -117,7 +117,7 @@ namespace TagLib {
         Properties(const Properties &);
         Properties &operator=(const Properties &);
 
-        void read(File *file);
+        void read(File *file, ReadStyle style);
 
         class PropertiesPrivate;
         PropertiesPrivate *d;
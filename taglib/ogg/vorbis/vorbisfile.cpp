@@ -68,27 +68,51 @@ bool Vorbis::File::isSupported(IOStream *stream)
   // An Ogg Vorbis file has IDs "OggS" and "\x01vorbis" somewhere.
 
   const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
-  return (buffer.find("OggS") >= 0 && buffer.find("\x01vorbis") >= 0);
+  return (Utils::findOggSignature(buffer, "\x01vorbis") >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-Vorbis::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+Vorbis::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-Vorbis::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+Vorbis::File::File(FileName file, bool readProperties,
+                   Properties::ReadStyle propertiesStyle,
+                   PictureReading pictureReading) :
+  Ogg::File(file),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties, propertiesStyle);
+}
+
+Vorbis::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
+}
+
+Vorbis::File::File(IOStream *stream, bool readProperties,
+                   Properties::ReadStyle propertiesStyle,
+                   PictureReading pictureReading) :
+  Ogg::File(stream),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties, propertiesStyle);
 }
 
 Vorbis::File::~File()
@@ -124,7 +148,7 @@ bool Vorbis::File::save()
     d->comment = new Ogg::XiphComment();
   v.append(d->comment->render());
 
-  setPacket(1, v);
+  setPacket(1, paddedPacket(1, v));
 
   return Ogg::File::save();
 }
@@ -133,7 +157,7 @@ bool Vorbis::File::save()
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Vorbis::File::read(bool readProperties)
+void Vorbis::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   ByteVector commentHeaderData = packet(1);
 
@@ -143,8 +167,8 @@ void Vorbis::File::read(bool readProperties)
     return;
   }
 
-  d->comment = new Ogg::XiphComment(commentHeaderData.mid(7));
+  d->comment = new Ogg::XiphComment(commentHeaderData.mid(7), pictureReading());
 
   if(readProperties)
-    d->properties = new Properties(this);
+    d->properties = new Properties(this, propertiesStyle);
 }
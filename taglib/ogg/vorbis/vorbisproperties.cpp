@@ -27,6 +27,7 @@
 #include <tdebug.h>
 
 #include <oggpageheader.h>
+#include <oggutils.h>
 
 #include "vorbisproperties.h"
 #include "vorbisfile.h"
@@ -72,7 +73,7 @@ Vorbis::Properties::Properties(File *file, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
-  read(file);
+  read(file, style);
 }
 
 Vorbis::Properties::~Properties()
@@ -134,7 +135,7 @@ int Vorbis::Properties::bitrateMinimum() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Vorbis::Properties::read(File *file)
+void Vorbis::Properties::read(File *file, ReadStyle style)
 {
   // Get the identification header from the Ogg implementation.
 
@@ -175,11 +176,12 @@ void Vorbis::Properties::read(File *file)
   // for my notes on the topic.
 
   const Ogg::PageHeader *first = file->firstPageHeader();
-  const Ogg::PageHeader *last  = file->lastPageHeader();
 
-  if(first && last) {
+  bool estimated = false;
+  const long long end = Ogg::lastGranulePosition(file, style, estimated);
+
+  if(first) {
     const long long start = first->absoluteGranularPosition();
-    const long long end   = last->absoluteGranularPosition();
 
     if(start >= 0 && end >= 0 && d->sampleRate > 0) {
       const long long frameCount = end - start;
@@ -189,6 +191,7 @@ void Vorbis::Properties::read(File *file)
 
         d->length  = static_cast<int>(length + 0.5);
         d->bitrate = static_cast<int>(file->length() * 8.0 / length + 0.5);
+        setEstimated(estimated);
       }
     }
     else {
@@ -197,7 +200,7 @@ void Vorbis::Properties::read(File *file)
     }
   }
   else
-    debug("Vorbis::Properties::read() -- Could not find valid first and last Ogg pages.");
+    debug("Vorbis::Properties::read() -- Could not find a valid first Ogg page.");
 
   // Alternative to the actual average bitrate.
 
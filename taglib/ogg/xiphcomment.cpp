@@ -24,6 +24,7 @@
  ***************************************************************************/
 
 #include <tbytevector.h>
+#include <tbytevectorlist.h>
 #include <tdebug.h>
 
 #include <flacpicture.h>
@@ -40,12 +41,31 @@ namespace
   typedef List<FLAC::Picture *> PictureList;
   typedef PictureList::Iterator PictureIterator;
   typedef PictureList::Iterator PictureConstIterator;
+
+  FLAC::Picture *decodePicture(const ByteVector &base64Data)
+  {
+    const ByteVector picturedata = ByteVector::fromBase64(base64Data);
+    if(picturedata.isEmpty()) {
+      debug("Ogg::XiphComment::parse() - Discarding a field. Invalid base64 data");
+      return 0;
+    }
+
+    FLAC::Picture * picture = new FLAC::Picture();
+    if(!picture->parse(picturedata)) {
+      delete picture;
+      debug("Ogg::XiphComment::parse() - Failed to decode FLAC Picture block");
+      return 0;
+    }
+
+    return picture;
+  }
 }
 
 class Ogg::XiphComment::XiphCommentPrivate
 {
 public:
-  XiphCommentPrivate()
+  XiphCommentPrivate() :
+    pictureReading(TagLib::File::ReadPictures)
   {
     pictureList.setAutoDelete(true);
   }
@@ -54,6 +74,12 @@ public:
   String vendorID;
   String commentField;
   PictureList pictureList;
+
+  // With File::SkipPictures, the base64 data of the METADATA_BLOCK_PICTURE
+  // fields, until the pictures are asked for.
+
+  TagLib::File::PictureReading pictureReading;
+  ByteVectorList pendingPictures;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -73,6 +99,14 @@ Ogg::XiphComment::XiphComment(const ByteVector &data) :
   parse(data);
 }
 
+Ogg::XiphComment::XiphComment(const ByteVector &data, TagLib::File::PictureReading pictureReading) :
+  TagLib::Tag(),
+  d(new XiphCommentPrivate())
+{
+  d->pictureReading = pictureReading;
+  parse(data);
+}
+
 Ogg::XiphComment::~XiphComment()
 {
   delete d;
@@ -207,6 +241,7 @@ unsigned int Ogg::XiphComment::fieldCount() const
     count += (*it).second.size();
 
   count += d->pictureList.size();
+  count += d->pendingPictures.size();
 
   return count;
 }
@@ -329,6 +364,8 @@ bool Ogg::XiphComment::contains(const String &key) const
 
 void Ogg::XiphComment::removePicture(FLAC::Picture *picture, bool del)
 {
+  decodePictures();
+
   PictureIterator it = d->pictureList.find(picture);
   if(it != d->pictureList.end())
     d->pictureList.erase(it);
@@ -340,15 +377,20 @@ void Ogg::XiphComment::removePicture(FLAC::Picture *picture, bool del)
 void Ogg::XiphComment::removeAllPictures()
 {
   d->pictureList.clear();
+  d->pendingPictures.clear();
 }
 
 void Ogg::XiphComment::addPicture(FLAC::Picture * picture)
 {
+  decodePictures();
+
   d->pictureList.append(picture);
 }
 
 List<FLAC::Picture *> Ogg::XiphComment::pictureList()
 {
+  decodePictures();
+
   return d->pictureList;
 }
 
@@ -405,6 +447,12 @@ ByteVector Ogg::XiphComment::render(bool addFramingBit) const
     data.append(picture);
   }
 
+  for(ByteVectorList::ConstIterator it = d->pendingPictures.begin(); it != d->pendingPictures.end(); ++it) {
+    data.append(ByteVector::fromUInt(it->size() + 23, false));
+    data.append("METADATA_BLOCK_PICTURE=");
+    data.append(*it);
+  }
+
   // Append the "framing bit".
 
   if(addFramingBit)
@@ -475,27 +523,23 @@ void Ogg::XiphComment::parse(const ByteVector &data)
 
       // Handle Pictures separately
 
-      const ByteVector picturedata = ByteVector::fromBase64(entry.mid(sep + 1));
-      if(picturedata.isEmpty()) {
-        debug("Ogg::XiphComment::parse() - Discarding a field. Invalid base64 data");
-        continue;
-      }
-
       if(key[0] == L'M') {
 
         // Decode FLAC Picture
 
-        FLAC::Picture * picture = new FLAC::Picture();
-        if(picture->parse(picturedata)) {
+        if(d->pictureReading == TagLib::File::SkipPictures)
+          d->pendingPictures.append(entry.mid(sep + 1));
+        else if(FLAC::Picture *picture = decodePicture(entry.mid(sep + 1)))
           d->pictureList.append(picture);
-        }
-        else {
-          delete picture;
-          debug("Ogg::XiphComment::parse() - Failed to decode FLAC Picture block");
-        }
       }
       else {
 
+        const ByteVector picturedata = ByteVector::fromBase64(entry.mid(sep + 1));
+        if(picturedata.isEmpty()) {
+          debug("Ogg::XiphComment::parse() - Discarding a field. Invalid base64 data");
+          continue;
+        }
+
         // Assume it's some type of image file
 
         FLAC::Picture * picture = new FLAC::Picture();
@@ -513,3 +557,17 @@ void Ogg::XiphComment::parse(const ByteVector &data)
     }
   }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void Ogg::XiphComment::decodePictures()
+{
+  for(ByteVectorList::ConstIterator it = d->pendingPictures.begin(); it != d->pendingPictures.end(); ++it) {
+    if(FLAC::Picture *picture = decodePicture(*it))
+      d->pictureList.append(picture);
+  }
+
+  d->pendingPictures.clear();
+}
@@ -32,6 +32,7 @@
 #include "tstring.h"
 #include "tstringlist.h"
 #include "tbytevector.h"
+#include "tfile.h"
 #include "flacpicture.h"
 #include "taglib_export.h"
 
@@ -75,6 +76,16 @@ namespace TagLib {
        */
       XiphComment(const ByteVector &data);
 
+      /*!
+       * Constructs a Vorbis comment from \a data.  With File::SkipPictures,
+       * the METADATA_BLOCK_PICTURE fields are only decoded when one of the
+       * picture methods is called, and the ones that are not are written back
+       * as they were read.
+       *
+       * \see TagLib::File::pictureReading()
+       */
+      XiphComment(const ByteVector &data, TagLib::File::PictureReading pictureReading);
+
       /*!
        * Destroys this instance of the XiphComment.
        */
@@ -266,6 +277,8 @@ namespace TagLib {
       XiphComment(const XiphComment &);
       XiphComment &operator=(const XiphComment &);
 
+      void decodePictures();
+
       class XiphCommentPrivate;
       XiphCommentPrivate *d;
     };
@@ -63,7 +63,7 @@ bool RIFF::AIFF::File::isSupported(IOStream *stream)
   // An AIFF file has to start with "FORM????AIFF" or "FORM????AIFC".
 
   const ByteVector id = Utils::readHeader(stream, 12, false);
-  return (id.startsWith("FORM") && (id.containsAt("AIFF", 8) || id.containsAt("AIFC", 8)));
+  return (Utils::findAIFFSignature(id) == 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,6 +78,17 @@ RIFF::AIFF::File::File(FileName file, bool readProperties, Properties::ReadStyle
     read(readProperties);
 }
 
+RIFF::AIFF::File::File(FileName file, bool readProperties, Properties::ReadStyle,
+                       PictureReading pictureReading) :
+  RIFF::File(file, BigEndian),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties);
+}
+
 RIFF::AIFF::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
   RIFF::File(stream, BigEndian),
   d(new FilePrivate())
@@ -86,6 +97,17 @@ RIFF::AIFF::File::File(IOStream *stream, bool readProperties, Properties::ReadSt
     read(readProperties);
 }
 
+RIFF::AIFF::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle,
+                       PictureReading pictureReading) :
+  RIFF::File(stream, BigEndian),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties);
+}
+
 RIFF::AIFF::File::~File()
 {
   delete d;
@@ -128,6 +150,8 @@ bool RIFF::AIFF::File::save()
     return false;
   }
 
+  SaveScope scope(this);
+
   if(d->hasID3v2) {
     removeChunk("ID3 ");
     removeChunk("id3 ");
@@ -135,11 +159,14 @@ bool RIFF::AIFF::File::save()
   }
 
   if(tag() && !tag()->isEmpty()) {
+    d->tag->setPadding(minimumPadding(d->tag->minimumPadding()),
+                       maximumPadding(d->tag->maximumPadding()));
+
     setChunkData("ID3 ", d->tag->render());
     d->hasID3v2 = true;
   }
 
-  return true;
+  return scope.finish();
 }
 
 bool RIFF::AIFF::File::hasID3v2Tag() const
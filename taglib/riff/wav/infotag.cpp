@@ -25,6 +25,7 @@
 
 #include <tdebug.h>
 #include <tfile.h>
+#include <tthread.h>
 
 #include "infotag.h"
 #include "riffutils.h"
@@ -35,7 +36,10 @@ using namespace RIFF::Info;
 namespace
 {
   const RIFF::Info::StringHandler defaultStringHandler;
-  const RIFF::Info::StringHandler *stringHandler = &defaultStringHandler;
+
+  Thread::SharedHandler<RIFF::Info::StringHandler> stringHandler = {
+    const_cast<RIFF::Info::StringHandler *>(&defaultStringHandler), &defaultStringHandler
+  };
 }
 
 class RIFF::Info::Tag::TagPrivate
@@ -206,7 +210,7 @@ ByteVector RIFF::Info::Tag::render() const
 
   FieldListMap::ConstIterator it = d->fieldListMap.begin();
   for(; it != d->fieldListMap.end(); ++it) {
-    ByteVector text = stringHandler->render(it->second);
+    ByteVector text = stringHandler.get()->render(it->second);
     if(text.isEmpty())
       continue;
 
@@ -227,10 +231,7 @@ ByteVector RIFF::Info::Tag::render() const
 
 void RIFF::Info::Tag::setStringHandler(const StringHandler *handler)
 {
-  if(handler)
-    stringHandler = handler;
-  else
-    stringHandler = &defaultStringHandler;
+  stringHandler.set(handler);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -247,7 +248,7 @@ void RIFF::Info::Tag::parse(const ByteVector &data)
 
     const ByteVector id = data.mid(p, 4);
     if(isValidChunkName(id)) {
-      const String text = stringHandler->parse(data.mid(p + 8, size));
+      const String text = stringHandler.get()->parse(data.mid(p + 8, size));
       d->fieldListMap[id] = text;
     }
 
@@ -70,7 +70,7 @@ bool RIFF::WAV::File::isSupported(IOStream *stream)
   // A WAV file has to start with "RIFF????WAVE".
 
   const ByteVector id = Utils::readHeader(stream, 12, false);
-  return (id.startsWith("RIFF") && id.containsAt("WAVE", 8));
+  return (Utils::findWAVSignature(id) == 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -85,6 +85,17 @@ RIFF::WAV::File::File(FileName file, bool readProperties, Properties::ReadStyle)
     read(readProperties);
 }
 
+RIFF::WAV::File::File(FileName file, bool readProperties, Properties::ReadStyle,
+                      PictureReading pictureReading) :
+  RIFF::File(file, LittleEndian),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties);
+}
+
 RIFF::WAV::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
   RIFF::File(stream, LittleEndian),
   d(new FilePrivate())
@@ -93,6 +104,17 @@ RIFF::WAV::File::File(IOStream *stream, bool readProperties, Properties::ReadSty
     read(readProperties);
 }
 
+RIFF::WAV::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle,
+                      PictureReading pictureReading) :
+  RIFF::File(stream, LittleEndian),
+  d(new FilePrivate())
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties);
+}
+
 RIFF::WAV::File::~File()
 {
   delete d;
@@ -115,6 +137,8 @@ RIFF::Info::Tag *RIFF::WAV::File::InfoTag() const
 
 void RIFF::WAV::File::strip(TagTypes tags)
 {
+  SaveScope scope(this);
+
   removeTagChunks(tags);
 
   if(tags & ID3v2)
@@ -162,6 +186,8 @@ bool RIFF::WAV::File::save(TagTypes tags, bool stripOthers, int id3v2Version)
     return false;
   }
 
+  SaveScope scope(this);
+
   if(stripOthers)
     strip(static_cast<TagTypes>(AllTags & ~tags));
 
@@ -169,7 +195,10 @@ bool RIFF::WAV::File::save(TagTypes tags, bool stripOthers, int id3v2Version)
     removeTagChunks(ID3v2);
 
     if(ID3v2Tag() && !ID3v2Tag()->isEmpty()) {
-      setChunkData("ID3 ", ID3v2Tag()->render(id3v2Version));
+      ID3v2::Tag *tag = ID3v2Tag();
+      tag->setPadding(minimumPadding(tag->minimumPadding()), maximumPadding(tag->maximumPadding()));
+
+      setChunkData("ID3 ", tag->render(id3v2Version));
       d->hasID3v2 = true;
     }
   }
@@ -183,7 +212,7 @@ bool RIFF::WAV::File::save(TagTypes tags, bool stripOthers, int id3v2Version)
     }
   }
 
-  return true;
+  return scope.finish();
 }
 
 bool RIFF::WAV::File::hasID3v2Tag() const
@@ -96,6 +96,9 @@ bool S3M::File::save()
     debug("S3M::File::save() - Cannot save to a read only file.");
     return false;
   }
+
+  SaveScope scope(this);
+
   // note: if title starts with "Extended Module: "
   // the file would look like an .xm file
   seek(0);
@@ -143,7 +146,7 @@ bool S3M::File::save()
     // string terminating NUL is not optional:
     writeByte(0);
   }
-  return true;
+  return scope.finish();
 }
 
 void S3M::File::read(bool)
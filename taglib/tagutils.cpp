@@ -23,16 +23,24 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tfile.h>
 
 #include "id3v1tag.h"
 #include "id3v2header.h"
 #include "apetag.h"
+#include "mpegutils.h"
 
 #include "tagutils.h"
 
 using namespace TagLib;
 
+namespace
+{
+  const ByteVector ASFHeaderGuid("\x30\x26\xB2\x75\x8E\x66\xCF\x11\xA6\xD9\x00\xAA\x00\x62\xCE\x6C", 16);
+}
+
 long Utils::findID3v1(File *file)
 {
   if(!file->isValid())
@@ -103,3 +111,106 @@ ByteVector TagLib::Utils::readHeader(IOStream *stream, unsigned int length,
 
   return header;
 }
+
+long TagLib::Utils::paddingThreshold(long fileLength, long minimumSize, long maximumSize)
+{
+  // The padding that ID3v2 tags and FLAC metadata keep grows with the file up
+  // to 1% of its size.
+
+  long threshold = fileLength / 100;
+  threshold = std::max(threshold, minimumSize);
+  threshold = std::min(threshold, maximumSize);
+
+  return threshold;
+}
+
+long TagLib::Utils::paddingSize(long originalSize, long dataSize, long minimumSize, long threshold)
+{
+  // originalSize is the space taken by the old tag and its padding.  A new tag,
+  // or one that doesn't fit into that space, gets the minimum padding.
+  // Otherwise the space left over is kept as padding unless it's larger than
+  // threshold.
+
+  if(originalSize == 0 || dataSize > originalSize)
+    return minimumSize;
+
+  const long freeSize = originalSize - dataSize;
+  if(freeSize > threshold)
+    return minimumSize;
+
+  return freeSize;
+}
+
+long TagLib::Utils::findMPEGSignature(const ByteVector &data, unsigned int searchLength)
+{
+  // An MPEG frame sync counts only if it's followed by another frame of the
+  // same stream.  The data must hold MPEG::FrameLookahead bytes more than
+  // searchLength, unless the stream ends within it.
+
+  for(int i = data.find('\xFF'); i >= 0 && i < static_cast<int>(searchLength);
+      i = data.find('\xFF', i + 1)) {
+    if(MPEG::checkFrame(data, i, true) == MPEG::ValidFrame)
+      return i;
+  }
+
+  return -1;
+}
+
+long TagLib::Utils::findOggSignature(const ByteVector &data, const ByteVector &codecId)
+{
+  // An Ogg stream has a page "OggS" and the ID of its codec somewhere.
+
+  const long offset = data.find("OggS");
+  if(offset >= 0 && data.find(codecId) >= 0)
+    return offset;
+
+  return -1;
+}
+
+long TagLib::Utils::findFLACSignature(const ByteVector &data)
+{
+  return data.find("fLaC");
+}
+
+long TagLib::Utils::findMPCSignature(const ByteVector &data)
+{
+  // Older MPC files don't have keys to do a quick check.
+
+  return (data.startsWith("MPCK") || data.startsWith("MP+")) ? 0 : -1;
+}
+
+long TagLib::Utils::findWavPackSignature(const ByteVector &data)
+{
+  return data.startsWith("wvpk") ? 0 : -1;
+}
+
+long TagLib::Utils::findTrueAudioSignature(const ByteVector &data)
+{
+  return data.startsWith("TTA") ? 0 : -1;
+}
+
+long TagLib::Utils::findMP4Signature(const ByteVector &data)
+{
+  return data.containsAt("ftyp", 4) ? 0 : -1;
+}
+
+long TagLib::Utils::findASFSignature(const ByteVector &data)
+{
+  return data.startsWith(ASFHeaderGuid) ? 0 : -1;
+}
+
+long TagLib::Utils::findAIFFSignature(const ByteVector &data)
+{
+  return (data.startsWith("FORM") &&
+          (data.containsAt("AIFF", 8) || data.containsAt("AIFC", 8))) ? 0 : -1;
+}
+
+long TagLib::Utils::findWAVSignature(const ByteVector &data)
+{
+  return (data.startsWith("RIFF") && data.containsAt("WAVE", 8)) ? 0 : -1;
+}
+
+long TagLib::Utils::findAPESignature(const ByteVector &data)
+{
+  return data.find("MAC ");
+}
@@ -47,6 +47,37 @@ namespace TagLib {
 
     ByteVector readHeader(IOStream *stream, unsigned int length, bool skipID3v2,
                           long *headerOffset = 0);
+
+    long paddingThreshold(long fileLength, long minimumSize, long maximumSize);
+
+    long paddingSize(long originalSize, long dataSize, long minimumSize, long threshold);
+
+    // The signatures of the file types that can be told apart by their
+    // content.  \a data is read from the start of the stream, or from the end
+    // of its ID3v2 tag.  Each function returns the offset of the signature in
+    // \a data, or -1.  The isSupported() functions and FileRef share these.
+
+    long findMPEGSignature(const ByteVector &data, unsigned int searchLength);
+
+    long findOggSignature(const ByteVector &data, const ByteVector &codecId);
+
+    long findFLACSignature(const ByteVector &data);
+
+    long findMPCSignature(const ByteVector &data);
+
+    long findWavPackSignature(const ByteVector &data);
+
+    long findTrueAudioSignature(const ByteVector &data);
+
+    long findMP4Signature(const ByteVector &data);
+
+    long findASFSignature(const ByteVector &data);
+
+    long findAIFFSignature(const ByteVector &data);
+
+    long findWAVSignature(const ByteVector &data);
+
+    long findAPESignature(const ByteVector &data);
   }
 }
 
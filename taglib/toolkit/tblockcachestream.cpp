@@ -0,0 +1,393 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tblockcachestream.h"
+#include "tfilestream.h"
+#include "tstring.h"
+#include "tdebug.h"
+
+#include <algorithm>
+#include <list>
+#include <map>
+
+using namespace TagLib;
+
+namespace
+{
+  const unsigned int DefaultPageSize = 4096;
+  const unsigned int DefaultMaximumPages = 64;
+
+  // The number of pages read after the requested ones on a miss.
+
+  const unsigned int ReadAheadPages = 4;
+
+  struct Page
+  {
+    Page(long index, const ByteVector &data) :
+      index(index),
+      data(data) {}
+
+    long index;
+    ByteVector data;
+  };
+
+  // The most recently used page comes first.
+
+  typedef std::list<Page> PageList;
+  typedef std::map<long, PageList::iterator> PageMap;
+}
+
+class BlockCacheStream::BlockCacheStreamPrivate
+{
+public:
+  BlockCacheStreamPrivate(IOStream *stream, bool owner) :
+    stream(stream),
+    owner(owner),
+    position(0),
+    length(-1),
+    pageSize(DefaultPageSize),
+    maximumPages(DefaultMaximumPages),
+    hits(0),
+    misses(0),
+    bytesRead(0) {}
+
+  ~BlockCacheStreamPrivate()
+  {
+    if(owner)
+      delete stream;
+  }
+
+  long streamLength()
+  {
+    if(length < 0)
+      length = stream->length();
+    return length;
+  }
+
+  // Returns the page with the given index and marks it as the most recently
+  // used one, or null if it is not cached.
+
+  const Page *findPage(long index)
+  {
+    const PageMap::iterator it = pageMap.find(index);
+    if(it == pageMap.end())
+      return 0;
+
+    pages.splice(pages.begin(), pages, it->second);
+    return &pages.front();
+  }
+
+  bool isCached(long index) const
+  {
+    return pageMap.find(index) != pageMap.end();
+  }
+
+  // Reads the pages first to last from the underlying stream in one call.
+  // They are evicted only after the current request has been served.
+
+  void loadPages(long first, long last)
+  {
+    stream->seek(first * pageSize);
+    const ByteVector data = stream->readBlock((last - first + 1) * pageSize);
+
+    ++misses;
+    bytesRead += data.size();
+
+    for(long index = first; index <= last; ++index) {
+      const unsigned int offset = static_cast<unsigned int>((index - first) * pageSize);
+      if(offset >= data.size())
+        break;
+
+      pages.push_front(Page(index, data.mid(offset, pageSize)));
+      pageMap[index] = pages.begin();
+    }
+  }
+
+  // Drops the least recently used pages beyond the maximum, but keeps the
+  // first and the last page of the stream as long as possible.
+
+  void evict()
+  {
+    const long lastIndex = (streamLength() - 1) / static_cast<long>(pageSize);
+
+    while(pages.size() > maximumPages) {
+      PageList::iterator victim = pages.end();
+      for(PageList::iterator it = pages.end(); it != pages.begin(); ) {
+        --it;
+        if(it->index != 0 && it->index != lastIndex) {
+          victim = it;
+          break;
+        }
+      }
+
+      if(victim == pages.end())
+        victim = --pages.end();
+
+      pageMap.erase(victim->index);
+      pages.erase(victim);
+    }
+  }
+
+  void dropPages(long first, long last)
+  {
+    for(PageMap::iterator it = pageMap.lower_bound(first); it != pageMap.end() && it->first <= last; ) {
+      pages.erase(it->second);
+      pageMap.erase(it++);
+    }
+  }
+
+  void dropAll()
+  {
+    pages.clear();
+    pageMap.clear();
+    length = -1;
+  }
+
+  IOStream *stream;
+  const bool owner;
+  long position;
+  long length;
+  unsigned int pageSize;
+  unsigned int maximumPages;
+  PageList pages;
+  PageMap pageMap;
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long long bytesRead;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+BlockCacheStream::BlockCacheStream(FileName file, bool openReadOnly) :
+  d(new BlockCacheStreamPrivate(new FileStream(file, openReadOnly), true))
+{
+}
+
+BlockCacheStream::BlockCacheStream(IOStream *stream) :
+  d(new BlockCacheStreamPrivate(stream, false))
+{
+}
+
+BlockCacheStream::~BlockCacheStream()
+{
+  delete d;
+}
+
+FileName BlockCacheStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector BlockCacheStream::readBlock(unsigned long length)
+{
+  if(!isOpen()) {
+    debug("BlockCacheStream::readBlock() -- invalid stream.");
+    return ByteVector();
+  }
+
+  if(length == 0)
+    return ByteVector();
+
+  // Large blocks, like whole tags or pictures, would only push everything else
+  // out of the cache.
+
+  if(length > static_cast<unsigned long>(d->pageSize) * d->maximumPages / 2) {
+    d->stream->seek(d->position);
+    const ByteVector data = d->stream->readBlock(length);
+
+    ++d->misses;
+    d->bytesRead += data.size();
+    d->position += data.size();
+
+    return data;
+  }
+
+  const long end = std::min<long>(d->position + length, d->streamLength());
+  if(d->position >= end)
+    return ByteVector();
+
+  const long pageSize  = d->pageSize;
+  const long firstPage = d->position / pageSize;
+  const long lastPage  = (end - 1) / pageSize;
+
+  const unsigned long misses = d->misses;
+
+  ByteVector data;
+  for(long index = firstPage; index <= lastPage; ++index) {
+    const Page *page = d->findPage(index);
+
+    if(!page) {
+
+      // Read all the missing pages up to the end of the request, and a few
+      // more after it, at once.
+
+      const long lastStreamPage = (d->streamLength() - 1) / pageSize;
+
+      const long readAhead = std::min(ReadAheadPages, d->maximumPages / 4);
+
+      long last = index;
+      while(last < lastStreamPage && last < lastPage + readAhead && !d->isCached(last + 1))
+        ++last;
+
+      d->loadPages(index, last);
+      page = d->findPage(index);
+      if(!page)
+        break;
+    }
+
+    const long pageStart = index * pageSize;
+    const long from = std::max(d->position, pageStart) - pageStart;
+    const long to   = std::min(end - pageStart, static_cast<long>(page->data.size()));
+
+    if(from < to)
+      data.append(page->data.mid(static_cast<unsigned int>(from), static_cast<unsigned int>(to - from)));
+  }
+
+  if(d->misses == misses)
+    ++d->hits;
+  else
+    d->evict();
+
+  d->position += data.size();
+  return data;
+}
+
+void BlockCacheStream::writeBlock(const ByteVector &data)
+{
+  if(data.isEmpty())
+    return;
+
+  // A write past the end also changes the last page, which may be short.
+
+  const long first = std::min(d->position, d->streamLength()) / d->pageSize;
+  d->dropPages(first, (d->position + data.size() - 1) / d->pageSize);
+  d->length = -1;
+
+  d->stream->seek(d->position);
+  d->stream->writeBlock(data);
+  d->position = d->stream->tell();
+}
+
+void BlockCacheStream::insert(const ByteVector &data, unsigned long start, unsigned long replace)
+{
+  d->dropAll();
+  d->stream->insert(data, start, replace);
+  d->position = d->stream->tell();
+}
+
+void BlockCacheStream::removeBlock(unsigned long start, unsigned long length)
+{
+  d->dropAll();
+  d->stream->removeBlock(start, length);
+  d->position = d->stream->tell();
+}
+
+bool BlockCacheStream::readOnly() const
+{
+  return d->stream->readOnly();
+}
+
+bool BlockCacheStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void BlockCacheStream::seek(long offset, Position p)
+{
+  long position;
+  switch(p) {
+  case Beginning:
+    position = offset;
+    break;
+  case Current:
+    position = d->position + offset;
+    break;
+  case End:
+    position = length() + offset;
+    break;
+  default:
+    debug("BlockCacheStream::seek() -- Invalid Position value.");
+    return;
+  }
+
+  if(position < 0) {
+    debug("BlockCacheStream::seek() -- Attempted to seek before the beginning of the stream.");
+    return;
+  }
+
+  d->position = position;
+}
+
+void BlockCacheStream::clear()
+{
+  d->stream->clear();
+}
+
+long BlockCacheStream::tell() const
+{
+  return d->position;
+}
+
+long BlockCacheStream::length()
+{
+  return d->streamLength();
+}
+
+void BlockCacheStream::truncate(long length)
+{
+  d->dropAll();
+  d->stream->truncate(length);
+}
+
+void BlockCacheStream::setCacheSize(unsigned int pageSize, unsigned int maximumPages)
+{
+  d->dropAll();
+  d->pageSize = pageSize > 0 ? pageSize : DefaultPageSize;
+  d->maximumPages = maximumPages;
+}
+
+unsigned long BlockCacheStream::cacheHits() const
+{
+  return d->hits;
+}
+
+unsigned long BlockCacheStream::cacheMisses() const
+{
+  return d->misses;
+}
+
+unsigned long long BlockCacheStream::bytesRead() const
+{
+  return d->bytesRead;
+}
+
+void BlockCacheStream::resetCounters()
+{
+  d->hits = 0;
+  d->misses = 0;
+  d->bytesRead = 0;
+}
@@ -0,0 +1,185 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_BLOCKCACHESTREAM_H
+#define TAGLIB_BLOCKCACHESTREAM_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+#include "tiostream.h"
+
+namespace TagLib {
+
+  //! A stream that caches the blocks read from another stream
+
+  /*!
+   * The parsers read files in many small pieces: frame headers of a few bytes,
+   * atom headers, or the tags at the end of the file, which are looked for
+   * once for each type of tag.  This stream sits on top of another one and
+   * keeps the recently read parts of it in a small number of aligned pages,
+   * so that most of those reads are served from memory.  A miss reads the
+   * missing pages and a few following ones in a single call.
+   *
+   * The first and the last page of the file are never evicted, since almost
+   * every file type looks at both.  Writes go straight to the underlying
+   * stream and drop the pages they affect, so the stream can be used to save
+   * files as well.
+   *
+   * To use it with a specific file type, pass it to the IOStream based
+   * constructor of that File subclass, or use FileRef::CachedStream.
+   *
+   * \see FileStream
+   */
+
+  class TAGLIB_EXPORT BlockCacheStream : public IOStream
+  {
+  public:
+    /*!
+     * Opens the \a file with a FileStream and caches it.  If \a openReadOnly
+     * is true, the file is opened read only.
+     *
+     * \see FileStream::FileStream()
+     */
+    BlockCacheStream(FileName file, bool openReadOnly = false);
+
+    /*!
+     * Caches the reads from \a stream, which must stay open as long as this
+     * stream is in use.  It is not deleted by this stream.
+     */
+    explicit BlockCacheStream(IOStream *stream);
+
+    /*!
+     * Destroys the cache, and the FileStream if this stream opened it.
+     */
+    virtual ~BlockCacheStream();
+
+    /*!
+     * Returns the name of the underlying stream.
+     */
+    FileName name() const;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.  Blocks
+     * larger than half of the cache bypass it.
+     */
+    ByteVector readBlock(unsigned long length);
+
+    /*!
+     * Writes the block \a data at the current get pointer of the underlying
+     * stream and drops the pages it overlaps.
+     */
+    void writeBlock(const ByteVector &data);
+
+    /*!
+     * Inserts \a data at position \a start in the underlying stream and drops
+     * the cache.
+     *
+     * \see IOStream::insert()
+     */
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+
+    /*!
+     * Removes a block of the underlying stream and drops the cache.
+     *
+     * \see IOStream::removeBlock()
+     */
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+
+    /*!
+     * Returns true if the underlying stream is read only.
+     */
+    bool readOnly() const;
+
+    /*!
+     * Returns true if the underlying stream is open.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.  This
+     * defaults to seeking from the beginning of the stream.
+     *
+     * \see Position
+     */
+    void seek(long offset, Position p = Beginning);
+
+    /*!
+     * Reset the end-of-file and error flags on the underlying stream.
+     */
+    void clear();
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    long tell() const;
+
+    /*!
+     * Returns the length of the stream.
+     */
+    long length();
+
+    /*!
+     * Truncates the underlying stream to \a length and drops the cache.
+     */
+    void truncate(long length);
+
+    /*!
+     * Sets the size of a page to \a pageSize bytes and the number of pages
+     * kept in memory to \a maximumPages, and drops the cache.  The default is
+     * 64 pages of 4 KiB.  A \a maximumPages of 0 disables the cache, while
+     * the counters keep counting.
+     */
+    void setCacheSize(unsigned int pageSize, unsigned int maximumPages);
+
+    /*!
+     * Returns the number of readBlock() calls that were served from the cache
+     * alone.
+     */
+    unsigned long cacheHits() const;
+
+    /*!
+     * Returns the number of reads from the underlying stream.
+     */
+    unsigned long cacheMisses() const;
+
+    /*!
+     * Returns the number of bytes read from the underlying stream.
+     */
+    unsigned long long bytesRead() const;
+
+    /*!
+     * Resets the cacheHits(), cacheMisses() and bytesRead() counters to zero.
+     */
+    void resetCounters();
+
+  private:
+    class BlockCacheStreamPrivate;
+    BlockCacheStreamPrivate *d;
+  };
+
+}
+
+#endif
@@ -25,6 +25,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <new>
 #include <limits>
 #include <cmath>
 #include <cstdio>
@@ -32,9 +33,21 @@
 
 #include <tstring.h>
 #include <tdebug.h>
-#include <trefcounter.h>
 #include <tutils.h>
 
+#include "tatomic.h"
+#include "tcrc.h"
+
+#if defined(HAVE_GCC_AVX2)
+# include <immintrin.h>
+#elif defined(HAVE_SSE2)
+# include <emmintrin.h>
+#endif
+
+#if defined(HAVE_SSE2) && defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
 #include "tbytevector.h"
 
 // This is a bit ugly to keep writing over and over again.
@@ -252,42 +265,364 @@ long double toFloat80(const ByteVector &v, size_t offset)
     return val;
 }
 
+namespace
+{
+  // Searching for a pattern of unaligned bytes.  A position is only compared
+  // in full if both the first and the last byte of the pattern match there,
+  // which the vector versions test for 16 or 32 positions at once.  Anything
+  // else goes through memchr(), which the C library vectorizes in its own way.
+
+  inline bool matchesAt(const char *p, const char *pattern, size_t patternSize)
+  {
+    return patternSize <= 2 || ::memcmp(p + 1, pattern + 1, patternSize - 2) == 0;
+  }
+
+  int findScalar(const char *data, size_t dataSize, const char *pattern, size_t patternSize)
+  {
+    const char *p = data;
+    const char *last = data + dataSize - patternSize;
+
+    while(p <= last) {
+      p = static_cast<const char *>(::memchr(p, pattern[0], last - p + 1));
+      if(!p)
+        break;
+
+      if(p[patternSize - 1] == pattern[patternSize - 1] && matchesAt(p, pattern, patternSize))
+        return static_cast<int>(p - data);
+
+      ++p;
+    }
+
+    return -1;
+  }
+
+  int rfindScalar(const char *data, size_t dataSize, const char *pattern, size_t patternSize)
+  {
+    for(size_t i = dataSize - patternSize + 1; i-- > 0;) {
+      const char *p = data + i;
+      if(p[0] == pattern[0] && p[patternSize - 1] == pattern[patternSize - 1]
+         && matchesAt(p, pattern, patternSize)) {
+        return static_cast<int>(i);
+      }
+    }
+
+    return -1;
+  }
+
+#if defined(HAVE_SSE2)
+
+  inline unsigned int lowestBit(unsigned int mask)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+
+  inline unsigned int highestBit(unsigned int mask)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return index;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+  }
+
+  // One bit for each of the 16 positions from p on where the pattern may start.
+
+  inline unsigned int candidates16(const char *p, size_t patternSize, __m128i first, __m128i last)
+  {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + patternSize - 1));
+    return _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+  }
+
+  int findSSE2(const char *data, size_t dataSize, const char *pattern, size_t patternSize)
+  {
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last  = _mm_set1_epi8(pattern[patternSize - 1]);
+    const size_t positions = dataSize - patternSize + 1;
+
+    size_t i = 0;
+    for(; i + 16 <= positions; i += 16) {
+      for(unsigned int mask = candidates16(data + i, patternSize, first, last); mask != 0; mask &= mask - 1) {
+        const size_t pos = i + lowestBit(mask);
+        if(matchesAt(data + pos, pattern, patternSize))
+          return static_cast<int>(pos);
+      }
+    }
+
+    const int pos = findScalar(data + i, dataSize - i, pattern, patternSize);
+    return pos >= 0 ? static_cast<int>(i + pos) : -1;
+  }
+
+  int rfindSSE2(const char *data, size_t dataSize, const char *pattern, size_t patternSize)
+  {
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last  = _mm_set1_epi8(pattern[patternSize - 1]);
+
+    size_t end = dataSize - patternSize + 1;
+    for(; end >= 16; end -= 16) {
+      unsigned int mask = candidates16(data + end - 16, patternSize, first, last);
+      while(mask != 0) {
+        const unsigned int bit = highestBit(mask);
+        const size_t pos = end - 16 + bit;
+        if(matchesAt(data + pos, pattern, patternSize))
+          return static_cast<int>(pos);
+        mask &= ~(1U << bit);
+      }
+    }
+
+    return rfindScalar(data, end + patternSize - 1, pattern, patternSize);
+  }
+
+#endif
+
+#if defined(HAVE_GCC_AVX2)
+
+  __attribute__((target("avx2")))
+  inline unsigned int candidates32(const char *p, size_t patternSize, __m256i first, __m256i last)
+  {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + patternSize - 1));
+    return _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+  }
+
+  __attribute__((target("avx2")))
+  int findAVX2(const char *data, size_t dataSize, const char *pattern, size_t patternSize)
+  {
+    const __m256i first = _mm256_set1_epi8(pattern[0]);
+    const __m256i last  = _mm256_set1_epi8(pattern[patternSize - 1]);
+    const size_t positions = dataSize - patternSize + 1;
+
+    size_t i = 0;
+    for(; i + 32 <= positions; i += 32) {
+      for(unsigned int mask = candidates32(data + i, patternSize, first, last); mask != 0; mask &= mask - 1) {
+        const size_t pos = i + lowestBit(mask);
+        if(matchesAt(data + pos, pattern, patternSize))
+          return static_cast<int>(pos);
+      }
+    }
+
+    const int pos = findSSE2(data + i, dataSize - i, pattern, patternSize);
+    return pos >= 0 ? static_cast<int>(i + pos) : -1;
+  }
+
+  __attribute__((target("avx2")))
+  int rfindAVX2(const char *data, size_t dataSize, const char *pattern, size_t patternSize)
+  {
+    const __m256i first = _mm256_set1_epi8(pattern[0]);
+    const __m256i last  = _mm256_set1_epi8(pattern[patternSize - 1]);
+
+    size_t end = dataSize - patternSize + 1;
+    for(; end >= 32; end -= 32) {
+      unsigned int mask = candidates32(data + end - 32, patternSize, first, last);
+      while(mask != 0) {
+        const unsigned int bit = highestBit(mask);
+        const size_t pos = end - 32 + bit;
+        if(matchesAt(data + pos, pattern, patternSize))
+          return static_cast<int>(pos);
+        mask &= ~(1U << bit);
+      }
+    }
+
+    return rfindSSE2(data, end + patternSize - 1, pattern, patternSize);
+  }
+
+  bool hasAVX2()
+  {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }
+
+#endif
+
+  typedef int (*SearchFunction)(const char *, size_t, const char *, size_t);
+
+  // Not worth setting up the vector registers for.
+
+  const size_t ShortSearch = 64;
+
+  SearchFunction findFunction(size_t dataSize)
+  {
+#if defined(HAVE_GCC_AVX2)
+    static const bool avx2 = hasAVX2();
+    if(avx2 && dataSize >= ShortSearch)
+      return findAVX2;
+#endif
+#if defined(HAVE_SSE2)
+    if(dataSize >= ShortSearch)
+      return findSSE2;
+#endif
+    (void)dataSize;
+    return findScalar;
+  }
+
+  SearchFunction rfindFunction(size_t dataSize)
+  {
+#if defined(HAVE_GCC_AVX2)
+    static const bool avx2 = hasAVX2();
+    if(avx2 && dataSize >= ShortSearch)
+      return rfindAVX2;
+#endif
+#if defined(HAVE_SSE2)
+    if(dataSize >= ShortSearch)
+      return rfindSSE2;
+#endif
+    (void)dataSize;
+    return rfindScalar;
+  }
+}
+
+namespace
+{
+  // Bytes that are shared by several vectors.  The reference count is
+  // allocated together with the std::vector, which the iterators point into.
+
+  class SharedVector
+  {
+  public:
+    SharedVector(unsigned int l, char c) :
+      data(l, c),
+      refCount(1) {}
+
+    SharedVector(const char *s, unsigned int l) :
+      data(s, s + l),
+      refCount(1) {}
+
+    void ref()
+    {
+      ATOMIC_INC(refCount);
+    }
+
+    void deref()
+    {
+      if(ATOMIC_DEC(refCount) == 0)
+        delete this;
+    }
+
+    bool isShared() const
+    {
+      return static_cast<int>(refCount) > 1;
+    }
+
+    std::vector<char> data;
+
+  private:
+    SharedVector(const SharedVector &);
+    SharedVector &operator=(const SharedVector &);
+
+    volatile ATOMIC_INT refCount;
+  };
+
+  // What the iterators of empty vectors point into, so that they need no
+  // storage of their own.  Nothing can be written through them.
+
+  std::vector<char> &emptyVector()
+  {
+    static std::vector<char> v;
+    return v;
+  }
+
+  std::vector<char> &initEmptyVector = emptyVector();
+}
+
 class ByteVector::ByteVectorPrivate
 {
 public:
+  // Empty vectors allocate nothing but their private data.
+
   ByteVectorPrivate(unsigned int l, char c) :
-    counter(new RefCounter()),
-    data(new std::vector<char>(l, c)),
+    shared(l > 0 ? new SharedVector(l, c) : 0),
     offset(0),
     length(l) {}
 
   ByteVectorPrivate(const char *s, unsigned int l) :
-    counter(new RefCounter()),
-    data(new std::vector<char>(s, s + l)),
+    shared(l > 0 ? new SharedVector(s, l) : 0),
     offset(0),
     length(l) {}
 
   ByteVectorPrivate(const ByteVectorPrivate &d, unsigned int o, unsigned int l) :
-    counter(d.counter),
-    data(d.data),
-    offset(d.offset + o),
+    shared(l > 0 ? d.shared : 0),
+    offset(l > 0 ? d.offset + o : 0),
     length(l)
   {
-    counter->ref();
+    if(shared)
+      shared->ref();
   }
 
   ~ByteVectorPrivate()
   {
-    if(counter->deref()) {
-      delete counter;
-      delete data;
+    if(shared)
+      shared->deref();
+  }
+
+  char *data()
+  {
+    return shared ? &shared->data[offset] : 0;
+  }
+
+  const char *data() const
+  {
+    return shared ? &shared->data[offset] : 0;
+  }
+
+  std::vector<char>::iterator begin()
+  {
+    return shared ? shared->data.begin() + offset : emptyVector().begin();
+  }
+
+  std::vector<char>::const_iterator begin() const
+  {
+    return shared ? shared->data.begin() + offset : emptyVector().begin();
+  }
+
+  bool isShared() const
+  {
+    return shared && shared->isShared();
+  }
+
+  // Makes the bytes writable by this vector alone and resizes them.  The
+  // first bytes are kept, up to size, and the rest are set to padding.
+
+  void resize(unsigned int size, char padding)
+  {
+    if(size == 0) {
+      if(shared)
+        shared->deref();
+      shared = 0;
+      offset = 0;
     }
+    else if(!shared || shared->isShared()) {
+      SharedVector *copy = new SharedVector(size, padding);
+      if(length > 0)
+        ::memcpy(&copy->data[0], data(), std::min(length, size));
+
+      if(shared)
+        shared->deref();
+      shared = copy;
+      offset = 0;
+    }
+    else {
+      // Remove the bytes past this vector first to pad correctly.  This
+      // doesn't reallocate, since std::vector::resize() doesn't when
+      // shrinking, and growing is geometric.
+
+      shared->data.resize(offset + length);
+      shared->data.resize(offset + size, padding);
+    }
+
+    length = size;
   }
 
-  RefCounter        *counter;
-  std::vector<char> *data;
-  unsigned int       offset;
-  unsigned int       length;
+  SharedVector *shared;
+  unsigned int  offset;
+  unsigned int  length;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -398,12 +733,12 @@ ByteVector &ByteVector::setData(const char *data)
 char *ByteVector::data()
 {
   detach();
-  return (size() > 0) ? (&(*d->data)[d->offset]) : 0;
+  return (size() > 0) ? d->data() : 0;
 }
 
 const char *ByteVector::data() const
 {
-  return (size() > 0) ? (&(*d->data)[d->offset]) : 0;
+  return (size() > 0) ? d->data() : 0;
 }
 
 ByteVector ByteVector::mid(unsigned int index, unsigned int length) const
@@ -416,18 +751,35 @@ ByteVector ByteVector::mid(unsigned int index, unsigned int length) const
 
 char ByteVector::at(unsigned int index) const
 {
-  return (index < size()) ? (*d->data)[d->offset + index] : 0;
+  return (index < size()) ? d->data()[index] : 0;
 }
 
 int ByteVector::find(const ByteVector &pattern, unsigned int offset, int byteAlign) const
 {
-  return findVector<ConstIterator>(
-    begin(), end(), pattern.begin(), pattern.end(), offset, byteAlign);
+  if(byteAlign != 1) {
+    return findVector<ConstIterator>(
+      begin(), end(), pattern.begin(), pattern.end(), offset, byteAlign);
+  }
+
+  if(pattern.isEmpty() || offset >= size() || pattern.size() > size() - offset)
+    return -1;
+
+  const int pos = findFunction(size() - offset)(
+    data() + offset, size() - offset, pattern.data(), pattern.size());
+
+  return pos >= 0 ? static_cast<int>(offset + pos) : -1;
 }
 
 int ByteVector::find(char c, unsigned int offset, int byteAlign) const
 {
-  return findChar<ConstIterator>(begin(), end(), c, offset, byteAlign);
+  if(byteAlign != 1)
+    return findChar<ConstIterator>(begin(), end(), c, offset, byteAlign);
+
+  if(offset >= size())
+    return -1;
+
+  const char *p = static_cast<const char *>(::memchr(data() + offset, c, size() - offset));
+  return p ? static_cast<int>(p - data()) : -1;
 }
 
 int ByteVector::rfind(const ByteVector &pattern, unsigned int offset, int byteAlign) const
@@ -438,6 +790,14 @@ int ByteVector::rfind(const ByteVector &pattern, unsigned int offset, int byteAl
       offset = 0;
   }
 
+  if(byteAlign == 1) {
+    if(pattern.isEmpty() || pattern.size() + offset > size())
+      return -1;
+
+    const size_t searchSize = size() - offset;
+    return rfindFunction(searchSize)(data(), searchSize, pattern.data(), pattern.size());
+  }
+
   const int pos = findVector<ConstReverseIterator>(
     rbegin(), rend(), pattern.rbegin(), pattern.rend(), offset, byteAlign);
 
@@ -596,18 +956,8 @@ unsigned int ByteVector::size() const
 
 ByteVector &ByteVector::resize(unsigned int size, char padding)
 {
-  if(size != d->length) {
-    detach();
-
-    // Remove the excessive length of the internal buffer first to pad correctly.
-    // This doesn't reallocate the buffer, since std::vector::resize() doesn't
-    // reallocate the buffer when shrinking.
-
-    d->data->resize(d->offset + d->length);
-    d->data->resize(d->offset + size, padding);
-
-    d->length = size;
-  }
+  if(size != d->length)
+    d->resize(size, padding);
 
   return *this;
 }
@@ -615,51 +965,43 @@ ByteVector &ByteVector::resize(unsigned int size, char padding)
 ByteVector::Iterator ByteVector::begin()
 {
   detach();
-  return d->data->begin() + d->offset;
+  return d->begin();
 }
 
 ByteVector::ConstIterator ByteVector::begin() const
 {
-  return d->data->begin() + d->offset;
+  return static_cast<const ByteVectorPrivate *>(d)->begin();
 }
 
 ByteVector::Iterator ByteVector::end()
 {
   detach();
-  return d->data->begin() + d->offset + d->length;
+  return d->begin() + d->length;
 }
 
 ByteVector::ConstIterator ByteVector::end() const
 {
-  return d->data->begin() + d->offset + d->length;
+  return static_cast<const ByteVectorPrivate *>(d)->begin() + d->length;
 }
 
 ByteVector::ReverseIterator ByteVector::rbegin()
 {
-  detach();
-  return d->data->rbegin() + (d->data->size() - (d->offset + d->length));
+  return ReverseIterator(end());
 }
 
 ByteVector::ConstReverseIterator ByteVector::rbegin() const
 {
-  // Workaround for the Solaris Studio 12.4 compiler.
-  // We need a const reference to the data vector so we can ensure the const version of rbegin() is called.
-  const std::vector<char> &v = *d->data;
-  return v.rbegin() + (v.size() - (d->offset + d->length));
+  return ConstReverseIterator(end());
 }
 
 ByteVector::ReverseIterator ByteVector::rend()
 {
-  detach();
-  return d->data->rbegin() + (d->data->size() - d->offset);
+  return ReverseIterator(begin());
 }
 
 ByteVector::ConstReverseIterator ByteVector::rend() const
 {
-  // Workaround for the Solaris Studio 12.4 compiler.
-  // We need a const reference to the data vector so we can ensure the const version of rbegin() is called.
-  const std::vector<char> &v = *d->data;
-  return v.rbegin() + (v.size() - d->offset);
+  return ConstReverseIterator(begin());
 }
 
 bool ByteVector::isNull() const
@@ -674,56 +1016,7 @@ bool ByteVector::isEmpty() const
 
 unsigned int ByteVector::checksum() const
 {
-  static const unsigned int crcTable[256] = {
-    0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9, 0x130476dc, 0x17c56b6b,
-    0x1a864db2, 0x1e475005, 0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61,
-    0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd, 0x4c11db70, 0x48d0c6c7,
-    0x4593e01e, 0x4152fda9, 0x5f15adac, 0x5bd4b01b, 0x569796c2, 0x52568b75,
-    0x6a1936c8, 0x6ed82b7f, 0x639b0da6, 0x675a1011, 0x791d4014, 0x7ddc5da3,
-    0x709f7b7a, 0x745e66cd, 0x9823b6e0, 0x9ce2ab57, 0x91a18d8e, 0x95609039,
-    0x8b27c03c, 0x8fe6dd8b, 0x82a5fb52, 0x8664e6e5, 0xbe2b5b58, 0xbaea46ef,
-    0xb7a96036, 0xb3687d81, 0xad2f2d84, 0xa9ee3033, 0xa4ad16ea, 0xa06c0b5d,
-    0xd4326d90, 0xd0f37027, 0xddb056fe, 0xd9714b49, 0xc7361b4c, 0xc3f706fb,
-    0xceb42022, 0xca753d95, 0xf23a8028, 0xf6fb9d9f, 0xfbb8bb46, 0xff79a6f1,
-    0xe13ef6f4, 0xe5ffeb43, 0xe8bccd9a, 0xec7dd02d, 0x34867077, 0x30476dc0,
-    0x3d044b19, 0x39c556ae, 0x278206ab, 0x23431b1c, 0x2e003dc5, 0x2ac12072,
-    0x128e9dcf, 0x164f8078, 0x1b0ca6a1, 0x1fcdbb16, 0x018aeb13, 0x054bf6a4,
-    0x0808d07d, 0x0cc9cdca, 0x7897ab07, 0x7c56b6b0, 0x71159069, 0x75d48dde,
-    0x6b93dddb, 0x6f52c06c, 0x6211e6b5, 0x66d0fb02, 0x5e9f46bf, 0x5a5e5b08,
-    0x571d7dd1, 0x53dc6066, 0x4d9b3063, 0x495a2dd4, 0x44190b0d, 0x40d816ba,
-    0xaca5c697, 0xa864db20, 0xa527fdf9, 0xa1e6e04e, 0xbfa1b04b, 0xbb60adfc,
-    0xb6238b25, 0xb2e29692, 0x8aad2b2f, 0x8e6c3698, 0x832f1041, 0x87ee0df6,
-    0x99a95df3, 0x9d684044, 0x902b669d, 0x94ea7b2a, 0xe0b41de7, 0xe4750050,
-    0xe9362689, 0xedf73b3e, 0xf3b06b3b, 0xf771768c, 0xfa325055, 0xfef34de2,
-    0xc6bcf05f, 0xc27dede8, 0xcf3ecb31, 0xcbffd686, 0xd5b88683, 0xd1799b34,
-    0xdc3abded, 0xd8fba05a, 0x690ce0ee, 0x6dcdfd59, 0x608edb80, 0x644fc637,
-    0x7a089632, 0x7ec98b85, 0x738aad5c, 0x774bb0eb, 0x4f040d56, 0x4bc510e1,
-    0x46863638, 0x42472b8f, 0x5c007b8a, 0x58c1663d, 0x558240e4, 0x51435d53,
-    0x251d3b9e, 0x21dc2629, 0x2c9f00f0, 0x285e1d47, 0x36194d42, 0x32d850f5,
-    0x3f9b762c, 0x3b5a6b9b, 0x0315d626, 0x07d4cb91, 0x0a97ed48, 0x0e56f0ff,
-    0x1011a0fa, 0x14d0bd4d, 0x19939b94, 0x1d528623, 0xf12f560e, 0xf5ee4bb9,
-    0xf8ad6d60, 0xfc6c70d7, 0xe22b20d2, 0xe6ea3d65, 0xeba91bbc, 0xef68060b,
-    0xd727bbb6, 0xd3e6a601, 0xdea580d8, 0xda649d6f, 0xc423cd6a, 0xc0e2d0dd,
-    0xcda1f604, 0xc960ebb3, 0xbd3e8d7e, 0xb9ff90c9, 0xb4bcb610, 0xb07daba7,
-    0xae3afba2, 0xaafbe615, 0xa7b8c0cc, 0xa379dd7b, 0x9b3660c6, 0x9ff77d71,
-    0x92b45ba8, 0x9675461f, 0x8832161a, 0x8cf30bad, 0x81b02d74, 0x857130c3,
-    0x5d8a9099, 0x594b8d2e, 0x5408abf7, 0x50c9b640, 0x4e8ee645, 0x4a4ffbf2,
-    0x470cdd2b, 0x43cdc09c, 0x7b827d21, 0x7f436096, 0x7200464f, 0x76c15bf8,
-    0x68860bfd, 0x6c47164a, 0x61043093, 0x65c52d24, 0x119b4be9, 0x155a565e,
-    0x18197087, 0x1cd86d30, 0x029f3d35, 0x065e2082, 0x0b1d065b, 0x0fdc1bec,
-    0x3793a651, 0x3352bbe6, 0x3e119d3f, 0x3ad08088, 0x2497d08d, 0x2056cd3a,
-    0x2d15ebe3, 0x29d4f654, 0xc5a92679, 0xc1683bce, 0xcc2b1d17, 0xc8ea00a0,
-    0xd6ad50a5, 0xd26c4d12, 0xdf2f6bcb, 0xdbee767c, 0xe3a1cbc1, 0xe760d676,
-    0xea23f0af, 0xeee2ed18, 0xf0a5bd1d, 0xf464a0aa, 0xf9278673, 0xfde69bc4,
-    0x89b8fd09, 0x8d79e0be, 0x803ac667, 0x84fbdbd0, 0x9abc8bd5, 0x9e7d9662,
-    0x933eb0bb, 0x97ffad0c, 0xafb010b1, 0xab710d06, 0xa6322bdf, 0xa2f33668,
-    0xbcb4666d, 0xb8757bda, 0xb5365d03, 0xb1f740b4
-  };
-
-  unsigned int sum = 0;
-  for(ByteVector::ConstIterator it = begin(); it != end(); ++it)
-    sum = (sum << 8) ^ crcTable[((sum >> 24) & 0xff) ^ static_cast<unsigned char>(*it)];
-  return sum;
+  return CRC::update(0, data(), size());
 }
 
 unsigned int ByteVector::toUInt(bool mostSignificantByteFirst) const
@@ -803,13 +1096,13 @@ long double ByteVector::toFloat80BE(size_t offset) const
 
 const char &ByteVector::operator[](int index) const
 {
-  return (*d->data)[d->offset + index];
+  return d->data()[index];
 }
 
 char &ByteVector::operator[](int index)
 {
   detach();
-  return (*d->data)[d->offset + index];
+  return d->data()[index];
 }
 
 bool ByteVector::operator==(const ByteVector &v) const
@@ -1023,12 +1316,8 @@ ByteVector ByteVector::toBase64() const
 
 void ByteVector::detach()
 {
-  if(d->counter->count() > 1) {
-    if(!isEmpty())
-      ByteVector(&d->data->front() + d->offset, d->length).swap(*this);
-    else
-      ByteVector().swap(*this);
-  }
+  if(d->isShared())
+    d->resize(d->length, '\0');
 }
 }
 
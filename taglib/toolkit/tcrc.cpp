@@ -0,0 +1,273 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#if defined(HAVE_GCC_PCLMUL)
+# include <immintrin.h>
+#endif
+
+#include "tcrc.h"
+
+using namespace TagLib;
+
+namespace
+{
+  const unsigned int Polynomial = 0x04c11db7;
+
+  // Returns a * b modulo the polynomial.
+
+  unsigned int multiply(unsigned int a, unsigned int b)
+  {
+    unsigned int product = 0;
+    for(int i = 31; i >= 0; --i) {
+      product = (product << 1) ^ ((product & 0x80000000) ? Polynomial : 0);
+      if(b & (1U << i))
+        product ^= a;
+    }
+    return product;
+  }
+
+  inline unsigned int readBigEndian(const unsigned char *p)
+  {
+    return (static_cast<unsigned int>(p[0]) << 24) | (static_cast<unsigned int>(p[1]) << 16)
+         | (static_cast<unsigned int>(p[2]) << 8)  |  static_cast<unsigned int>(p[3]);
+  }
+
+  // Slicing-by-8: table[n][b] is the checksum of the byte b followed by n
+  // zero bytes, so that eight bytes can be processed with independent lookups.
+
+  class SlicingTable
+  {
+  public:
+    SlicingTable()
+    {
+      for(unsigned int b = 0; b < 256; ++b) {
+        unsigned int crc = b << 24;
+        for(int bit = 0; bit < 8; ++bit)
+          crc = (crc << 1) ^ ((crc & 0x80000000) ? Polynomial : 0);
+        table[0][b] = crc;
+      }
+      for(unsigned int n = 1; n < 8; ++n) {
+        for(unsigned int b = 0; b < 256; ++b)
+          table[n][b] = (table[n - 1][b] << 8) ^ table[0][table[n - 1][b] >> 24];
+      }
+    }
+
+    unsigned int table[8][256];
+  };
+
+  const SlicingTable slicing;
+
+  // Returns a * b modulo the polynomial like multiply(), but four bits at a
+  // time and with the upper half of the product reduced by the table: that
+  // half is four bytes followed by four zero bytes, whose checksum it takes.
+
+  unsigned int multiplyFast(unsigned int a, unsigned int b)
+  {
+    unsigned long long multiples[16];
+    multiples[0] = 0;
+    for(unsigned int k = 1; k < 16; ++k)
+      multiples[k] = (k & 1) ? (multiples[k - 1] ^ a) : (multiples[k / 2] << 1);
+
+    unsigned long long product = 0;
+    for(int shift = 28; shift >= 0; shift -= 4)
+      product = (product << 4) ^ multiples[(b >> shift) & 0xf];
+
+    const unsigned int (*const t)[256] = slicing.table;
+    const unsigned int high = static_cast<unsigned int>(product >> 32);
+
+    return static_cast<unsigned int>(product)
+      ^ t[3][high >> 24] ^ t[2][(high >> 16) & 0xff] ^ t[1][(high >> 8) & 0xff] ^ t[0][high & 0xff];
+  }
+
+  // factors[i] shifts a checksum over 2^i zero bytes.
+
+  class ShiftTable
+  {
+  public:
+    ShiftTable()
+    {
+      factors[0] = 0x100;
+      for(unsigned int i = 1; i < sizeof(factors) / sizeof(factors[0]); ++i)
+        factors[i] = multiply(factors[i - 1], factors[i - 1]);
+    }
+
+    unsigned int factors[sizeof(size_t) * 8];
+  };
+
+  const ShiftTable shifting;
+
+  unsigned int updateSlicing(unsigned int crc, const unsigned char *data, size_t length)
+  {
+    const unsigned int (*const t)[256] = slicing.table;
+
+    for(; length >= 8; data += 8, length -= 8) {
+      const unsigned int a = crc ^ readBigEndian(data);
+      const unsigned int b = readBigEndian(data + 4);
+      crc = t[7][a >> 24] ^ t[6][(a >> 16) & 0xff] ^ t[5][(a >> 8) & 0xff] ^ t[4][a & 0xff]
+          ^ t[3][b >> 24] ^ t[2][(b >> 16) & 0xff] ^ t[1][(b >> 8) & 0xff] ^ t[0][b & 0xff];
+    }
+
+    for(; length > 0; ++data, --length)
+      crc = (crc << 8) ^ t[0][(crc >> 24) ^ *data];
+
+    return crc;
+  }
+
+#if defined(HAVE_GCC_PCLMUL)
+
+  // Folding with carry-less multiplication.  Four 16 byte blocks are kept in
+  // registers, with the first byte in the most significant position.  Each
+  // block is folded onto the one 64 bytes ahead by multiplying its two halves
+  // by x^(512 + 64) and x^512 modulo the polynomial, which keeps the blocks
+  // congruent to the data read so far.  At the end the blocks are folded into
+  // one, whose checksum is that of the data.
+
+  class FoldingConstants
+  {
+  public:
+    FoldingConstants() :
+      fold64Low(CRC::appendZeros(1, 64)),
+      fold64High(CRC::appendZeros(1, 64 + 8)),
+      fold16Low(CRC::appendZeros(1, 16)),
+      fold16High(CRC::appendZeros(1, 16 + 8)) {}
+
+    const unsigned int fold64Low;
+    const unsigned int fold64High;
+    const unsigned int fold16Low;
+    const unsigned int fold16High;
+  };
+
+  const FoldingConstants folding;
+
+  // Not worth setting up the vector registers for.
+
+  const size_t ShortChecksum = 256;
+
+  __attribute__((target("pclmul,ssse3")))
+  inline __m128i loadBlock(const unsigned char *p, __m128i reverse)
+  {
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), reverse);
+  }
+
+  __attribute__((target("pclmul,ssse3")))
+  inline __m128i fold(__m128i block, __m128i constants, __m128i next)
+  {
+    const __m128i low  = _mm_clmulepi64_si128(block, constants, 0x00);
+    const __m128i high = _mm_clmulepi64_si128(block, constants, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(low, high), next);
+  }
+
+  __attribute__((target("pclmul,ssse3")))
+  unsigned int updatePCLMUL(unsigned int crc, const unsigned char *data, size_t length)
+  {
+    const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i fold64 = _mm_set_epi64x(folding.fold64High, folding.fold64Low);
+    const __m128i fold16 = _mm_set_epi64x(folding.fold16High, folding.fold16Low);
+
+    // Starting from a checksum is the same as adding it to the first bytes.
+
+    __m128i x0 = _mm_xor_si128(loadBlock(data, reverse), _mm_set_epi32(static_cast<int>(crc), 0, 0, 0));
+    __m128i x1 = loadBlock(data + 16, reverse);
+    __m128i x2 = loadBlock(data + 32, reverse);
+    __m128i x3 = loadBlock(data + 48, reverse);
+
+    for(data += 64, length -= 64; length >= 64; data += 64, length -= 64) {
+      x0 = fold(x0, fold64, loadBlock(data,      reverse));
+      x1 = fold(x1, fold64, loadBlock(data + 16, reverse));
+      x2 = fold(x2, fold64, loadBlock(data + 32, reverse));
+      x3 = fold(x3, fold64, loadBlock(data + 48, reverse));
+    }
+
+    x1 = fold(x0, fold16, x1);
+    x2 = fold(x1, fold16, x2);
+    x3 = fold(x2, fold16, x3);
+
+    for(; length >= 16; data += 16, length -= 16)
+      x3 = fold(x3, fold16, loadBlock(data, reverse));
+
+    unsigned char block[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(block), _mm_shuffle_epi8(x3, reverse));
+
+    return updateSlicing(updateSlicing(0, block, 16), data, length);
+  }
+
+  bool hasPCLMUL()
+  {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") != 0 && __builtin_cpu_supports("ssse3") != 0;
+  }
+
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int CRC::update(unsigned int crc, const char *data, size_t length)
+{
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+
+#if defined(HAVE_GCC_PCLMUL)
+  static const bool pclmul = hasPCLMUL();
+  if(pclmul && length >= ShortChecksum)
+    return updatePCLMUL(crc, bytes, length);
+#endif
+
+  return updateSlicing(crc, bytes, length);
+}
+
+unsigned int CRC::appendZeros(unsigned int crc, size_t length)
+{
+  for(unsigned int i = 0; length > 0; ++i, length >>= 1) {
+    if(length & 1)
+      crc = multiplyFast(crc, shifting.factors[i]);
+  }
+  return crc;
+}
+
+unsigned int CRC::replace(unsigned int crc, size_t length, size_t offset,
+                          const char *oldData, const char *newData, size_t count)
+{
+  if(offset > length || count > length - offset)
+    return crc;
+
+  // The checksum of the difference, moved to where it is in the block.
+
+  const unsigned int (*const t)[256] = slicing.table;
+
+  unsigned int difference = 0;
+  for(size_t i = 0; i < count; ++i) {
+    const unsigned char delta = static_cast<unsigned char>(oldData[i] ^ newData[i]);
+    difference = (difference << 8) ^ t[0][(difference >> 24) ^ delta];
+  }
+
+  return crc ^ appendZeros(difference, length - offset - count);
+}
@@ -0,0 +1,81 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_CRC_H
+#define TAGLIB_CRC_H
+
+#include <cstddef>
+
+#include "taglib_export.h"
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  /*!
+   * The CRC-32 used by Ogg pages and returned by ByteVector::checksum(): the
+   * polynomial 0x04c11db7, processed most significant bit first, with no
+   * initial value and no final inversion.
+   *
+   * Since the checksum starts from zero and is not inverted, it is linear in
+   * the data: changing a few bytes of a block changes its checksum by an
+   * amount that only depends on the change and on its distance from the end
+   * of the block.  replace() uses this to update a checksum without reading
+   * the rest of the block again.
+   */
+
+  namespace CRC {
+
+    /*!
+     * Returns the checksum of the data that \a crc was computed over followed
+     * by the \a length bytes at \a data.  Pass 0 as \a crc to start a new
+     * checksum.
+     */
+    TAGLIB_EXPORT unsigned int update(unsigned int crc, const char *data, size_t length);
+
+    /*!
+     * Returns the checksum of the data that \a crc was computed over followed
+     * by \a length zero bytes.
+     */
+    TAGLIB_EXPORT unsigned int appendZeros(unsigned int crc, size_t length);
+
+    /*!
+     * Returns the checksum of a block of \a length bytes with checksum \a crc
+     * after the \a count bytes at \a offset have been changed from
+     * \a oldData to \a newData.
+     */
+    TAGLIB_EXPORT unsigned int replace(unsigned int crc, size_t length, size_t offset,
+                                       const char *oldData, const char *newData,
+                                       size_t count);
+
+  }
+}
+
+#endif
+
+#endif
@@ -32,6 +32,7 @@
 #include "tdebug.h"
 #include "tstring.h"
 #include "tdebuglistener.h"
+#include "tthread.h"
 #include "tutils.h"
 
 #include <bitset>
@@ -41,22 +42,32 @@
 namespace TagLib
 {
   // The instance is defined in tdebuglistener.cpp.
-  extern DebugListener *debugListener;
+  extern void *volatile debugListener;
+
+  namespace
+  {
+    DebugListener *currentListener()
+    {
+      return static_cast<DebugListener *>(Thread::loadPointer(&debugListener));
+    }
+  }
 
   void debug(const String &s)
   {
-    debugListener->printMessage("TagLib: " + s + "\n");
+    currentListener()->printMessage("TagLib: " + s + "\n");
   }
 
   void debugData(const ByteVector &v)
   {
+    DebugListener *listener = currentListener();
+
     for(unsigned int i = 0; i < v.size(); ++i) {
       const std::string bits = std::bitset<8>(v[i]).to_string();
       const String msg = Utils::formatString(
         "*** [%u] - char '%c' - int %d, 0x%02x, 0b%s\n",
         i, v[i], v[i], v[i], bits.c_str());
 
-      debugListener->printMessage(msg);
+      listener->printMessage(msg);
     }
   }
 }
@@ -24,6 +24,7 @@
  ***************************************************************************/
 
 #include "tdebuglistener.h"
+#include "tthread.h"
 
 #include <iostream>
 #include <bitset>
@@ -65,7 +66,9 @@ namespace
 
 namespace TagLib
 {
-  DebugListener *debugListener = &defaultListener;
+  // Read by debug() on any thread.
+
+  void *volatile debugListener = &defaultListener;
 
   DebugListener::DebugListener()
   {
@@ -77,9 +80,9 @@ namespace TagLib
 
   void setDebugListener(DebugListener *listener)
   {
-    if(listener)
-      debugListener = listener;
-    else
-      debugListener = &defaultListener;
+    if(!listener)
+      listener = &defaultListener;
+
+    Thread::storePointer(&debugListener, listener);
   }
 }
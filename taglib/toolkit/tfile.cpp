@@ -25,9 +25,13 @@
 
 #include "tfile.h"
 #include "tfilestream.h"
+#include "twriteplan.h"
 #include "tstring.h"
 #include "tdebug.h"
 #include "tpropertymap.h"
+#include "tpayload.h"
+
+#include <algorithm>
 
 #ifdef _WIN32
 # include <windows.h>
@@ -66,25 +70,180 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // Scans and shifts start with File::bufferSize() bytes and may grow up to
+  // this size, unless changed by File::setBufferSize().
+
+  const unsigned int DefaultMaximumBufferSize = 1024 * 1024;
+
+  // Returns \a stream if it is a file on disk that was opened by its name,
+  // and can therefore be replaced by a new file.  A stream opened from a file
+  // descriptor has no name.
+
+  FileStream *replaceableStream(IOStream *stream)
+  {
+    FileStream *const fileStream = dynamic_cast<FileStream *>(stream);
+    if(!fileStream)
+      return 0;
+
+#ifdef _WIN32
+    const FileName name = fileStream->name();
+    if(name.wstr().empty() && name.str().empty())
+      return 0;
+#else
+    const char *const name = fileStream->name();
+    if(!name || name[0] == '\0')
+      return 0;
+#endif
+
+    return fileStream;
+  }
+}
+
 class File::FilePrivate
 {
 public:
   FilePrivate(IOStream *stream, bool owner) :
     stream(stream),
     streamOwner(owner),
-    valid(true) {}
+    valid(true),
+    initialBufferSize(File::bufferSize()),
+    maximumBufferSize(DefaultMaximumBufferSize),
+    paddingSet(false),
+    minimumPadding(0),
+    maximumPadding(0),
+    saveDepth(0),
+    dataShifted(false),
+    saveMode(File::InPlace),
+    pictureReading(File::ReadPictures),
+    plan(0),
+    originalStream(0) {}
 
   ~FilePrivate()
   {
+    for(List<Payload>::Iterator it = payloads.begin(); it != payloads.end(); ++it)
+      it->unsetFile();
+
+    if(plan) {
+      delete plan;
+      stream = originalStream;
+    }
+
     if(streamOwner)
       delete stream;
   }
 
+  void loadPayloads();
+  void beginSave();
+  bool endSave();
+
   IOStream *stream;
   bool streamOwner;
   bool valid;
+  unsigned int initialBufferSize;
+  unsigned int maximumBufferSize;
+  bool paddingSet;
+  unsigned int minimumPadding;
+  unsigned int maximumPadding;
+  int saveDepth;
+  bool dataShifted;
+  File::SaveMode saveMode;
+  File::PictureReading pictureReading;
+  WritePlan *plan;
+  IOStream *originalStream;
+
+  // The payloads that still refer to the file.
+
+  List<Payload> payloads;
 };
 
+void File::FilePrivate::loadPayloads()
+{
+  // Saving may move the data that the payloads refer to, so the ones that
+  // are still used somewhere are read before.
+
+  for(List<Payload>::Iterator it = payloads.begin(); it != payloads.end(); ++it) {
+    if(it->isShared())
+      it->load();
+  }
+
+  payloads.clear();
+}
+
+void File::FilePrivate::beginSave()
+{
+  // The writes are collected and made when the save is complete, so that the
+  // data following several changed tags is moved only once.
+
+  if(!stream || !stream->isOpen() || stream->readOnly())
+    return;
+
+  // Only a file on disk can be replaced by a new one.
+
+  if(saveMode == File::Atomic && !replaceableStream(stream))
+    debug("File::save() -- Can not replace this stream, saving in place.");
+
+  plan = new WritePlan(stream);
+  originalStream = stream;
+  stream = plan;
+}
+
+bool File::FilePrivate::endSave()
+{
+  if(!plan)
+    return true;
+
+  WritePlan *const writePlan = plan;
+  stream = originalStream;
+  plan = 0;
+  originalStream = 0;
+
+  bool saved = true;
+
+  if(writePlan->isModified()) {
+    FileStream *const fileStream = replaceableStream(stream);
+
+    if(saveMode == File::Atomic && fileStream) {
+
+#ifdef _WIN32
+      const FileName name = fileStream->name();
+#else
+      const std::string nameString = fileStream->name();
+      const FileName name = nameString.c_str();
+#endif
+
+      if(writePlan->writeTemporaryFile(name)) {
+
+        // Windows can't replace a file that is still open.
+
+        fileStream->close();
+        const bool replaced = writePlan->replaceFile();
+
+        // A file that can't be opened for writing again can't be used any
+        // more, and the writes can't be made to it, so the save fails.
+
+        if(!fileStream->reopen()) {
+          debug("File::save() -- Could not reopen the file for writing.");
+          saved = false;
+        }
+        else if(!replaced) {
+          writePlan->apply(stream);
+        }
+      }
+      else {
+        writePlan->apply(stream);
+      }
+    }
+    else {
+      writePlan->apply(stream);
+    }
+  }
+
+  delete writePlan;
+  return saved;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
@@ -235,12 +394,15 @@ void File::writeBlock(const ByteVector &data)
 
 long File::find(const ByteVector &pattern, long fromOffset, const ByteVector &before)
 {
-  if(!d->stream || pattern.size() > bufferSize())
+  if(!d->stream || pattern.size() > initialBufferSize())
       return -1;
 
-  // The position in the file that the current buffer starts at.
+  // The position in the file that the current buffer starts at, and the
+  // size of the previous buffer.
 
   long bufferOffset = fromOffset;
+  unsigned int bufferLength = initialBufferSize();
+  unsigned int previousBufferLength = 0;
   ByteVector buffer;
 
   // These variables are used to keep track of a partial match that happens at
@@ -276,20 +438,20 @@ long File::find(const ByteVector &pattern, long fromOffset, const ByteVector &be
   // then check for "before".  The order is important because it gives priority
   // to "real" matches.
 
-  for(buffer = readBlock(bufferSize()); buffer.size() > 0; buffer = readBlock(bufferSize())) {
+  for(buffer = readBlock(bufferLength); buffer.size() > 0; buffer = readBlock(bufferLength)) {
 
     // (1) previous partial match
 
-    if(previousPartialMatch >= 0 && int(bufferSize()) > previousPartialMatch) {
-      const int patternOffset = (bufferSize() - previousPartialMatch);
+    if(previousPartialMatch >= 0 && int(previousBufferLength) > previousPartialMatch) {
+      const int patternOffset = (previousBufferLength - previousPartialMatch);
       if(buffer.containsAt(pattern, 0, patternOffset)) {
         seek(originalPosition);
-        return bufferOffset - bufferSize() + previousPartialMatch;
+        return bufferOffset - previousBufferLength + previousPartialMatch;
       }
     }
 
-    if(!before.isEmpty() && beforePreviousPartialMatch >= 0 && int(bufferSize()) > beforePreviousPartialMatch) {
-      const int beforeOffset = (bufferSize() - beforePreviousPartialMatch);
+    if(!before.isEmpty() && beforePreviousPartialMatch >= 0 && int(previousBufferLength) > beforePreviousPartialMatch) {
+      const int beforeOffset = (previousBufferLength - beforePreviousPartialMatch);
       if(buffer.containsAt(before, 0, beforeOffset)) {
         seek(originalPosition);
         return -1;
@@ -316,7 +478,9 @@ long File::find(const ByteVector &pattern, long fromOffset, const ByteVector &be
     if(!before.isEmpty())
       beforePreviousPartialMatch = buffer.endsWithPartialMatch(before);
 
-    bufferOffset += bufferSize();
+    bufferOffset += buffer.size();
+    previousBufferLength = buffer.size();
+    bufferLength = nextBufferSize(bufferLength);
   }
 
   // Since we hit the end of the file, reset the status before continuing.
@@ -331,21 +495,9 @@ long File::find(const ByteVector &pattern, long fromOffset, const ByteVector &be
 
 long File::rfind(const ByteVector &pattern, long fromOffset, const ByteVector &before)
 {
-  if(!d->stream || pattern.size() > bufferSize())
+  if(!d->stream || pattern.size() > initialBufferSize())
       return -1;
 
-  // The position in the file that the current buffer starts at.
-
-  ByteVector buffer;
-
-  // These variables are used to keep track of a partial match that happens at
-  // the end of a buffer.
-
-  /*
-  int previousPartialMatch = -1;
-  int beforePreviousPartialMatch = -1;
-  */
-
   // Save the location of the current read pointer.  We will restore the
   // position using seek() before all returns.
 
@@ -356,29 +508,29 @@ long File::rfind(const ByteVector &pattern, long fromOffset, const ByteVector &b
   if(fromOffset == 0)
     fromOffset = length();
 
-  long bufferLength = bufferSize();
-  long bufferOffset = fromOffset + pattern.size();
+  // The end of the next buffer to search, which is read backwards.
 
-  // See the notes in find() for an explanation of this algorithm.
+  long bufferLength = initialBufferSize();
+  long bufferEnd = fromOffset + pattern.size();
 
-  while(true) {
+  // See the notes in find() for an explanation of this algorithm.  Instead of
+  // remembering partial matches, each buffer overlaps the one searched before
+  // it by one byte less than the longer pattern.  A match that straddles two
+  // buffers is then wholly contained in the earlier one, and as any match in
+  // the later buffer starts after it, the last match is still found first.
 
-    if(bufferOffset > bufferLength) {
-      bufferOffset -= bufferLength;
-    }
-    else {
-      bufferLength = bufferOffset;
-      bufferOffset = 0;
-    }
+  const long overlap = std::min<long>(std::max(pattern.size(), before.size()), bufferLength) - 1;
+
+  while(bufferEnd > 0) {
+
+    const long bufferOffset = std::max(0L, bufferEnd - bufferLength);
     seek(bufferOffset);
 
-    buffer = readBlock(bufferLength);
+    const ByteVector buffer = readBlock(bufferEnd - bufferOffset);
     if(buffer.isEmpty())
       break;
 
-    // TODO: (1) previous partial match
-
-    // (2) pattern contained in current buffer
+    // pattern contained in current buffer
 
     const long location = buffer.rfind(pattern);
     if(location >= 0) {
@@ -391,7 +543,11 @@ long File::rfind(const ByteVector &pattern, long fromOffset, const ByteVector &b
       return -1;
     }
 
-    // TODO: (3) partial match
+    if(bufferOffset == 0)
+      break;
+
+    bufferEnd = bufferOffset + std::max(overlap, 0L);
+    bufferLength = nextBufferSize(bufferLength);
   }
 
   // Since we hit the end of the file, reset the status before continuing.
@@ -405,11 +561,19 @@ long File::rfind(const ByteVector &pattern, long fromOffset, const ByteVector &b
 
 void File::insert(const ByteVector &data, unsigned long start, unsigned long replace)
 {
+  // Anything but an overwrite of the same size moves the data behind it.
+
+  if(data.size() != replace && start + replace < static_cast<unsigned long>(length()))
+    d->dataShifted = true;
+
   d->stream->insert(data, start, replace);
 }
 
 void File::removeBlock(unsigned long start, unsigned long length)
 {
+  if(length > 0 && start + length < static_cast<unsigned long>(this->length()))
+    d->dataShifted = true;
+
   d->stream->removeBlock(start, length);
 }
 
@@ -453,6 +617,56 @@ long File::length()
   return d->stream->length();
 }
 
+void File::setBufferSize(unsigned int initialSize, unsigned int maximumSize)
+{
+  if(initialSize == 0)
+    initialSize = bufferSize();
+
+  d->initialBufferSize = initialSize;
+  d->maximumBufferSize = std::max(initialSize, maximumSize);
+
+  FileStream *fileStream = dynamic_cast<FileStream *>(d->stream);
+  if(fileStream)
+    fileStream->setBufferSize(d->initialBufferSize, d->maximumBufferSize);
+}
+
+void File::setPadding(unsigned int minimumSize, unsigned int maximumSize)
+{
+  d->paddingSet = true;
+  d->minimumPadding = minimumSize;
+  d->maximumPadding = std::max(minimumSize, maximumSize);
+}
+
+unsigned int File::minimumPadding(unsigned int defaultSize) const
+{
+  return d->paddingSet ? d->minimumPadding : defaultSize;
+}
+
+unsigned int File::maximumPadding(unsigned int defaultSize) const
+{
+  return d->paddingSet ? d->maximumPadding : defaultSize;
+}
+
+void File::setSaveMode(SaveMode mode)
+{
+  d->saveMode = mode;
+}
+
+File::SaveMode File::saveMode() const
+{
+  return d->saveMode;
+}
+
+bool File::lastSaveShiftedData() const
+{
+  return d->dataShifted;
+}
+
+File::PictureReading File::pictureReading() const
+{
+  return d->pictureReading;
+}
+
 bool File::isReadable(const char *file)
 {
 
@@ -492,8 +706,63 @@ unsigned int File::bufferSize()
   return 1024;
 }
 
+unsigned int File::initialBufferSize() const
+{
+  return d->initialBufferSize;
+}
+
+unsigned int File::nextBufferSize(unsigned int previousSize) const
+{
+  if(previousSize >= d->maximumBufferSize / 2)
+    return d->maximumBufferSize;
+
+  return std::max(previousSize * 2, d->initialBufferSize);
+}
+
+File::SaveScope::SaveScope(File *file) :
+  file(file),
+  finished(false)
+{
+  if(file->d->saveDepth++ == 0) {
+    file->d->dataShifted = false;
+    file->d->loadPayloads();
+    file->d->beginSave();
+  }
+}
+
+File::SaveScope::~SaveScope()
+{
+  finish();
+}
+
+bool File::SaveScope::finish()
+{
+  if(finished)
+    return true;
+
+  finished = true;
+
+  if(--file->d->saveDepth == 0)
+    return file->d->endSave();
+
+  return true;
+}
+
 void File::setValid(bool valid)
 {
   d->valid = valid;
 }
 
+void File::setPictureReading(PictureReading reading)
+{
+  d->pictureReading = reading;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void File::addPayload(const Payload &payload)
+{
+  d->payloads.append(payload);
+}
@@ -38,6 +38,7 @@ namespace TagLib {
   class Tag;
   class AudioProperties;
   class PropertyMap;
+  class Payload;
 
   //! A file class with some useful methods for tag manipulation
 
@@ -62,6 +63,31 @@ namespace TagLib {
       End
     };
 
+    /*!
+     * How save() writes the changes to the file.
+     *
+     * \see setSaveMode()
+     */
+    enum SaveMode {
+      //! Modify the file in place.
+      InPlace,
+      //! Write a new copy of the file and rename it over the original.
+      Atomic
+    };
+
+    /*!
+     * Whether the embedded pictures are read when the file is opened.
+     *
+     * \see pictureReading()
+     */
+    enum PictureReading {
+      //! Read the pictures with the rest of the tags.
+      ReadPictures,
+      //! Only record where the picture data is, and read it when it is asked
+      //! for.
+      SkipPictures
+    };
+
     /*!
      * Destroys this File instance.
      */
@@ -161,7 +187,7 @@ namespace TagLib {
      * file.
      *
      * \note This has the practical limitation that \a pattern can not be longer
-     * than the buffer size used by readBlock().  Currently this is 1024 bytes.
+     * than the initial buffer size.  By default this is 1024 bytes.
      */
     long find(const ByteVector &pattern,
               long fromOffset = 0,
@@ -177,7 +203,7 @@ namespace TagLib {
      * beginning of the file and defaults to the end of the file.
      *
      * \note This has the practical limitation that \a pattern can not be longer
-     * than the buffer size used by readBlock().  Currently this is 1024 bytes.
+     * than the initial buffer size.  By default this is 1024 bytes.
      */
     long rfind(const ByteVector &pattern,
                long fromOffset = 0,
@@ -240,6 +266,125 @@ namespace TagLib {
      */
     long length();
 
+    /*!
+     * Sets the sizes of the buffer used by find(), rfind() and the frame and
+     * tag scanners of the file types.  A scan starts by reading \a initialSize
+     * bytes and doubles the size of each following read until it reaches
+     * \a maximumSize, so that long scans do not need thousands of small reads.
+     *
+     * If the file is backed by a FileStream, the same sizes are also used when
+     * insert() or removeBlock() have to shift the rest of the file.
+     *
+     * By default, scans start with 1024 bytes and grow up to 1 MiB.  Setting
+     * both sizes to 1024 restores the fixed-size behavior of older versions of
+     * TagLib.
+     *
+     * \see FileStream::setBufferSize()
+     */
+    void setBufferSize(unsigned int initialSize, unsigned int maximumSize);
+
+    /*!
+     * Sets the amount of free space that save() reserves next to the tags, so
+     * that later saves can overwrite the tags in place instead of shifting the
+     * rest of the file.
+     *
+     * When a tag is written for the first time or outgrows the space it
+     * occupies, \a minimumSize bytes of padding are added after it.  When a
+     * tag shrinks, the freed space is kept as padding as long as it is not
+     * larger than \a maximumSize; for ID3v2 and FLAC it must also not be
+     * larger than 1% of the file size, unless it is within \a minimumSize.
+     * Larger padding is reduced to \a minimumSize again.
+     *
+     * This is honored by ID3v2 tags, FLAC metadata, the MP4 'ilst' atom and the
+     * comment header of Ogg Vorbis, Opus and Speex files.  If this has not been
+     * called, each format uses its own defaults: 1024 bytes up to 1 MiB for
+     * ID3v2, 4096 bytes up to 1 MiB for FLAC, a 'free' atom rounding 'ilst' up
+     * to a multiple of 1024 bytes for MP4 and no padding for Ogg.  When this
+     * has been called, an Ogg comment header that grows or shrinks is also
+     * kept on as many pages as before when it fits, so that the pages after
+     * it don't have to be renumbered.
+     *
+     * \see lastSaveShiftedData()
+     */
+    void setPadding(unsigned int minimumSize, unsigned int maximumSize);
+
+    /*!
+     * Returns the minimum padding set by setPadding(), or \a defaultSize if
+     * setPadding() has not been called.
+     */
+    unsigned int minimumPadding(unsigned int defaultSize) const;
+
+    /*!
+     * Returns the maximum padding set by setPadding(), or \a defaultSize if
+     * setPadding() has not been called.
+     */
+    unsigned int maximumPadding(unsigned int defaultSize) const;
+
+    /*!
+     * Sets how save() (and strip() for the types that have it) writes to the
+     * file.
+     *
+     * In the default InPlace mode, the tags are written into the file itself,
+     * shifting the rest of the file when their size changes.  The data is
+     * moved only once per save, even if several tags change size.
+     *
+     * In Atomic mode, the changes are collected while the file is being
+     * saved, and the complete new file is then written once, sequentially,
+     * into a temporary file in the same directory.  That file is flushed to
+     * disk and renamed over the original, so that a crash during the save
+     * does not damage the file and other readers never see it half written.
+     * This needs free space for a second copy of the file, and the file gets
+     * a new identity (e.g. inode) with the owner, group and permissions of
+     * the original.  A symbolic link is followed and the file it points to
+     * is replaced, so the link stays.
+     *
+     * Atomic mode is only possible for files read through a FileStream, which
+     * is opened again on the new file.  Otherwise the changes are written in
+     * place, and so they are if the new file could not keep everything but
+     * the content of the original: when the file has more than one hard link
+     * (which a new file would split), when its owner or group can not be set
+     * by the calling process, or when it has extended attributes or ACLs.
+     * They are also written in place if the temporary file can not be
+     * written or renamed.
+     *
+     * \see FileRef::save(File::SaveMode)
+     */
+    void setSaveMode(SaveMode mode);
+
+    /*!
+     * Returns the mode used by save().
+     *
+     * \see setSaveMode()
+     */
+    SaveMode saveMode() const;
+
+    /*!
+     * Returns true if the last call to save() (or strip() for the types that
+     * have it) had to move the data following a tag, i.e. it could not
+     * overwrite the tags in place.
+     *
+     * \see setPadding()
+     */
+    bool lastSaveShiftedData() const;
+
+    /*!
+     * Returns whether the embedded pictures were read when the file was
+     * opened.  This is set by the constructors of the file types that take a
+     * PictureReading argument, and defaults to ReadPictures.
+     *
+     * With SkipPictures, ID3v2 APIC frames, FLAC picture blocks, MP4 'covr'
+     * items and ASF WM/Picture attributes only record where the picture data
+     * is in the file.  The data is read from there when it is asked for, as
+     * long as the file is open, which avoids reading and allocating it when
+     * only the text of the tags is needed.  Pictures in Xiph comments are
+     * part of the comment header, which is still read, but they are only
+     * decoded when they are asked for.  Compressed, encrypted or
+     * unsynchronised ID3v2 frames are read as usual.
+     *
+     * \see Payload
+     */
+    PictureReading pictureReading() const;
+
     /*!
      * Returns true if \a file can be opened for reading.  If the file does not
      * exist, this will return false.
@@ -256,6 +401,38 @@ namespace TagLib {
     static bool isWritable(const char *name);
 
   protected:
+    /*!
+     * Marks the duration of a save() or strip() operation.  Subclasses create
+     * one on the stack before the first write, and nested scopes (e.g. a
+     * save() that calls strip()) belong to the outermost one.  The writes
+     * are collected until the outermost scope ends, and then made in a single
+     * pass over the file, or written to a new file in Atomic save mode.
+     *
+     * \see lastSaveShiftedData()
+     * \see setSaveMode()
+     */
+    class TAGLIB_EXPORT SaveScope
+    {
+    public:
+      explicit SaveScope(File *file);
+      ~SaveScope();
+
+      /*!
+       * Ends the scope before it is destroyed.  If this is the outermost
+       * scope, the collected writes are made now.  Returns false if they
+       * could not be made, in which case save() should fail.  A nested scope
+       * returns true.
+       */
+      bool finish();
+
+    private:
+      SaveScope(const SaveScope &);
+      SaveScope &operator=(const SaveScope &);
+
+      File *file;
+      bool finished;
+    };
+
     /*!
      * Construct a File object and opens the \a file.  \a file should be a
      * be a C-string in the local file system encoding.
@@ -283,6 +460,14 @@ namespace TagLib {
      */
     void setValid(bool valid);
 
+    /*!
+     * Sets whether the embedded pictures are read.  Subclasses call this
+     * before they read the file.
+     *
+     * \see pictureReading()
+     */
+    void setPictureReading(PictureReading reading);
+
     /*!
      * Truncates the file to a \a length.
      */
@@ -290,13 +475,35 @@ namespace TagLib {
 
     /*!
      * Returns the buffer size that is used for internal buffering.
+     *
+     * This is the smallest size a scan starts with.  Use initialBufferSize()
+     * and nextBufferSize() to honor the sizes set by setBufferSize().
      */
     static unsigned int bufferSize();
 
+    /*!
+     * Returns the size of the first read of a scan.
+     *
+     * \see setBufferSize()
+     */
+    unsigned int initialBufferSize() const;
+
+    /*!
+     * Returns the size of the read that follows a read of \a previousSize
+     * bytes in the same scan.
+     *
+     * \see setBufferSize()
+     */
+    unsigned int nextBufferSize(unsigned int previousSize) const;
+
   private:
+    friend class Payload;
+
     File(const File &);
     File &operator=(const File &);
 
+    void addPayload(const Payload &payload);
+
     class FilePrivate;
     FilePrivate *d;
   };
@@ -23,17 +23,30 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
 #include "tfilestream.h"
 #include "tstring.h"
 #include "tdebug.h"
+#include "tthread.h"
+
+#include <algorithm>
 
 #ifdef _WIN32
 # include <windows.h>
+# include <io.h>
 #else
-# include <stdio.h>
+# include <errno.h>
+# include <fcntl.h>
 # include <unistd.h>
+# include <sys/types.h>
+# include <sys/stat.h>
 #endif
 
+#include <climits>
+
 using namespace TagLib;
 
 namespace
@@ -58,6 +71,22 @@ namespace
 #endif
   }
 
+  FileHandle openFile(int fileDescriptor, bool readOnly)
+  {
+    const HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fileDescriptor));
+    if(handle == INVALID_HANDLE_VALUE)
+      return InvalidFileHandle;
+
+    const DWORD access = readOnly ? GENERIC_READ : (GENERIC_READ | GENERIC_WRITE);
+    const HANDLE process = GetCurrentProcess();
+
+    HANDLE file;
+    if(!DuplicateHandle(process, handle, process, &file, access, FALSE, 0))
+      return InvalidFileHandle;
+
+    return file;
+  }
+
   void closeFile(FileHandle file)
   {
     CloseHandle(file);
@@ -89,31 +118,120 @@ namespace
     operator FileName () const { return c_str(); }
   };
 
-  typedef FILE* FileHandle;
+  // Uses file descriptors and positional I/O instead of stdio.  This avoids
+  // the extra stdio buffer and a seek before every read and write, since the
+  // file position is kept in FileStreamPrivate.
 
-  const FileHandle InvalidFileHandle = 0;
+  typedef int FileHandle;
+
+  const FileHandle InvalidFileHandle = -1;
 
   FileHandle openFile(const FileName &path, bool readOnly)
   {
-    return fopen(path, readOnly ? "rb" : "rb+");
+    int flags = readOnly ? O_RDONLY : O_RDWR;
+#ifdef O_CLOEXEC
+    flags |= O_CLOEXEC;
+#endif
+
+    int fd;
+    do {
+      fd = open(path, flags);
+    } while(fd < 0 && errno == EINTR);
+
+    return fd;
+  }
+
+  FileHandle openFile(int fileDescriptor, bool readOnly)
+  {
+    const int flags = fcntl(fileDescriptor, F_GETFL);
+    if(flags < 0)
+      return InvalidFileHandle;
+
+    const int mode = flags & O_ACCMODE;
+    if(mode == O_WRONLY || (!readOnly && mode != O_RDWR))
+      return InvalidFileHandle;
+
+#ifdef F_DUPFD_CLOEXEC
+    return fcntl(fileDescriptor, F_DUPFD_CLOEXEC, 0);
+#else
+    return dup(fileDescriptor);
+#endif
   }
 
   void closeFile(FileHandle file)
   {
-    fclose(file);
+    close(file);
   }
 
-  size_t readFile(FileHandle file, ByteVector &buffer)
+  size_t readFile(FileHandle file, ByteVector &buffer, off_t offset)
   {
-    return fread(buffer.data(), sizeof(char), buffer.size(), file);
+    char *data = buffer.data();
+    size_t count = 0;
+
+    while(count < buffer.size()) {
+      const ssize_t n = pread(file, data + count, buffer.size() - count, offset + count);
+      if(n > 0)
+        count += n;
+      else if(n == 0 || errno != EINTR)
+        break;
+    }
+
+    return count;
   }
 
-  size_t writeFile(FileHandle file, const ByteVector &buffer)
+  size_t writeFile(FileHandle file, const ByteVector &buffer, off_t offset)
   {
-    return fwrite(buffer.data(), sizeof(char), buffer.size(), file);
+    const char *data = buffer.data();
+    size_t count = 0;
+
+    while(count < buffer.size()) {
+      const ssize_t n = pwrite(file, data + count, buffer.size() - count, offset + count);
+      if(n > 0)
+        count += n;
+      else if(n == 0 || errno != EINTR)
+        break;
+    }
+
+    return count;
   }
 
+#ifdef HAVE_COPY_FILE_RANGE
+
+  // Copies a block within the file without passing it through user space.
+  // The kernel may use reflinks or a server side copy on network file systems.
+
+  size_t copyFileRange(FileHandle file, off_t from, off_t to, size_t length)
+  {
+    loff_t inOffset  = from;
+    loff_t outOffset = to;
+    size_t count = 0;
+
+    while(count < length) {
+      const ssize_t n = copy_file_range(file, &inOffset, file, &outOffset, length - count, 0);
+      if(n > 0)
+        count += n;
+      else if(n == 0 || errno != EINTR)
+        break;
+    }
+
+    return count;
+  }
+
+  // copy_file_range() refuses overlapping ranges, so a shift is copied in
+  // blocks no longer than the shift distance.  Short distances would need
+  // too many calls and are left to the buffered copy.
+
+  const unsigned long MinimumCopyRangeDistance = 256 * 1024;
+  const unsigned long MaximumCopyRangeLength   = 8 * 1024 * 1024;
+
+#endif  // HAVE_COPY_FILE_RANGE
+
 #endif  // _WIN32
+
+  // Shifts start with FileStream::bufferSize() bytes and may grow up to this
+  // size, unless changed by FileStream::setBufferSize().
+
+  const unsigned int DefaultMaximumBufferSize = 8 * 1024 * 1024;
 }
 
 class FileStream::FileStreamPrivate
@@ -123,12 +241,67 @@ public:
     : file(InvalidFileHandle)
     , name(fileName)
     , readOnly(true)
+    , initialBufferSize(FileStream::bufferSize())
+    , maximumBufferSize(DefaultMaximumBufferSize)
+#ifndef _WIN32
+    , position(0)
+    , length(-1)
+#endif
+#ifdef HAVE_COPY_FILE_RANGE
+    , copyFileRangeSupported(true)
+#endif
+  {
+  }
+
+  // Reads and writes at the current position and advances it.
+
+  size_t read(ByteVector &buffer)
+  {
+#ifdef _WIN32
+    return readFile(file, buffer);
+#else
+    const size_t count = readFile(file, buffer, position);
+    position += count;
+    return count;
+#endif
+  }
+
+  size_t write(const ByteVector &buffer)
+  {
+#ifdef _WIN32
+    return writeFile(file, buffer);
+#else
+    const size_t count = writeFile(file, buffer, position);
+    position += count;
+    length = -1;
+    return count;
+#endif
+  }
+
+  unsigned int nextBufferSize(unsigned int previousSize) const
   {
+    if(previousSize >= maximumBufferSize / 2)
+      return maximumBufferSize;
+
+    return std::max(previousSize * 2, initialBufferSize);
   }
 
   FileHandle file;
   FileNameHandle name;
   bool readOnly;
+  unsigned int initialBufferSize;
+  unsigned int maximumBufferSize;
+#ifdef _WIN32
+  // A read at an offset moves the file pointer on Windows, so such reads put
+  // it back one at a time.
+  Mutex filePointerMutex;
+#else
+  off_t position;
+  off_t length;  // -1 if not known yet.
+#endif
+#ifdef HAVE_COPY_FILE_RANGE
+  bool copyFileRangeSupported;
+#endif
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -158,6 +331,27 @@ FileStream::FileStream(FileName fileName, bool openReadOnly)
   }
 }
 
+FileStream::FileStream(int fileDescriptor, bool openReadOnly)
+  : d(new FileStreamPrivate(""))
+{
+  // First try with read / write mode, if that fails, fall back to read only.
+
+  if(!openReadOnly)
+    d->file = openFile(fileDescriptor, false);
+
+  if(d->file != InvalidFileHandle)
+    d->readOnly = false;
+  else
+    d->file = openFile(fileDescriptor, true);
+
+  if(d->file == InvalidFileHandle)
+    debug("Could not open file descriptor " + String::number(fileDescriptor));
+#ifdef _WIN32
+  else
+    seek(0);
+#endif
+}
+
 FileStream::~FileStream()
 {
   if(isOpen())
@@ -187,12 +381,79 @@ ByteVector FileStream::readBlock(unsigned long length)
 
   ByteVector buffer(static_cast<unsigned int>(length));
 
-  const size_t count = readFile(d->file, buffer);
+  const size_t count = d->read(buffer);
   buffer.resize(static_cast<unsigned int>(count));
 
   return buffer;
 }
 
+ByteVector FileStream::readBlock(long offset, unsigned long length)
+{
+  if(!isOpen()) {
+    debug("FileStream::readBlock() -- invalid file.");
+    return ByteVector();
+  }
+
+  if(offset < 0 || length == 0)
+    return ByteVector();
+
+  // The cached length may be filled in by another thread, so it is not used.
+
+#ifdef _WIN32
+
+  LARGE_INTEGER fileSize;
+  if(!GetFileSizeEx(d->file, &fileSize))
+    return ByteVector();
+
+  const long long streamLength = fileSize.QuadPart;
+
+#else
+
+  struct stat st;
+  if(fstat(d->file, &st) != 0)
+    return ByteVector();
+
+  const long long streamLength = st.st_size;
+
+#endif
+
+  if(offset >= streamLength)
+    return ByteVector();
+
+  if(length > bufferSize() && static_cast<long long>(length) > streamLength - offset)
+    length = static_cast<unsigned long>(streamLength - offset);
+
+  ByteVector buffer(static_cast<unsigned int>(length));
+
+#ifdef _WIN32
+
+  MutexLocker locker(d->filePointerMutex);
+
+  LARGE_INTEGER zero;
+  zero.QuadPart = 0;
+  LARGE_INTEGER position;
+  if(!SetFilePointerEx(d->file, zero, &position, FILE_CURRENT))
+    return ByteVector();
+
+  OVERLAPPED overlapped = {};
+  overlapped.Offset = static_cast<DWORD>(offset);
+
+  DWORD count;
+  if(!ReadFile(d->file, buffer.data(), static_cast<DWORD>(buffer.size()), &count, &overlapped))
+    count = 0;
+
+  SetFilePointerEx(d->file, position, NULL, FILE_BEGIN);
+
+#else
+
+  const size_t count = readFile(d->file, buffer, offset);
+
+#endif
+
+  buffer.resize(static_cast<unsigned int>(count));
+  return buffer;
+}
+
 void FileStream::writeBlock(const ByteVector &data)
 {
   if(!isOpen()) {
@@ -205,7 +466,7 @@ void FileStream::writeBlock(const ByteVector &data)
     return;
   }
 
-  writeFile(d->file, data);
+  d->write(data);
 }
 
 void FileStream::insert(const ByteVector &data, unsigned long start, unsigned long replace)
@@ -232,62 +493,17 @@ void FileStream::insert(const ByteVector &data, unsigned long start, unsigned lo
     return;
   }
 
-  // Woohoo!  Faster (about 20%) than id3lib at last.  I had to get hardcore
-  // and avoid TagLib's high level API for rendering just copying parts of
-  // the file that don't contain tag data.
-  //
-  // Now I'll explain the steps in this ugliness:
-
-  // First, make sure that we're working with a buffer that is longer than
-  // the *differnce* in the tag sizes.  We want to avoid overwriting parts
-  // that aren't yet in memory, so this is necessary.
-
-  unsigned long bufferLength = bufferSize();
-
-  while(data.size() - replace > bufferLength)
-    bufferLength += bufferSize();
-
-  // Set where to start the reading and writing.
-
-  long readPosition = start + replace;
-  long writePosition = start;
-
-  ByteVector buffer = data;
-  ByteVector aboutToOverwrite(static_cast<unsigned int>(bufferLength));
-
-  while(true)
-  {
-    // Seek to the current read position and read the data that we're about
-    // to overwrite.  Appropriately increment the readPosition.
-
-    seek(readPosition);
-    const unsigned int bytesRead = static_cast<unsigned int>(readFile(d->file, aboutToOverwrite));
-    aboutToOverwrite.resize(bytesRead);
-    readPosition += bufferLength;
-
-    // Check to see if we just read the last block.  We need to call clear()
-    // if we did so that the last write succeeds.
-
-    if(bytesRead < bufferLength)
-      clear();
-
-    // Seek to the write position and write our buffer.  Increment the
-    // writePosition.
-
-    seek(writePosition);
-    writeBlock(buffer);
-
-    // We hit the end of the file.
-
-    if(bytesRead == 0)
-      break;
+  // Move the rest of the file towards the end to make room for the new data,
+  // then write it.
 
-    writePosition += buffer.size();
+  const unsigned long fileLength = static_cast<unsigned long>(length());
+  const unsigned long tailStart  = start + replace;
 
-    // Make the current buffer the data that we read in the beginning.
+  if(tailStart < fileLength)
+    moveBlock(tailStart, start + data.size(), fileLength - tailStart);
 
-    buffer = aboutToOverwrite;
-  }
+  seek(start);
+  writeBlock(data);
 }
 
 void FileStream::removeBlock(unsigned long start, unsigned long length)
@@ -297,34 +513,22 @@ void FileStream::removeBlock(unsigned long start, unsigned long length)
     return;
   }
 
-  unsigned long bufferLength = bufferSize();
-
-  long readPosition = start + length;
-  long writePosition = start;
-
-  ByteVector buffer(static_cast<unsigned int>(bufferLength));
-
-  for(unsigned int bytesRead = -1; bytesRead != 0;)
-  {
-    seek(readPosition);
-    bytesRead = static_cast<unsigned int>(readFile(d->file, buffer));
-    readPosition += bytesRead;
-
-    // Check to see if we just read the last block.  We need to call clear()
-    // if we did so that the last write succeeds.
-
-    if(bytesRead < buffer.size()) {
-      clear();
-      buffer.resize(bytesRead);
-    }
+  if(readOnly()) {
+    debug("FileStream::removeBlock() -- read only file.");
+    return;
+  }
 
-    seek(writePosition);
-    writeFile(d->file, buffer);
+  const unsigned long fileLength = static_cast<unsigned long>(FileStream::length());
+  if(length == 0 || start >= fileLength)
+    return;
 
-    writePosition += bytesRead;
+  if(start + length < fileLength) {
+    moveBlock(start + length, start, fileLength - start - length);
+    truncate(fileLength - length);
+  }
+  else {
+    truncate(start);
   }
-
-  truncate(writePosition);
 }
 
 bool FileStream::readOnly() const
@@ -360,38 +564,38 @@ void FileStream::seek(long offset, Position p)
 
 #else
 
-  int whence;
+  off_t position;
   switch(p) {
   case Beginning:
-    whence = SEEK_SET;
+    position = offset;
     break;
   case Current:
-    whence = SEEK_CUR;
+    position = d->position + offset;
     break;
   case End:
-    whence = SEEK_END;
+    position = length() + offset;
     break;
   default:
     debug("FileStream::seek() -- Invalid Position value.");
     return;
   }
 
-  fseek(d->file, offset, whence);
+  // Same as lseek(), seeking before the beginning of the file fails and
+  // seeking beyond the end succeeds.
+
+  if(position < 0) {
+    debug("FileStream::seek() -- Failed to set the file pointer.");
+    return;
+  }
+
+  d->position = position;
 
 #endif
 }
 
 void FileStream::clear()
 {
-#ifdef _WIN32
-
-  // NOP
-
-#else
-
-  clearerr(d->file);
-
-#endif
+  // NOP, neither Win32 API nor positional I/O have error or EOF flags.
 }
 
 long FileStream::tell() const
@@ -411,7 +615,13 @@ long FileStream::tell() const
 
 #else
 
-  return ftell(d->file);
+  if(d->position <= LONG_MAX) {
+    return static_cast<long>(d->position);
+  }
+  else {
+    debug("FileStream::tell() -- Failed to get the file pointer.");
+    return 0;
+  }
 
 #endif
 }
@@ -437,16 +647,123 @@ long FileStream::length()
 
 #else
 
-  const long curpos = tell();
+  // The length is cached until the file is written or truncated.
+
+  if(d->length < 0) {
+    struct stat st;
+    if(fstat(d->file, &st) == 0)
+      d->length = st.st_size;
+  }
+
+  if(d->length >= 0 && d->length <= LONG_MAX) {
+    return static_cast<long>(d->length);
+  }
+  else {
+    debug("FileStream::length() -- Failed to get the file size.");
+    return 0;
+  }
+
+#endif
+}
+
+void FileStream::moveBlock(unsigned long from, unsigned long to, unsigned long length)
+{
+  // When moving towards the end of the file, start with the last block so
+  // that nothing is overwritten before it has been read.
+
+  const bool backwards = (to > from);
+  const unsigned long distance = backwards ? (to - from) : (from - to);
+
+#ifdef HAVE_COPY_FILE_RANGE
+  bool useCopyFileRange = d->copyFileRangeSupported && distance >= MinimumCopyRangeDistance;
+#endif
+
+  unsigned int bufferLength = d->initialBufferSize;
+  ByteVector buffer;
+
+  unsigned long moved = 0;
+  while(moved < length) {
+
+    unsigned long blockLength = std::min<unsigned long>(length - moved, bufferLength);
+    unsigned long copied = 0;
+
+#ifdef HAVE_COPY_FILE_RANGE
+    if(useCopyFileRange)
+      blockLength = std::min(length - moved, std::min(distance, MaximumCopyRangeLength));
+#endif
+
+    const unsigned long offset = backwards ? (length - moved - blockLength) : moved;
 
-  seek(0, End);
-  const long endpos = tell();
+#ifdef HAVE_COPY_FILE_RANGE
+    if(useCopyFileRange) {
+      copied = copyFileRange(d->file, from + offset, to + offset, blockLength);
+      d->length = -1;
 
-  seek(curpos, Beginning);
+      // Not supported by this kernel or file system.  Copy the rest of the
+      // block and everything after it through the buffer.
 
-  return endpos;
+      if(copied < blockLength) {
+        useCopyFileRange = false;
+        if(copied == 0)
+          d->copyFileRangeSupported = false;
+      }
+    }
+#endif
+
+    if(copied < blockLength) {
+      buffer.resize(static_cast<unsigned int>(blockLength - copied));
+
+      seek(from + offset + copied);
+      buffer.resize(static_cast<unsigned int>(d->read(buffer)));
+
+      seek(to + offset + copied);
+      d->write(buffer);
+
+      bufferLength = d->nextBufferSize(bufferLength);
+    }
 
+    moved += blockLength;
+  }
+}
+
+void FileStream::close()
+{
+  if(isOpen()) {
+    closeFile(d->file);
+    d->file = InvalidFileHandle;
+  }
+}
+
+bool FileStream::reopen()
+{
+  close();
+
+  d->file = openFile(d->name, false);
+  d->readOnly = (d->file == InvalidFileHandle);
+
+  if(d->readOnly)
+    d->file = openFile(d->name, true);
+
+#ifndef _WIN32
+  d->position = 0;
+  d->length = -1;
 #endif
+
+  if(d->file == InvalidFileHandle) {
+    debug("FileStream::reopen() -- Could not open the file.");
+    return false;
+  }
+
+  return !d->readOnly;
+}
+
+void FileStream::setBufferSize(unsigned int initialSize, unsigned int maximumSize)
+{
+  if(initialSize == 0)
+    initialSize = bufferSize();
+
+  d->initialBufferSize = initialSize;
+  d->maximumBufferSize = std::max(initialSize, maximumSize);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -469,11 +786,13 @@ void FileStream::truncate(long length)
 
 #else
 
-  const int error = ftruncate(fileno(d->file), length);
+  const int error = ftruncate(d->file, length);
   if(error != 0) {
     debug("FileStream::truncate() -- Coundn't truncate the file.");
   }
 
+  d->length = -1;
+
 #endif
 }
 
@@ -54,6 +54,16 @@ namespace TagLib {
      */
     FileStream(FileName file, bool openReadOnly = false);
 
+    /*!
+     * Constructs a FileStream for the open file descriptor \a fileDescriptor.
+     * The descriptor is duplicated, so the caller still owns it and has to
+     * close it.  The stream starts at the beginning of the file, whatever the
+     * position of the descriptor is.
+     *
+     * The stream has no file name, so reopen() cannot open it again.
+     */
+    FileStream(int fileDescriptor, bool openReadOnly = false);
+
     /*!
      * Destroys this FileStream instance.
      */
@@ -69,6 +79,16 @@ namespace TagLib {
      */
     ByteVector readBlock(unsigned long length);
 
+    /*!
+     * Reads a block of size \a length at \a offset, without using or moving
+     * the get pointer.
+     *
+     * Unlike the other members, this may be called by several threads at once,
+     * as long as none of them writes to the stream or moves its get pointer
+     * at the same time.
+     */
+    ByteVector readBlock(long offset, unsigned long length);
+
     /*!
      * Attempts to write the block \a data at the current get pointer.  If the
      * file is currently only opened read only -- i.e. readOnly() returns true --
@@ -137,6 +157,18 @@ namespace TagLib {
      */
     void truncate(long length);
 
+    /*!
+     * Sets the sizes of the buffer used by insert() and removeBlock() to shift
+     * the rest of the file.  The first round moves \a initialSize bytes, and
+     * each following round doubles that until it reaches \a maximumSize.
+     *
+     * By default, shifts start with 1024 bytes and grow up to 8 MiB.
+     *
+     * \note Where the system supports copy_file_range(), large shifts are
+     * done by the kernel without using this buffer.
+     */
+    void setBufferSize(unsigned int initialSize, unsigned int maximumSize);
+
   protected:
 
     /*!
@@ -145,6 +177,26 @@ namespace TagLib {
     static unsigned int bufferSize();
 
   private:
+    friend class File;
+    friend class WritePlan;
+
+    /*!
+     * Closes the file, so that it can be replaced by another one.
+     */
+    void close();
+
+    /*!
+     * Opens the file again by name after close().  Returns false if it could
+     * not be opened for writing.
+     */
+    bool reopen();
+
+    /*!
+     * Moves \a length bytes from \a from to \a to.  The two ranges may
+     * overlap.
+     */
+    void moveBlock(unsigned long from, unsigned long to, unsigned long length);
+
     class FileStreamPrivate;
     FileStreamPrivate *d;
   };
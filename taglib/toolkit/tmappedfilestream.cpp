@@ -0,0 +1,419 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tmappedfilestream.h"
+#include "tfilestream.h"
+#include "tstring.h"
+#include "tdebug.h"
+
+#include <climits>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+using namespace TagLib;
+
+namespace
+{
+#ifdef _WIN32
+
+  typedef FileName FileNameHandle;
+
+#else
+
+  struct FileNameHandle : public std::string
+  {
+    FileNameHandle(FileName name) : std::string(name) {}
+    operator FileName () const { return c_str(); }
+  };
+
+#endif
+
+  // Maps the whole file into memory.  Returns a null pointer and leaves
+  // \a size untouched if the file can not be mapped.  Where a mapped file can
+  // be truncated, \a file is left open to check its size.
+
+#if defined(_WIN32) && !defined(PLATFORM_WINRT)
+
+  // Windows does not allow truncating a file while it is mapped.
+
+  typedef int FileHandle;
+
+  const FileHandle InvalidFileHandle = -1;
+
+  const char *mapFile(const FileName &path, size_t &size, FileHandle &)
+  {
+    const HANDLE file = CreateFileW(
+      path.wstr().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if(file == INVALID_HANDLE_VALUE)
+      return 0;
+
+    const char *data = 0;
+
+    LARGE_INTEGER fileSize;
+    if(GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0 && fileSize.QuadPart <= LONG_MAX) {
+      const HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+      if(mapping) {
+        data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if(data)
+          size = static_cast<size_t>(fileSize.QuadPart);
+
+        // The view keeps the mapping object alive.
+
+        CloseHandle(mapping);
+      }
+    }
+
+    CloseHandle(file);
+    return data;
+  }
+
+  void unmapFile(const char *data, size_t)
+  {
+    UnmapViewOfFile(data);
+  }
+
+  bool sizeChanged(FileHandle, size_t)
+  {
+    return false;
+  }
+
+  FileStream *openFallback(const FileName &path, FileHandle)
+  {
+    return new FileStream(path, true);
+  }
+
+  void closeFile(FileHandle)
+  {
+  }
+
+#elif defined(_WIN32)
+
+  // WinRT does not allow mapping arbitrary files.  Always use the fallback.
+
+  typedef int FileHandle;
+
+  const FileHandle InvalidFileHandle = -1;
+
+  const char *mapFile(const FileName &, size_t &, FileHandle &)
+  {
+    return 0;
+  }
+
+  void unmapFile(const char *, size_t)
+  {
+  }
+
+  bool sizeChanged(FileHandle, size_t)
+  {
+    return false;
+  }
+
+  FileStream *openFallback(const FileName &path, FileHandle)
+  {
+    return new FileStream(path, true);
+  }
+
+  void closeFile(FileHandle)
+  {
+  }
+
+#else
+
+  typedef int FileHandle;
+
+  const FileHandle InvalidFileHandle = -1;
+
+  const char *mapFile(const FileName &path, size_t &size, FileHandle &file)
+  {
+    const int fd = open(path, O_RDONLY);
+    if(fd < 0)
+      return 0;
+
+    const char *data = 0;
+
+    struct stat st;
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && st.st_size <= LONG_MAX) {
+      void *p = mmap(0, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if(p != MAP_FAILED) {
+        data = static_cast<const char *>(p);
+        size = static_cast<size_t>(st.st_size);
+      }
+    }
+
+    // The mapping stays valid after the descriptor has been closed, but the
+    // descriptor is kept to check that the file still has the mapped size.
+
+    if(data)
+      file = fd;
+    else
+      close(fd);
+
+    return data;
+  }
+
+  void unmapFile(const char *data, size_t size)
+  {
+    munmap(const_cast<char *>(data), size);
+  }
+
+  // Touching the pages past the end of a truncated file raises SIGBUS.
+
+  bool sizeChanged(FileHandle file, size_t size)
+  {
+    struct stat st;
+    return fstat(file, &st) != 0 || static_cast<size_t>(st.st_size) != size;
+  }
+
+  // Reads the file that has been mapped, even if it has been renamed.
+
+  FileStream *openFallback(const FileName &, FileHandle file)
+  {
+    return new FileStream(file, true);
+  }
+
+  void closeFile(FileHandle file)
+  {
+    close(file);
+  }
+
+#endif
+}
+
+class MappedFileStream::MappedFileStreamPrivate
+{
+public:
+  MappedFileStreamPrivate(const FileName &fileName) :
+    name(fileName),
+    file(InvalidFileHandle),
+    data(0),
+    size(0),
+    position(0),
+    fallback(0) {}
+
+  ~MappedFileStreamPrivate()
+  {
+    unmap();
+    delete fallback;
+  }
+
+  // Falls back to a FileStream at the current position if the file no
+  // longer has the size that was mapped.  Returns true if it still has.
+  // This is only done where the size is asked for, so that reading the
+  // mapping makes no system call.
+
+  bool checkSize()
+  {
+    if(!data)
+      return false;
+
+    if(!sizeChanged(file, size))
+      return true;
+
+    debug("MappedFileStream -- The size of the file has changed. Not using the mapping any more.");
+
+    fallback = openFallback(name, file);
+    fallback->seek(position);
+    unmap();
+
+    return false;
+  }
+
+  void unmap()
+  {
+    if(data)
+      unmapFile(data, size);
+    if(file != InvalidFileHandle)
+      closeFile(file);
+
+    file = InvalidFileHandle;
+    data = 0;
+    size = 0;
+  }
+
+  FileNameHandle name;
+  FileHandle file;
+  const char *data;
+  size_t size;
+  long position;
+  FileStream *fallback;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+MappedFileStream::MappedFileStream(FileName fileName) :
+  d(new MappedFileStreamPrivate(fileName))
+{
+  d->data = mapFile(fileName, d->size, d->file);
+
+  // Empty files, pipes and some network file systems can not be mapped.
+
+  if(!d->data)
+    d->fallback = new FileStream(fileName, true);
+}
+
+MappedFileStream::~MappedFileStream()
+{
+  delete d;
+}
+
+FileName MappedFileStream::name() const
+{
+  return d->name;
+}
+
+ByteVector MappedFileStream::readBlock(unsigned long length)
+{
+  if(d->fallback)
+    return d->fallback->readBlock(length);
+
+  if(length == 0 || d->position >= static_cast<long>(d->size))
+    return ByteVector();
+
+  const size_t available = d->size - static_cast<size_t>(d->position);
+  if(length > available)
+    length = static_cast<unsigned long>(available);
+
+  const ByteVector buffer(d->data + d->position, static_cast<unsigned int>(length));
+  d->position += static_cast<long>(length);
+
+  return buffer;
+}
+
+const char *MappedFileStream::data(long offset, unsigned long length)
+{
+  if(!d->data || offset < 0 || static_cast<size_t>(offset) > d->size
+     || length > d->size - static_cast<size_t>(offset)) {
+    return 0;
+  }
+
+  return d->data + offset;
+}
+
+void MappedFileStream::writeBlock(const ByteVector &)
+{
+  debug("MappedFileStream::writeBlock() -- read only stream.");
+}
+
+void MappedFileStream::insert(const ByteVector &, unsigned long, unsigned long)
+{
+  debug("MappedFileStream::insert() -- read only stream.");
+}
+
+void MappedFileStream::removeBlock(unsigned long, unsigned long)
+{
+  debug("MappedFileStream::removeBlock() -- read only stream.");
+}
+
+bool MappedFileStream::readOnly() const
+{
+  return true;
+}
+
+bool MappedFileStream::isOpen() const
+{
+  if(d->fallback)
+    return d->fallback->isOpen();
+
+  return true;
+}
+
+void MappedFileStream::seek(long offset, Position p)
+{
+  if(d->fallback) {
+    d->fallback->seek(offset, p);
+    return;
+  }
+
+  long position;
+  switch(p) {
+  case Beginning:
+    position = offset;
+    break;
+  case Current:
+    position = d->position + offset;
+    break;
+  case End:
+    if(!d->checkSize()) {
+      d->fallback->seek(offset, p);
+      return;
+    }
+    position = static_cast<long>(d->size) + offset;
+    break;
+  default:
+    debug("MappedFileStream::seek() -- Invalid Position value.");
+    return;
+  }
+
+  // Same as fseek(), seeking before the beginning of the file fails and
+  // seeking beyond the end succeeds.
+
+  if(position < 0) {
+    debug("MappedFileStream::seek() -- Attempted to seek before the beginning of the file.");
+    return;
+  }
+
+  d->position = position;
+}
+
+void MappedFileStream::clear()
+{
+  if(d->fallback)
+    d->fallback->clear();
+}
+
+long MappedFileStream::tell() const
+{
+  if(d->fallback)
+    return d->fallback->tell();
+
+  return d->position;
+}
+
+long MappedFileStream::length()
+{
+  if(!d->checkSize())
+    return d->fallback->length();
+
+  return static_cast<long>(d->size);
+}
+
+void MappedFileStream::truncate(long)
+{
+  debug("MappedFileStream::truncate() -- read only stream.");
+}
+
+bool MappedFileStream::isMapped() const
+{
+  return (d->data != 0);
+}
@@ -0,0 +1,164 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MAPPEDFILESTREAM_H
+#define TAGLIB_MAPPEDFILESTREAM_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+#include "tiostream.h"
+
+namespace TagLib {
+
+  //! A read only stream that maps the whole file into memory
+
+  /*!
+   * This is an alternative to FileStream for code that only reads tags from a
+   * large number of files.  The file is mapped into the address space once
+   * when the stream is opened, so readBlock() copies from memory instead of
+   * reading the file, seek() makes no system call, and data() gives access to
+   * the bytes without copying them.
+   *
+   * If the file can not be mapped (e.g. it is empty or lives on a file system
+   * that does not support mapping), the stream silently falls back to a read
+   * only FileStream.  isMapped() tells which of the two is in use.
+   *
+   * The size of the file is checked again by length() and by seeking from
+   * the end, and if it has changed since the file was mapped, the stream
+   * falls back to a FileStream from then on.  Reads are not checked, so
+   * truncating the file while it is being read from the mapping may still
+   * crash the process with SIGBUS on the systems where a mapped file can be
+   * truncated.  Use FileStream for files that other processes may shorten.
+   *
+   * Since the stream is always read only, any File that uses it can not be
+   * saved.  To use it with a specific file type, pass it to the IOStream based
+   * constructor of that File subclass, or use FileRef::MappedStream.
+   *
+   * \see FileStream
+   */
+
+  class TAGLIB_EXPORT MappedFileStream : public IOStream
+  {
+  public:
+    /*!
+     * Opens and maps the \a file.  \a file should be a C-string in the local
+     * file system encoding.
+     */
+    MappedFileStream(FileName file);
+
+    /*!
+     * Unmaps and closes the file.
+     */
+    virtual ~MappedFileStream();
+
+    /*!
+     * Returns the file name in the local file system encoding.
+     */
+    FileName name() const;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(unsigned long length);
+
+    /*!
+     * Returns a pointer to the \a length bytes at \a offset in the mapped file,
+     * so that they can be used without being copied, or a null pointer if the
+     * file is not mapped or they are not all in it.  The get pointer is not
+     * used or moved.
+     *
+     * The pointer stays valid as long as the stream exists, but reading from
+     * it after the file has been truncated may crash the process.
+     */
+    const char *data(long offset, unsigned long length);
+
+    /*!
+     * Does nothing, since this stream is read only.
+     */
+    void writeBlock(const ByteVector &data);
+
+    /*!
+     * Does nothing, since this stream is read only.
+     */
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+
+    /*!
+     * Does nothing, since this stream is read only.
+     */
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+
+    /*!
+     * Always returns true.
+     */
+    bool readOnly() const;
+
+    /*!
+     * Returns true if the file was successfully opened, whether mapped or not.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Move the I/O pointer to \a offset in the file from position \a p.  This
+     * defaults to seeking from the beginning of the file.
+     *
+     * \see Position
+     */
+    void seek(long offset, Position p = Beginning);
+
+    /*!
+     * Reset the end-of-file and error flags on the file.
+     */
+    void clear();
+
+    /*!
+     * Returns the current offset within the file.
+     */
+    long tell() const;
+
+    /*!
+     * Returns the length of the file.
+     */
+    long length();
+
+    /*!
+     * Does nothing, since this stream is read only.
+     */
+    void truncate(long length);
+
+    /*!
+     * Returns true if the file is actually mapped into memory, or false if the
+     * stream has fallen back to a FileStream.
+     */
+    bool isMapped() const;
+
+  private:
+    class MappedFileStreamPrivate;
+    MappedFileStreamPrivate *d;
+  };
+
+}
+
+#endif
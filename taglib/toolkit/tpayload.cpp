@@ -0,0 +1,246 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <algorithm>
+
+#include "tpayload.h"
+#include "tfile.h"
+#include "tiostream.h"
+#include "tdebug.h"
+#include "trefcounter.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // File and IOStream have the same reading interface, but are not related.
+
+  template <class T>
+  ByteVector readRange(T *source, long offset, unsigned int length)
+  {
+    const long position = source->tell();
+
+    source->seek(offset);
+    const ByteVector data = source->readBlock(length);
+    source->seek(position);
+
+    return data;
+  }
+}
+
+class Payload::PayloadPrivate : public RefCounter
+{
+public:
+  PayloadPrivate() :
+    RefCounter(),
+    file(0),
+    stream(0),
+    offset(-1),
+    size(0) {}
+
+  ByteVector data;
+  File *file;
+  IOStream *stream;
+  long offset;
+  unsigned int size;
+  String mimeType;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+Payload::Payload() :
+  d(new PayloadPrivate())
+{
+}
+
+Payload::Payload(const ByteVector &data, const String &mimeType) :
+  d(new PayloadPrivate())
+{
+  d->data = data;
+  d->size = data.size();
+  d->mimeType = mimeType;
+}
+
+Payload::Payload(File *file, long offset, unsigned int size, const String &mimeType) :
+  d(new PayloadPrivate())
+{
+  d->file = file;
+  d->offset = offset;
+  d->size = size;
+  d->mimeType = mimeType;
+
+  if(file)
+    file->addPayload(*this);
+}
+
+Payload::Payload(IOStream *stream, long offset, unsigned int size, const String &mimeType) :
+  d(new PayloadPrivate())
+{
+  d->stream = stream;
+  d->offset = offset;
+  d->size = size;
+  d->mimeType = mimeType;
+}
+
+Payload::Payload(const Payload &other) :
+  d(other.d)
+{
+  d->ref();
+}
+
+Payload::~Payload()
+{
+  if(d->deref())
+    delete d;
+}
+
+Payload &Payload::operator=(const Payload &other)
+{
+  Payload(other).swap(*this);
+  return *this;
+}
+
+void Payload::swap(Payload &other)
+{
+  using std::swap;
+
+  swap(d, other.d);
+}
+
+unsigned int Payload::size() const
+{
+  return d->size;
+}
+
+bool Payload::isEmpty() const
+{
+  return d->size == 0;
+}
+
+String Payload::mimeType() const
+{
+  return d->mimeType;
+}
+
+void Payload::setMimeType(const String &mimeType)
+{
+  detach();
+  d->mimeType = mimeType;
+}
+
+bool Payload::isLoaded() const
+{
+  return d->offset < 0;
+}
+
+long Payload::offset() const
+{
+  return d->offset;
+}
+
+ByteVector Payload::data() const
+{
+  if(d->offset < 0)
+    return d->data;
+
+  return data(0, d->size);
+}
+
+ByteVector Payload::data(unsigned int offset, unsigned int length) const
+{
+  if(offset >= d->size)
+    return ByteVector();
+
+  length = std::min(length, d->size - offset);
+
+  if(d->offset < 0)
+    return d->data.mid(offset, length);
+
+  ByteVector data;
+
+  if(d->file && d->file->isOpen())
+    data = readRange(d->file, d->offset + offset, length);
+  else if(d->stream && d->stream->isOpen())
+    data = readRange(d->stream, d->offset + offset, length);
+  else {
+    debug("Payload::data() -- The file of this payload has been closed.");
+    return ByteVector();
+  }
+
+  if(data.size() != length)
+    debug("Payload::data() -- The data is truncated.");
+
+  return data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void Payload::detach()
+{
+  if(d->count() == 1)
+    return;
+
+  PayloadPrivate *p = new PayloadPrivate();
+  p->data = d->data;
+  p->file = d->file;
+  p->stream = d->stream;
+  p->offset = d->offset;
+  p->size = d->size;
+  p->mimeType = d->mimeType;
+
+  d->deref();
+  d = p;
+
+  // The copy has to be read before the file is saved as well.
+
+  if(d->file && d->offset >= 0)
+    d->file->addPayload(*this);
+}
+
+void Payload::load()
+{
+  if(d->offset < 0)
+    return;
+
+  d->data = data();
+  d->size = d->data.size();
+  d->file = 0;
+  d->stream = 0;
+  d->offset = -1;
+}
+
+void Payload::unsetFile()
+{
+  d->file = 0;
+}
+
+bool Payload::isShared() const
+{
+  return d->count() > 1;
+}
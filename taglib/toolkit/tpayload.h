@@ -0,0 +1,180 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_PAYLOAD_H
+#define TAGLIB_PAYLOAD_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+#include "tstring.h"
+
+namespace TagLib {
+
+  class File;
+  class IOStream;
+
+  //! A block of binary data that is either in memory or still in a file
+
+  /*!
+   * Large binary values, such as the embedded pictures, are held in a Payload.
+   * Usually the payload holds the data itself.  When a file is opened with
+   * File::SkipPictures, the payloads of the pictures only record where the
+   * data is in the file, and data() reads it from there each time it is
+   * called.
+   *
+   * A payload that refers to a file can only be read while that file is open.
+   * The payloads that are still in use are read into memory before the file
+   * is saved, since saving may move the data.
+   *
+   * A payload can also be read from any IOStream.  Passing such a payload to
+   * a tag, e.g. with ID3v2::AttachedPictureFrame::setPayload(), leaves the
+   * data in the stream until the tag is rendered.
+   *
+   * Use data(unsigned int, unsigned int) or a PayloadStream to read only a
+   * part of the data at a time.
+   *
+   * This class is implicitly shared.
+   *
+   * \see File::PictureReading
+   * \see PayloadStream
+   */
+
+  class TAGLIB_EXPORT Payload
+  {
+  public:
+    /*!
+     * Constructs an empty payload.
+     */
+    Payload();
+
+    /*!
+     * Constructs a payload that holds \a data in memory, with the MIME type
+     * \a mimeType.
+     */
+    explicit Payload(const ByteVector &data, const String &mimeType = String());
+
+    /*!
+     * Constructs a payload for the \a size bytes at \a offset in \a file,
+     * with the MIME type \a mimeType.  Nothing is read until data() is
+     * called.
+     */
+    Payload(File *file, long offset, unsigned int size,
+            const String &mimeType = String());
+
+    /*!
+     * Constructs a payload for the \a size bytes at \a offset in \a stream,
+     * with the MIME type \a mimeType.  Nothing is read until data() is
+     * called.
+     *
+     * The stream is not owned by the payload and must stay open as long as
+     * the payload may be read.
+     */
+    Payload(IOStream *stream, long offset, unsigned int size,
+            const String &mimeType = String());
+
+    /*!
+     * Makes a shallow, implicitly shared, copy of \a other.
+     */
+    Payload(const Payload &other);
+
+    /*!
+     * Destroys this Payload instance.
+     */
+    ~Payload();
+
+    /*!
+     * Copies the contents of \a other into this payload.
+     */
+    Payload &operator=(const Payload &other);
+
+    /*!
+     * Exchanges the content of this payload with the content of \a other.
+     */
+    void swap(Payload &other);
+
+    /*!
+     * Returns the size of the data in bytes.
+     */
+    unsigned int size() const;
+
+    /*!
+     * Returns true if the payload holds no data.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * Returns the MIME type of the data, or an empty string if it is not
+     * known.
+     */
+    String mimeType() const;
+
+    /*!
+     * Sets the MIME type of the data to \a mimeType.
+     */
+    void setMimeType(const String &mimeType);
+
+    /*!
+     * Returns true if the data is in memory, false if it is read from the file
+     * or stream when it is asked for.
+     */
+    bool isLoaded() const;
+
+    /*!
+     * Returns the offset of the data in the file or stream, or -1 if the data
+     * is in memory.
+     */
+    long offset() const;
+
+    /*!
+     * Returns the data.  If it is not in memory, it is read from the file or
+     * stream, leaving its position unchanged.  If the file or stream has been
+     * closed, this returns an empty ByteVector.
+     */
+    ByteVector data() const;
+
+    /*!
+     * Returns at most \a length bytes of the data, starting at \a offset.
+     * Only this range is read if the data is not in memory.
+     *
+     * \see data()
+     */
+    ByteVector data(unsigned int offset, unsigned int length) const;
+
+  private:
+    friend class File;
+
+    void detach();
+    void load();
+    void unsetFile();
+    bool isShared() const;
+
+    class PayloadPrivate;
+    PayloadPrivate *d;
+  };
+
+}
+
+#endif
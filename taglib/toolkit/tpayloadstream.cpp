@@ -0,0 +1,129 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tpayloadstream.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+class PayloadStream::PayloadStreamPrivate
+{
+public:
+  PayloadStreamPrivate(const Payload &payload) :
+    payload(payload),
+    position(0) {}
+
+  const Payload payload;
+  long position;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+PayloadStream::PayloadStream(const Payload &payload) :
+  d(new PayloadStreamPrivate(payload))
+{
+}
+
+PayloadStream::~PayloadStream()
+{
+  delete d;
+}
+
+FileName PayloadStream::name() const
+{
+  return FileName("");
+}
+
+ByteVector PayloadStream::readBlock(unsigned long length)
+{
+  if(length == 0 || d->position < 0 || d->position >= PayloadStream::length())
+    return ByteVector();
+
+  const ByteVector data = d->payload.data(d->position, static_cast<unsigned int>(length));
+  d->position += data.size();
+  return data;
+}
+
+void PayloadStream::writeBlock(const ByteVector &)
+{
+  debug("PayloadStream::writeBlock() -- The stream is read-only.");
+}
+
+void PayloadStream::insert(const ByteVector &, unsigned long, unsigned long)
+{
+  debug("PayloadStream::insert() -- The stream is read-only.");
+}
+
+void PayloadStream::removeBlock(unsigned long, unsigned long)
+{
+  debug("PayloadStream::removeBlock() -- The stream is read-only.");
+}
+
+bool PayloadStream::readOnly() const
+{
+  return true;
+}
+
+bool PayloadStream::isOpen() const
+{
+  return true;
+}
+
+void PayloadStream::seek(long offset, Position p)
+{
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = length() + offset;
+    break;
+  }
+}
+
+long PayloadStream::tell() const
+{
+  return d->position;
+}
+
+long PayloadStream::length()
+{
+  return d->payload.size();
+}
+
+void PayloadStream::truncate(long)
+{
+  debug("PayloadStream::truncate() -- The stream is read-only.");
+}
+
+Payload PayloadStream::payload() const
+{
+  return d->payload;
+}
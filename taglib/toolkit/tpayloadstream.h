@@ -0,0 +1,130 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_PAYLOADSTREAM_H
+#define TAGLIB_PAYLOADSTREAM_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tiostream.h"
+#include "tpayload.h"
+
+namespace TagLib {
+
+  //! A read-only stream over the data of a Payload
+
+  /*!
+   * This makes a payload readable by code that takes an IOStream, such as
+   * an image decoder.  Each read only reads the requested range, so a
+   * payload that is still in its file is never read into memory as a whole.
+   *
+   * The stream holds a copy of the payload, so the usual limits apply: a
+   * payload that refers to a file can only be read while that file is open.
+   */
+
+  class TAGLIB_EXPORT PayloadStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a stream that reads the data of \a payload.
+     */
+    explicit PayloadStream(const Payload &payload);
+
+    /*!
+     * Destroys this PayloadStream instance.
+     */
+    virtual ~PayloadStream();
+
+    /*!
+     * Returns an empty file name.
+     */
+    FileName name() const;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(unsigned long length);
+
+    /*!
+     * Does nothing, since the stream is read-only.
+     */
+    void writeBlock(const ByteVector &data);
+
+    /*!
+     * Does nothing, since the stream is read-only.
+     */
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+
+    /*!
+     * Does nothing, since the stream is read-only.
+     */
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+
+    /*!
+     * Returns true.
+     */
+    bool readOnly() const;
+
+    /*!
+     * Returns true.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.  This
+     * defaults to seeking from the beginning of the stream.
+     *
+     * \see Position
+     */
+    void seek(long offset, Position p = Beginning);
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    long tell() const;
+
+    /*!
+     * Returns the size of the payload.
+     */
+    long length();
+
+    /*!
+     * Does nothing, since the stream is read-only.
+     */
+    void truncate(long length);
+
+    /*!
+     * Returns the payload that is read.
+     */
+    Payload payload() const;
+
+  private:
+    class PayloadStreamPrivate;
+    PayloadStreamPrivate *d;
+  };
+
+}
+
+#endif
@@ -95,7 +95,11 @@ namespace TagLib
 #elif defined(TAGLIB_ATOMIC_GCC)
     void ref() { __sync_add_and_fetch(&refCount, 1); }
     bool deref() { return ! __sync_sub_and_fetch(&refCount, 1); }
+#  ifdef __ATOMIC_RELAXED
+    int count() { return __atomic_load_n(&refCount, __ATOMIC_RELAXED); }
+#  else
     int count() { return refCount; }
+#  endif
   private:
     volatile int refCount;
 #else
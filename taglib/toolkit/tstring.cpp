@@ -25,14 +25,16 @@
 
 #include <cerrno>
 #include <climits>
-
-#include <utf8-cpp/checked.h>
+#include <cstring>
+#include <new>
 
 #include <tdebug.h>
 #include <tstringlist.h>
-#include <trefcounter.h>
 #include <tutils.h>
 
+#include "tatomic.h"
+#include "tthread.h"
+#include "tunicode.h"
 #include "tstring.h"
 
 namespace
@@ -54,8 +56,8 @@ namespace
   {
     data.resize(length);
 
-    for(size_t i = 0; i < length; ++i)
-      data[i] = static_cast<unsigned char>(s[i]);
+    if(length > 0)
+      Unicode::latin1ToUTF16(s, length, &data[0]);
   }
 
   // Converts a UTF-8 string into UTF-16(without BOM/CPU byte order)
@@ -64,15 +66,17 @@ namespace
   {
     data.resize(length);
 
-    try {
-      const std::wstring::iterator dstEnd = utf8::utf8to16(s, s + length, data.begin());
-      data.resize(dstEnd - data.begin());
-    }
-    catch(const utf8::exception &e) {
-      const String message(e.what());
-      debug("String::copyFromUTF8() - UTF8-CPP error: " + message);
+    if(length == 0)
+      return;
+
+    const size_t units = Unicode::utf8ToUTF16(s, length, &data[0]);
+    if(units == Unicode::Invalid) {
+      debug("String::copyFromUTF8() - Invalid UTF-8 string.");
       data.clear();
     }
+    else {
+      data.resize(units);
+    }
   }
 
   // Helper functions to read a UTF-16 character from an array.
@@ -97,6 +101,20 @@ namespace
     return u.w;
   }
 
+  // Helper functions to copy the UTF-16 characters after the BOM.
+  void copyUTF16Units(wchar_t *data, const wchar_t *s, size_t length, bool swap)
+  {
+    for(size_t i = 0; i < length; ++i) {
+      const unsigned short c = static_cast<unsigned short>(s[i]);
+      data[i] = swap ? Utils::byteSwap(c) : c;
+    }
+  }
+
+  void copyUTF16Units(wchar_t *data, const char *s, size_t length, bool swap)
+  {
+    Unicode::bytesToUTF16(s, length, data, swap);
+  }
+
   // Converts a UTF-16 (with BOM), UTF-16LE or UTF16-BE string into
   // UTF-16(without BOM/CPU byte order) and copies it to the internal buffer.
   template <typename T>
@@ -126,29 +144,198 @@ namespace
     }
 
     data.resize(length);
-    for(size_t i = 0; i < length; ++i) {
-      const unsigned short c = nextUTF16(&s);
-      if(swap)
-        data[i] = Utils::byteSwap(c);
-      else
-        data[i] = c;
+    if(length > 0)
+      copyUTF16Units(&data[0], s, length, swap);
+  }
+
+  // Converts the length bytes at s in the encoding t, up to the first null
+  // character.
+  void copyFromByteVector(std::wstring &data, const char *s, size_t length, String::Type t)
+  {
+    if(t == String::Latin1)
+      copyFromLatin1(data, s, length);
+    else if(t == String::UTF8)
+      copyFromUTF8(data, s, length);
+    else
+      copyFromUTF16(data, s, length / 2, t);
+
+    data.resize(::wcslen(data.c_str()));
+  }
+
+  // Returns whether decoding the length bytes at p from the encoding from and
+  // encoding the result as to gives the same bytes again, so that they can be
+  // used as they are.
+  bool encodesAs(const char *p, size_t length, String::Type from, String::Type to)
+  {
+
+    if(from == String::Latin1 || from == String::UTF8) {
+      if(::memchr(p, 0, length))
+        return false;
+
+      if(from == to && from == String::Latin1)
+        return true;
+
+      if(to != String::Latin1 && to != String::UTF8)
+        return false;
+
+      // ASCII is the same in both, and is valid UTF-8.
+
+      const size_t i = Unicode::asciiLength(p, length);
+      if(i == length)
+        return true;
+
+      return from == to && Unicode::isValidUTF8(p + i, length - i);
     }
+
+    // String::data() writes UTF-16 little-endian after its byte order mark.
+
+    size_t i = 0;
+    if(from == String::UTF16) {
+      if(to != String::UTF16 || length < 2 || p[0] != '\xff' || p[1] != '\xfe')
+        return false;
+      i = 2;
+    }
+    else if(from != to) {
+      return false;
+    }
+
+    if(length % 2 != 0)
+      return false;
+
+    for(; i < length; i += 2) {
+      if(p[i] == 0 && p[i + 1] == 0)
+        return false;
+    }
+    return true;
   }
 }
 
 namespace TagLib {
 
-class String::StringPrivate : public RefCounter
+// The reference count is kept here rather than in a RefCounter, which would
+// be a second allocation for every string.  So are the encoded bytes, which
+// are allocated together with the private data.
+
+class String::StringPrivate
 {
 public:
   StringPrivate() :
-    RefCounter() {}
+    refCount(1),
+    encodedSize(0),
+    encodedType(Latin1),
+    decodeClaims(1),
+    decoded(1) {}
+
+  StringPrivate(const ByteVector &v, Type t) :
+    refCount(1),
+    encodedSize(v.size()),
+    encodedType(t),
+    decodeClaims(0),
+    decoded(0)
+  {
+    ::memcpy(encoded(), v.data(), encodedSize);
+  }
+
+  static void *operator new(size_t size)
+  {
+    return ::operator new(size);
+  }
+
+  static void *operator new(size_t size, unsigned int encodedSize)
+  {
+    return ::operator new(size + encodedSize);
+  }
+
+  static void operator delete(void *p)
+  {
+    ::operator delete(p);
+  }
+
+  static void operator delete(void *p, unsigned int)
+  {
+    ::operator delete(p);
+  }
+
+  void ref()
+  {
+    ATOMIC_INC(refCount);
+  }
+
+  bool deref()
+  {
+    return ATOMIC_DEC(refCount) == 0;
+  }
+
+  int count() const
+  {
+    return static_cast<int>(refCount);
+  }
+
+  /*!
+   * Returns the string, decoding it from the encoded bytes first if that
+   * hasn't been done yet.  A string shared between threads is decoded by the
+   * first one to use it, which the others wait for.  A mutex would cost as
+   * much as decoding a short string.
+   */
+  TagLib::wstring &text()
+  {
+    if(!Thread::loadInt(&decoded)) {
+      if(ATOMIC_INC(decodeClaims) == 1) {
+        copyFromByteVector(data, encoded(), encodedSize, encodedType);
+        Thread::storeInt(&decoded, 1);
+      }
+      else {
+        while(!Thread::loadInt(&decoded))
+          Thread::yield();
+      }
+    }
+    return data;
+  }
+
+  /*!
+   * The bytes that the string was made from, which follow the private data.
+   */
+  char *encoded()
+  {
+    return reinterpret_cast<char *>(this + 1);
+  }
+
+  bool hasEncoded() const
+  {
+    return encodedSize > 0;
+  }
+
+  /*!
+   * Forgets the encoded bytes, once the string has been decoded.
+   */
+  void releaseEncoded()
+  {
+    encodedSize = 0;
+  }
+
+  volatile ATOMIC_INT refCount;
 
   /*!
    * Stores string in UTF-16. The byte order depends on the CPU endian.
+   * Empty until text() has been called if the string is not decoded yet.
    */
   TagLib::wstring data;
 
+  /*!
+   * The size and the encoding of the bytes that the string was made from, as
+   * long as it has not been changed, or 0.  Strings read from tags are only
+   * decoded when they are used, and written back as they were read.
+   */
+  unsigned int encodedSize;
+  Type encodedType;
+
+  /*!
+   * The number of times text() has started to decode the string, and whether
+   * data holds the string.
+   */
+  volatile ATOMIC_INT decodeClaims;
+  volatile int decoded;
+
   /*!
    * This is only used to hold the the most recent value of toCString().
    */
@@ -255,20 +442,16 @@ String::String(char c, Type t) :
 }
 
 String::String(const ByteVector &v, Type t) :
-  d(new StringPrivate())
+  d(0)
 {
-  if(v.isEmpty())
-    return;
-
-  if(t == Latin1)
-    copyFromLatin1(d->data, v.data(), v.size());
-  else if(t == UTF8)
-    copyFromUTF8(d->data, v.data(), v.size());
-  else
-    copyFromUTF16(d->data, v.data(), v.size() / 2, t);
-
-  // If we hit a null in the ByteVector, shrink the string again.
-  d->data.resize(::wcslen(d->data.c_str()));
+  if(!v.isEmpty() && (t == Latin1 || t == UTF8 || t == UTF16 || t == UTF16BE || t == UTF16LE)) {
+    d = new(v.size()) StringPrivate(v, t);
+  }
+  else {
+    d = new StringPrivate();
+    if(!v.isEmpty())
+      copyFromByteVector(d->data, v.data(), v.size(), t);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -287,7 +470,7 @@ std::string String::to8Bit(bool unicode) const
 
 TagLib::wstring String::toWString() const
 {
-  return d->data;
+  return d->text();
 }
 
 const char *String::toCString(bool unicode) const
@@ -298,39 +481,39 @@ const char *String::toCString(bool unicode) const
 
 const wchar_t *String::toCWString() const
 {
-  return d->data.c_str();
+  return d->text().c_str();
 }
 
 String::Iterator String::begin()
 {
   detach();
-  return d->data.begin();
+  return d->text().begin();
 }
 
 String::ConstIterator String::begin() const
 {
-  return d->data.begin();
+  return d->text().begin();
 }
 
 String::Iterator String::end()
 {
   detach();
-  return d->data.end();
+  return d->text().end();
 }
 
 String::ConstIterator String::end() const
 {
-  return d->data.end();
+  return d->text().end();
 }
 
 int String::find(const String &s, int offset) const
 {
-  return static_cast<int>(d->data.find(s.d->data, offset));
+  return static_cast<int>(d->text().find(s.d->text(), offset));
 }
 
 int String::rfind(const String &s, int offset) const
 {
-  return static_cast<int>(d->data.rfind(s.d->data, offset));
+  return static_cast<int>(d->text().rfind(s.d->text(), offset));
 }
 
 StringList String::split(const String &separator) const
@@ -363,13 +546,13 @@ String String::substr(unsigned int position, unsigned int n) const
   if(position == 0 && n >= size())
     return *this;
   else
-    return String(d->data.substr(position, n));
+    return String(d->text().substr(position, n));
 }
 
 String &String::append(const String &s)
 {
   detach();
-  d->data += s.d->data;
+  d->text() += s.d->text();
   return *this;
 }
 
@@ -396,7 +579,7 @@ String String::upper() const
 
 unsigned int String::size() const
 {
-  return static_cast<unsigned int>(d->data.size());
+  return static_cast<unsigned int>(d->text().size());
 }
 
 unsigned int String::length() const
@@ -406,7 +589,7 @@ unsigned int String::length() const
 
 bool String::isEmpty() const
 {
-  return d->data.empty();
+  return d->text().empty();
 }
 
 bool String::isNull() const
@@ -416,37 +599,36 @@ bool String::isNull() const
 
 ByteVector String::data(Type t) const
 {
+  if(d->hasEncoded() && encodesAs(d->encoded(), d->encodedSize, d->encodedType, t))
+    return ByteVector(d->encoded(), d->encodedSize);
+
   switch(t)
   {
   case Latin1:
     {
-      ByteVector v(size(), 0);
-      char *p = v.data();
-
-      for(ConstIterator it = begin(); it != end(); ++it)
-        *p++ = static_cast<char>(*it);
-
+      const wstring &text = d->text();
+      ByteVector v(static_cast<unsigned int>(text.size()), 0);
+      Unicode::utf16ToLatin1(text.data(), text.size(), v.data());
       return v;
     }
   case UTF8:
     {
-      ByteVector v(size() * 4, 0);
+      const wstring &text = d->text();
+      ByteVector v(static_cast<unsigned int>(text.size() * 3), 0);
 
-      try {
-        const ByteVector::Iterator dstEnd = utf8::utf16to8(begin(), end(), v.begin());
-        v.resize(static_cast<unsigned int>(dstEnd - v.begin()));
-      }
-      catch(const utf8::exception &e) {
-        const String message(e.what());
-        debug("String::data() - UTF8-CPP error: " + message);
-        v.clear();
+      const size_t length = Unicode::utf16ToUTF8(text.data(), text.size(), v.data());
+      if(length == Unicode::Invalid) {
+        debug("String::data() - Invalid UTF-16 string.");
+        return ByteVector();
       }
 
+      v.resize(static_cast<unsigned int>(length));
       return v;
     }
   case UTF16:
     {
-      ByteVector v(2 + size() * 2, 0);
+      const wstring &text = d->text();
+      ByteVector v(static_cast<unsigned int>(2 + text.size() * 2), 0);
       char *p = v.data();
 
       // We use little-endian encoding here and need a BOM.
@@ -454,35 +636,21 @@ ByteVector String::data(Type t) const
       *p++ = '\xff';
       *p++ = '\xfe';
 
-      for(ConstIterator it = begin(); it != end(); ++it) {
-        *p++ = static_cast<char>(*it & 0xff);
-        *p++ = static_cast<char>(*it >> 8);
-      }
-
+      Unicode::utf16ToBytes(text.data(), text.size(), p, wcharByteOrder() != UTF16LE);
       return v;
     }
   case UTF16BE:
     {
-      ByteVector v(size() * 2, 0);
-      char *p = v.data();
-
-      for(ConstIterator it = begin(); it != end(); ++it) {
-        *p++ = static_cast<char>(*it >> 8);
-        *p++ = static_cast<char>(*it & 0xff);
-      }
-
+      const wstring &text = d->text();
+      ByteVector v(static_cast<unsigned int>(text.size() * 2), 0);
+      Unicode::utf16ToBytes(text.data(), text.size(), v.data(), wcharByteOrder() != UTF16BE);
       return v;
     }
   case UTF16LE:
     {
-      ByteVector v(size() * 2, 0);
-      char *p = v.data();
-
-      for(ConstIterator it = begin(); it != end(); ++it) {
-        *p++ = static_cast<char>(*it & 0xff);
-        *p++ = static_cast<char>(*it >> 8);
-      }
-
+      const wstring &text = d->text();
+      ByteVector v(static_cast<unsigned int>(text.size() * 2), 0);
+      Unicode::utf16ToBytes(text.data(), text.size(), v.data(), wcharByteOrder() != UTF16LE);
       return v;
     }
   default:
@@ -500,7 +668,7 @@ int String::toInt() const
 
 int String::toInt(bool *ok) const
 {
-  const wchar_t *begin = d->data.c_str();
+  const wchar_t *begin = d->text().c_str();
   wchar_t *end;
   errno = 0;
   const long value = ::wcstol(begin, &end, 10);
@@ -518,11 +686,11 @@ String String::stripWhiteSpace() const
 {
   static const wchar_t *WhiteSpaceChars = L"\t\n\f\r ";
 
-  const size_t pos1 = d->data.find_first_not_of(WhiteSpaceChars);
+  const size_t pos1 = d->text().find_first_not_of(WhiteSpaceChars);
   if(pos1 == std::wstring::npos)
     return String();
 
-  const size_t pos2 = d->data.find_last_not_of(WhiteSpaceChars);
+  const size_t pos2 = d->text().find_last_not_of(WhiteSpaceChars);
   return substr(static_cast<unsigned int>(pos1), static_cast<unsigned int>(pos2 - pos1 + 1));
 }
 
@@ -552,17 +720,26 @@ String String::number(int n) // static
 wchar_t &String::operator[](int i)
 {
   detach();
-  return d->data[i];
+  return d->text()[i];
 }
 
 const wchar_t &String::operator[](int i) const
 {
-  return d->data[i];
+  return d->text()[i];
 }
 
 bool String::operator==(const String &s) const
 {
-  return (d == s.d || d->data == s.d->data);
+  if(d == s.d)
+    return true;
+
+  if(d->hasEncoded() && s.d->hasEncoded() && d->encodedType == s.d->encodedType
+     && d->encodedSize == s.d->encodedSize
+     && ::memcmp(d->encoded(), s.d->encoded(), d->encodedSize) == 0) {
+    return true;
+  }
+
+  return d->text() == s.d->text();
 }
 
 bool String::operator!=(const String &s) const
@@ -588,7 +765,7 @@ bool String::operator!=(const char *s) const
 
 bool String::operator==(const wchar_t *s) const
 {
-  return (d->data == s);
+  return (d->text() == s);
 }
 
 bool String::operator!=(const wchar_t *s) const
@@ -600,7 +777,7 @@ String &String::operator+=(const String &s)
 {
   detach();
 
-  d->data += s.d->data;
+  d->text() += s.d->text();
   return *this;
 }
 
@@ -608,7 +785,7 @@ String &String::operator+=(const wchar_t *s)
 {
   detach();
 
-  d->data += s;
+  d->text() += s;
   return *this;
 }
 
@@ -617,7 +794,7 @@ String &String::operator+=(const char *s)
   detach();
 
   for(int i = 0; s[i] != 0; i++)
-    d->data += static_cast<unsigned char>(s[i]);
+    d->text() += static_cast<unsigned char>(s[i]);
   return *this;
 }
 
@@ -625,7 +802,7 @@ String &String::operator+=(wchar_t c)
 {
   detach();
 
-  d->data += c;
+  d->text() += c;
   return *this;
 }
 
@@ -633,7 +810,7 @@ String &String::operator+=(char c)
 {
   detach();
 
-  d->data += static_cast<unsigned char>(c);
+  d->text() += static_cast<unsigned char>(c);
   return *this;
 }
 
@@ -694,7 +871,7 @@ void String::swap(String &s)
 
 bool String::operator<(const String &s) const
 {
-  return (d->data < s.d->data);
+  return (d->text() < s.d->text());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -703,8 +880,13 @@ bool String::operator<(const String &s) const
 
 void String::detach()
 {
-  if(d->count() > 1)
-    String(d->data.c_str()).swap(*this);
+  if(d->count() > 1) {
+    String(d->text().c_str()).swap(*this);
+  }
+  else if(d->hasEncoded()) {
+    d->text();
+    d->releaseEncoded();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -179,6 +179,10 @@ namespace TagLib {
 
     /*!
      * Makes a deep copy of the data in \a v.
+     *
+     * \note The data is only decoded when the string is first used.  Until the
+     * string is modified, data() returns a copy of \a v when asked for the
+     * same encoding and the result would be the same.
      */
     String(const ByteVector &v, Type t = Latin1);
 
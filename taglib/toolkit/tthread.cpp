@@ -0,0 +1,257 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "tthread.h"
+
+#include <vector>
+
+#if defined(_WIN32)
+# include <windows.h>
+#elif defined(HAVE_PTHREAD)
+# include <pthread.h>
+# include <sched.h>
+# include <unistd.h>
+#endif
+
+#if !defined(__ATOMIC_ACQUIRE) && !defined(_WIN32) && defined(HAVE_MAC_ATOMIC)
+# include <libkern/OSAtomic.h>
+#endif
+
+using namespace TagLib;
+
+namespace
+{
+  struct Call
+  {
+    void (*function)(void *);
+    void *data;
+  };
+
+#if defined(_WIN32) && !defined(PLATFORM_WINRT)
+
+  DWORD WINAPI threadMain(LPVOID call)
+  {
+    static_cast<Call *>(call)->function(static_cast<Call *>(call)->data);
+    return 0;
+  }
+
+#elif defined(HAVE_PTHREAD)
+
+  extern "C" void *threadMain(void *call)
+  {
+    static_cast<Call *>(call)->function(static_cast<Call *>(call)->data);
+    return 0;
+  }
+
+#endif
+}
+
+class Mutex::MutexPrivate
+{
+public:
+#if defined(_WIN32)
+  CRITICAL_SECTION section;
+#elif defined(HAVE_PTHREAD)
+  pthread_mutex_t mutex;
+#endif
+};
+
+Mutex::Mutex() :
+  d(new MutexPrivate())
+{
+#if defined(_WIN32)
+  InitializeCriticalSectionEx(&d->section, 0, 0);
+#elif defined(HAVE_PTHREAD)
+  pthread_mutex_init(&d->mutex, 0);
+#endif
+}
+
+Mutex::~Mutex()
+{
+#if defined(_WIN32)
+  DeleteCriticalSection(&d->section);
+#elif defined(HAVE_PTHREAD)
+  pthread_mutex_destroy(&d->mutex);
+#endif
+
+  delete d;
+}
+
+void Mutex::lock()
+{
+#if defined(_WIN32)
+  EnterCriticalSection(&d->section);
+#elif defined(HAVE_PTHREAD)
+  pthread_mutex_lock(&d->mutex);
+#endif
+}
+
+void Mutex::unlock()
+{
+#if defined(_WIN32)
+  LeaveCriticalSection(&d->section);
+#elif defined(HAVE_PTHREAD)
+  pthread_mutex_unlock(&d->mutex);
+#endif
+}
+
+unsigned int Thread::hardwareConcurrency()
+{
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+  GetNativeSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+#elif defined(HAVE_PTHREAD) && defined(_SC_NPROCESSORS_ONLN)
+  const long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? static_cast<unsigned int>(count) : 1;
+#else
+  return 1;
+#endif
+}
+
+void Thread::run(unsigned int count, void (*function)(void *), void *data)
+{
+  Call call;
+  call.function = function;
+  call.data = data;
+
+  unsigned int started = 0;
+
+#if defined(_WIN32) && !defined(PLATFORM_WINRT)
+
+  std::vector<HANDLE> threads;
+  for(unsigned int i = 1; i < count; ++i) {
+    const HANDLE thread = CreateThread(NULL, 0, threadMain, &call, 0, NULL);
+    if(!thread)
+      break;
+    threads.push_back(thread);
+  }
+
+  started = static_cast<unsigned int>(threads.size());
+
+#elif defined(HAVE_PTHREAD)
+
+  std::vector<pthread_t> threads;
+  for(unsigned int i = 1; i < count; ++i) {
+    pthread_t thread;
+    if(pthread_create(&thread, 0, threadMain, &call) != 0)
+      break;
+    threads.push_back(thread);
+  }
+
+  started = static_cast<unsigned int>(threads.size());
+
+#endif
+
+  for(unsigned int i = started; i < count; ++i)
+    function(data);
+
+#if defined(_WIN32) && !defined(PLATFORM_WINRT)
+
+  for(std::vector<HANDLE>::const_iterator it = threads.begin(); it != threads.end(); ++it) {
+    WaitForSingleObject(*it, INFINITE);
+    CloseHandle(*it);
+  }
+
+#elif defined(HAVE_PTHREAD)
+
+  for(std::vector<pthread_t>::const_iterator it = threads.begin(); it != threads.end(); ++it)
+    pthread_join(*it, 0);
+
+#endif
+}
+
+void Thread::yield()
+{
+#if defined(_WIN32)
+  SwitchToThread();
+#elif defined(HAVE_PTHREAD)
+  sched_yield();
+#endif
+}
+
+// The compiler builtins are preferred, as they are understood by the thread
+// sanitizers. Otherwise a volatile access is fenced by a full barrier.
+
+#if defined(__ATOMIC_ACQUIRE)
+# define LOAD_ACQUIRE(x)     __atomic_load_n(x, __ATOMIC_ACQUIRE)
+# define STORE_RELEASE(x, v) __atomic_store_n(x, v, __ATOMIC_RELEASE)
+#else
+# if defined(_WIN32)
+#  define MEMORY_BARRIER() MemoryBarrier()
+# elif defined(HAVE_GCC_ATOMIC)
+#  define MEMORY_BARRIER() __sync_synchronize()
+# elif defined(HAVE_MAC_ATOMIC)
+#  define MEMORY_BARRIER() OSMemoryBarrier()
+# else
+#  define MEMORY_BARRIER()
+# endif
+
+namespace
+{
+  template <class T>
+  T loadAcquire(const volatile T *x)
+  {
+    const T value = *x;
+    MEMORY_BARRIER();
+    return value;
+  }
+
+  template <class T>
+  void storeRelease(volatile T *x, T value)
+  {
+    MEMORY_BARRIER();
+    *x = value;
+    MEMORY_BARRIER();
+  }
+}
+
+# define LOAD_ACQUIRE(x)     loadAcquire(x)
+# define STORE_RELEASE(x, v) storeRelease(x, v)
+#endif
+
+void *Thread::loadPointer(void *const volatile *pointer)
+{
+  return LOAD_ACQUIRE(pointer);
+}
+
+void Thread::storePointer(void *volatile *pointer, void *value)
+{
+  STORE_RELEASE(pointer, value);
+}
+
+int Thread::loadInt(const volatile int *value)
+{
+  return LOAD_ACQUIRE(value);
+}
+
+void Thread::storeInt(volatile int *value, int newValue)
+{
+  STORE_RELEASE(value, newValue);
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_THREAD_H
+#define TAGLIB_THREAD_H
+
+#include "taglib_export.h"
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  //! A minimal mutex, since TagLib can not rely on C++11 threads
+
+  class TAGLIB_EXPORT Mutex
+  {
+  public:
+    Mutex();
+    ~Mutex();
+
+    void lock();
+    void unlock();
+
+  private:
+    Mutex(const Mutex &);
+    Mutex &operator=(const Mutex &);
+
+    class MutexPrivate;
+    MutexPrivate *d;
+  };
+
+  //! Locks a mutex for the lifetime of the locker
+
+  class MutexLocker
+  {
+  public:
+    explicit MutexLocker(Mutex &mutex) : m_mutex(mutex) { m_mutex.lock(); }
+    ~MutexLocker() { m_mutex.unlock(); }
+
+  private:
+    MutexLocker(const MutexLocker &);
+    MutexLocker &operator=(const MutexLocker &);
+
+    Mutex &m_mutex;
+  };
+
+  namespace Thread {
+
+    /*!
+     * Returns the number of processors available, or 1 if it is not known.
+     */
+    TAGLIB_EXPORT unsigned int hardwareConcurrency();
+
+    /*!
+     * Calls \a function with \a data on \a count threads at once, one of them
+     * being the calling thread, and returns when all of them have returned.
+     * If threads are not supported or can not be started, the remaining calls
+     * are made on the calling thread.
+     */
+    TAGLIB_EXPORT void run(unsigned int count, void (*function)(void *), void *data);
+
+    /*!
+     * Lets another thread run, while this one waits for it.
+     */
+    TAGLIB_EXPORT void yield();
+
+    /*!
+     * Reads a pointer that another thread may replace with storePointer().
+     * Everything written before the pointer was stored is visible after it
+     * has been loaded.
+     */
+    TAGLIB_EXPORT void *loadPointer(void *const volatile *pointer);
+
+    /*!
+     * Replaces a pointer that other threads read with loadPointer().
+     */
+    TAGLIB_EXPORT void storePointer(void *volatile *pointer, void *value);
+
+    /*!
+     * Reads and writes a setting that other threads may change at any time.
+     */
+    TAGLIB_EXPORT int loadInt(const volatile int *value);
+    TAGLIB_EXPORT void storeInt(volatile int *value, int newValue);
+
+    //! A process-wide handler that may be replaced while other threads use it
+
+    /*!
+     * This is an aggregate, so that it is initialized before any constructor
+     * runs, e.g. with { &defaultHandler, &defaultHandler }.  Setting a null
+     * handler restores the default one.
+     */
+    template <class T>
+    struct SharedHandler
+    {
+      const T *get() const
+      {
+        return static_cast<const T *>(loadPointer(&current));
+      }
+
+      void set(const T *handler)
+      {
+        storePointer(&current, const_cast<T *>(handler ? handler : defaultHandler));
+      }
+
+      void *volatile current;
+      const T *defaultHandler;
+    };
+
+  }
+
+}
+
+#endif
+
+#endif
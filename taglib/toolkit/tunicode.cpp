@@ -0,0 +1,671 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <cstring>
+
+#if defined(HAVE_GCC_AVX2)
+# include <immintrin.h>
+#elif defined(HAVE_SSE2)
+# include <emmintrin.h>
+#endif
+
+#if defined(HAVE_SSE2) && defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+#include "tunicode.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // The portable conversions, also used for the ends of the input that are
+  // too short for a vector.  The ASCII ones stop at the first character that
+  // is not ASCII and return how many they converted.
+
+  void widenScalar(const char *src, size_t length, wchar_t *dst)
+  {
+    for(size_t i = 0; i < length; ++i)
+      dst[i] = static_cast<unsigned char>(src[i]);
+  }
+
+  void narrowScalar(const wchar_t *src, size_t length, char *dst)
+  {
+    for(size_t i = 0; i < length; ++i)
+      dst[i] = static_cast<char>(src[i]);
+  }
+
+  size_t widenASCIIScalar(const char *src, size_t length, wchar_t *dst)
+  {
+    size_t i = 0;
+    for(; i < length && static_cast<unsigned char>(src[i]) < 0x80; ++i)
+      dst[i] = src[i];
+    return i;
+  }
+
+  size_t narrowASCIIScalar(const wchar_t *src, size_t length, char *dst)
+  {
+    size_t i = 0;
+    for(; i < length && (src[i] & 0xff80) == 0; ++i)
+      dst[i] = static_cast<char>(src[i]);
+    return i;
+  }
+
+  inline unsigned short swapBytes(unsigned short c)
+  {
+    return static_cast<unsigned short>((c << 8) | (c >> 8));
+  }
+
+  void bytesToUTF16Scalar(const char *src, size_t length, wchar_t *dst, bool swap)
+  {
+    for(size_t i = 0; i < length; ++i) {
+      unsigned short c;
+      ::memcpy(&c, src + i * 2, 2);
+      dst[i] = swap ? swapBytes(c) : c;
+    }
+  }
+
+  void utf16ToBytesScalar(const wchar_t *src, size_t length, char *dst, bool swap)
+  {
+    for(size_t i = 0; i < length; ++i) {
+      unsigned short c = static_cast<unsigned short>(src[i]);
+      if(swap)
+        c = swapBytes(c);
+      ::memcpy(dst + i * 2, &c, 2);
+    }
+  }
+
+  size_t asciiLengthScalar(const char *data, size_t length)
+  {
+    size_t i = 0;
+    while(i < length && static_cast<unsigned char>(data[i]) < 0x80)
+      ++i;
+    return i;
+  }
+
+#if defined(HAVE_SSE2)
+
+  inline unsigned int lowestBit(unsigned int mask)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+
+  // Stores the 8 code units of a vector as wchar_t.
+
+  inline void storeUnits8(wchar_t *dst, __m128i units)
+  {
+    if(sizeof(wchar_t) == 2) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), units);
+    }
+    else {
+      const __m128i zero = _mm_setzero_si128();
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),     _mm_unpacklo_epi16(units, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4), _mm_unpackhi_epi16(units, zero));
+    }
+  }
+
+  // Loads 8 wchar_t as code units.  Sign extending the low 16 bits of a wider
+  // wchar_t lets the saturating pack keep them unchanged.
+
+  inline __m128i loadUnits8(const wchar_t *src)
+  {
+    if(sizeof(wchar_t) == 2)
+      return _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4));
+    return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                           _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+  }
+
+  inline __m128i swapUnits8(__m128i units)
+  {
+    return _mm_or_si128(_mm_slli_epi16(units, 8), _mm_srli_epi16(units, 8));
+  }
+
+  void widenSSE2(const char *src, size_t length, wchar_t *dst)
+  {
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16) {
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+      storeUnits8(dst + i,     _mm_unpacklo_epi8(bytes, zero));
+      storeUnits8(dst + i + 8, _mm_unpackhi_epi8(bytes, zero));
+    }
+
+    widenScalar(src + i, length - i, dst + i);
+  }
+
+  void narrowSSE2(const wchar_t *src, size_t length, char *dst)
+  {
+    const __m128i lowByte = _mm_set1_epi16(0xff);
+
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16) {
+      const __m128i a = _mm_and_si128(loadUnits8(src + i), lowByte);
+      const __m128i b = _mm_and_si128(loadUnits8(src + i + 8), lowByte);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(a, b));
+    }
+
+    narrowScalar(src + i, length - i, dst + i);
+  }
+
+  // The ASCII conversions write the whole vector in which they stop.  The
+  // destination has room for it, and the caller overwrites the rest.
+
+  size_t widenASCIISSE2(const char *src, size_t length, wchar_t *dst)
+  {
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16) {
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+      storeUnits8(dst + i,     _mm_unpacklo_epi8(bytes, zero));
+      storeUnits8(dst + i + 8, _mm_unpackhi_epi8(bytes, zero));
+
+      const unsigned int mask = _mm_movemask_epi8(bytes);
+      if(mask != 0)
+        return i + lowestBit(mask);
+    }
+
+    return i + widenASCIIScalar(src + i, length - i, dst + i);
+  }
+
+  size_t narrowASCIISSE2(const wchar_t *src, size_t length, char *dst)
+  {
+    const __m128i nonASCII = _mm_set1_epi16(static_cast<short>(0xff80));
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16) {
+      const __m128i a = loadUnits8(src + i);
+      const __m128i b = loadUnits8(src + i + 8);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(a, b));
+
+      const __m128i ascii = _mm_packs_epi16(_mm_cmpeq_epi16(_mm_and_si128(a, nonASCII), zero),
+                                            _mm_cmpeq_epi16(_mm_and_si128(b, nonASCII), zero));
+      const unsigned int mask = ~_mm_movemask_epi8(ascii) & 0xffff;
+      if(mask != 0)
+        return i + lowestBit(mask);
+    }
+
+    return i + narrowASCIIScalar(src + i, length - i, dst + i);
+  }
+
+  void bytesToUTF16SSE2(const char *src, size_t length, wchar_t *dst, bool swap)
+  {
+    size_t i = 0;
+    for(; i + 8 <= length; i += 8) {
+      __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+      if(swap)
+        units = swapUnits8(units);
+      storeUnits8(dst + i, units);
+    }
+
+    bytesToUTF16Scalar(src + i * 2, length - i, dst + i, swap);
+  }
+
+  void utf16ToBytesSSE2(const wchar_t *src, size_t length, char *dst, bool swap)
+  {
+    size_t i = 0;
+    for(; i + 8 <= length; i += 8) {
+      __m128i units = loadUnits8(src + i);
+      if(swap)
+        units = swapUnits8(units);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 2), units);
+    }
+
+    utf16ToBytesScalar(src + i, length - i, dst + i * 2, swap);
+  }
+
+  size_t asciiLengthSSE2(const char *data, size_t length)
+  {
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16) {
+      const unsigned int mask
+        = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+      if(mask != 0)
+        return i + lowestBit(mask);
+    }
+
+    return i + asciiLengthScalar(data + i, length - i);
+  }
+
+#endif
+
+#if defined(HAVE_GCC_AVX2)
+
+  // The same with 32 bytes or 16 code units at a time.  Packing works within
+  // each half of a vector, so the packed quarters are put back in order.
+
+  __attribute__((target("avx2")))
+  inline void storeUnits16(wchar_t *dst, __m256i units)
+  {
+    if(sizeof(wchar_t) == 2) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), units);
+    }
+    else {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                          _mm256_cvtepu16_epi32(_mm256_castsi256_si128(units)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 8),
+                          _mm256_cvtepu16_epi32(_mm256_extracti128_si256(units, 1)));
+    }
+  }
+
+  __attribute__((target("avx2")))
+  inline __m256i loadUnits16(const wchar_t *src)
+  {
+    if(sizeof(wchar_t) == 2)
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 8));
+    const __m256i units = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16),
+                                             _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16));
+    return _mm256_permute4x64_epi64(units, 0xd8);
+  }
+
+  __attribute__((target("avx2")))
+  inline __m256i swapUnits16(__m256i units)
+  {
+    return _mm256_or_si256(_mm256_slli_epi16(units, 8), _mm256_srli_epi16(units, 8));
+  }
+
+  __attribute__((target("avx2")))
+  void widenAVX2(const char *src, size_t length, wchar_t *dst)
+  {
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32) {
+      const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      storeUnits16(dst + i,      _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+      storeUnits16(dst + i + 16, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+    }
+
+    widenSSE2(src + i, length - i, dst + i);
+  }
+
+  __attribute__((target("avx2")))
+  void narrowAVX2(const wchar_t *src, size_t length, char *dst)
+  {
+    const __m256i lowByte = _mm256_set1_epi16(0xff);
+
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32) {
+      const __m256i a = _mm256_and_si256(loadUnits16(src + i), lowByte);
+      const __m256i b = _mm256_and_si256(loadUnits16(src + i + 16), lowByte);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                          _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8));
+    }
+
+    narrowSSE2(src + i, length - i, dst + i);
+  }
+
+  __attribute__((target("avx2")))
+  size_t widenASCIIAVX2(const char *src, size_t length, wchar_t *dst)
+  {
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32) {
+      const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      storeUnits16(dst + i,      _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+      storeUnits16(dst + i + 16, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+
+      const unsigned int mask = _mm256_movemask_epi8(bytes);
+      if(mask != 0)
+        return i + lowestBit(mask);
+    }
+
+    return i + widenASCIISSE2(src + i, length - i, dst + i);
+  }
+
+  __attribute__((target("avx2")))
+  size_t narrowASCIIAVX2(const wchar_t *src, size_t length, char *dst)
+  {
+    const __m256i nonASCII = _mm256_set1_epi16(static_cast<short>(0xff80));
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32) {
+      const __m256i a = loadUnits16(src + i);
+      const __m256i b = loadUnits16(src + i + 16);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                          _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8));
+
+      const __m256i ascii = _mm256_packs_epi16(_mm256_cmpeq_epi16(_mm256_and_si256(a, nonASCII), zero),
+                                               _mm256_cmpeq_epi16(_mm256_and_si256(b, nonASCII), zero));
+      const unsigned int mask = ~_mm256_movemask_epi8(_mm256_permute4x64_epi64(ascii, 0xd8));
+      if(mask != 0)
+        return i + lowestBit(mask);
+    }
+
+    return i + narrowASCIISSE2(src + i, length - i, dst + i);
+  }
+
+  __attribute__((target("avx2")))
+  void bytesToUTF16AVX2(const char *src, size_t length, wchar_t *dst, bool swap)
+  {
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16) {
+      __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 2));
+      if(swap)
+        units = swapUnits16(units);
+      storeUnits16(dst + i, units);
+    }
+
+    bytesToUTF16SSE2(src + i * 2, length - i, dst + i, swap);
+  }
+
+  __attribute__((target("avx2")))
+  void utf16ToBytesAVX2(const wchar_t *src, size_t length, char *dst, bool swap)
+  {
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16) {
+      __m256i units = loadUnits16(src + i);
+      if(swap)
+        units = swapUnits16(units);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 2), units);
+    }
+
+    utf16ToBytesSSE2(src + i, length - i, dst + i * 2, swap);
+  }
+
+  __attribute__((target("avx2")))
+  size_t asciiLengthAVX2(const char *data, size_t length)
+  {
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32) {
+      const unsigned int mask
+        = _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+      if(mask != 0)
+        return i + lowestBit(mask);
+    }
+
+    return i + asciiLengthSSE2(data + i, length - i);
+  }
+
+  bool hasAVX2()
+  {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }
+
+#endif
+
+  // The conversions for this processor, chosen on first use.
+
+  struct Kernels
+  {
+    void   (*widen)(const char *, size_t, wchar_t *);
+    void   (*narrow)(const wchar_t *, size_t, char *);
+    size_t (*widenASCII)(const char *, size_t, wchar_t *);
+    size_t (*narrowASCII)(const wchar_t *, size_t, char *);
+    void   (*bytesToUTF16)(const char *, size_t, wchar_t *, bool);
+    void   (*utf16ToBytes)(const wchar_t *, size_t, char *, bool);
+    size_t (*asciiLength)(const char *, size_t);
+  };
+
+  Kernels selectKernels()
+  {
+#if defined(HAVE_GCC_AVX2)
+    if(hasAVX2()) {
+      const Kernels kernels = {
+        widenAVX2, narrowAVX2, widenASCIIAVX2, narrowASCIIAVX2,
+        bytesToUTF16AVX2, utf16ToBytesAVX2, asciiLengthAVX2
+      };
+      return kernels;
+    }
+#endif
+#if defined(HAVE_SSE2)
+    const Kernels kernels = {
+      widenSSE2, narrowSSE2, widenASCIISSE2, narrowASCIISSE2,
+      bytesToUTF16SSE2, utf16ToBytesSSE2, asciiLengthSSE2
+    };
+#else
+    const Kernels kernels = {
+      widenScalar, narrowScalar, widenASCIIScalar, narrowASCIIScalar,
+      bytesToUTF16Scalar, utf16ToBytesScalar, asciiLengthScalar
+    };
+#endif
+    return kernels;
+  }
+
+  const Kernels &kernels()
+  {
+    static const Kernels k = selectKernels();
+    return k;
+  }
+
+  // Text that is not in English has only a few ASCII characters in a row,
+  // which are converted one by one.  After this many the rest of the run is
+  // converted a vector at a time.
+
+  const size_t LongASCII = 8;
+
+  inline bool isContinuation(unsigned char c)
+  {
+    return (c & 0xc0) == 0x80;
+  }
+
+  // Decodes the sequence that starts with the byte at p, of which at most
+  // available bytes may be read.  Returns its length, or 0 if it is not valid.
+
+  inline size_t decodeUTF8(const unsigned char *p, size_t available, unsigned int &cp)
+  {
+    const unsigned int lead = p[0];
+
+    if(lead < 0x80) {
+      cp = lead;
+      return 1;
+    }
+    if(lead < 0xc2) {
+      // A continuation byte, or the start of an overlong 2 byte sequence.
+      return 0;
+    }
+    if(lead < 0xe0) {
+      if(available < 2 || !isContinuation(p[1]))
+        return 0;
+      cp = ((lead & 0x1f) << 6) | (p[1] & 0x3f);
+      return 2;
+    }
+    if(lead < 0xf0) {
+      if(available < 3 || !isContinuation(p[1]) || !isContinuation(p[2]))
+        return 0;
+      cp = ((lead & 0x0f) << 12) | ((p[1] & 0x3f) << 6) | (p[2] & 0x3f);
+      if(cp < 0x800 || (cp >= 0xd800 && cp < 0xe000))
+        return 0;
+      return 3;
+    }
+    if(lead < 0xf5) {
+      if(available < 4 || !isContinuation(p[1]) || !isContinuation(p[2]) || !isContinuation(p[3]))
+        return 0;
+      cp = ((lead & 0x07) << 18) | ((p[1] & 0x3f) << 12) | ((p[2] & 0x3f) << 6) | (p[3] & 0x3f);
+      if(cp < 0x10000 || cp > 0x10ffff)
+        return 0;
+      return 4;
+    }
+    return 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+void Unicode::latin1ToUTF16(const char *src, size_t length, wchar_t *dst)
+{
+  kernels().widen(src, length, dst);
+}
+
+void Unicode::utf16ToLatin1(const wchar_t *src, size_t length, char *dst)
+{
+  kernels().narrow(src, length, dst);
+}
+
+size_t Unicode::utf8ToUTF16(const char *src, size_t length, wchar_t *dst)
+{
+  const Kernels &k = kernels();
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(src);
+
+  size_t i = 0;
+  size_t n = 0;
+  size_t run = 0;
+  while(i < length) {
+    if(bytes[i] < 0x80) {
+      if(++run < LongASCII) {
+        dst[n++] = bytes[i++];
+      }
+      else {
+        const size_t ascii = k.widenASCII(src + i, length - i, dst + n);
+        i += ascii;
+        n += ascii;
+      }
+      continue;
+    }
+
+    run = 0;
+
+    unsigned int cp;
+    const size_t sequence = decodeUTF8(bytes + i, length - i, cp);
+    if(sequence == 0)
+      return Invalid;
+
+    i += sequence;
+    if(cp < 0x10000) {
+      dst[n++] = static_cast<wchar_t>(cp);
+    }
+    else {
+      cp -= 0x10000;
+      dst[n++] = static_cast<wchar_t>(0xd800 + (cp >> 10));
+      dst[n++] = static_cast<wchar_t>(0xdc00 + (cp & 0x3ff));
+    }
+  }
+
+  return n;
+}
+
+size_t Unicode::utf16ToUTF8(const wchar_t *src, size_t length, char *dst)
+{
+  const Kernels &k = kernels();
+
+  size_t i = 0;
+  size_t n = 0;
+  size_t run = 0;
+  while(i < length) {
+    const unsigned int c = static_cast<unsigned int>(src[i]) & 0xffff;
+
+    if(c < 0x80) {
+      if(++run < LongASCII) {
+        dst[n++] = static_cast<char>(c);
+        ++i;
+      }
+      else {
+        const size_t ascii = k.narrowASCII(src + i, length - i, dst + n);
+        i += ascii;
+        n += ascii;
+      }
+      continue;
+    }
+
+    run = 0;
+
+    if(c < 0x800) {
+      dst[n++] = static_cast<char>(0xc0 | (c >> 6));
+      dst[n++] = static_cast<char>(0x80 | (c & 0x3f));
+    }
+    else if(c >= 0xd800 && c < 0xdc00) {
+      if(i + 1 == length)
+        return Invalid;
+
+      const unsigned int trail = static_cast<unsigned int>(src[i + 1]) & 0xffff;
+      if(trail < 0xdc00 || trail >= 0xe000)
+        return Invalid;
+
+      const unsigned int cp = 0x10000 + ((c - 0xd800) << 10) + (trail - 0xdc00);
+      dst[n++] = static_cast<char>(0xf0 | (cp >> 18));
+      dst[n++] = static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+      dst[n++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+      dst[n++] = static_cast<char>(0x80 | (cp & 0x3f));
+      ++i;
+    }
+    else if(c >= 0xdc00 && c < 0xe000) {
+      return Invalid;
+    }
+    else {
+      dst[n++] = static_cast<char>(0xe0 | (c >> 12));
+      dst[n++] = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+      dst[n++] = static_cast<char>(0x80 | (c & 0x3f));
+    }
+    ++i;
+  }
+
+  return n;
+}
+
+void Unicode::bytesToUTF16(const char *src, size_t length, wchar_t *dst, bool swap)
+{
+  kernels().bytesToUTF16(src, length, dst, swap);
+}
+
+void Unicode::utf16ToBytes(const wchar_t *src, size_t length, char *dst, bool swap)
+{
+  kernels().utf16ToBytes(src, length, dst, swap);
+}
+
+bool Unicode::isValidUTF8(const char *data, size_t length)
+{
+  const Kernels &k = kernels();
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+
+  size_t i = 0;
+  while(i < length) {
+    if(bytes[i] < 0x80) {
+      i += k.asciiLength(data + i, length - i);
+      continue;
+    }
+
+    unsigned int cp;
+    const size_t sequence = decodeUTF8(bytes + i, length - i, cp);
+    if(sequence == 0)
+      return false;
+    i += sequence;
+  }
+
+  return true;
+}
+
+size_t Unicode::asciiLength(const char *data, size_t length)
+{
+  return kernels().asciiLength(data, length);
+}
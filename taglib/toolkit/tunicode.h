@@ -0,0 +1,108 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_UNICODE_H
+#define TAGLIB_UNICODE_H
+
+#include <cstddef>
+
+#include "taglib_export.h"
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  /*!
+   * Conversions between the encodings that String reads and writes and the
+   * UTF-16 code units that it keeps, one in each wchar_t.  Only the low 16
+   * bits of a wchar_t are used, as the rest of String does.
+   *
+   * The destination must have room for the result; no terminating null is
+   * written.  The work is done with SSE2 or AVX2 where the processor has them.
+   */
+
+  namespace Unicode {
+
+    /*!
+     * Returned by the conversions that fail on malformed input.
+     */
+    const size_t Invalid = static_cast<size_t>(-1);
+
+    /*!
+     * Converts the \a length Latin-1 characters at \a src to \a length code
+     * units.
+     */
+    TAGLIB_EXPORT void latin1ToUTF16(const char *src, size_t length, wchar_t *dst);
+
+    /*!
+     * Converts \a length code units to Latin-1, keeping the low byte of each.
+     */
+    TAGLIB_EXPORT void utf16ToLatin1(const wchar_t *src, size_t length, char *dst);
+
+    /*!
+     * Converts the \a length bytes of UTF-8 at \a src to at most \a length
+     * code units.  Returns the number of code units, or Invalid if the bytes
+     * are not strictly valid UTF-8: overlong forms, surrogates and code points
+     * above U+10FFFF are rejected.
+     */
+    TAGLIB_EXPORT size_t utf8ToUTF16(const char *src, size_t length, wchar_t *dst);
+
+    /*!
+     * Converts \a length code units to at most 3 * \a length bytes of UTF-8.
+     * Returns the number of bytes, or Invalid if a surrogate is not paired.
+     */
+    TAGLIB_EXPORT size_t utf16ToUTF8(const wchar_t *src, size_t length, char *dst);
+
+    /*!
+     * Reads \a length code units of two bytes each, in the byte order of the
+     * processor or, if \a swap is true, in the other one.
+     */
+    TAGLIB_EXPORT void bytesToUTF16(const char *src, size_t length, wchar_t *dst, bool swap);
+
+    /*!
+     * Writes \a length code units as two bytes each, in the byte order of the
+     * processor or, if \a swap is true, in the other one.
+     */
+    TAGLIB_EXPORT void utf16ToBytes(const wchar_t *src, size_t length, char *dst, bool swap);
+
+    /*!
+     * Returns whether the \a length bytes at \a data are valid UTF-8, in the
+     * sense of utf8ToUTF16().
+     */
+    TAGLIB_EXPORT bool isValidUTF8(const char *data, size_t length);
+
+    /*!
+     * Returns the number of bytes below 0x80 that \a data starts with.
+     */
+    TAGLIB_EXPORT size_t asciiLength(const char *data, size_t length);
+
+  }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,722 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "twriteplan.h"
+#include "tfilestream.h"
+#include "tstring.h"
+#include "tdebug.h"
+
+#include <algorithm>
+#include <list>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <errno.h>
+# include <fcntl.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <unistd.h>
+# include <sys/stat.h>
+# if defined(HAVE_LISTXATTR) || defined(HAVE_MAC_LISTXATTR)
+#  include <sys/xattr.h>
+# endif
+#endif
+
+using namespace TagLib;
+
+namespace
+{
+  // A piece of the new content: either a range of the original stream or a
+  // block of new data.
+
+  struct Piece
+  {
+    Piece(long offset, long length) :
+      offset(offset),
+      length(length) {}
+
+    explicit Piece(const ByteVector &data) :
+      offset(-1),
+      length(static_cast<long>(data.size())),
+      data(data) {}
+
+    bool isData() const { return offset < 0; }
+
+    long offset;
+    long length;
+    ByteVector data;
+  };
+
+  typedef std::list<Piece> PieceList;
+
+  // A range of the original stream that has to be moved to its new place.
+
+  struct Move
+  {
+    Move(long from, long to, long length) :
+      from(from),
+      to(to),
+      length(length) {}
+
+    long from;
+    long to;
+    long length;
+  };
+
+  const unsigned int CopyBufferSize = 1024 * 1024;
+
+#ifdef _WIN32
+
+  typedef std::wstring TemporaryName;
+
+  bool writeFile(HANDLE file, const ByteVector &data)
+  {
+    DWORD length;
+    return WriteFile(file, data.data(), static_cast<DWORD>(data.size()), &length, NULL)
+      && length == data.size();
+  }
+
+#else
+
+  typedef std::string TemporaryName;
+
+  bool writeFile(int file, const ByteVector &data)
+  {
+    const char *p = data.data();
+    size_t count = 0;
+
+    while(count < data.size()) {
+      const ssize_t n = write(file, p + count, data.size() - count);
+      if(n > 0)
+        count += n;
+      else if(n == 0 || errno != EINTR)
+        return false;
+    }
+
+    return true;
+  }
+
+  // Returns true if the file at path has extended attributes, which include
+  // its ACLs on Linux, that a new file would not have.  The security labels
+  // that the system gives every new file are not counted.
+
+  bool hasExtendedAttributes(const char *path)
+  {
+#if defined(HAVE_LISTXATTR) || defined(HAVE_MAC_LISTXATTR)
+
+# ifdef HAVE_MAC_LISTXATTR
+    const ssize_t size = listxattr(path, 0, 0, 0);
+# else
+    const ssize_t size = listxattr(path, 0, 0);
+# endif
+
+    if(size <= 0)
+      return false;
+
+    std::vector<char> names(size);
+
+# ifdef HAVE_MAC_LISTXATTR
+    const ssize_t length = listxattr(path, &names[0], names.size(), 0);
+# else
+    const ssize_t length = listxattr(path, &names[0], names.size());
+# endif
+
+    // The list may have changed since its size was read.
+
+    if(length < 0)
+      return true;
+
+    for(ssize_t i = 0; i < length; i += strlen(&names[i]) + 1) {
+      if(strncmp(&names[i], "security.", 9) != 0)
+        return true;
+    }
+
+    return false;
+
+#else
+
+    (void)path;
+    return false;
+
+#endif
+  }
+
+#endif
+}
+
+class WritePlan::WritePlanPrivate
+{
+public:
+  WritePlanPrivate(IOStream *stream) :
+    stream(stream),
+    position(0),
+    length(stream->length()),
+    modified(false)
+  {
+    if(length > 0)
+      pieces.push_back(Piece(0, length));
+
+    cursor = pieces.end();
+    cursorStart = 0;
+  }
+
+  // Returns the piece that contains offset and sets pieceStart to where it
+  // starts, or returns pieces.end() for the end of the content.
+
+  PieceList::iterator find(long offset, long &pieceStart)
+  {
+    PieceList::iterator it = pieces.begin();
+    pieceStart = 0;
+
+    if(cursor != pieces.end() && cursorStart <= offset) {
+      it = cursor;
+      pieceStart = cursorStart;
+    }
+
+    for(; it != pieces.end() && offset >= pieceStart + it->length; ++it)
+      pieceStart += it->length;
+
+    cursor = it;
+    cursorStart = pieceStart;
+    return it;
+  }
+
+  // Returns the piece that starts at offset, splitting the piece that
+  // contains it if necessary.  Returns pieces.end() for the end of the content.
+
+  PieceList::iterator split(long offset)
+  {
+    long pieceStart;
+    PieceList::iterator it = find(offset, pieceStart);
+    if(it == pieces.end() || pieceStart == offset)
+      return it;
+
+    const long headLength = offset - pieceStart;
+
+    Piece tail = it->isData()
+      ? Piece(it->data.mid(static_cast<unsigned int>(headLength)))
+      : Piece(it->offset + headLength, it->length - headLength);
+
+    if(it->isData())
+      it->data.resize(static_cast<unsigned int>(headLength));
+    it->length = headLength;
+
+    cursor = pieces.insert(++it, tail);
+    cursorStart = offset;
+    return cursor;
+  }
+
+  // Replaces removeLength bytes at start with data.
+
+  void replace(long start, long removeLength, const ByteVector &data)
+  {
+    if(start > length) {
+      if(data.isEmpty())
+        return;
+
+      // Writing beyond the end fills the gap with zeros, like a file does.
+
+      replace(length, 0, ByteVector(static_cast<unsigned int>(start - length), '\0'));
+    }
+
+    removeLength = std::min(removeLength, length - start);
+
+    PieceList::iterator first = split(start);
+    PieceList::iterator last  = split(start + removeLength);
+    PieceList::iterator it    = pieces.erase(first, last);
+
+    cursor = it;
+    cursorStart = start;
+
+    if(!data.isEmpty()) {
+
+      // Runs of small writes, like the offset tables of MP4 files, end up in
+      // a single block.
+
+      PieceList::iterator previous = it;
+      if(it != pieces.begin() && (--previous)->isData()) {
+        cursor = previous;
+        cursorStart = start - previous->length;
+
+        previous->data.append(data);
+        if(it != pieces.end() && it->isData()) {
+          previous->data.append(it->data);
+          pieces.erase(it);
+        }
+        previous->length = static_cast<long>(previous->data.size());
+      }
+      else if(it != pieces.end() && it->isData()) {
+        it->data = data + it->data;
+        it->length = static_cast<long>(it->data.size());
+      }
+      else {
+        cursor = pieces.insert(it, Piece(data));
+      }
+    }
+
+    length += static_cast<long>(data.size()) - removeLength;
+    modified = true;
+  }
+
+  IOStream *stream;
+  PieceList pieces;
+
+  // Where the last lookup ended.  Reads and writes that walk forward through
+  // the content, like the renumbering of Ogg pages, start from here instead
+  // of from the first piece.
+
+  PieceList::iterator cursor;
+  long cursorStart;
+
+  long position;
+  long length;
+  bool modified;
+  TemporaryName temporaryName;
+  TemporaryName targetName;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+WritePlan::WritePlan(IOStream *stream) :
+  d(new WritePlanPrivate(stream))
+{
+}
+
+WritePlan::~WritePlan()
+{
+  if(!d->temporaryName.empty()) {
+#ifdef _WIN32
+    DeleteFileW(d->temporaryName.c_str());
+#else
+    unlink(d->temporaryName.c_str());
+#endif
+  }
+
+  delete d;
+}
+
+FileName WritePlan::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector WritePlan::readBlock(unsigned long length)
+{
+  ByteVector data;
+
+  long pieceStart;
+  for(PieceList::const_iterator it = d->find(d->position, pieceStart);
+      it != d->pieces.end() && length > 0; ++it) {
+    const long pieceEnd = pieceStart + it->length;
+
+    if(d->position < pieceEnd) {
+      const long offset = d->position - pieceStart;
+      const long count  = std::min<long>(pieceEnd - d->position, length);
+
+      if(it->isData()) {
+        data.append(it->data.mid(static_cast<unsigned int>(offset), static_cast<unsigned int>(count)));
+      }
+      else {
+        d->stream->seek(it->offset + offset);
+        data.append(d->stream->readBlock(count));
+      }
+
+      d->position += count;
+      length -= count;
+    }
+
+    pieceStart = pieceEnd;
+  }
+
+  return data;
+}
+
+void WritePlan::writeBlock(const ByteVector &data)
+{
+  d->replace(d->position, data.size(), data);
+  d->position += data.size();
+}
+
+void WritePlan::insert(const ByteVector &data, unsigned long start, unsigned long replace)
+{
+  d->replace(start, replace, data);
+}
+
+void WritePlan::removeBlock(unsigned long start, unsigned long length)
+{
+  if(length == 0)
+    return;
+
+  d->replace(start, length, ByteVector());
+}
+
+bool WritePlan::readOnly() const
+{
+  return false;
+}
+
+bool WritePlan::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void WritePlan::seek(long offset, Position p)
+{
+  long position;
+  switch(p) {
+  case Beginning:
+    position = offset;
+    break;
+  case Current:
+    position = d->position + offset;
+    break;
+  case End:
+    position = d->length + offset;
+    break;
+  default:
+    debug("WritePlan::seek() -- Invalid Position value.");
+    return;
+  }
+
+  if(position < 0) {
+    debug("WritePlan::seek() -- Failed to set the file pointer.");
+    return;
+  }
+
+  d->position = position;
+}
+
+void WritePlan::clear()
+{
+}
+
+long WritePlan::tell() const
+{
+  return d->position;
+}
+
+long WritePlan::length()
+{
+  return d->length;
+}
+
+void WritePlan::truncate(long length)
+{
+  if(length < 0)
+    return;
+
+  if(length < d->length)
+    d->replace(length, d->length - length, ByteVector());
+  else if(length > d->length)
+    d->replace(d->length, 0, ByteVector(static_cast<unsigned int>(length - d->length), '\0'));
+}
+
+bool WritePlan::isModified() const
+{
+  return d->modified;
+}
+
+bool WritePlan::writeTemporaryFile(FileName name)
+{
+  // Create a new file next to the original, so that it can be renamed over it.
+  // Replacing the file must not change anything but its content, so a file
+  // that has other names, or whose owner or attributes a new file would not
+  // get, is left to be saved in place.
+
+#ifdef _WIN32
+
+# if !defined(PLATFORM_WINRT)
+
+  // Renaming over a symbolic link or a hard link would split it from the
+  // file it shares its content with.
+
+  HANDLE original = CreateFileW(name.wstr().c_str(), 0,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                NULL, OPEN_EXISTING, FILE_FLAG_OPEN_REPARSE_POINT, NULL);
+
+  BY_HANDLE_FILE_INFORMATION info;
+  const bool linked = original == INVALID_HANDLE_VALUE
+    || !GetFileInformationByHandle(original, &info)
+    || (info.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0
+    || info.nNumberOfLinks > 1;
+
+  if(original != INVALID_HANDLE_VALUE)
+    CloseHandle(original);
+
+  if(linked) {
+    debug("WritePlan::writeTemporaryFile() -- The file is a link or has other links.");
+    return false;
+  }
+
+# endif
+
+  d->targetName = name.wstr();
+
+  HANDLE file = INVALID_HANDLE_VALUE;
+  for(int i = 0; i < 100 && file == INVALID_HANDLE_VALUE; ++i) {
+    wchar_t suffix[32];
+    _snwprintf(suffix, 32, L".taglib%d", i);
+    d->temporaryName = d->targetName + suffix;
+
+# if defined(PLATFORM_WINRT)
+    file = CreateFile2(d->temporaryName.c_str(), GENERIC_WRITE, 0, CREATE_NEW, NULL);
+# else
+    file = CreateFileW(d->temporaryName.c_str(), GENERIC_WRITE, 0, NULL, CREATE_NEW,
+                       FILE_ATTRIBUTE_NORMAL, NULL);
+# endif
+    if(file == INVALID_HANDLE_VALUE && GetLastError() != ERROR_FILE_EXISTS)
+      break;
+  }
+
+  if(file == INVALID_HANDLE_VALUE) {
+    d->temporaryName.clear();
+    debug("WritePlan::writeTemporaryFile() -- Could not create a temporary file.");
+    return false;
+  }
+
+#else
+
+  // A symbolic link is followed, so that the file it points to is replaced
+  // and the link stays.
+
+  char *const target = realpath(name, 0);
+  if(!target) {
+    debug("WritePlan::writeTemporaryFile() -- Could not resolve the file name.");
+    return false;
+  }
+
+  d->targetName = target;
+  free(target);
+
+  struct stat st;
+  if(stat(d->targetName.c_str(), &st) != 0) {
+    debug("WritePlan::writeTemporaryFile() -- Could not read the file status.");
+    return false;
+  }
+
+  if(st.st_nlink > 1) {
+    debug("WritePlan::writeTemporaryFile() -- The file has other hard links.");
+    return false;
+  }
+
+  if(hasExtendedAttributes(d->targetName.c_str())) {
+    debug("WritePlan::writeTemporaryFile() -- The file has extended attributes.");
+    return false;
+  }
+
+  std::string pattern = d->targetName + ".XXXXXX";
+  const int file = mkstemp(&pattern[0]);
+  if(file < 0) {
+    debug("WritePlan::writeTemporaryFile() -- Could not create a temporary file.");
+    return false;
+  }
+
+  d->temporaryName = pattern;
+
+  // Changing the owner may clear the set-user-ID and set-group-ID bits, so
+  // the mode is set last.
+
+  if(fchown(file, st.st_uid, st.st_gid) != 0 || fchmod(file, st.st_mode & 07777) != 0) {
+    close(file);
+    unlink(d->temporaryName.c_str());
+    d->temporaryName.clear();
+    debug("WritePlan::writeTemporaryFile() -- Could not keep the owner of the file.");
+    return false;
+  }
+
+#endif
+
+  // Write the pieces in order.  The ranges of the original stream are copied
+  // in large blocks.
+
+  bool written = true;
+
+  for(PieceList::const_iterator it = d->pieces.begin(); it != d->pieces.end() && written; ++it) {
+    if(it->isData()) {
+      written = writeFile(file, it->data);
+      continue;
+    }
+
+    for(long copied = 0; copied < it->length && written; ) {
+      const long count = std::min<long>(it->length - copied, CopyBufferSize);
+
+      d->stream->seek(it->offset + copied);
+      const ByteVector data = d->stream->readBlock(count);
+
+      written = (static_cast<long>(data.size()) == count) && writeFile(file, data);
+      copied += count;
+    }
+  }
+
+#ifdef _WIN32
+  written = FlushFileBuffers(file) && written;
+  written = CloseHandle(file) && written;
+#else
+  written = (fsync(file) == 0) && written;
+  written = (close(file) == 0) && written;
+#endif
+
+  if(!written) {
+#ifdef _WIN32
+    DeleteFileW(d->temporaryName.c_str());
+#else
+    unlink(d->temporaryName.c_str());
+#endif
+    d->temporaryName.clear();
+    debug("WritePlan::writeTemporaryFile() -- Could not write the temporary file.");
+  }
+
+  return written;
+}
+
+bool WritePlan::replaceFile()
+{
+  if(d->temporaryName.empty())
+    return false;
+
+#ifdef _WIN32
+
+# if defined(PLATFORM_WINRT)
+  const bool replaced = false;
+# else
+  const bool replaced = MoveFileExW(d->temporaryName.c_str(), d->targetName.c_str(),
+                                    MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+# endif
+
+  if(!replaced)
+    DeleteFileW(d->temporaryName.c_str());
+
+#else
+
+  const bool replaced = (rename(d->temporaryName.c_str(), d->targetName.c_str()) == 0);
+
+  if(replaced) {
+
+    // Make the rename itself durable.
+
+    const std::string::size_type slash = d->targetName.rfind('/');
+    const std::string directory = d->targetName.substr(0, slash + 1);
+
+    const int dir = open(directory.c_str(), O_RDONLY);
+    if(dir >= 0) {
+      fsync(dir);
+      close(dir);
+    }
+  }
+  else {
+    unlink(d->temporaryName.c_str());
+  }
+
+#endif
+
+  d->temporaryName.clear();
+
+  if(!replaced)
+    debug("WritePlan::replaceFile() -- Could not replace the file.");
+
+  return replaced;
+}
+
+void WritePlan::apply(IOStream *stream) const
+{
+  // Each range of the original stream moves by a fixed distance, and the
+  // ranges keep their order.  So the ranges that move towards the start can be
+  // moved first to last, and those that move towards the end last to first,
+  // without overwriting anything that has not been moved yet.  This way every
+  // byte is moved at most once, however many tags were changed, and the new
+  // data is written when everything else is in place.
+
+  std::vector<Move> moves;
+
+  long position = 0;
+  for(PieceList::const_iterator it = d->pieces.begin(); it != d->pieces.end(); ++it) {
+    if(!it->isData() && it->offset != position)
+      moves.push_back(Move(it->offset, position, it->length));
+    position += it->length;
+  }
+
+  for(std::vector<Move>::const_iterator it = moves.begin(); it != moves.end(); ++it) {
+    if(it->to < it->from)
+      moveBlock(stream, it->from, it->to, it->length);
+  }
+
+  for(std::vector<Move>::const_reverse_iterator it = moves.rbegin(); it != moves.rend(); ++it) {
+    if(it->to > it->from)
+      moveBlock(stream, it->from, it->to, it->length);
+  }
+
+  position = 0;
+  for(PieceList::const_iterator it = d->pieces.begin(); it != d->pieces.end(); ++it) {
+    if(it->isData()) {
+      stream->seek(position);
+      stream->writeBlock(it->data);
+    }
+    position += it->length;
+  }
+
+  if(stream->length() != d->length)
+    stream->truncate(d->length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void WritePlan::moveBlock(IOStream *stream, long from, long to, long length)
+{
+  FileStream *fileStream = dynamic_cast<FileStream *>(stream);
+  if(fileStream) {
+    fileStream->moveBlock(from, to, length);
+    return;
+  }
+
+  // When moving towards the end, start with the last block so that nothing is
+  // overwritten before it has been read.
+
+  const bool backwards = (to > from);
+
+  for(long moved = 0; moved < length; ) {
+    const long count  = std::min<long>(length - moved, CopyBufferSize);
+    const long offset = backwards ? (length - moved - count) : moved;
+
+    stream->seek(from + offset);
+    const ByteVector data = stream->readBlock(count);
+
+    stream->seek(to + offset);
+    stream->writeBlock(data);
+
+    moved += count;
+  }
+}
@@ -0,0 +1,124 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+    email                : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_WRITEPLAN_H
+#define TAGLIB_WRITEPLAN_H
+
+#include "tiostream.h"
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  //! A stream that collects the changes of a save without touching the file
+
+  /*!
+   * WritePlan sits on top of another stream and behaves as if the writes,
+   * inserts and removals made to it had been made to that stream.  Nothing is
+   * written to the underlying stream; the new content is kept as a list of
+   * ranges of the original stream and blocks of new data, so that it can be
+   * written out at once when the save is complete: either in place, where
+   * the changes of several tags are coalesced into one pass over the file, or
+   * into a new file that replaces the original.
+   */
+
+  class WritePlan : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a plan on top of \a stream, which must stay open and
+     * unchanged while the plan is in use.
+     */
+    explicit WritePlan(IOStream *stream);
+
+    /*!
+     * Destroys the plan.  Pending changes are discarded, and a temporary file
+     * that has not been moved into place is removed.
+     */
+    virtual ~WritePlan();
+
+    FileName name() const;
+    ByteVector readBlock(unsigned long length);
+    void writeBlock(const ByteVector &data);
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+    bool readOnly() const;
+    bool isOpen() const;
+    void seek(long offset, Position p = Beginning);
+    void clear();
+    long tell() const;
+    long length();
+    void truncate(long length);
+
+    /*!
+     * Returns true if anything has been written to the plan.
+     */
+    bool isModified() const;
+
+    /*!
+     * Writes the new content sequentially into a temporary file next to the
+     * file \a name and flushes it to the storage device.  A symbolic link is
+     * followed to the file it points to.  The owner, group and permissions of
+     * the file are copied.  Returns false if the temporary file could not be
+     * created or written, or if replacing the file would lose anything but
+     * its content: another hard link to it, its owner or its extended
+     * attributes.
+     */
+    bool writeTemporaryFile(FileName name);
+
+    /*!
+     * Replaces the file that was given to writeTemporaryFile() with the
+     * temporary file.  On POSIX systems this is an atomic rename(), so that
+     * other readers see either the old or the new file.  Returns false and
+     * removes the temporary file if the rename failed.
+     *
+     * \note The file must not be open in this process on Windows.
+     */
+    bool replaceFile();
+
+    /*!
+     * Makes the planned changes to \a stream in place, in a single pass that
+     * moves every byte of the original content at most once.  \a stream must
+     * have the same content as the stream the plan was constructed on.
+     */
+    void apply(IOStream *stream) const;
+
+  private:
+    WritePlan(const WritePlan &);
+    WritePlan &operator=(const WritePlan &);
+
+    static void moveBlock(IOStream *stream, long from, long to, long length);
+
+    class WritePlanPrivate;
+    WritePlanPrivate *d;
+  };
+
+}
+
+#endif
+
+#endif
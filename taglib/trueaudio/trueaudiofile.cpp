@@ -82,7 +82,7 @@ bool TrueAudio::File::isSupported(IOStream *stream)
   // A TrueAudio file has to start with "TTA". An ID3v2 tag may precede.
 
   const ByteVector id = Utils::readHeader(stream, 3, true);
-  return (id == "TTA");
+  return (Utils::findTrueAudioSignature(id) == 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -106,6 +106,18 @@ TrueAudio::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
     read(readProperties);
 }
 
+TrueAudio::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
+                      bool readProperties, Properties::ReadStyle,
+                      PictureReading pictureReading) :
+  TagLib::File(file),
+  d(new FilePrivate(frameFactory))
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties);
+}
+
 TrueAudio::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
   TagLib::File(stream),
   d(new FilePrivate())
@@ -123,6 +135,18 @@ TrueAudio::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
     read(readProperties);
 }
 
+TrueAudio::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
+                      bool readProperties, Properties::ReadStyle,
+                      PictureReading pictureReading) :
+  TagLib::File(stream),
+  d(new FilePrivate(frameFactory))
+{
+  setPictureReading(pictureReading);
+
+  if(isOpen())
+    read(readProperties);
+}
+
 TrueAudio::File::~File()
 {
   delete d;
@@ -168,6 +192,8 @@ bool TrueAudio::File::save()
     return false;
   }
 
+  SaveScope scope(this);
+
   // Update ID3v2 tag
 
   if(ID3v2Tag() && !ID3v2Tag()->isEmpty()) {
@@ -177,7 +203,10 @@ bool TrueAudio::File::save()
     if(d->ID3v2Location < 0)
       d->ID3v2Location = 0;
 
-    const ByteVector data = ID3v2Tag()->render();
+    ID3v2::Tag *tag = ID3v2Tag();
+    tag->setPadding(minimumPadding(tag->minimumPadding()), maximumPadding(tag->maximumPadding()));
+
+    const ByteVector data = tag->render();
     insert(data, d->ID3v2Location, d->ID3v2OriginalSize);
 
     if(d->ID3v1Location >= 0)
@@ -226,7 +255,7 @@ bool TrueAudio::File::save()
     }
   }
 
-  return true;
+  return scope.finish();
 }
 
 ID3v1::Tag *TrueAudio::File::ID3v1Tag(bool create)
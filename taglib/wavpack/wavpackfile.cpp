@@ -80,27 +80,27 @@ bool WavPack::File::isSupported(IOStream *stream)
   // A WavPack file has to start with "wvpk".
 
   const ByteVector id = Utils::readHeader(stream, 4, false);
-  return (id == "wvpk");
+  return (Utils::findWavPackSignature(id) == 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-WavPack::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+WavPack::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-WavPack::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+WavPack::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 WavPack::File::~File()
@@ -143,6 +143,8 @@ bool WavPack::File::save()
     return false;
   }
 
+  SaveScope scope(this);
+
   // Update ID3v1 tag
 
   if(ID3v1Tag() && !ID3v1Tag()->isEmpty()) {
@@ -205,7 +207,7 @@ bool WavPack::File::save()
     }
   }
 
-  return true;
+  return scope.finish();
 }
 
 ID3v1::Tag *WavPack::File::ID3v1Tag(bool create)
@@ -244,7 +246,7 @@ bool WavPack::File::hasAPETag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void WavPack::File::read(bool readProperties)
+void WavPack::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v1 tag
 
@@ -279,6 +281,6 @@ void WavPack::File::read(bool readProperties)
     else
       streamLength = length();
 
-    d->properties = new Properties(this, streamLength);
+    d->properties = new Properties(this, streamLength, propertiesStyle);
   }
 }
@@ -76,7 +76,7 @@ WavPack::Properties::Properties(File *file, long streamLength, ReadStyle style)
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
-  read(file, streamLength);
+  read(file, streamLength, style);
 }
 
 WavPack::Properties::~Properties()
@@ -160,9 +160,10 @@ namespace
 
 #define FINAL_BLOCK     0x1000
 
-void WavPack::Properties::read(File *file, long streamLength)
+void WavPack::Properties::read(File *file, long streamLength, ReadStyle style)
 {
   long offset = 0;
+  unsigned int blockSamples = 0;
 
   while(true) {
     file->seek(offset);
@@ -189,19 +190,34 @@ void WavPack::Properties::read(File *file, long streamLength)
       d->sampleRate    = sample_rates[(flags & SRATE_MASK) >> SRATE_LSB];
       d->lossless      = !(flags & LOSSLESS_FLAG);
       d->sampleFrames  = data.toUInt(12, false);
+      blockSamples     = data.toUInt(20, false);
     }
 
     d->channels += (flags & MONO_FLAG) ? 1 : 2;
 
-    if(flags & FINAL_BLOCK)
-      break;
-
     const unsigned int blockSize = data.toUInt(4, false);
     offset += blockSize + 8;
+
+    if(flags & FINAL_BLOCK)
+      break;
   }
 
-  if(d->sampleFrames == ~0u)
-    d->sampleFrames = seekFinalIndex(file, streamLength);
+  if(d->sampleFrames == ~0u) {
+    if(style == Fast) {
+
+      // Assume that the rest of the stream takes as many bytes per sample as
+      // the blocks of the first samples.
+
+      d->sampleFrames = 0;
+      if(offset > 0 && blockSamples > 0) {
+        d->sampleFrames = static_cast<unsigned int>(
+          static_cast<double>(streamLength) / offset * blockSamples + 0.5);
+        setEstimated(true);
+      }
+    }
+    else
+      d->sampleFrames = seekFinalIndex(file, streamLength);
+  }
 
   if(d->sampleFrames > 0 && d->sampleRate > 0) {
     const double length = d->sampleFrames * 1000.0 / d->sampleRate;
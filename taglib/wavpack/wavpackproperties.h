@@ -137,7 +137,7 @@ namespace TagLib {
       Properties(const Properties &);
       Properties &operator=(const Properties &);
 
-      void read(File *file, long streamLength);
+      void read(File *file, long streamLength, ReadStyle style);
       unsigned int seekFinalIndex(File *file, long streamLength);
 
       class PropertiesPrivate;
@@ -405,6 +405,8 @@ bool XM::File::save()
     return false;
   }
 
+  SaveScope scope(this);
+
   seek(17);
   writeString(d->tag.title(), 20);
 
@@ -490,7 +492,7 @@ bool XM::File::save()
     }
   }
 
-  return true;
+  return scope.finish();
 }
 
 void XM::File::read(bool)
@@ -30,6 +30,7 @@
 #include <tbytevectorlist.h>
 #include <tpropertymap.h>
 #include <asffile.h>
+#include <tfilestream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -51,6 +52,9 @@ class TestASF : public CppUnit::TestFixture
   CPPUNIT_TEST(testSaveMultiplePictures);
   CPPUNIT_TEST(testProperties);
   CPPUNIT_TEST(testRepeatedSave);
+  CPPUNIT_TEST(testSkipPictures);
+  CPPUNIT_TEST(testSkipPicturesSmallAndLongDescription);
+  CPPUNIT_TEST(testSkipPicturesWrongLength);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -319,6 +323,116 @@ public:
     }
   }
 
+  void testSkipPictures()
+  {
+    ScopedFileCopy copy("silence-1", ".wma");
+    const ByteVector data = longText(100000, true).data(String::Latin1);
+    {
+      ASF::File f(copy.fileName().c_str());
+      ASF::Picture picture;
+      picture.setMimeType("image/jpeg");
+      picture.setType(ASF::Picture::FrontCover);
+      picture.setDescription("large image");
+      picture.setPicture(data);
+      f.tag()->setAttribute("WM/Picture", picture);
+      f.save();
+    }
+    {
+      ASF::File f(copy.fileName().c_str(), true, ASF::Properties::Average, File::SkipPictures);
+      CPPUNIT_ASSERT(f.isValid());
+      ASF::AttributeList values = f.tag()->attribute("WM/Picture");
+      CPPUNIT_ASSERT_EQUAL(1U, values.size());
+      ASF::Picture picture = values.front().toPicture();
+      CPPUNIT_ASSERT(picture.isValid());
+      CPPUNIT_ASSERT(!picture.payload().isLoaded());
+      CPPUNIT_ASSERT_EQUAL(100000U, picture.payload().size());
+      CPPUNIT_ASSERT_EQUAL(String("image/jpeg"), picture.mimeType());
+      CPPUNIT_ASSERT_EQUAL(ASF::Picture::FrontCover, picture.type());
+      CPPUNIT_ASSERT_EQUAL(String("large image"), picture.description());
+      CPPUNIT_ASSERT(picture.picture() == data);
+
+      f.tag()->setTitle(longText(20000));
+      f.save();
+      CPPUNIT_ASSERT(picture.payload().isLoaded());
+      CPPUNIT_ASSERT(picture.picture() == data);
+    }
+    {
+      ASF::File f(copy.fileName().c_str());
+      ASF::AttributeList values = f.tag()->attribute("WM/Picture");
+      CPPUNIT_ASSERT_EQUAL(1U, values.size());
+      CPPUNIT_ASSERT(values.front().toPicture().picture() == data);
+      CPPUNIT_ASSERT_EQUAL(longText(20000), f.tag()->title());
+    }
+  }
+
+  void testSkipPicturesSmallAndLongDescription()
+  {
+    // A small picture is read with the rest of the tag, and so is a picture
+    // whose description does not end within the part that is read first.
+
+    ScopedFileCopy copy("silence-1", ".wma");
+    const ByteVector small = longText(500, true).data(String::Latin1);
+    const ByteVector large = longText(100000, true).data(String::Latin1);
+    {
+      ASF::File f(copy.fileName().c_str());
+      ASF::Picture smallPicture;
+      smallPicture.setPicture(small);
+      f.tag()->setAttribute("WM/Picture", smallPicture);
+      ASF::Picture largePicture;
+      largePicture.setDescription(longText(2000));
+      largePicture.setPicture(large);
+      f.tag()->addAttribute("WM/Picture", largePicture);
+      f.save();
+    }
+    {
+      ASF::File f(copy.fileName().c_str(), true, ASF::Properties::Average, File::SkipPictures);
+      ASF::AttributeList values = f.tag()->attribute("WM/Picture");
+      CPPUNIT_ASSERT_EQUAL(2U, values.size());
+      // The large picture goes to the metadata library object, which is read
+      // before the extended content description object.
+      ASF::Picture picture = values[0].toPicture();
+      CPPUNIT_ASSERT(picture.payload().isLoaded());
+      CPPUNIT_ASSERT_EQUAL(longText(2000), picture.description());
+      CPPUNIT_ASSERT(picture.picture() == large);
+      picture = values[1].toPicture();
+      CPPUNIT_ASSERT(picture.payload().isLoaded());
+      CPPUNIT_ASSERT(picture.picture() == small);
+    }
+  }
+
+  void testSkipPicturesWrongLength()
+  {
+    // The image data is one byte shorter than the picture says, so it is not
+    // a valid picture, whether it is read or not.
+
+    ScopedFileCopy copy("silence-1", ".wma");
+    const ByteVector data = longText(100000, true).data(String::Latin1);
+    {
+      ASF::File f(copy.fileName().c_str());
+      ASF::Picture picture;
+      picture.setPicture(data);
+      f.tag()->setAttribute("WM/Picture", picture);
+      f.save();
+    }
+    {
+      FileStream stream(copy.fileName().c_str());
+      const ByteVector fileData = stream.readBlock(stream.length());
+      const int lengthOffset = fileData.find(ByteVector::fromUInt(100000, false));
+      CPPUNIT_ASSERT(lengthOffset > 0);
+      stream.seek(lengthOffset);
+      stream.writeBlock(ByteVector::fromUInt(100001, false));
+    }
+    for(int i = 0; i < 2; ++i) {
+      ASF::File f(copy.fileName().c_str(), true, ASF::Properties::Average,
+                  i == 0 ? File::ReadPictures : File::SkipPictures);
+      CPPUNIT_ASSERT(f.isValid());
+      ASF::AttributeList values = f.tag()->attribute("WM/Picture");
+      CPPUNIT_ASSERT_EQUAL(1U, values.size());
+      CPPUNIT_ASSERT(!values.front().toPicture().isValid());
+      CPPUNIT_ASSERT_EQUAL(100000U + 9, values.front().toByteVector().size());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestASF);
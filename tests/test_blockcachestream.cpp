@@ -0,0 +1,211 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <tblockcachestream.h>
+#include <tbytevectorstream.h>
+#include <tag.h>
+#include <fileref.h>
+#include <mpegfile.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestBlockCacheStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestBlockCacheStream);
+  CPPUNIT_TEST(testReadBlock);
+  CPPUNIT_TEST(testCounters);
+  CPPUNIT_TEST(testRandomReads);
+  CPPUNIT_TEST(testWrite);
+  CPPUNIT_TEST(testDisabled);
+  CPPUNIT_TEST(testFileRef);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static ByteVector testData(unsigned int size)
+  {
+    ByteVector data(size);
+    for(unsigned int i = 0; i < size; ++i)
+      data[i] = static_cast<char>(i % 251);
+    return data;
+  }
+
+public:
+
+  void testReadBlock()
+  {
+    const ByteVector data = testData(1000);
+    ByteVectorStream source(data);
+    BlockCacheStream stream(&source);
+    stream.setCacheSize(64, 4);
+
+    CPPUNIT_ASSERT_EQUAL(1000L, stream.length());
+    stream.seek(60);
+    CPPUNIT_ASSERT_EQUAL(data.mid(60, 10), stream.readBlock(10));
+    CPPUNIT_ASSERT_EQUAL(70L, stream.tell());
+    stream.seek(-8, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(data.mid(992), stream.readBlock(100));
+    CPPUNIT_ASSERT_EQUAL(1000L, stream.tell());
+    CPPUNIT_ASSERT(stream.readBlock(10).isEmpty());
+    stream.seek(0);
+    CPPUNIT_ASSERT_EQUAL(data, stream.readBlock(1000));
+  }
+
+  void testCounters()
+  {
+    const ByteVector data = testData(100000);
+    ByteVectorStream source(data);
+    BlockCacheStream stream(&source);
+
+    // Reading 4 bytes at a time goes to the underlying stream once per few
+    // pages only.
+
+    for(long offset = 0; offset < 20000; offset += 4) {
+      stream.seek(offset);
+      CPPUNIT_ASSERT_EQUAL(data.mid(offset, 4), stream.readBlock(4));
+    }
+
+    CPPUNIT_ASSERT(stream.cacheMisses() <= 2);
+    CPPUNIT_ASSERT_EQUAL(5000UL - stream.cacheMisses(), stream.cacheHits());
+    CPPUNIT_ASSERT(stream.bytesRead() >= 20000);
+    CPPUNIT_ASSERT(stream.bytesRead() <= 40960);
+
+    // The first and the last page stay cached.
+
+    stream.seek(-128, IOStream::End);
+    stream.readBlock(128);
+    stream.resetCounters();
+    for(long offset = 20000; offset < 100000; offset += 4096) {
+      stream.seek(offset);
+      stream.readBlock(16);
+    }
+    CPPUNIT_ASSERT(stream.cacheMisses() > 0);
+    stream.resetCounters();
+
+    stream.seek(0);
+    CPPUNIT_ASSERT_EQUAL(data.mid(0, 10), stream.readBlock(10));
+    stream.seek(-128, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(data.mid(100000 - 128), stream.readBlock(128));
+    CPPUNIT_ASSERT_EQUAL(0UL, stream.cacheMisses());
+    CPPUNIT_ASSERT_EQUAL(2UL, stream.cacheHits());
+    CPPUNIT_ASSERT_EQUAL(0ULL, stream.bytesRead());
+  }
+
+  void testRandomReads()
+  {
+    srand(1);
+
+    const ByteVector data = testData(50000);
+    ByteVectorStream source(data);
+    BlockCacheStream stream(&source);
+    stream.setCacheSize(512, 8);
+
+    for(int i = 0; i < 2000; ++i) {
+      const long offset = rand() % 51000;
+      const unsigned int length = rand() % 3000;
+
+      stream.seek(offset);
+      CPPUNIT_ASSERT(data.mid(offset, length) == stream.readBlock(length));
+    }
+  }
+
+  void testWrite()
+  {
+    const ByteVector data = testData(10000);
+    ByteVectorStream source(data);
+    BlockCacheStream stream(&source);
+    stream.setCacheSize(256, 8);
+
+    stream.seek(0);
+    stream.readBlock(1000);
+    stream.seek(100);
+    stream.writeBlock("abcd");
+    stream.seek(98);
+    CPPUNIT_ASSERT_EQUAL(data.mid(98, 2) + ByteVector("abcd") + data.mid(104, 2), stream.readBlock(8));
+
+    stream.seek(-10, IOStream::End);
+    stream.readBlock(10);
+    stream.seek(10100);
+    stream.writeBlock("xyz");
+    CPPUNIT_ASSERT_EQUAL(10103L, stream.length());
+    stream.seek(9990);
+    CPPUNIT_ASSERT(source.data()->mid(9990) == stream.readBlock(200));
+
+    stream.insert("1234", 2);
+    stream.seek(0);
+    CPPUNIT_ASSERT(*source.data() == stream.readBlock(20000));
+    stream.removeBlock(0, 5000);
+    stream.seek(0);
+    CPPUNIT_ASSERT(source.data()->mid(0, 300) == stream.readBlock(300));
+    stream.truncate(200);
+    CPPUNIT_ASSERT_EQUAL(200L, stream.length());
+  }
+
+  void testDisabled()
+  {
+    const ByteVector data = testData(1000);
+    ByteVectorStream source(data);
+    BlockCacheStream stream(&source);
+    stream.setCacheSize(0, 0);
+
+    stream.seek(10);
+    CPPUNIT_ASSERT_EQUAL(data.mid(10, 4), stream.readBlock(4));
+    CPPUNIT_ASSERT_EQUAL(data.mid(14, 4), stream.readBlock(4));
+    CPPUNIT_ASSERT_EQUAL(2UL, stream.cacheMisses());
+    CPPUNIT_ASSERT_EQUAL(0UL, stream.cacheHits());
+    CPPUNIT_ASSERT_EQUAL(8ULL, stream.bytesRead());
+  }
+
+  void testFileRef()
+  {
+    ScopedFileCopy copy("ape-id3v2", ".mp3");
+    const string newname = copy.fileName();
+
+    {
+      FileRef plain(newname.c_str());
+      FileRef cached(newname.c_str(), true, AudioProperties::Average, FileRef::CachedStream);
+
+      CPPUNIT_ASSERT(!cached.isNull());
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(cached.file()));
+      CPPUNIT_ASSERT(!cached.file()->readOnly());
+      CPPUNIT_ASSERT_EQUAL(plain.tag()->title(), cached.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(plain.audioProperties()->lengthInMilliseconds(),
+                           cached.audioProperties()->lengthInMilliseconds());
+
+      cached.tag()->setTitle(longText(3000));
+      CPPUNIT_ASSERT(cached.save());
+      CPPUNIT_ASSERT_EQUAL(longText(3000), cached.tag()->title());
+    }
+    {
+      FileRef f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(longText(3000), f.tag()->title());
+    }
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestBlockCacheStream);
@@ -27,6 +27,7 @@
 #include <cmath>
 #include <tbytevector.h>
 #include <tbytevectorlist.h>
+#include <tcrc.h>
 #include <cppunit/extensions/HelperMacros.h>
 
 using namespace std;
@@ -42,6 +43,8 @@ class TestByteVector : public CppUnit::TestFixture
   CPPUNIT_TEST(testRfind1);
   CPPUNIT_TEST(testRfind2);
   CPPUNIT_TEST(testRfind3);
+  CPPUNIT_TEST(testFindLong);
+  CPPUNIT_TEST(testChecksum);
   CPPUNIT_TEST(testToHex);
   CPPUNIT_TEST(testIntegerConversion);
   CPPUNIT_TEST(testFloatingPointConversion);
@@ -49,6 +52,7 @@ class TestByteVector : public CppUnit::TestFixture
   CPPUNIT_TEST(testReplaceAndDetach);
   CPPUNIT_TEST(testIterator);
   CPPUNIT_TEST(testResize);
+  CPPUNIT_TEST(testResizeLong);
   CPPUNIT_TEST(testAppend1);
   CPPUNIT_TEST(testAppend2);
   CPPUNIT_TEST(testBase64);
@@ -172,6 +176,86 @@ public:
     CPPUNIT_ASSERT_EQUAL(1, ByteVector(".OggS....").rfind('O'));
   }
 
+  void testFindLong()
+  {
+    // Long enough for the vector search, with matches at every distance from
+    // the ends and from the block boundaries.
+
+    ByteVector data;
+    for(int i = 0; i < 300; ++i)
+      data.append(static_cast<char>("abcab"[(i * 7 + i / 13) % 5]));
+
+    const ByteVector patterns[] = {
+      "a", "b", "c", "ab", "ca", "cab", "abca", "bcabc", data.mid(40, 17), data.mid(250, 33), "abd"
+    };
+
+    for(unsigned int p = 0; p < sizeof(patterns) / sizeof(patterns[0]); ++p) {
+      const ByteVector &pattern = patterns[p];
+
+      for(unsigned int offset = 0; offset < data.size(); offset += 5) {
+        int expected = -1;
+        for(unsigned int i = offset; i + pattern.size() <= data.size() && expected < 0; ++i) {
+          if(data.containsAt(pattern, i))
+            expected = i;
+        }
+        CPPUNIT_ASSERT_EQUAL(expected, data.find(pattern, offset));
+      }
+
+      for(unsigned int length = 0; length <= data.size(); length += 7) {
+        const ByteVector head = data.mid(0, length);
+
+        int expected = -1;
+        for(int i = static_cast<int>(length) - static_cast<int>(pattern.size()); i >= 0 && expected < 0; --i) {
+          if(data.containsAt(pattern, i))
+            expected = i;
+        }
+        CPPUNIT_ASSERT_EQUAL(expected, head.rfind(pattern));
+      }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(299, data.find(data.mid(299, 1), 299));
+    CPPUNIT_ASSERT_EQUAL(-1, data.find("", 0));
+    CPPUNIT_ASSERT_EQUAL(-1, data.find("a", 300));
+  }
+
+  void testChecksum()
+  {
+    // Compared with the checksum computed bit by bit, at lengths that end in
+    // every part of the table and vector loops.
+
+    ByteVector data;
+    for(unsigned int i = 0; i < 1500; ++i)
+      data.append(static_cast<char>((i * 2654435761U) >> 13));
+
+    for(unsigned int length = 0; length <= data.size(); length += (length < 300 ? 1 : 37)) {
+      unsigned int expected = 0;
+      for(unsigned int i = 0; i < length; ++i) {
+        expected ^= static_cast<unsigned int>(static_cast<unsigned char>(data[i])) << 24;
+        for(int bit = 0; bit < 8; ++bit)
+          expected = (expected << 1) ^ ((expected & 0x80000000) ? 0x04c11db7 : 0);
+      }
+
+      const ByteVector head = data.mid(0, length);
+      CPPUNIT_ASSERT_EQUAL(expected, head.checksum());
+
+      const unsigned int split = length / 3;
+      CPPUNIT_ASSERT_EQUAL(expected,
+        CRC::update(CRC::update(0, head.data(), split), head.data() + split, length - split));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0U, ByteVector().checksum());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc\0\0\0\0\0", 8).checksum(),
+                         CRC::appendZeros(ByteVector("abc").checksum(), 5));
+
+    ByteVector changed = data;
+    changed[700] = 'x';
+    changed[701] = 'y';
+    CPPUNIT_ASSERT_EQUAL(changed.checksum(),
+      CRC::replace(data.checksum(), data.size(), 700, data.data() + 700, "xy", 2));
+    CPPUNIT_ASSERT_EQUAL(data.checksum(),
+      CRC::replace(data.checksum(), data.size(), 1499, "a", "b", 2));
+  }
+
   void testToHex()
   {
     ByteVector v("\xf0\xe1\xd2\xc3\xb4\xa5\x96\x87\x78\x69\x5a\x4b\x3c\x2d\x1e\x0f", 16);
@@ -444,6 +528,43 @@ public:
     CPPUNIT_ASSERT_EQUAL(-1, c.find('C'));
   }
 
+  void testResizeLong()
+  {
+    // Long enough that the bytes are shared instead of copied.
+
+    const ByteVector a("0123456789abcdefghijklmnopqrstuvwxyz");
+    ByteVector b = a.mid(10, 20);
+    ByteVector c = b;
+
+    b.resize(24, 'A');
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdefghijklmnopqrstAAAA"), b);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdefghijklmnopqrst"), c);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("0123456789abcdefghijklmnopqrstuvwxyz"), a);
+
+    // Shrink below the size that is kept in place, and grow again.
+
+    c.resize(4);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcd"), c);
+    c.resize(40, 'B');
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcd") + ByteVector(36, 'B'), c);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdefghijklmnopqrstAAAA"), b);
+
+    // The only owner of a slice, writing past the end of the slice.
+
+    ByteVector d = ByteVector(a.data(), a.size()).mid(4, 20);
+    d.resize(30, 'C');
+    CPPUNIT_ASSERT_EQUAL(ByteVector("456789abcdefghijklmn") + ByteVector(10, 'C'), d);
+    d.resize(40, 'D');
+    CPPUNIT_ASSERT_EQUAL(ByteVector("456789abcdefghijklmn") + ByteVector(10, 'C') + ByteVector(10, 'D'), d);
+
+    ByteVector e;
+    for(int i = 0; i < 1000; ++i)
+      e.append(static_cast<char>(i));
+    CPPUNIT_ASSERT_EQUAL((unsigned int)1000, e.size());
+    for(int i = 0; i < 1000; ++i)
+      CPPUNIT_ASSERT_EQUAL(static_cast<char>(i), e[i]);
+  }
+
   void testAppend1()
   {
     ByteVector v1("foo");
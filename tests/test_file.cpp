@@ -24,6 +24,8 @@
  ***************************************************************************/
 
 #include <tfile.h>
+#include <tfilestream.h>
+#include <tthread.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -46,6 +48,13 @@ class TestFile : public CppUnit::TestFixture
   CPPUNIT_TEST(testRFindInSmallFile);
   CPPUNIT_TEST(testSeek);
   CPPUNIT_TEST(testTruncate);
+  CPPUNIT_TEST(testLengthAfterWrite);
+  CPPUNIT_TEST(testReadBlockAtOffset);
+  CPPUNIT_TEST(testLargeInsertAndRemove);
+  CPPUNIT_TEST(testFindWithGrowingBuffer);
+  CPPUNIT_TEST(testRFindWithGrowingBuffer);
+  CPPUNIT_TEST(testInsertWithGrowingBuffer);
+  CPPUNIT_TEST(testRemoveBlockWithGrowingBuffer);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -148,6 +157,245 @@ public:
     }
   }
 
+  void testLengthAfterWrite()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    PlainFile f(name.c_str());
+    CPPUNIT_ASSERT_EQUAL(4328L, f.length());
+
+    f.seek(-8, File::End);
+    f.writeBlock(ByteVector(10, 'x'));
+    CPPUNIT_ASSERT_EQUAL(4330L, f.tell());
+    CPPUNIT_ASSERT_EQUAL(4330L, f.length());
+
+    f.seek(100, File::End);
+    f.writeBlock(ByteVector("y"));
+    CPPUNIT_ASSERT_EQUAL(4431L, f.length());
+    f.seek(4428);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("\0\0y", 3), f.readBlock(10));
+
+    f.truncate(1000);
+    CPPUNIT_ASSERT_EQUAL(1000L, f.length());
+    f.seek(0, File::End);
+    CPPUNIT_ASSERT_EQUAL(1000L, f.tell());
+    CPPUNIT_ASSERT(f.readBlock(1).isEmpty());
+  }
+
+  struct OffsetReads
+  {
+    FileStream *stream;
+    ByteVector data;
+    volatile int failures;
+  };
+
+  static void readAtOffsets(void *p)
+  {
+    OffsetReads *reads = static_cast<OffsetReads *>(p);
+    for(unsigned int i = 0; i < 1000; ++i) {
+      const long offset = (i * 37) % 4000;
+      if(reads->stream->readBlock(offset, 300) != reads->data.mid(offset, 300))
+        reads->failures = 1;
+    }
+  }
+
+  void testReadBlockAtOffset()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+
+    FileStream stream(copy.fileName().c_str(), true);
+    const ByteVector data = stream.readBlock(stream.length());
+    CPPUNIT_ASSERT_EQUAL(4328U, data.size());
+
+    stream.seek(10);
+    CPPUNIT_ASSERT(stream.readBlock(100, 4) == data.mid(100, 4));
+    CPPUNIT_ASSERT(stream.readBlock(4320, 100) == data.mid(4320));
+    CPPUNIT_ASSERT(stream.readBlock(4328, 1).isEmpty());
+    CPPUNIT_ASSERT(stream.readBlock(-1, 1).isEmpty());
+    CPPUNIT_ASSERT_EQUAL(10L, stream.tell());
+    CPPUNIT_ASSERT(stream.readBlock(4) == data.mid(10, 4));
+
+    OffsetReads reads;
+    reads.stream = &stream;
+    reads.data = data;
+    reads.failures = 0;
+    Thread::run(4, &readAtOffsets, &reads);
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(reads.failures));
+    CPPUNIT_ASSERT_EQUAL(14L, stream.tell());
+  }
+
+  void testFindWithGrowingBuffer()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector data(3000, 'x');
+    const int positions[] = { 7, 22, 54, 119, 500, 2996 };
+    for(unsigned int i = 0; i < sizeof(positions) / sizeof(positions[0]); ++i)
+      ::memcpy(data.data() + positions[i], "ABCD", 4);
+
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+    {
+      PlainFile file(name.c_str());
+      file.setBufferSize(8, 64);
+
+      // Buffers of 8, 16, 32 and 64 bytes end at offsets 8, 24, 56 and 120,
+      // so most of the patterns straddle two buffers.
+
+      for(long offset = 0; offset < 3000; offset += 3)
+        CPPUNIT_ASSERT_EQUAL(static_cast<long>(data.find("ABCD", offset)), file.find("ABCD", offset));
+
+      CPPUNIT_ASSERT_EQUAL(-1L, file.find("ABCD", 0, "xA"));
+      CPPUNIT_ASSERT_EQUAL(-1L, file.find("ABCDE"));
+      CPPUNIT_ASSERT_EQUAL(-1L, file.find(ByteVector(9, 'x')));
+    }
+  }
+
+  void testRFindWithGrowingBuffer()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector data(3000, 'x');
+    const int positions[] = { 7, 22, 54, 119, 500, 2882, 2996 };
+    for(unsigned int i = 0; i < sizeof(positions) / sizeof(positions[0]); ++i)
+      ::memcpy(data.data() + positions[i], "ABCD", 4);
+
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+    {
+      PlainFile file(name.c_str());
+      file.setBufferSize(8, 64);
+
+      // The buffers are read backwards from the offset, so where they start
+      // depends on it, and every pattern straddles two buffers for some.
+
+      for(long offset = 1; offset < 3000; offset += 3) {
+        long expected = -1;
+        for(long i = offset; i >= 0 && expected < 0; --i) {
+          if(data.containsAt("ABCD", i))
+            expected = i;
+        }
+        CPPUNIT_ASSERT_EQUAL(expected, file.rfind("ABCD", offset));
+      }
+
+      CPPUNIT_ASSERT_EQUAL(2996L, file.rfind("ABCD"));
+      CPPUNIT_ASSERT_EQUAL(-1L, file.rfind("ABCD", 2990, "xx"));
+      CPPUNIT_ASSERT_EQUAL(-1L, file.rfind("ABCDE"));
+      CPPUNIT_ASSERT_EQUAL(-1L, file.rfind(ByteVector(9, 'x')));
+    }
+  }
+
+  void testInsertWithGrowingBuffer()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector data;
+    for(int i = 0; i < 5000; ++i)
+      data.append(static_cast<char>(i % 251));
+
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+    {
+      PlainFile file(name.c_str());
+      file.setBufferSize(16, 256);
+      file.insert(ByteVector(40, 'a'), 100, 10);
+
+      data = data.mid(0, 100) + ByteVector(40, 'a') + data.mid(110);
+      file.seek(0);
+      CPPUNIT_ASSERT_EQUAL(data, file.readBlock(file.length()));
+
+      file.insert(ByteVector(300, 'b'), 4000);
+
+      data = data.mid(0, 4000) + ByteVector(300, 'b') + data.mid(4000);
+      file.seek(0);
+      CPPUNIT_ASSERT_EQUAL(data, file.readBlock(file.length()));
+    }
+  }
+
+  void testRemoveBlockWithGrowingBuffer()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector data;
+    for(int i = 0; i < 5000; ++i)
+      data.append(static_cast<char>(i % 251));
+
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+    {
+      PlainFile file(name.c_str());
+      file.setBufferSize(16, 256);
+      file.removeBlock(10, 1000);
+
+      data = data.mid(0, 10) + data.mid(1010);
+      CPPUNIT_ASSERT_EQUAL(static_cast<long>(data.size()), file.length());
+      file.seek(0);
+      CPPUNIT_ASSERT_EQUAL(data, file.readBlock(file.length()));
+    }
+  }
+
+
+  void testLargeInsertAndRemove()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector data;
+    for(int i = 0; i < 1024 * 1024; ++i)
+      data.append(static_cast<char>(i % 251));
+
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+    {
+      // Shifts by more than a few hundred KiB may be done by the kernel,
+      // shorter ones go through the buffer.
+
+      PlainFile file(name.c_str());
+      const ByteVector original = data;
+
+      file.insert(ByteVector(300 * 1024, 'a'), 1000, 100);
+      data = data.mid(0, 1000) + ByteVector(300 * 1024, 'a') + data.mid(1100);
+      file.seek(0);
+      CPPUNIT_ASSERT_EQUAL(data, file.readBlock(file.length()));
+
+      file.insert(ByteVector(5000, 'b'), 500000);
+      data = data.mid(0, 500000) + ByteVector(5000, 'b') + data.mid(500000);
+      file.seek(0);
+      CPPUNIT_ASSERT_EQUAL(data, file.readBlock(file.length()));
+
+      file.removeBlock(500000, 5000);
+      file.insert(original.mid(1000, 100), 1000, 300 * 1024);
+      CPPUNIT_ASSERT_EQUAL(static_cast<long>(original.size()), file.length());
+      file.seek(0);
+      CPPUNIT_ASSERT_EQUAL(original, file.readBlock(file.length()));
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFile);
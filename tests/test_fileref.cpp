@@ -24,6 +24,7 @@
  ***************************************************************************/
 
 #include <string>
+#include <vector>
 #include <stdio.h>
 #include <tag.h>
 #include <fileref.h>
@@ -39,11 +40,18 @@
 #include <wavfile.h>
 #include <apefile.h>
 #include <aifffile.h>
+#include <id3v2tag.h>
+#include <privateframe.h>
 #include <tfilestream.h>
 #include <tbytevectorstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
+#ifndef _WIN32
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
 using namespace std;
 using namespace TagLib;
 
@@ -57,6 +65,20 @@ namespace
       return new Ogg::Vorbis::File(fileName);
     }
   };
+
+  class CountingStream : public ByteVectorStream
+  {
+  public:
+    explicit CountingStream(const ByteVector &data) : ByteVectorStream(data), reads(0) {}
+
+    virtual ByteVector readBlock(unsigned long length)
+    {
+      ++reads;
+      return ByteVectorStream::readBlock(length);
+    }
+
+    unsigned int reads;
+  };
 }
 
 class TestFileRef : public CppUnit::TestFixture
@@ -80,7 +102,12 @@ class TestFileRef : public CppUnit::TestFixture
   CPPUNIT_TEST(testAIFF_1);
   CPPUNIT_TEST(testAIFF_2);
   CPPUNIT_TEST(testUnsupported);
+  CPPUNIT_TEST(testDetectByContent);
   CPPUNIT_TEST(testCreate);
+  CPPUNIT_TEST(testSaveAtomic);
+  CPPUNIT_TEST(testSaveAtomicFileDescriptor);
+  CPPUNIT_TEST(testSaveAtomicLinks);
+  CPPUNIT_TEST(testReadBatch);
   CPPUNIT_TEST(testFileResolver);
   CPPUNIT_TEST_SUITE_END();
 
@@ -204,6 +231,62 @@ public:
     }
   }
 
+  template <typename T>
+  void fileRefSaveAtomic(const string &filename, const string &ext)
+  {
+    ScopedFileCopy copy(filename, ext);
+    string newname = copy.fileName();
+
+    ByteVector original;
+    {
+      FileStream fs(newname.c_str());
+      original = fs.readBlock(fs.length());
+    }
+
+    ByteVectorStream bs(original);
+    FileRef inPlace(&bs);
+    FileRef atomic(newname.c_str());
+    CPPUNIT_ASSERT(dynamic_cast<T*>(atomic.file()));
+
+#ifndef _WIN32
+    struct stat st;
+    stat(newname.c_str(), &st);
+    const ino_t inode = st.st_ino;
+#endif
+
+    // A stream in memory can not be replaced and is saved in place.
+
+    inPlace.tag()->setTitle(longText(5000));
+    atomic.tag()->setTitle(longText(5000));
+    CPPUNIT_ASSERT(inPlace.save(File::Atomic));
+    CPPUNIT_ASSERT(atomic.save(File::Atomic));
+    CPPUNIT_ASSERT_EQUAL(File::InPlace, atomic.file()->saveMode());
+    CPPUNIT_ASSERT(atomic.file()->isValid());
+    CPPUNIT_ASSERT(!atomic.file()->readOnly());
+
+#ifndef _WIN32
+    stat(newname.c_str(), &st);
+    CPPUNIT_ASSERT(st.st_ino != inode);
+#endif
+
+    {
+      FileStream fs(newname.c_str(), true);
+      CPPUNIT_ASSERT_EQUAL(*bs.data(), fs.readBlock(fs.length()));
+    }
+
+    // The file is still usable after the stream has been replaced.
+
+    inPlace.tag()->setTitle("short");
+    atomic.tag()->setTitle("short");
+    CPPUNIT_ASSERT(inPlace.save());
+    CPPUNIT_ASSERT(atomic.save());
+
+    {
+      FileStream fs(newname.c_str(), true);
+      CPPUNIT_ASSERT_EQUAL(*bs.data(), fs.readBlock(fs.length()));
+    }
+  }
+
   void testMusepack()
   {
     fileRefSave<MPC::File>("click", ".mpc");
@@ -298,6 +381,60 @@ public:
     CPPUNIT_ASSERT(f2.isNull());
   }
 
+  void testDetectByContent()
+  {
+    {
+      // An unknown file is rejected after a single read.
+
+      FileStream fs(TEST_FILE_PATH_C("no-extension"), true);
+      CountingStream stream(fs.readBlock(fs.length()));
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(f.isNull());
+      CPPUNIT_ASSERT_EQUAL(1U, stream.reads);
+    }
+    {
+      // The samples of a WAV file happen to hold two MPEG frame headers, but
+      // the RIFF header at the start of the file wins.
+
+      FileStream fs(TEST_FILE_PATH_C("alaw.wav"), true);
+      ByteVector data = fs.readBlock(fs.length());
+      const ByteVector frameHeader("\xFF\xFB\x90\x00", 4);
+      const unsigned int offset = data.find("data") + 8;
+      for(unsigned int i = 0; i < frameHeader.size(); ++i) {
+        data[offset + i] = frameHeader[i];
+        data[offset + 417 + i] = frameHeader[i];
+      }
+
+      ByteVectorStream stream(data);
+      CPPUNIT_ASSERT(MPEG::File::isSupported(&stream));
+
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(dynamic_cast<RIFF::WAV::File *>(f.file()));
+    }
+    {
+      // The IDs of an Opus stream in a frame of an ID3v2 tag are not taken
+      // for the content that follows the tag.
+
+      ID3v2::PrivateFrame *frame = new ID3v2::PrivateFrame();
+      frame->setOwner("test");
+      frame->setData(ByteVector("OggS") + ByteVector(24, '\0') + ByteVector("OpusHead"));
+
+      ID3v2::Tag tag;
+      tag.addFrame(frame);
+      const ByteVector tagData = tag.render();
+
+      FileStream mpegFile(TEST_FILE_PATH_C("xing.mp3"), true);
+      ByteVectorStream mpegStream(tagData + mpegFile.readBlock(mpegFile.length()));
+      FileRef f1(&mpegStream);
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f1.file()));
+
+      FileStream flacFile(TEST_FILE_PATH_C("no-tags.flac"), true);
+      ByteVectorStream flacStream(tagData + flacFile.readBlock(flacFile.length()));
+      FileRef f2(&flacStream);
+      CPPUNIT_ASSERT(dynamic_cast<FLAC::File *>(f2.file()));
+    }
+  }
+
   void testCreate()
   {
     // This is depricated. But worth it to test.
@@ -311,6 +448,160 @@ public:
     delete f;
   }
 
+  void testSaveAtomic()
+  {
+    fileRefSaveAtomic<MPEG::File>("xing", ".mp3");
+    fileRefSaveAtomic<FLAC::File>("no-tags", ".flac");
+    fileRefSaveAtomic<MP4::File>("has-tags", ".m4a");
+    fileRefSaveAtomic<Ogg::Vorbis::File>("empty", ".ogg");
+    fileRefSaveAtomic<RIFF::WAV::File>("empty", ".wav");
+  }
+
+  void testSaveAtomicFileDescriptor()
+  {
+#ifndef _WIN32
+    ScopedFileCopy copy("xing", ".mp3");
+    const string newname = copy.fileName();
+
+    // A stream opened from a file descriptor has no name that a new file could
+    // be renamed to, so it is saved in place and stays open.
+
+    const int fd = open(newname.c_str(), O_RDWR);
+    CPPUNIT_ASSERT(fd >= 0);
+    {
+      FileStream stream(fd, false);
+      close(fd);
+
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()));
+
+      f.tag()->setTitle(longText(5000));
+      CPPUNIT_ASSERT(f.save(File::Atomic));
+      CPPUNIT_ASSERT(stream.isOpen());
+      CPPUNIT_ASSERT(f.file()->isValid());
+
+      f.tag()->setTitle("short");
+      CPPUNIT_ASSERT(f.save(File::Atomic));
+      CPPUNIT_ASSERT(stream.isOpen());
+    }
+    {
+      FileRef f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(String("short"), f.tag()->title());
+    }
+#endif
+  }
+
+  void testSaveAtomicLinks()
+  {
+#ifndef _WIN32
+    ScopedFileCopy copy("xing", ".mp3");
+    const string newname = copy.fileName();
+    const string symlinkName = newname + ".symlink.mp3";
+    const string hardlinkName = newname + ".hardlink.mp3";
+
+    struct stat st;
+    stat(newname.c_str(), &st);
+    const ino_t inode = st.st_ino;
+
+    // Saving through a symbolic link replaces the file it points to, and the
+    // link stays a link.
+
+    CPPUNIT_ASSERT_EQUAL(0, symlink(newname.c_str(), symlinkName.c_str()));
+    {
+      FileRef f(symlinkName.c_str());
+      f.tag()->setTitle(longText(5000));
+      CPPUNIT_ASSERT(f.save(File::Atomic));
+    }
+    CPPUNIT_ASSERT_EQUAL(0, lstat(symlinkName.c_str(), &st));
+    CPPUNIT_ASSERT(S_ISLNK(st.st_mode));
+    stat(newname.c_str(), &st);
+    CPPUNIT_ASSERT(st.st_ino != inode);
+    {
+      FileRef f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(longText(5000), f.tag()->title());
+    }
+    unlink(symlinkName.c_str());
+
+    // A file with another hard link is saved in place, so that both names
+    // still share the new content.
+
+    CPPUNIT_ASSERT_EQUAL(0, link(newname.c_str(), hardlinkName.c_str()));
+    stat(newname.c_str(), &st);
+    const ino_t linkedInode = st.st_ino;
+    {
+      FileRef f(hardlinkName.c_str());
+      f.tag()->setTitle("short");
+      CPPUNIT_ASSERT(f.save(File::Atomic));
+    }
+    stat(newname.c_str(), &st);
+    CPPUNIT_ASSERT(st.st_ino == linkedInode);
+    {
+      FileRef f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(String("short"), f.tag()->title());
+    }
+    unlink(hardlinkName.c_str());
+#endif
+  }
+
+  void testReadBatch()
+  {
+    const char *names[] = {
+      "xing.mp3", "ape-id3v2.mp3", "no-tags.flac", "has-tags.m4a", "empty.ogg",
+      "empty.wav", "mac-399.ape", "click.mpc", "silence-1.wma", "empty.aiff",
+      "no-such-file.mp3", "no-extension"
+    };
+    const size_t count = sizeof(names) / sizeof(names[0]);
+
+    vector<string> paths;
+    for(size_t i = 0; i < count; ++i)
+      paths.push_back(testFilePath(names[i]));
+
+    List<FileName> fileNames;
+    List<IOStream *> streams;
+    for(size_t i = 0; i < count; ++i) {
+      fileNames.append(paths[i].c_str());
+      streams.append(new FileStream(paths[i].c_str(), true));
+    }
+
+    const FileRef::MetadataList byName = FileRef::readBatch(fileNames, true, AudioProperties::Average, 4);
+    const FileRef::MetadataList byStream = FileRef::readBatch(streams);
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(count), byName.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(count), byStream.size());
+
+    for(size_t i = 0; i < count; ++i) {
+      const FileRef ref(paths[i].c_str());
+      const FileRef::Metadata &a = byName[i];
+      const FileRef::Metadata &b = byStream[i];
+
+      CPPUNIT_ASSERT_EQUAL(ref.isNull(), a.isNull());
+      if(ref.isNull())
+        continue;
+
+      CPPUNIT_ASSERT(!b.isNull());
+      CPPUNIT_ASSERT(ref.file()->properties() == a.properties());
+      CPPUNIT_ASSERT_EQUAL(ref.tag()->title(), a.title());
+      CPPUNIT_ASSERT_EQUAL(ref.tag()->artist(), a.artist());
+      CPPUNIT_ASSERT_EQUAL(ref.tag()->track(), a.track());
+      CPPUNIT_ASSERT(a.hasAudioProperties());
+      CPPUNIT_ASSERT_EQUAL(ref.audioProperties()->lengthInMilliseconds(), a.lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(ref.audioProperties()->bitrate(), a.bitrate());
+      CPPUNIT_ASSERT_EQUAL(ref.audioProperties()->sampleRate(), a.sampleRate());
+      CPPUNIT_ASSERT_EQUAL(ref.audioProperties()->channels(), a.channels());
+      CPPUNIT_ASSERT_EQUAL(a.title(), b.title());
+      CPPUNIT_ASSERT_EQUAL(a.lengthInMilliseconds(), b.lengthInMilliseconds());
+    }
+
+    CPPUNIT_ASSERT(byName[count - 2].isNull());
+    CPPUNIT_ASSERT(!byName[0].isNull());
+
+    for(List<IOStream *>::ConstIterator it = streams.begin(); it != streams.end(); ++it)
+      delete *it;
+
+    const FileRef::MetadataList noProperties = FileRef::readBatch(fileNames, false);
+    CPPUNIT_ASSERT(!noProperties[0].hasAudioProperties());
+    CPPUNIT_ASSERT(FileRef::readBatch(List<FileName>()).isEmpty());
+  }
+
   void testFileResolver()
   {
     {
@@ -325,6 +616,13 @@ public:
       FileRef f(TEST_FILE_PATH_C("xing.mp3"));
       CPPUNIT_ASSERT(dynamic_cast<Ogg::Vorbis::File *>(f.file()) != NULL);
     }
+
+    FileRef::removeFileTypeResolver(&resolver);
+
+    {
+      FileRef f(TEST_FILE_PATH_C("xing.mp3"));
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()) != NULL);
+    }
   }
 
 };
@@ -30,9 +30,11 @@
 #include <tbytevectorlist.h>
 #include <tpropertymap.h>
 #include <flacfile.h>
+#include <tfilestream.h>
 #include <xiphcomment.h>
 #include <id3v1tag.h>
 #include <id3v2tag.h>
+#include <id3v2framefactory.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -64,6 +66,10 @@ class TestFLAC : public CppUnit::TestFixture
   CPPUNIT_TEST(testStripTags);
   CPPUNIT_TEST(testRemoveXiphField);
   CPPUNIT_TEST(testEmptySeekTable);
+  CPPUNIT_TEST(testSaveWithPadding);
+  CPPUNIT_TEST(testSkipPictures);
+  CPPUNIT_TEST(testSkipPicturesLongDescription);
+  CPPUNIT_TEST(testSkipPicturesTruncated);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -535,6 +541,145 @@ public:
     }
   }
 
+
+  void testSaveWithPadding()
+  {
+    const ScopedFileCopy copy("no-tags", ".flac");
+    {
+      FLAC::File f(copy.fileName().c_str());
+      f.setPadding(4096, 65536);
+
+      f.xiphComment(true)->setTitle("Title A");
+      f.save();
+      const long length = f.length();
+
+      f.xiphComment()->setTitle(longText(2048));
+      f.save();
+      CPPUNIT_ASSERT(!f.lastSaveShiftedData());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+
+      f.xiphComment()->setTitle("Title B");
+      f.save();
+      CPPUNIT_ASSERT(!f.lastSaveShiftedData());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+
+      f.xiphComment()->setTitle(longText(8192));
+      f.save();
+      CPPUNIT_ASSERT(f.lastSaveShiftedData());
+      CPPUNIT_ASSERT(f.length() > length);
+    }
+    {
+      FLAC::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(longText(8192), f.xiphComment()->title());
+    }
+  }
+
+  void testSkipPictures()
+  {
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    const ByteVector data = longText(100000, true).data(String::Latin1);
+    {
+      FLAC::File f(copy.fileName().c_str());
+      FLAC::Picture *picture = new FLAC::Picture();
+      picture->setMimeType("image/jpeg");
+      picture->setDescription("large image");
+      picture->setData(data);
+      f.addPicture(picture);
+      f.save();
+    }
+    {
+      FLAC::File f(copy.fileName().c_str(), ID3v2::FrameFactory::instance(), true,
+                   FLAC::Properties::Average, File::SkipPictures);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(File::SkipPictures, f.pictureReading());
+
+      List<FLAC::Picture *> lst = f.pictureList();
+      CPPUNIT_ASSERT_EQUAL(2U, lst.size());
+      CPPUNIT_ASSERT(lst[0]->payload().isLoaded());
+      CPPUNIT_ASSERT_EQUAL(150U, lst[0]->data().size());
+      CPPUNIT_ASSERT(!lst[1]->payload().isLoaded());
+      CPPUNIT_ASSERT_EQUAL(100000U, lst[1]->payload().size());
+      CPPUNIT_ASSERT_EQUAL(String("large image"), lst[1]->description());
+      CPPUNIT_ASSERT(lst[1]->data() == data);
+
+      // The picture moves when the comment grows past the padding.
+
+      f.xiphComment()->setTitle(longText(20000));
+      f.save();
+      CPPUNIT_ASSERT(f.lastSaveShiftedData());
+      CPPUNIT_ASSERT(lst[1]->payload().isLoaded());
+      CPPUNIT_ASSERT(lst[1]->data() == data);
+    }
+    {
+      FLAC::File f(copy.fileName().c_str());
+      List<FLAC::Picture *> lst = f.pictureList();
+      CPPUNIT_ASSERT_EQUAL(2U, lst.size());
+      CPPUNIT_ASSERT(lst[1]->data() == data);
+      CPPUNIT_ASSERT_EQUAL(longText(20000), f.xiphComment()->title());
+    }
+  }
+
+  void testSkipPicturesLongDescription()
+  {
+    // The image data does not start within the part of the block that is read
+    // first, so the whole block is read.
+
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    const ByteVector data = longText(100000, true).data(String::Latin1);
+    {
+      FLAC::File f(copy.fileName().c_str());
+      FLAC::Picture *picture = new FLAC::Picture();
+      picture->setDescription(longText(2000));
+      picture->setData(data);
+      f.addPicture(picture);
+      f.save();
+    }
+    {
+      FLAC::File f(copy.fileName().c_str(), ID3v2::FrameFactory::instance(), true,
+                   FLAC::Properties::Average, File::SkipPictures);
+      CPPUNIT_ASSERT(f.isValid());
+      List<FLAC::Picture *> lst = f.pictureList();
+      CPPUNIT_ASSERT_EQUAL(2U, lst.size());
+      CPPUNIT_ASSERT(lst[1]->payload().isLoaded());
+      CPPUNIT_ASSERT_EQUAL(longText(2000), lst[1]->description());
+      CPPUNIT_ASSERT(lst[1]->data() == data);
+    }
+  }
+
+  void testSkipPicturesTruncated()
+  {
+    // A file that ends within a picture block is not valid, whether the
+    // picture is read or not.
+
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    const ByteVector data = longText(100000, true).data(String::Latin1);
+    {
+      FLAC::File f(copy.fileName().c_str());
+      FLAC::Picture *picture = new FLAC::Picture();
+      picture->setData(data);
+      f.addPicture(picture);
+      f.save();
+    }
+    {
+      FileStream stream(copy.fileName().c_str());
+      const ByteVector fileData = stream.readBlock(stream.length());
+      const int pictureOffset = fileData.find(data.mid(0, 64));
+      CPPUNIT_ASSERT(pictureOffset > 0);
+      stream.truncate(pictureOffset + 50000);
+    }
+    {
+      FLAC::File f(copy.fileName().c_str(), ID3v2::FrameFactory::instance(), true,
+                   FLAC::Properties::Average, File::ReadPictures);
+      CPPUNIT_ASSERT(!f.isValid());
+    }
+    {
+      FLAC::File f(copy.fileName().c_str(), ID3v2::FrameFactory::instance(), true,
+                   FLAC::Properties::Average, File::SkipPictures);
+      CPPUNIT_ASSERT(!f.isValid());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFLAC);
@@ -39,12 +39,14 @@
 #include <popularimeterframe.h>
 #include <urllinkframe.h>
 #include <ownershipframe.h>
+#include <privateframe.h>
 #include <unknownframe.h>
 #include <chapterframe.h>
 #include <tableofcontentsframe.h>
 #include <tdebug.h>
 #include <tpropertymap.h>
 #include <tzlib.h>
+#include <tbytevectorstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -120,6 +122,16 @@ class TestID3v2 : public CppUnit::TestFixture
   CPPUNIT_TEST(testEmptyFrame);
   CPPUNIT_TEST(testDuplicateTags);
   CPPUNIT_TEST(testParseTOCFrameWithManyChildren);
+  CPPUNIT_TEST(testManyFrames);
+  CPPUNIT_TEST(testFrameListReferences);
+  CPPUNIT_TEST(testUnreadFramesRenderedVerbatim);
+  CPPUNIT_TEST(testStopAtInvalidFrame);
+  CPPUNIT_TEST(testRejectedFramesOnDemand);
+  CPPUNIT_TEST(testParseLargeFramesOnDemand);
+  CPPUNIT_TEST(testSkipPictures);
+  CPPUNIT_TEST(testSkipPicturesV3);
+  CPPUNIT_TEST(testSkipPicturesLongDescription);
+  CPPUNIT_TEST(testSkipPicturesTruncated);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -1269,6 +1281,414 @@ public:
     CPPUNIT_ASSERT(f.isValid());
   }
 
+  void testManyFrames()
+  {
+    ID3v2::Tag tag;
+    for(int i = 0; i < 3000; ++i) {
+      ID3v2::UserTextIdentificationFrame *frame = new ID3v2::UserTextIdentificationFrame();
+      frame->setDescription(String::number(i));
+      frame->setText(String::number(i));
+      tag.addFrame(frame);
+      if(i % 3 == 0)
+        tag.addFrame(new ID3v2::UniqueFileIdentifierFrame(String::number(i), "id"));
+    }
+    tag.setTitle("Title");
+
+    CPPUNIT_ASSERT_EQUAL((unsigned int)4001, tag.frameList().size());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)3000, tag.frameList("TXXX").size());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)1000, tag.frameListMap()["UFID"].size());
+    CPPUNIT_ASSERT_EQUAL(String("Title"), tag.title());
+
+    // Remove every other frame, and the title.  The copies of the lists are
+    // not changed.
+
+    const ID3v2::FrameList frames = tag.frameList();
+    const ID3v2::FrameList userFrames = tag.frameList("TXXX");
+    const ID3v2::FrameListMap map = tag.frameListMap();
+    for(unsigned int i = 0; i < frames.size(); i += 2)
+      tag.removeFrame(frames[i]);
+    tag.removeFrames("TIT2");
+
+    CPPUNIT_ASSERT_EQUAL((unsigned int)4001, frames.size());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)3000, userFrames.size());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)3000, map["TXXX"].size());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)1, map["TIT2"].size());
+
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2000, tag.frameList().size());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)3, tag.frameListMap().size());
+    CPPUNIT_ASSERT(tag.frameListMap()["TIT2"].isEmpty());
+    CPPUNIT_ASSERT(tag.frameList("TIT2").isEmpty());
+    CPPUNIT_ASSERT(tag.title().isEmpty());
+
+    unsigned int frameCount = 0;
+    for(ID3v2::FrameListMap::ConstIterator it = tag.frameListMap().begin();
+        it != tag.frameListMap().end(); ++it) {
+      CPPUNIT_ASSERT(it->second == tag.frameList(it->first));
+      frameCount += it->second.size();
+    }
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2000, frameCount);
+
+    ID3v2::FrameList::ConstIterator it = tag.frameList().begin();
+    for(unsigned int i = 1; i < frames.size(); i += 2, ++it)
+      CPPUNIT_ASSERT(*it == frames[i]);
+
+    ByteVector data = tag.render();
+    ByteVectorStream stream(data);
+    {
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), false);
+      CPPUNIT_ASSERT(f.hasID3v2Tag());
+      CPPUNIT_ASSERT_EQUAL((unsigned int)2000, f.ID3v2Tag()->frameList().size());
+      CPPUNIT_ASSERT_EQUAL(tag.frameList().back()->render(), f.ID3v2Tag()->frameList().back()->render());
+    }
+
+    tag.setTitle("Title");
+    CPPUNIT_ASSERT_EQUAL(String("Title"), tag.title());
+    CPPUNIT_ASSERT(tag.frameList().back() == tag.frameList("TIT2").front());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2001, tag.frameList().size());
+  }
+
+  void testFrameListReferences()
+  {
+    ID3v2::Tag tag;
+    for(int i = 0; i < 5; ++i) {
+      ID3v2::UserTextIdentificationFrame *frame = new ID3v2::UserTextIdentificationFrame();
+      frame->setDescription(String::number(i));
+      tag.addFrame(frame);
+    }
+    tag.setTitle("Title");
+
+    ByteVector data = tag.render();
+    ByteVectorStream stream(data);
+    MPEG::File f(&stream, ID3v2::FrameFactory::instance(), false);
+    ID3v2::Tag *fileTag = f.ID3v2Tag();
+
+    // The lists that a caller holds on to follow the changes to the tag.
+
+    const ID3v2::FrameList &frames = fileTag->frameList();
+    const ID3v2::FrameList &userFrames = fileTag->frameList("TXXX");
+    const ID3v2::FrameListMap &map = fileTag->frameListMap();
+    CPPUNIT_ASSERT_EQUAL((unsigned int)6, frames.size());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)5, userFrames.size());
+
+    while(!userFrames.isEmpty())
+      fileTag->removeFrame(userFrames.front());
+
+    CPPUNIT_ASSERT_EQUAL((unsigned int)1, frames.size());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("TIT2"), frames.front()->frameID());
+    CPPUNIT_ASSERT(map["TXXX"].isEmpty());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)1, map["TIT2"].size());
+
+    fileTag->addFrame(new ID3v2::UserTextIdentificationFrame());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)1, userFrames.size());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2, frames.size());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)1, map["TXXX"].size());
+
+    fileTag->removeFrames("TIT2");
+    CPPUNIT_ASSERT_EQUAL((unsigned int)1, frames.size());
+    CPPUNIT_ASSERT(map["TIT2"].isEmpty());
+
+    // Asking for an ID that is not there does not add it.
+
+    CPPUNIT_ASSERT(fileTag->frameList("TPE1").isEmpty());
+    CPPUNIT_ASSERT(fileTag->frameList(ByteVector()).isEmpty());
+    CPPUNIT_ASSERT(!fileTag->frameListMap().contains("TPE1"));
+    CPPUNIT_ASSERT(!fileTag->frameListMap().contains(ByteVector()));
+  }
+
+  void testUnreadFramesRenderedVerbatim()
+  {
+    // A TPE1 frame with an empty field and a stray terminator, which TagLib
+    // would not render the same way, between a TIT2 and a PRIV frame.
+
+    const ByteVector tpe1("TPE1\x00\x00\x00\x0a\x00\x00\x00" "Artist\x00\x00\x00", 20);
+    const ByteVector frames =
+      ByteVector("TIT2\x00\x00\x00\x06\x00\x00\x00Title", 16) +
+      tpe1 +
+      ByteVector("PRIV\x00\x00\x00\x05\x00\x00" "abc\x00\x01", 15);
+
+    ByteVector data = ByteVector("ID3\x04\x00\x00\x00\x00\x00", 9) + char(frames.size());
+    data.append(frames);
+    data.append(ByteVector(1024, '\0'));
+
+    // A factory of its own, which parses the frames on demand.
+
+    class Factory : public ID3v2::FrameFactory {} factory;
+    factory.setParseFramesOnDemand(true);
+
+    ByteVectorStream stream(data);
+    {
+      MPEG::File f(&stream, &factory, false);
+      CPPUNIT_ASSERT(f.hasID3v2Tag());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.ID3v2Tag()->title());
+
+      f.ID3v2Tag()->setTitle("New Title");
+      f.save(MPEG::File::ID3v2, false, 4, false);
+    }
+
+    // Only the changed frame was rendered again.
+
+    CPPUNIT_ASSERT(stream.data()->find(tpe1) > 0);
+    CPPUNIT_ASSERT(stream.data()->find(ByteVector("TIT2\x00\x00\x00\x0a\x00\x00\x00New Title", 20)) > 0);
+
+    {
+      MPEG::File f(&stream, &factory, false);
+      const ID3v2::FrameList &frameList = f.ID3v2Tag()->frameList();
+      CPPUNIT_ASSERT_EQUAL((unsigned int)3, frameList.size());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("TIT2"), frameList[0]->frameID());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("TPE1"), frameList[1]->frameID());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("PRIV"), frameList[2]->frameID());
+      CPPUNIT_ASSERT_EQUAL(String("New Title"), f.ID3v2Tag()->title());
+      CPPUNIT_ASSERT_EQUAL(String("Artist"), f.ID3v2Tag()->artist());
+
+      // Once every frame has been made, they are all rendered again.
+
+      CPPUNIT_ASSERT(f.ID3v2Tag()->render().find(tpe1) < 0);
+    }
+  }
+
+  void testStopAtInvalidFrame()
+  {
+    // The frame after TIT2 has an ID that is not valid, so neither it nor the
+    // TPE1 frame after it are read, whether the frames are parsed on demand
+    // or not.
+
+    const ByteVector frames =
+      ByteVector("TIT2\x00\x00\x00\x06\x00\x00\x00Title", 16) +
+      ByteVector("T!T2\x00\x00\x00\x06\x00\x00\x00Title", 16) +
+      ByteVector("TPE1\x00\x00\x00\x07\x00\x00\x00" "Artist", 17);
+
+    ByteVector data = ByteVector("ID3\x04\x00\x00\x00\x00\x00", 9) + char(frames.size());
+    data.append(frames);
+    data.append(ByteVector(1024, '\0'));
+
+    class Factory : public ID3v2::FrameFactory {} factory;
+
+    for(int i = 0; i < 2; ++i) {
+      factory.setParseFramesOnDemand(i == 1);
+      ByteVector fileData = data;
+      ByteVectorStream stream(fileData);
+      MPEG::File f(&stream, &factory, false);
+      CPPUNIT_ASSERT_EQUAL((unsigned int)1, f.ID3v2Tag()->frameList().size());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.ID3v2Tag()->title());
+      CPPUNIT_ASSERT(f.ID3v2Tag()->artist().isEmpty());
+    }
+  }
+
+  void testRejectedFramesOnDemand()
+  {
+    // A large frame is left in the file until it is asked for.  If the file
+    // has been cut short by then, the frame can't be made, and a tag with no
+    // other frames is empty.
+
+    ID3v2::Tag tag;
+    ID3v2::PrivateFrame *frame = new ID3v2::PrivateFrame();
+    frame->setOwner("owner");
+    frame->setData(ByteVector(100000, 'x'));
+    tag.addFrame(frame);
+
+    class Factory : public ID3v2::FrameFactory {} factory;
+    factory.setParseFramesOnDemand(true);
+
+    for(int i = 0; i < 2; ++i) {
+      if(i == 1)
+        tag.setTitle("Title");
+
+      ByteVector data = tag.render();
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, &factory, false);
+      CPPUNIT_ASSERT(f.hasID3v2Tag());
+
+      stream.truncate(1024);
+      CPPUNIT_ASSERT_EQUAL(i == 0, f.ID3v2Tag()->isEmpty());
+      CPPUNIT_ASSERT_EQUAL((unsigned int)i, f.ID3v2Tag()->frameList().size());
+    }
+  }
+
+  void testParseLargeFramesOnDemand()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    const ByteVector data = longText(1000000, true).data(String::Latin1);
+    {
+      MPEG::File f(copy.fileName().c_str());
+      ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+      frame->setMimeType("image/png");
+      frame->setPicture(data);
+      f.ID3v2Tag(true)->addFrame(frame);
+      f.ID3v2Tag()->setTitle("Title");
+      f.save();
+    }
+
+    class Factory : public ID3v2::FrameFactory {} factory;
+    factory.setParseFramesOnDemand(true);
+
+    {
+      // The picture frame is left in the file, and is read before the save
+      // moves it.
+
+      MPEG::File f(copy.fileName().c_str(), &factory);
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.ID3v2Tag()->title());
+      f.ID3v2Tag()->setTitle(longText(20000));
+      f.save(MPEG::File::ID3v2, false, 4, false);
+    }
+    {
+      MPEG::File f(copy.fileName().c_str(), &factory);
+      CPPUNIT_ASSERT_EQUAL(longText(20000), f.ID3v2Tag()->title());
+      const ID3v2::FrameList &frames = f.ID3v2Tag()->frameList("APIC");
+      CPPUNIT_ASSERT_EQUAL(1U, frames.size());
+      ID3v2::AttachedPictureFrame *frame
+        = static_cast<ID3v2::AttachedPictureFrame *>(frames.front());
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), frame->mimeType());
+      CPPUNIT_ASSERT(frame->picture() == data);
+    }
+  }
+
+  void testSkipPictures()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    const ByteVector data = longText(100000, true).data(String::Latin1);
+    {
+      MPEG::File f(copy.fileName().c_str());
+      ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+      frame->setMimeType("image/png");
+      frame->setDescription("large image");
+      frame->setType(ID3v2::AttachedPictureFrame::FrontCover);
+      frame->setPicture(data);
+      f.ID3v2Tag(true)->addFrame(frame);
+      f.ID3v2Tag()->setTitle("Title");
+      f.save();
+    }
+    {
+      MPEG::File f(copy.fileName().c_str(), ID3v2::FrameFactory::instance(), true,
+                   MPEG::Properties::Average, File::SkipPictures);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.ID3v2Tag()->title());
+
+      const ID3v2::FrameList frames = f.ID3v2Tag()->frameList("APIC");
+      CPPUNIT_ASSERT_EQUAL(1U, frames.size());
+      ID3v2::AttachedPictureFrame *frame
+        = dynamic_cast<ID3v2::AttachedPictureFrame *>(frames.front());
+      CPPUNIT_ASSERT(frame);
+      CPPUNIT_ASSERT(!frame->payload().isLoaded());
+      CPPUNIT_ASSERT_EQUAL(100000U, frame->payload().size());
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), frame->mimeType());
+      CPPUNIT_ASSERT_EQUAL(String("large image"), frame->description());
+      CPPUNIT_ASSERT_EQUAL(ID3v2::AttachedPictureFrame::FrontCover, frame->type());
+      CPPUNIT_ASSERT(frame->picture() == data);
+
+      // Growing the tag moves the picture, so it is read before the save.
+
+      f.ID3v2Tag()->setTitle(longText(20000));
+      f.save();
+      CPPUNIT_ASSERT(frame->payload().isLoaded());
+      CPPUNIT_ASSERT(frame->picture() == data);
+    }
+    {
+      MPEG::File f(copy.fileName().c_str());
+      const ID3v2::FrameList frames = f.ID3v2Tag()->frameList("APIC");
+      CPPUNIT_ASSERT_EQUAL(1U, frames.size());
+      ID3v2::AttachedPictureFrame *frame
+        = dynamic_cast<ID3v2::AttachedPictureFrame *>(frames.front());
+      CPPUNIT_ASSERT(frame->picture() == data);
+      CPPUNIT_ASSERT_EQUAL(longText(20000), f.ID3v2Tag()->title());
+    }
+  }
+
+  void testSkipPicturesV3()
+  {
+    // The frame sizes of ID3v2.3 are not synchsafe, and a picture whose
+    // fields fit into what is read anyway is not left in the file.
+
+    ScopedFileCopy copy("xing", ".mp3");
+    const ByteVector small = longText(500, true).data(String::Latin1);
+    const ByteVector large = longText(300000, true).data(String::Latin1);
+    {
+      MPEG::File f(copy.fileName().c_str());
+      ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+      frame->setDescription("small");
+      frame->setPicture(small);
+      f.ID3v2Tag(true)->addFrame(frame);
+      frame = new ID3v2::AttachedPictureFrame();
+      frame->setDescription("large");
+      frame->setPicture(large);
+      f.ID3v2Tag()->addFrame(frame);
+      f.ID3v2Tag()->setArtist("Artist");
+      f.save(MPEG::File::ID3v2, true, 3);
+    }
+    {
+      MPEG::File f(copy.fileName().c_str(), ID3v2::FrameFactory::instance(), true,
+                   MPEG::Properties::Average, File::SkipPictures);
+      CPPUNIT_ASSERT_EQUAL((unsigned int)3, f.ID3v2Tag()->header()->majorVersion());
+      CPPUNIT_ASSERT_EQUAL(String("Artist"), f.ID3v2Tag()->artist());
+
+      const ID3v2::FrameList &frames = f.ID3v2Tag()->frameList("APIC");
+      CPPUNIT_ASSERT_EQUAL(2U, frames.size());
+      ID3v2::AttachedPictureFrame *frame
+        = static_cast<ID3v2::AttachedPictureFrame *>(frames[0]);
+      CPPUNIT_ASSERT_EQUAL(String("small"), frame->description());
+      CPPUNIT_ASSERT(frame->payload().isLoaded());
+      CPPUNIT_ASSERT(frame->picture() == small);
+      frame = static_cast<ID3v2::AttachedPictureFrame *>(frames[1]);
+      CPPUNIT_ASSERT_EQUAL(String("large"), frame->description());
+      CPPUNIT_ASSERT(!frame->payload().isLoaded());
+      CPPUNIT_ASSERT(frame->picture() == large);
+    }
+  }
+
+  void testSkipPicturesLongDescription()
+  {
+    // The fields before the picture do not end within the part of the frame
+    // that is read first, so the frame is read in full.
+
+    ScopedFileCopy copy("xing", ".mp3");
+    const ByteVector data = longText(100000, true).data(String::Latin1);
+    {
+      MPEG::File f(copy.fileName().c_str());
+      ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+      frame->setTextEncoding(String::UTF16);
+      frame->setDescription(longText(2000));
+      frame->setPicture(data);
+      f.ID3v2Tag(true)->addFrame(frame);
+      f.save();
+    }
+    {
+      MPEG::File f(copy.fileName().c_str(), ID3v2::FrameFactory::instance(), true,
+                   MPEG::Properties::Average, File::SkipPictures);
+      const ID3v2::FrameList &frames = f.ID3v2Tag()->frameList("APIC");
+      CPPUNIT_ASSERT_EQUAL(1U, frames.size());
+      ID3v2::AttachedPictureFrame *frame
+        = static_cast<ID3v2::AttachedPictureFrame *>(frames.front());
+      CPPUNIT_ASSERT(frame->payload().isLoaded());
+      CPPUNIT_ASSERT_EQUAL(longText(2000), frame->description());
+      CPPUNIT_ASSERT(frame->picture() == data);
+    }
+  }
+
+  void testSkipPicturesTruncated()
+  {
+    // A file that ends within a picture is read as if the pictures were read.
+
+    ID3v2::Tag tag;
+    tag.setTitle("Title");
+    ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+    frame->setPicture(longText(100000, true).data(String::Latin1));
+    tag.addFrame(frame);
+    tag.setArtist("Artist");
+
+    const ByteVector data = tag.render().mid(0, 50000);
+
+    for(int i = 0; i < 2; ++i) {
+      ByteVector fileData = data;
+      ByteVectorStream stream(fileData);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), false,
+                   MPEG::Properties::Average,
+                   i == 0 ? File::ReadPictures : File::SkipPictures);
+      CPPUNIT_ASSERT(f.hasID3v2Tag());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.ID3v2Tag()->title());
+      CPPUNIT_ASSERT(f.ID3v2Tag()->frameList("APIC").isEmpty());
+      CPPUNIT_ASSERT(f.ID3v2Tag()->artist().isEmpty());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestID3v2);
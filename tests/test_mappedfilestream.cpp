@@ -0,0 +1,201 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <tmappedfilestream.h>
+#include <tfilestream.h>
+#include <tag.h>
+#include <fileref.h>
+#include <mpegfile.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestMappedFileStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestMappedFileStream);
+  CPPUNIT_TEST(testReadBlock);
+  CPPUNIT_TEST(testSeek);
+  CPPUNIT_TEST(testReadOnly);
+  CPPUNIT_TEST(testFallback);
+  CPPUNIT_TEST(testData);
+  CPPUNIT_TEST(testTruncatedWhileMapped);
+  CPPUNIT_TEST(testFileRef);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadBlock()
+  {
+    MappedFileStream mapped(TEST_FILE_PATH_C("xing.mp3"));
+    FileStream plain(TEST_FILE_PATH_C("xing.mp3"), true);
+
+    CPPUNIT_ASSERT(mapped.isOpen());
+    CPPUNIT_ASSERT(mapped.isMapped());
+    CPPUNIT_ASSERT_EQUAL(plain.length(), mapped.length());
+
+    CPPUNIT_ASSERT_EQUAL(plain.readBlock(100), mapped.readBlock(100));
+    CPPUNIT_ASSERT_EQUAL(plain.readBlock(3000), mapped.readBlock(3000));
+    CPPUNIT_ASSERT_EQUAL(plain.tell(), mapped.tell());
+
+    mapped.seek(-10, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(10U, mapped.readBlock(100).size());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), mapped.readBlock(100));
+    CPPUNIT_ASSERT_EQUAL(mapped.length(), mapped.tell());
+  }
+
+  void testSeek()
+  {
+    MappedFileStream mapped(TEST_FILE_PATH_C("xing.mp3"));
+    FileStream plain(TEST_FILE_PATH_C("xing.mp3"), true);
+
+    mapped.seek(1000);
+    plain.seek(1000);
+    mapped.seek(-200, IOStream::Current);
+    plain.seek(-200, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(800L, mapped.tell());
+    CPPUNIT_ASSERT_EQUAL(plain.readBlock(16), mapped.readBlock(16));
+
+    mapped.seek(-1);
+    CPPUNIT_ASSERT_EQUAL(816L, mapped.tell());
+
+    mapped.seek(mapped.length() + 100);
+    CPPUNIT_ASSERT(mapped.readBlock(4).isEmpty());
+  }
+
+  void testReadOnly()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    {
+      MappedFileStream mapped(copy.fileName().c_str());
+      CPPUNIT_ASSERT(mapped.readOnly());
+
+      const long length = mapped.length();
+      mapped.writeBlock(ByteVector("xxxx"));
+      mapped.insert(ByteVector("xxxx"), 10);
+      mapped.removeBlock(0, 10);
+      mapped.truncate(0);
+      CPPUNIT_ASSERT_EQUAL(length, mapped.length());
+    }
+    CPPUNIT_ASSERT(fileEqual(copy.fileName(), TEST_FILE_PATH_C("xing.mp3")));
+  }
+
+  void testFallback()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    {
+      FileStream stream(copy.fileName().c_str());
+      stream.truncate(0);
+    }
+    {
+      MappedFileStream mapped(copy.fileName().c_str());
+      CPPUNIT_ASSERT(mapped.isOpen());
+      CPPUNIT_ASSERT(!mapped.isMapped());
+      CPPUNIT_ASSERT(mapped.readOnly());
+      CPPUNIT_ASSERT_EQUAL(0L, mapped.length());
+      CPPUNIT_ASSERT(mapped.readBlock(4).isEmpty());
+    }
+    {
+      MappedFileStream mapped("does-not-exist.mp3");
+      CPPUNIT_ASSERT(!mapped.isOpen());
+      CPPUNIT_ASSERT(!mapped.isMapped());
+    }
+  }
+
+  void testData()
+  {
+    MappedFileStream mapped(TEST_FILE_PATH_C("xing.mp3"));
+    FileStream plain(TEST_FILE_PATH_C("xing.mp3"), true);
+
+    mapped.seek(10);
+    plain.seek(100);
+    const char *p = mapped.data(100, 200);
+    CPPUNIT_ASSERT(p);
+    CPPUNIT_ASSERT_EQUAL(plain.readBlock(200), ByteVector(p, 200));
+    CPPUNIT_ASSERT_EQUAL(10L, mapped.tell());
+
+    const long length = mapped.length();
+    CPPUNIT_ASSERT(mapped.data(length - 10, 10));
+    CPPUNIT_ASSERT(!mapped.data(length - 10, 11));
+    CPPUNIT_ASSERT(!mapped.data(length + 1, 0));
+    CPPUNIT_ASSERT(!mapped.data(-1, 1));
+  }
+
+  void testTruncatedWhileMapped()
+  {
+    // Reading the mapping past the new end of the file would raise SIGBUS,
+    // so the change has to be noticed by length() before reading on.
+
+    ScopedFileCopy copy("xing", ".mp3");
+    const ByteVector data = FileStream(copy.fileName().c_str(), true).readBlock(200);
+
+    MappedFileStream mapped(copy.fileName().c_str());
+    CPPUNIT_ASSERT(mapped.isMapped());
+    mapped.seek(50);
+    CPPUNIT_ASSERT_EQUAL(data.mid(50, 10), mapped.readBlock(10));
+
+    {
+      FileStream stream(copy.fileName().c_str());
+      stream.truncate(100);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(100L, mapped.length());
+    CPPUNIT_ASSERT(!mapped.isMapped());
+    CPPUNIT_ASSERT(mapped.isOpen());
+    CPPUNIT_ASSERT_EQUAL(data.mid(60, 40), mapped.readBlock(3000));
+    CPPUNIT_ASSERT(!mapped.data(0, 1));
+
+    mapped.seek(-20, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(data.mid(80, 20), mapped.readBlock(100));
+  }
+
+  void testFileRef()
+  {
+    FileRef plain(TEST_FILE_PATH_C("ape-id3v2.mp3"));
+    FileRef mapped(TEST_FILE_PATH_C("ape-id3v2.mp3"), true, AudioProperties::Average,
+                   FileRef::MappedStream);
+
+    CPPUNIT_ASSERT(!mapped.isNull());
+    CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(mapped.file()));
+    CPPUNIT_ASSERT(mapped.file()->readOnly());
+    CPPUNIT_ASSERT_EQUAL(plain.tag()->title(), mapped.tag()->title());
+    CPPUNIT_ASSERT_EQUAL(plain.tag()->artist(), mapped.tag()->artist());
+    CPPUNIT_ASSERT_EQUAL(plain.audioProperties()->lengthInMilliseconds(),
+                         mapped.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT(!mapped.save());
+
+    FileRef byContent(TEST_FILE_PATH_C("empty_vorbis.oga"), true, AudioProperties::Average,
+                      FileRef::MappedStream);
+    CPPUNIT_ASSERT(!byContent.isNull());
+
+    FileRef unsupported(TEST_FILE_PATH_C("no-extension"), true, AudioProperties::Average,
+                        FileRef::MappedStream);
+    CPPUNIT_ASSERT(unsupported.isNull());
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestMappedFileStream);
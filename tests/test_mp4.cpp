@@ -31,6 +31,7 @@
 #include <tpropertymap.h>
 #include <mp4atom.h>
 #include <mp4file.h>
+#include <tfilestream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -59,6 +60,9 @@ class TestMP4 : public CppUnit::TestFixture
   CPPUNIT_TEST(testFuzzedFile);
   CPPUNIT_TEST(testRepeatedSave);
   CPPUNIT_TEST(testWithZeroLengthAtom);
+  CPPUNIT_TEST(testSaveWithPadding);
+  CPPUNIT_TEST(testSkipPictures);
+  CPPUNIT_TEST(testSkipPicturesCorruptLength);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -458,6 +462,120 @@ public:
     CPPUNIT_ASSERT_EQUAL(22050, f.audioProperties()->sampleRate());
   }
 
+
+  void testSaveWithPadding()
+  {
+    const ScopedFileCopy copy("no-tags", ".m4a");
+    {
+      MP4::File f(copy.fileName().c_str());
+      f.setPadding(2048, 65536);
+
+      f.tag()->setTitle("Title A");
+      f.save();
+      CPPUNIT_ASSERT(f.lastSaveShiftedData());
+      const long length = f.length();
+
+      f.tag()->setTitle(longText(1024));
+      f.save();
+      CPPUNIT_ASSERT(!f.lastSaveShiftedData());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+
+      f.tag()->setTitle("Title B");
+      f.save();
+      CPPUNIT_ASSERT(!f.lastSaveShiftedData());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+
+      f.tag()->setTitle(longText(8192));
+      f.save();
+      CPPUNIT_ASSERT(f.lastSaveShiftedData());
+      CPPUNIT_ASSERT(f.length() > length);
+    }
+    {
+      MP4::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(longText(8192), f.tag()->title());
+    }
+  }
+
+  void testSkipPictures()
+  {
+    ScopedFileCopy copy("has-tags", ".m4a");
+    const ByteVector data = longText(100000, true).data(String::Latin1);
+    {
+      MP4::File f(copy.fileName().c_str());
+      MP4::CoverArtList l = f.tag()->item("covr").toCoverArtList();
+      l.append(MP4::CoverArt(MP4::CoverArt::PNG, data));
+      f.tag()->setItem("covr", l);
+      f.save();
+    }
+    {
+      MP4::File f(copy.fileName().c_str(), true, MP4::Properties::Average, File::SkipPictures);
+      CPPUNIT_ASSERT(f.isValid());
+      MP4::CoverArtList l = f.tag()->item("covr").toCoverArtList();
+      CPPUNIT_ASSERT_EQUAL(3U, l.size());
+
+      // Small images are read with the rest of the tag.
+
+      CPPUNIT_ASSERT(l[0].payload().isLoaded());
+      CPPUNIT_ASSERT_EQUAL(MP4::CoverArt::PNG, l[0].format());
+      CPPUNIT_ASSERT_EQUAL(79U, l[0].data().size());
+      CPPUNIT_ASSERT(l[1].payload().isLoaded());
+      CPPUNIT_ASSERT_EQUAL(MP4::CoverArt::JPEG, l[1].format());
+      CPPUNIT_ASSERT_EQUAL(287U, l[1].data().size());
+      CPPUNIT_ASSERT(!l[2].payload().isLoaded());
+      CPPUNIT_ASSERT_EQUAL(MP4::CoverArt::PNG, l[2].format());
+      CPPUNIT_ASSERT_EQUAL(100000U, l[2].payload().size());
+      CPPUNIT_ASSERT(l[2].data() == data);
+
+      f.tag()->setTitle(longText(20000));
+      f.save();
+      CPPUNIT_ASSERT(l[2].payload().isLoaded());
+      CPPUNIT_ASSERT(l[2].data() == data);
+    }
+    {
+      MP4::File f(copy.fileName().c_str());
+      MP4::CoverArtList l = f.tag()->item("covr").toCoverArtList();
+      CPPUNIT_ASSERT_EQUAL(3U, l.size());
+      CPPUNIT_ASSERT_EQUAL(287U, l[1].data().size());
+      CPPUNIT_ASSERT(l[2].data() == data);
+      CPPUNIT_ASSERT_EQUAL(longText(20000), f.tag()->title());
+    }
+  }
+
+  void testSkipPicturesCorruptLength()
+  {
+    // The last 'data' atom in 'covr' claims to be longer than 'covr', so its
+    // image ends with 'covr', whether it is read or not.
+
+    ScopedFileCopy copy("has-tags", ".m4a");
+    const ByteVector data = longText(100000, true).data(String::Latin1);
+    {
+      MP4::File f(copy.fileName().c_str());
+      MP4::CoverArtList l = f.tag()->item("covr").toCoverArtList();
+      l.append(MP4::CoverArt(MP4::CoverArt::PNG, data));
+      f.tag()->setItem("covr", l);
+      f.save();
+    }
+    {
+      FileStream stream(copy.fileName().c_str());
+      const ByteVector fileData = stream.readBlock(stream.length());
+      const int imageOffset = fileData.find(data.mid(0, 64));
+      CPPUNIT_ASSERT(imageOffset > 16);
+      CPPUNIT_ASSERT_EQUAL(ByteVector("data"), fileData.mid(imageOffset - 12, 4));
+      stream.seek(imageOffset - 16);
+      stream.writeBlock(ByteVector::fromUInt(100016 + 500000));
+    }
+    for(int i = 0; i < 2; ++i) {
+      MP4::File f(copy.fileName().c_str(), true, MP4::Properties::Average,
+                  i == 0 ? File::ReadPictures : File::SkipPictures);
+      CPPUNIT_ASSERT(f.isValid());
+      MP4::CoverArtList l = f.tag()->item("covr").toCoverArtList();
+      CPPUNIT_ASSERT_EQUAL(3U, l.size());
+      CPPUNIT_ASSERT_EQUAL(100000U, l[2].payload().size());
+      CPPUNIT_ASSERT(l[2].data() == data);
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMP4);
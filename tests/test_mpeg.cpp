@@ -24,6 +24,7 @@
  ***************************************************************************/
 
 #include <string>
+#include <vector>
 #include <stdio.h>
 #include <tstring.h>
 #include <tpropertymap.h>
@@ -34,6 +35,9 @@
 #include <mpegproperties.h>
 #include <xingheader.h>
 #include <mpegheader.h>
+#include <mpegseekindex.h>
+#include <tfilestream.h>
+#include <tbytevectorstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -47,6 +51,11 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testAudioPropertiesXingHeaderVBR);
   CPPUNIT_TEST(testAudioPropertiesVBRIHeader);
   CPPUNIT_TEST(testAudioPropertiesNoVBRHeaders);
+  CPPUNIT_TEST(testAudioPropertiesAccurateVBR);
+  CPPUNIT_TEST(testAudioPropertiesAccurateLAME);
+  CPPUNIT_TEST(testAudioPropertiesFast);
+  CPPUNIT_TEST(testSeekIndex);
+  CPPUNIT_TEST(testSeekIndexXingTOC);
   CPPUNIT_TEST(testSkipInvalidFrames1);
   CPPUNIT_TEST(testSkipInvalidFrames2);
   CPPUNIT_TEST(testSkipInvalidFrames3);
@@ -57,6 +66,7 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testDuplicateID3v2);
   CPPUNIT_TEST(testFuzzedFile);
   CPPUNIT_TEST(testFrameOffset);
+  CPPUNIT_TEST(testFrameOffsetSmallBuffers);
   CPPUNIT_TEST(testStripAndProperties);
   CPPUNIT_TEST(testRepeatedSave1);
   CPPUNIT_TEST(testRepeatedSave2);
@@ -65,6 +75,8 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testEmptyID3v1);
   CPPUNIT_TEST(testEmptyAPE);
   CPPUNIT_TEST(testIgnoreGarbage);
+  CPPUNIT_TEST(testSaveWithPadding);
+  CPPUNIT_TEST(testIsSupportedTagOnly);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -127,6 +139,185 @@ public:
     CPPUNIT_ASSERT_EQUAL(209, lastHeader.frameLength());
   }
 
+  void testAudioPropertiesAccurateVBR()
+  {
+    // 100 frames at 32 kb/s followed by 100 frames at 320 kb/s, without a
+    // VBR header.
+
+    ByteVector data;
+    for(int i = 0; i < 200; ++i) {
+      const bool high = (i >= 100);
+      ByteVector frame(high ? 1044 : 104, '\0');
+      frame[0] = '\xFF';
+      frame[1] = '\xFB';
+      frame[2] = high ? '\xE0' : '\x10';
+      frame[3] = '\xC4';
+      data.append(frame);
+    }
+
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, MPEG::Properties::Average);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(28700, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(32, f.audioProperties()->bitrate());
+    }
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, MPEG::Properties::Accurate);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(5224, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(176, f.audioProperties()->bitrate());
+      CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+    }
+  }
+
+  void testAudioPropertiesAccurateLAME()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("lame_cbr.mp3"), true, MPEG::Properties::Accurate);
+    CPPUNIT_ASSERT(f.audioProperties());
+
+    const MPEG::XingHeader *xingHeader = f.audioProperties()->xingHeader();
+    CPPUNIT_ASSERT(xingHeader);
+    CPPUNIT_ASSERT_EQUAL(576, xingHeader->encoderDelay());
+    CPPUNIT_ASSERT_EQUAL(576, xingHeader->encoderPadding());
+
+    // The Xing header counts 72243 frames, but the file is cut after 19
+    // frames.  The first one holds the Xing header.
+
+    CPPUNIT_ASSERT_EQUAL(444, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+  }
+
+  void testAudioPropertiesFast()
+  {
+    // 200 frames at 32 kb/s and an ID3v1 tag, without a VBR header.
+
+    ByteVector data;
+    for(int i = 0; i < 200; ++i) {
+      ByteVector frame(104, '\0');
+      frame[0] = '\xFF';
+      frame[1] = '\xFB';
+      frame[2] = '\x10';
+      frame[3] = '\xC4';
+      data.append(frame);
+    }
+    data.append(ID3v1::Tag().render());
+
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, MPEG::Properties::Fast);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT(f.audioProperties()->isEstimated());
+      CPPUNIT_ASSERT_EQUAL(5200, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(32, f.audioProperties()->bitrate());
+    }
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, MPEG::Properties::Average);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT(!f.audioProperties()->isEstimated());
+      CPPUNIT_ASSERT_EQUAL(5200, f.audioProperties()->lengthInMilliseconds());
+    }
+
+    // The Xing header tells the length.
+
+    MPEG::File f(TEST_FILE_PATH_C("lame_vbr.mp3"), true, MPEG::Properties::Fast);
+    CPPUNIT_ASSERT(f.audioProperties());
+    CPPUNIT_ASSERT(!f.audioProperties()->isEstimated());
+    CPPUNIT_ASSERT_EQUAL(1887164, f.audioProperties()->lengthInMilliseconds());
+  }
+
+  void testSeekIndex()
+  {
+    // 100 frames at 32 kb/s followed by 100 frames at 320 kb/s, behind 10
+    // bytes of garbage.
+
+    ByteVector data(10, 'x');
+    for(int i = 0; i < 200; ++i) {
+      const bool high = (i >= 100);
+      ByteVector frame(high ? 1044 : 104, '\0');
+      frame[0] = '\xFF';
+      frame[1] = '\xFB';
+      frame[2] = high ? '\xE0' : '\x10';
+      frame[3] = '\xC4';
+      data.append(frame);
+    }
+
+    ByteVectorStream stream(data);
+    MPEG::File f(&stream, ID3v2::FrameFactory::instance(), false);
+
+    const MPEG::SeekIndex index = f.seekIndex(MPEG::Properties::Average, 50);
+    CPPUNIT_ASSERT(index.isValid());
+    CPPUNIT_ASSERT(!index.isApproximate());
+    CPPUNIT_ASSERT_EQUAL(50U, index.frameInterval());
+    CPPUNIT_ASSERT_EQUAL(44100, index.sampleRate());
+    CPPUNIT_ASSERT_EQUAL(200LL * 1152, index.totalSamples());
+    CPPUNIT_ASSERT_EQUAL(100LL * 104 + 100LL * 1044, index.totalBytes());
+
+    const MPEG::SeekIndex::SeekPointList points = index.seekPoints();
+    CPPUNIT_ASSERT_EQUAL(4U, points.size());
+    CPPUNIT_ASSERT_EQUAL(10LL, points[0].offset);
+    CPPUNIT_ASSERT_EQUAL(0LL, points[0].sample);
+    CPPUNIT_ASSERT_EQUAL(32, points[0].bitrate);
+    CPPUNIT_ASSERT_EQUAL(10LL + 50 * 104, points[1].offset);
+    CPPUNIT_ASSERT_EQUAL(50LL * 1152, points[1].sample);
+    CPPUNIT_ASSERT_EQUAL(10LL + 100 * 104, points[2].offset);
+    CPPUNIT_ASSERT_EQUAL(320, points[2].bitrate);
+    CPPUNIT_ASSERT_EQUAL(10LL + 100 * 104 + 50 * 1044, points[3].offset);
+    CPPUNIT_ASSERT_EQUAL(150LL * 1152, points[3].sample);
+
+    CPPUNIT_ASSERT_EQUAL(10LL, index.find(0).offset);
+    CPPUNIT_ASSERT_EQUAL(10LL + 50 * 104, index.find(100 * 1152 - 1).offset);
+    CPPUNIT_ASSERT_EQUAL(10LL + 100 * 104, index.find(100 * 1152).offset);
+    CPPUNIT_ASSERT_EQUAL(points[3].offset, index.find(1000000).offset);
+
+    const ByteVector rendered = index.render();
+    CPPUNIT_ASSERT_EQUAL(36U + 4 * 10, rendered.size());
+
+    const MPEG::SeekIndex copy(rendered);
+    CPPUNIT_ASSERT(copy.isValid());
+    CPPUNIT_ASSERT_EQUAL(index.totalSamples(), copy.totalSamples());
+    CPPUNIT_ASSERT_EQUAL(index.totalBytes(), copy.totalBytes());
+    CPPUNIT_ASSERT_EQUAL(50U, copy.frameInterval());
+    CPPUNIT_ASSERT_EQUAL(rendered, copy.render());
+    CPPUNIT_ASSERT_EQUAL(points[2].offset, copy.seekPoints()[2].offset);
+    CPPUNIT_ASSERT_EQUAL(points[2].bitrate, copy.seekPoints()[2].bitrate);
+
+    CPPUNIT_ASSERT(!MPEG::SeekIndex(rendered.mid(0, rendered.size() - 1)).isValid());
+    CPPUNIT_ASSERT(!MPEG::SeekIndex(ByteVector("junk")).isValid());
+    CPPUNIT_ASSERT_EQUAL(-1LL, MPEG::SeekIndex().find(0).offset);
+  }
+
+  void testSeekIndexXingTOC()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("lame_vbr.mp3"));
+
+    const MPEG::XingHeader *xingHeader = f.audioProperties()->xingHeader();
+    CPPUNIT_ASSERT(xingHeader);
+    CPPUNIT_ASSERT_EQUAL(100U, xingHeader->tableOfContents().size());
+
+    const MPEG::SeekIndex index = f.seekIndex();
+    CPPUNIT_ASSERT(index.isValid());
+    CPPUNIT_ASSERT(index.isApproximate());
+    CPPUNIT_ASSERT_EQUAL(100U, index.seekPoints().size());
+    CPPUNIT_ASSERT_EQUAL(1152LL * xingHeader->totalFrames(), index.totalSamples());
+    CPPUNIT_ASSERT_EQUAL(static_cast<long long>(xingHeader->totalSize()), index.totalBytes());
+    CPPUNIT_ASSERT_EQUAL(f.firstFrameOffset(), static_cast<long>(index.find(0).offset));
+
+    const MPEG::SeekIndex copy(index.render());
+    CPPUNIT_ASSERT(copy.isApproximate());
+    CPPUNIT_ASSERT_EQUAL(index.find(index.totalSamples() / 2).offset,
+                         copy.find(index.totalSamples() / 2).offset);
+
+    // The file is cut short, so only the frames that are there are indexed.
+
+    const MPEG::SeekIndex accurate = f.seekIndex(MPEG::Properties::Accurate, 1);
+    CPPUNIT_ASSERT(!accurate.isApproximate());
+    CPPUNIT_ASSERT_EQUAL(8U, accurate.seekPoints().size());
+    CPPUNIT_ASSERT_EQUAL(8LL * 1152, accurate.totalSamples());
+  }
+
   void testSkipInvalidFrames1()
   {
     MPEG::File f(TEST_FILE_PATH_C("invalid-frames1.mp3"));
@@ -280,6 +471,33 @@ public:
     }
   }
 
+  void testFrameOffsetSmallBuffers()
+  {
+    // Frames whose headers are split between the blocks of a scan.
+
+    MPEG::File f(TEST_FILE_PATH_C("garbage.mp3"));
+    CPPUNIT_ASSERT(f.isValid());
+
+    const long length = f.length();
+    vector<long> next, previous;
+    for(long position = 0; position < length; position += 37) {
+      next.push_back(f.nextFrameOffset(position));
+      previous.push_back(f.previousFrameOffset(position));
+    }
+
+    const unsigned int sizes[][2] = { { 1, 1 }, { 3, 7 }, { 16, 64 } };
+    for(unsigned int i = 0; i < 3; ++i) {
+      f.setBufferSize(sizes[i][0], sizes[i][1]);
+      CPPUNIT_ASSERT_EQUAL(2255L, f.firstFrameOffset());
+      CPPUNIT_ASSERT_EQUAL(6015L, f.lastFrameOffset());
+
+      for(long position = 0, j = 0; position < length; position += 37, ++j) {
+        CPPUNIT_ASSERT_EQUAL(next[j], f.nextFrameOffset(position));
+        CPPUNIT_ASSERT_EQUAL(previous[j], f.previousFrameOffset(position));
+      }
+    }
+  }
+
   void testStripAndProperties()
   {
     ScopedFileCopy copy("xing", ".mp3");
@@ -438,6 +656,49 @@ public:
     }
   }
 
+
+  void testIsSupportedTagOnly()
+  {
+    // Nothing follows the ID3v2 tag in this file.
+
+    FileStream stream(TEST_FILE_PATH_C("005411.id3"), true);
+    CPPUNIT_ASSERT(!MPEG::File::isSupported(&stream));
+  }
+
+  void testSaveWithPadding()
+  {
+    const ScopedFileCopy copy("xing", ".mp3");
+    {
+      MPEG::File f(copy.fileName().c_str());
+      f.setPadding(4096, 65536);
+
+      f.ID3v2Tag(true)->setTitle("Title A");
+      f.save();
+      CPPUNIT_ASSERT(f.lastSaveShiftedData());
+      const long length = f.length();
+
+      f.ID3v2Tag()->setTitle(longText(2048));
+      f.save();
+      CPPUNIT_ASSERT(!f.lastSaveShiftedData());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+
+      f.ID3v2Tag()->setTitle("Title B");
+      f.save();
+      CPPUNIT_ASSERT(!f.lastSaveShiftedData());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+
+      f.ID3v2Tag()->setTitle(longText(8192));
+      f.save();
+      CPPUNIT_ASSERT(f.lastSaveShiftedData());
+      CPPUNIT_ASSERT(f.length() > length);
+    }
+    {
+      MPEG::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(longText(8192), f.ID3v2Tag()->title());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMPEG);
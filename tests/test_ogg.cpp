@@ -31,13 +31,49 @@
 #include <tpropertymap.h>
 #include <oggfile.h>
 #include <vorbisfile.h>
+#include <oggpage.h>
 #include <oggpageheader.h>
+#include <tcrc.h>
+#include <tfilestream.h>
+#include <tbytevectorstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
 using namespace std;
 using namespace TagLib;
 
+namespace
+{
+  // Returns whether the pages of the file are numbered one after another from
+  // zero and all have correct checksums.
+
+  bool pagesAreValid(Ogg::File &f)
+  {
+    long offset = 0;
+    for(int number = 0; offset < f.length(); ++number) {
+      const Ogg::Page page(&f, offset);
+      if(!page.header()->isValid() || page.pageSequenceNumber() != number)
+        return false;
+
+      const ByteVector rendered = page.render();
+      f.seek(offset);
+      if(f.readBlock(page.size()) != rendered)
+        return false;
+
+      offset += page.size();
+    }
+    return offset == f.length();
+  }
+
+  // Unlike Ogg::File::lastPageHeader(), reads the file again after a save.
+
+  int lastPageNumber(Ogg::File &f)
+  {
+    f.seek(f.rfind("OggS"));
+    return static_cast<int>(f.readBlock(22).toUInt(18, false));
+  }
+}
+
 class TestOGG : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestOGG);
@@ -47,7 +83,13 @@ class TestOGG : public CppUnit::TestFixture
   CPPUNIT_TEST(testDictInterface1);
   CPPUNIT_TEST(testDictInterface2);
   CPPUNIT_TEST(testAudioProperties);
+  CPPUNIT_TEST(testAudioPropertiesFast);
   CPPUNIT_TEST(testPageChecksum);
+  CPPUNIT_TEST(testPageChecksumRenumbered);
+  CPPUNIT_TEST(testSaveWithPadding);
+  CPPUNIT_TEST(testShrinkKeepsPaddingUpToMaximum);
+  CPPUNIT_TEST(testRenumberPages);
+  CPPUNIT_TEST(testSaveKeepsPageCount);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -200,6 +242,41 @@ public:
     CPPUNIT_ASSERT_EQUAL(0, f.audioProperties()->bitrateMinimum());
   }
 
+  void testAudioPropertiesFast()
+  {
+    {
+      Ogg::Vorbis::File f(TEST_FILE_PATH_C("empty.ogg"), true, AudioProperties::Fast);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(3685, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT(!f.audioProperties()->isEstimated());
+    }
+
+    // Without the end of stream flag on the last page, the stream might go on
+    // after the part that is read, so the length is worked out from the pages
+    // at the start.
+
+    FileStream file(TEST_FILE_PATH_C("empty.ogg"), true);
+    ByteVector data = file.readBlock(file.length());
+    data[data.rfind("OggS") + 5] &= ~0x04;
+    data.append(ByteVector(100000, '\0'));
+
+    {
+      ByteVectorStream stream(data);
+      Ogg::Vorbis::File f(&stream, true, AudioProperties::Average);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(3685, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT(!f.audioProperties()->isEstimated());
+    }
+    {
+      ByteVectorStream stream(data);
+      Ogg::Vorbis::File f(&stream, true, AudioProperties::Fast);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT(f.audioProperties()->lengthInMilliseconds() > 3685);
+      CPPUNIT_ASSERT(f.audioProperties()->isEstimated());
+      CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+    }
+  }
+
   void testPageChecksum()
   {
     ScopedFileCopy copy("empty", ".ogg");
@@ -223,6 +300,133 @@ public:
 
   }
 
+  void testPageChecksumRenumbered()
+  {
+    Vorbis::File f(TEST_FILE_PATH_C("empty.ogg"));
+    Ogg::Page page(&f, 0x3a);
+    const ByteVector original = page.render();
+
+    page.setPageSequenceNumber(page.pageSequenceNumber() + 3);
+    const ByteVector renumbered = page.render();
+
+    // The checksum covers the page with its own four bytes set to zero.
+
+    CPPUNIT_ASSERT_EQUAL(renumbered.toUInt(22, false),
+      CRC::replace(original.toUInt(22, false), original.size(), 18,
+                   original.data() + 18, renumbered.data() + 18, 4));
+  }
+
+
+  void testSaveWithPadding()
+  {
+    const ScopedFileCopy copy("empty", ".ogg");
+    {
+      Vorbis::File f(copy.fileName().c_str());
+      f.setPadding(1024, 65536);
+
+      f.tag()->setTitle("Title A");
+      f.save();
+      CPPUNIT_ASSERT(f.lastSaveShiftedData());
+      const long length = f.length();
+      const unsigned int packetSize = f.packet(1).size();
+
+      f.tag()->setTitle(longText(512));
+      f.save();
+      CPPUNIT_ASSERT(!f.lastSaveShiftedData());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+      CPPUNIT_ASSERT_EQUAL(packetSize, f.packet(1).size());
+
+      f.tag()->setTitle("Title B");
+      f.save();
+      CPPUNIT_ASSERT(!f.lastSaveShiftedData());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+    }
+    {
+      Vorbis::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("Title B"), f.tag()->title());
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(3685, f.audioProperties()->lengthInMilliseconds());
+    }
+  }
+
+  void testShrinkKeepsPaddingUpToMaximum()
+  {
+    // Unlike ID3v2 and FLAC, the freed space is not limited to 1% of the file.
+
+    const ScopedFileCopy copy("empty", ".ogg");
+    {
+      Vorbis::File f(copy.fileName().c_str());
+      f.setPadding(0, 65536);
+
+      f.tag()->setTitle(longText(8000));
+      f.save();
+      const long length = f.length();
+
+      f.tag()->setTitle("Title");
+      f.save();
+      CPPUNIT_ASSERT(!f.lastSaveShiftedData());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+    }
+    {
+      Vorbis::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+    }
+  }
+
+  void testRenumberPages()
+  {
+    const ScopedFileCopy copy("empty", ".ogg");
+    {
+      Vorbis::File f(copy.fileName().c_str());
+      f.tag()->setTitle(longText(128 * 1024));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(19, lastPageNumber(f));
+      CPPUNIT_ASSERT(pagesAreValid(f));
+
+      f.tag()->setTitle("ABCDE");
+      f.save();
+    }
+    {
+      Vorbis::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(3, f.lastPageHeader()->pageSequenceNumber());
+      CPPUNIT_ASSERT(pagesAreValid(f));
+    }
+  }
+
+  void testSaveKeepsPageCount()
+  {
+    const ScopedFileCopy copy("empty", ".ogg");
+    {
+      Vorbis::File f(copy.fileName().c_str());
+      f.setPadding(1024, 65536);
+
+      f.tag()->setTitle(longText(100 * 1024));
+      f.save();
+      CPPUNIT_ASSERT(pagesAreValid(f));
+      const int lastPage = lastPageNumber(f);
+      CPPUNIT_ASSERT(lastPage > 3);
+
+      // Outgrows the padding and the pages as the default pagination would
+      // make them, but still fits into the same number of pages.
+
+      f.tag()->setTitle(longText(110 * 1024));
+      f.save();
+      CPPUNIT_ASSERT(f.lastSaveShiftedData());
+      CPPUNIT_ASSERT(pagesAreValid(f));
+      CPPUNIT_ASSERT_EQUAL(lastPage, lastPageNumber(f));
+    }
+    {
+      Vorbis::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(longText(110 * 1024), f.tag()->title());
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(3685, f.audioProperties()->lengthInMilliseconds());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOGG);
@@ -0,0 +1,218 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <string>
+#include <stdio.h>
+#include <tpayload.h>
+#include <tpayloadstream.h>
+#include <tbytevectorstream.h>
+#include <tfilestream.h>
+#include <mpegfile.h>
+#include <id3v2tag.h>
+#include <id3v2framefactory.h>
+#include <attachedpictureframe.h>
+#include <generalencapsulatedobjectframe.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+using namespace std;
+using namespace TagLib;
+
+class TestPayload : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestPayload);
+  CPPUNIT_TEST(testRangeRead);
+  CPPUNIT_TEST(testStreamPayload);
+  CPPUNIT_TEST(testSetMimeType);
+  CPPUNIT_TEST(testPayloadStream);
+  CPPUNIT_TEST(testFramePayload);
+  CPPUNIT_TEST(testSkippedPictureStream);
+  CPPUNIT_TEST(testSavePictureFromStream);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testRangeRead()
+  {
+    const Payload payload(ByteVector("0123456789"), "text/plain");
+    CPPUNIT_ASSERT(payload.isLoaded());
+    CPPUNIT_ASSERT_EQUAL(10U, payload.size());
+    CPPUNIT_ASSERT_EQUAL(String("text/plain"), payload.mimeType());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("234"), payload.data(2, 3));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("89"), payload.data(8, 10));
+    CPPUNIT_ASSERT(payload.data(10, 1).isEmpty());
+  }
+
+  void testStreamPayload()
+  {
+    ByteVectorStream stream("xx0123456789yy");
+    stream.seek(5);
+
+    const Payload payload(&stream, 2, 10, "image/png");
+    CPPUNIT_ASSERT(!payload.isLoaded());
+    CPPUNIT_ASSERT_EQUAL(2L, payload.offset());
+    CPPUNIT_ASSERT_EQUAL(10U, payload.size());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("3456"), payload.data(3, 4));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("0123456789"), payload.data());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("9"), payload.data(9, 4));
+    CPPUNIT_ASSERT_EQUAL(5L, stream.tell());
+  }
+
+  void testSetMimeType()
+  {
+    Payload payload(ByteVector("data"), "image/png");
+    Payload copy = payload;
+    copy.setMimeType("image/jpeg");
+    CPPUNIT_ASSERT_EQUAL(String("image/png"), payload.mimeType());
+    CPPUNIT_ASSERT_EQUAL(String("image/jpeg"), copy.mimeType());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("data"), copy.data());
+  }
+
+  void testPayloadStream()
+  {
+    ByteVectorStream source("xx0123456789yy");
+    PayloadStream stream(Payload(&source, 2, 10));
+    CPPUNIT_ASSERT(stream.readOnly());
+    CPPUNIT_ASSERT_EQUAL(10L, stream.length());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("0123"), stream.readBlock(4));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("4567"), stream.readBlock(4));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("89"), stream.readBlock(4));
+    CPPUNIT_ASSERT(stream.readBlock(4).isEmpty());
+    CPPUNIT_ASSERT_EQUAL(10L, stream.tell());
+
+    stream.seek(-3, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("789"), stream.readBlock(10));
+
+    stream.seek(0);
+    stream.writeBlock("abc");
+    CPPUNIT_ASSERT_EQUAL(ByteVector("0123456789"), stream.readBlock(10));
+  }
+
+  void testFramePayload()
+  {
+    ID3v2::AttachedPictureFrame picture;
+    picture.setMimeType("image/png");
+    picture.setPicture("PNG data");
+    CPPUNIT_ASSERT_EQUAL(String("image/png"), picture.payload().mimeType());
+
+    picture.setMimeType("image/jpeg");
+    CPPUNIT_ASSERT_EQUAL(String("image/jpeg"), picture.payload().mimeType());
+
+    ByteVectorStream source("JPEG data");
+    picture.setPayload(Payload(&source, 0, 9, "image/gif"));
+    CPPUNIT_ASSERT_EQUAL(String("image/gif"), picture.mimeType());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("JPEG data"), picture.picture());
+
+    picture.setPayload(Payload(ByteVector("BMP data")));
+    CPPUNIT_ASSERT_EQUAL(String("image/gif"), picture.payload().mimeType());
+
+    ID3v2::GeneralEncapsulatedObjectFrame object;
+    object.setMimeType("text/plain");
+    object.setPayload(Payload(&source, 5, 4));
+    CPPUNIT_ASSERT_EQUAL(String("text/plain"), object.payload().mimeType());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("data"), object.object());
+
+    ID3v2::GeneralEncapsulatedObjectFrame parsed(object.render());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("data"), parsed.object());
+  }
+
+  void testSkippedPictureStream()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    const ByteVector data = longText(100000, true).data(String::Latin1);
+    {
+      MPEG::File f(copy.fileName().c_str());
+      ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+      frame->setMimeType("image/png");
+      frame->setPicture(data);
+      f.ID3v2Tag(true)->addFrame(frame);
+      f.save();
+    }
+    {
+      MPEG::File f(copy.fileName().c_str(), ID3v2::FrameFactory::instance(), true,
+                   MPEG::Properties::Average, File::SkipPictures);
+      const ID3v2::FrameList frames = f.ID3v2Tag()->frameList("APIC");
+      CPPUNIT_ASSERT_EQUAL(1U, frames.size());
+      const Payload payload
+        = static_cast<ID3v2::AttachedPictureFrame *>(frames.front())->payload();
+      CPPUNIT_ASSERT(!payload.isLoaded());
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), payload.mimeType());
+
+      PayloadStream stream(payload);
+      ByteVector read;
+      while(stream.tell() < stream.length())
+        read.append(stream.readBlock(4096));
+      CPPUNIT_ASSERT(read == data);
+      CPPUNIT_ASSERT(!payload.isLoaded());
+    }
+  }
+
+  void testSavePictureFromStream()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    const string sourceName = TEST_FILE_PATH_C("has-tags.m4a");
+
+    ByteVector expected;
+    {
+      FileStream source(sourceName.c_str(), true);
+      expected = source.readBlock(source.length());
+    }
+    {
+#ifdef _WIN32
+      FileStream source(sourceName.c_str(), true);
+#else
+      const int fd = open(sourceName.c_str(), O_RDONLY);
+      CPPUNIT_ASSERT(fd >= 0);
+      FileStream source(fd, true);
+      close(fd);
+#endif
+      CPPUNIT_ASSERT(source.isOpen());
+      CPPUNIT_ASSERT_EQUAL(static_cast<long>(expected.size()), source.length());
+
+      MPEG::File f(copy.fileName().c_str());
+      ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+      frame->setPayload(Payload(&source, 0, expected.size(), "image/jpeg"));
+      f.ID3v2Tag(true)->addFrame(frame);
+      f.save();
+    }
+    {
+      MPEG::File f(copy.fileName().c_str());
+      const ID3v2::FrameList frames = f.ID3v2Tag()->frameList("APIC");
+      CPPUNIT_ASSERT_EQUAL(1U, frames.size());
+      ID3v2::AttachedPictureFrame *frame
+        = static_cast<ID3v2::AttachedPictureFrame *>(frames.front());
+      CPPUNIT_ASSERT_EQUAL(String("image/jpeg"), frame->mimeType());
+      CPPUNIT_ASSERT(frame->picture() == expected);
+    }
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestPayload);
@@ -30,6 +30,31 @@
 using namespace std;
 using namespace TagLib;
 
+namespace
+{
+  void appendUTF8(ByteVector &v, unsigned int c)
+  {
+    if(c < 0x80) {
+      v.append(static_cast<char>(c));
+    }
+    else if(c < 0x800) {
+      v.append(static_cast<char>(0xc0 | (c >> 6)));
+      v.append(static_cast<char>(0x80 | (c & 0x3f)));
+    }
+    else if(c < 0x10000) {
+      v.append(static_cast<char>(0xe0 | (c >> 12)));
+      v.append(static_cast<char>(0x80 | ((c >> 6) & 0x3f)));
+      v.append(static_cast<char>(0x80 | (c & 0x3f)));
+    }
+    else {
+      v.append(static_cast<char>(0xf0 | (c >> 18)));
+      v.append(static_cast<char>(0x80 | ((c >> 12) & 0x3f)));
+      v.append(static_cast<char>(0x80 | ((c >> 6) & 0x3f)));
+      v.append(static_cast<char>(0x80 | (c & 0x3f)));
+    }
+  }
+}
+
 class TestString : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestString);
@@ -52,6 +77,8 @@ class TestString : public CppUnit::TestFixture
   CPPUNIT_TEST(testEncodeNonBMP);
   CPPUNIT_TEST(testIterator);
   CPPUNIT_TEST(testInvalidUTF8);
+  CPPUNIT_TEST(testDecodeOnDemand);
+  CPPUNIT_TEST(testEncodeLong);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -366,6 +393,138 @@ public:
     CPPUNIT_ASSERT(String(ByteVector("\xED\xB0\x80\xED\xA0\x80"), String::UTF8).isEmpty());
   }
 
+  void testDecodeOnDemand()
+  {
+    const ByteVector utf8("\x54\x61\x67\xC3\xA9");
+    const ByteVector utf16("\xFF\xFE\x54\x00\x61\x00\x67\x00\xE9\x00", 10);
+    const ByteVector utf16be("\x00\x54\x00\x61\x00\x67\x00\xE9", 8);
+    const ByteVector latin1("\x54\x61\x67\xE9");
+
+    const String s1(utf8, String::UTF8);
+    const String s2(utf16, String::UTF16);
+    const String s3(utf16be, String::UTF16BE);
+    const String s4(latin1, String::Latin1);
+
+    CPPUNIT_ASSERT_EQUAL(utf8, s1.data(String::UTF8));
+    CPPUNIT_ASSERT_EQUAL(utf16, s2.data(String::UTF16));
+    CPPUNIT_ASSERT_EQUAL(utf16be, s3.data(String::UTF16BE));
+    CPPUNIT_ASSERT_EQUAL(latin1, s4.data(String::Latin1));
+
+    CPPUNIT_ASSERT_EQUAL(latin1, s1.data(String::Latin1));
+    CPPUNIT_ASSERT_EQUAL(utf8, s2.data(String::UTF8));
+    CPPUNIT_ASSERT_EQUAL(utf16be, s4.data(String::UTF16BE));
+
+    CPPUNIT_ASSERT(s1 == s2);
+    CPPUNIT_ASSERT(s2 == s3);
+    CPPUNIT_ASSERT(s3 == s4);
+    CPPUNIT_ASSERT(s1 == String(utf8, String::UTF8));
+    CPPUNIT_ASSERT(s1 != String(latin1, String::UTF8));
+    CPPUNIT_ASSERT_EQUAL(4U, s2.size());
+    CPPUNIT_ASSERT_EQUAL(L'\xE9', s3[3]);
+
+    // Text after a null character is dropped, also in the original encoding.
+
+    const String s5(ByteVector("abc\0def", 7), String::Latin1);
+    CPPUNIT_ASSERT_EQUAL(String("abc"), s5);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc"), s5.data(String::Latin1));
+
+    // A byte order mark which is not the native one is not kept.
+
+    const ByteVector utf16be2("\xFE\xFF\x00\x54\x00\x61\x00\x67\x00\xE9", 10);
+    CPPUNIT_ASSERT_EQUAL(utf16, String(utf16be2, String::UTF16).data(String::UTF16));
+
+    // Once the string is changed the original bytes must not come back.
+
+    String s6(utf8, String::UTF8);
+    String s7 = s6;
+    s6 += "!";
+    CPPUNIT_ASSERT_EQUAL(ByteVector("Tag\xC3\xA9!"), s6.data(String::UTF8));
+    CPPUNIT_ASSERT_EQUAL(utf8, s7.data(String::UTF8));
+
+    String s8(latin1, String::Latin1);
+    s8[0] = L'W';
+    CPPUNIT_ASSERT_EQUAL(ByteVector("Wag\xE9"), s8.data(String::Latin1));
+    CPPUNIT_ASSERT(s8 != s4);
+
+    String s9(utf16be, String::UTF16BE);
+    s9.clear();
+    CPPUNIT_ASSERT(s9.data(String::UTF16BE).isEmpty());
+  }
+
+  void testEncodeLong()
+  {
+    // Strings long enough to be converted a vector at a time, with a
+    // character that is not ASCII at different places.
+
+    const unsigned int specials[] = { 0xe9, 0x20ac, 0x1f600 };
+
+    for(unsigned int length = 0; length < 100; ++length) {
+      for(unsigned int k = 0; k < 3; ++k) {
+        const unsigned int positions[] = { length, 0, length / 2, length - 1 };
+        for(unsigned int p = 0; p < 4; ++p) {
+          const unsigned int pos = positions[p];
+          if(pos > length || (pos == length && p > 0))
+            continue;
+
+          wstring text;
+          ByteVector utf8;
+          ByteVector utf16be;
+          for(unsigned int i = 0; i < length; ++i) {
+            const unsigned int c = (i == pos) ? specials[k] : 'a' + i % 26;
+            appendUTF8(utf8, c);
+            if(c < 0x10000) {
+              text += static_cast<wchar_t>(c);
+              utf16be.append(ByteVector::fromShort(static_cast<short>(c)));
+            }
+            else {
+              const unsigned int high = 0xd800 + ((c - 0x10000) >> 10);
+              const unsigned int low  = 0xdc00 + ((c - 0x10000) & 0x3ff);
+              text += static_cast<wchar_t>(high);
+              text += static_cast<wchar_t>(low);
+              utf16be.append(ByteVector::fromShort(static_cast<short>(high)));
+              utf16be.append(ByteVector::fromShort(static_cast<short>(low)));
+            }
+          }
+
+          ByteVector utf16le;
+          for(unsigned int i = 0; i < utf16be.size(); i += 2) {
+            utf16le.append(utf16be[i + 1]);
+            utf16le.append(utf16be[i]);
+          }
+
+          const String s(text);
+          CPPUNIT_ASSERT_EQUAL(utf8, s.data(String::UTF8));
+          CPPUNIT_ASSERT_EQUAL(utf16be, s.data(String::UTF16BE));
+          CPPUNIT_ASSERT_EQUAL(utf16le, s.data(String::UTF16LE));
+          CPPUNIT_ASSERT_EQUAL(ByteVector("\xff\xfe", 2) + utf16le, s.data(String::UTF16));
+
+          CPPUNIT_ASSERT(String(utf8, String::UTF8).toWString() == text);
+          CPPUNIT_ASSERT(String(utf16be, String::UTF16BE).toWString() == text);
+          CPPUNIT_ASSERT(String(utf16le, String::UTF16LE).toWString() == text);
+          CPPUNIT_ASSERT(String(ByteVector("\xfe\xff", 2) + utf16be, String::UTF16).toWString() == text);
+
+          if(specials[k] < 0x100) {
+            ByteVector latin1;
+            for(unsigned int i = 0; i < text.size(); ++i)
+              latin1.append(static_cast<char>(text[i]));
+            CPPUNIT_ASSERT_EQUAL(latin1, s.data(String::Latin1));
+            CPPUNIT_ASSERT(String(latin1, String::Latin1).toWString() == text);
+          }
+
+          if(pos < length) {
+            ByteVector invalidUTF8 = ByteVector(length, 'a');
+            invalidUTF8[pos] = '\x80';
+            CPPUNIT_ASSERT(String(invalidUTF8, String::UTF8).isEmpty());
+
+            wstring unpaired(length, L'a');
+            unpaired[pos] = static_cast<wchar_t>(0xdc00);
+            CPPUNIT_ASSERT(String(unpaired).data(String::UTF8).isEmpty());
+          }
+        }
+      }
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestString);
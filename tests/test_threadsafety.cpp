@@ -0,0 +1,343 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fileref.h>
+#include <mpegfile.h>
+#include <id3v1tag.h>
+#include <id3v2tag.h>
+#include <id3v2framefactory.h>
+#include <textidentificationframe.h>
+#include <tbytevectorstream.h>
+#include <infotag.h>
+#include <tdebuglistener.h>
+#include <tthread.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <dirent.h>
+# include <sys/stat.h>
+#endif
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  const unsigned int Threads = 8;
+  const unsigned int Rounds = 3;
+
+  vector<string> dataFiles()
+  {
+    vector<string> files;
+
+#ifdef _WIN32
+
+    WIN32_FIND_DATAA data;
+    const HANDLE find = FindFirstFileA(TEST_FILE_PATH_C("*"), &data);
+    if(find != INVALID_HANDLE_VALUE) {
+      do {
+        if(!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+          files.push_back(testFilePath(data.cFileName));
+      } while(FindNextFileA(find, &data));
+      FindClose(find);
+    }
+
+#else
+
+    DIR *dir = opendir(TEST_FILE_PATH_C(""));
+    if(dir) {
+      while(const dirent *entry = readdir(dir)) {
+        const string path = testFilePath(entry->d_name);
+        struct stat st;
+        if(stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+          files.push_back(path);
+      }
+      closedir(dir);
+    }
+
+#endif
+
+    sort(files.begin(), files.end());
+    return files;
+  }
+
+  bool sameMetadata(const FileRef::Metadata &a, const FileRef::Metadata &b)
+  {
+    return a.isNull() == b.isNull()
+        && a.properties() == b.properties()
+        && a.title() == b.title()
+        && a.artist() == b.artist()
+        && a.album() == b.album()
+        && a.year() == b.year()
+        && a.track() == b.track()
+        && a.hasAudioProperties() == b.hasAudioProperties()
+        && a.lengthInMilliseconds() == b.lengthInMilliseconds()
+        && a.bitrate() == b.bitrate()
+        && a.sampleRate() == b.sampleRate()
+        && a.channels() == b.channels();
+  }
+
+  // Registered and removed while the files are being opened; it never claims
+  // a file, so the results must not change.
+
+  class NullResolver : public FileRef::FileTypeResolver
+  {
+  public:
+    virtual File *createFile(FileName, bool, AudioProperties::ReadStyle) const
+    {
+      return 0;
+    }
+  };
+
+  class QuietListener : public DebugListener
+  {
+  public:
+    virtual void printMessage(const String &) {}
+  };
+
+  class SharedFrameFactory : public ID3v2::FrameFactory
+  {
+  };
+
+  const NullResolver nullResolver;
+  QuietListener quietListener;
+  const ID3v1::StringHandler id3v1Handler;
+  const ID3v2::Latin1StringHandler id3v2Handler;
+  const RIFF::Info::StringHandler infoHandler;
+
+  struct StressTest
+  {
+    vector<string> files;
+    vector<FileRef::Metadata> expected;
+    vector<String> expectedTitles;
+    SharedFrameFactory factory;
+
+    Mutex mutex;
+    unsigned int started;
+    unsigned int mismatches;
+  };
+
+  // Changes every global setting that is shared between threads, and puts
+  // back the defaults.
+
+  void changeGlobals(StressTest *test, unsigned int step)
+  {
+    if(step % 2 == 0) {
+      FileRef::addFileTypeResolver(&nullResolver);
+      ID3v1::Tag::setStringHandler(&id3v1Handler);
+      ID3v2::Tag::setLatin1StringHandler(&id3v2Handler);
+      RIFF::Info::Tag::setStringHandler(&infoHandler);
+      setDebugListener(&quietListener);
+      test->factory.setDefaultTextEncoding(String::UTF16);
+    }
+    else {
+      FileRef::removeFileTypeResolver(&nullResolver);
+      ID3v1::Tag::setStringHandler(0);
+      ID3v2::Tag::setLatin1StringHandler(0);
+      RIFF::Info::Tag::setStringHandler(0);
+      setDebugListener(0);
+      test->factory.setDefaultTextEncoding(String::UTF8);
+    }
+  }
+
+  void stress(void *data)
+  {
+    StressTest *test = static_cast<StressTest *>(data);
+
+    unsigned int index;
+    {
+      MutexLocker locker(test->mutex);
+      index = test->started++;
+    }
+
+    const size_t count = test->files.size();
+    unsigned int mismatches = 0;
+
+    for(unsigned int round = 0; round < Rounds; ++round) {
+      for(size_t i = 0; i < count; ++i) {
+        const size_t file = (i + index * count / Threads) % count;
+        const string &path = test->files[file];
+
+        if(index == 0)
+          changeGlobals(test, static_cast<unsigned int>(round * count + i));
+
+        if(!sameMetadata(FileRef::Metadata(FileRef(path.c_str())), test->expected[file]))
+          ++mismatches;
+
+        if(!test->expectedTitles[file].isEmpty()) {
+          MPEG::File f(path.c_str(), &test->factory);
+          if(!f.isValid() || f.tag()->title() != test->expectedTitles[file])
+            ++mismatches;
+        }
+      }
+    }
+
+    if(index == 0)
+      changeGlobals(test, 1);
+
+    MutexLocker locker(test->mutex);
+    test->mismatches += mismatches;
+  }
+}
+
+namespace
+{
+  struct DecodeTest
+  {
+    vector<String> strings;
+    wstring expected;
+    volatile int mismatches;
+  };
+
+  // Every thread decodes the same strings, which have not been decoded yet.
+
+  void decode(void *data)
+  {
+    DecodeTest *test = static_cast<DecodeTest *>(data);
+    for(size_t i = 0; i < test->strings.size(); ++i) {
+      const String &s = test->strings[i];
+      if(s.toWString() != test->expected || s.size() != test->expected.size())
+        test->mismatches = 1;
+    }
+  }
+}
+
+namespace
+{
+  struct SharedTagTest
+  {
+    const ID3v2::Tag *tag;
+    volatile int mismatches;
+  };
+
+  // Every thread reads the same tag, whose frames have not been made yet.
+
+  void readSharedTag(void *data)
+  {
+    SharedTagTest *test = static_cast<SharedTagTest *>(data);
+    const ID3v2::Tag *tag = test->tag;
+
+    if(tag->isEmpty()
+       || tag->title() != "Title"
+       || tag->frameList("TXXX").size() != 200
+       || tag->frameListMap().size() != 2
+       || tag->properties().size() != 201
+       || tag->frameList().size() != 201)
+    {
+      test->mismatches = 1;
+    }
+  }
+}
+
+class TestThreadSafety : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestThreadSafety);
+  CPPUNIT_TEST(testReadConcurrently);
+  CPPUNIT_TEST(testDecodeConcurrently);
+  CPPUNIT_TEST(testReadSharedTagConcurrently);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadConcurrently()
+  {
+    StressTest test;
+    test.files = dataFiles();
+    test.started = 0;
+    test.mismatches = 0;
+
+    CPPUNIT_ASSERT(test.files.size() > 50);
+
+    for(vector<string>::const_iterator it = test.files.begin(); it != test.files.end(); ++it) {
+      test.expected.push_back(FileRef::Metadata(FileRef(it->c_str())));
+
+      String title;
+      if(it->size() > 4 && it->compare(it->size() - 4, 4, ".mp3") == 0) {
+        MPEG::File f(it->c_str());
+        if(f.isValid() && !f.tag()->title().isEmpty())
+          title = f.tag()->title();
+      }
+      test.expectedTitles.push_back(title);
+    }
+
+    Thread::run(Threads, &stress, &test);
+
+    CPPUNIT_ASSERT_EQUAL(Threads, test.started);
+    CPPUNIT_ASSERT_EQUAL(0U, test.mismatches);
+    CPPUNIT_ASSERT_EQUAL(String::Latin1, ID3v2::FrameFactory::instance()->defaultTextEncoding());
+  }
+
+  void testDecodeConcurrently()
+  {
+    const ByteVector utf8("Caf\xc3\xa9 con leche, por favor");
+
+    DecodeTest test;
+    test.expected = String(utf8, String::UTF8).toWString();
+    test.mismatches = 0;
+    for(unsigned int i = 0; i < 10000; ++i)
+      test.strings.push_back(String(utf8, String::UTF8));
+
+    Thread::run(Threads, &decode, &test);
+
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(test.mismatches));
+    CPPUNIT_ASSERT_EQUAL(25U, test.strings.back().size());
+  }
+
+  void testReadSharedTagConcurrently()
+  {
+    ID3v2::Tag tag;
+    tag.setTitle("Title");
+    for(int i = 0; i < 200; ++i) {
+      ID3v2::UserTextIdentificationFrame *frame = new ID3v2::UserTextIdentificationFrame();
+      frame->setDescription("Key" + String::number(i));
+      frame->setText(String::number(i));
+      tag.addFrame(frame);
+    }
+
+    ByteVector data = tag.render();
+    ByteVectorStream stream(data);
+
+    SharedFrameFactory factory;
+    factory.setParseFramesOnDemand(true);
+    MPEG::File f(&stream, &factory, false);
+
+    SharedTagTest test;
+    test.tag = f.ID3v2Tag();
+    test.mismatches = 0;
+
+    Thread::run(Threads, &readSharedTag, &test);
+
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(test.mismatches));
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestThreadSafety);
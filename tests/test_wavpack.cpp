@@ -40,6 +40,7 @@ class TestWavPack : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestWavPack);
   CPPUNIT_TEST(testNoLengthProperties);
+  CPPUNIT_TEST(testNoLengthPropertiesFast);
   CPPUNIT_TEST(testMultiChannelProperties);
   CPPUNIT_TEST(testTaggedProperties);
   CPPUNIT_TEST(testFuzzedFile);
@@ -65,6 +66,23 @@ public:
     CPPUNIT_ASSERT_EQUAL(1031, f.audioProperties()->version());
   }
 
+  void testNoLengthPropertiesFast()
+  {
+    // The stream does not tell its length, and the last block is not read.
+
+    WavPack::File f(TEST_FILE_PATH_C("no_length.wv"), true, WavPack::Properties::Fast);
+    CPPUNIT_ASSERT(f.audioProperties());
+    CPPUNIT_ASSERT(f.audioProperties()->isEstimated());
+    CPPUNIT_ASSERT_EQUAL(2375, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(104738U, f.audioProperties()->sampleFrames());
+    CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+
+    WavPack::File f2(TEST_FILE_PATH_C("four_channels.wv"), true, WavPack::Properties::Fast);
+    CPPUNIT_ASSERT(f2.audioProperties());
+    CPPUNIT_ASSERT(!f2.audioProperties()->isEstimated());
+    CPPUNIT_ASSERT_EQUAL(3833, f2.audioProperties()->lengthInMilliseconds());
+  }
+
   void testMultiChannelProperties()
   {
     WavPack::File f(TEST_FILE_PATH_C("four_channels.wv"));
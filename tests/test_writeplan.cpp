@@ -0,0 +1,245 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+    email               : taglib-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <twriteplan.h>
+#include <tbytevectorstream.h>
+#include <tfilestream.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  class CountingStream : public ByteVectorStream
+  {
+  public:
+    CountingStream(const ByteVector &data) : ByteVectorStream(data), written(0) {}
+
+    void writeBlock(const ByteVector &data)
+    {
+      written += data.size();
+      ByteVectorStream::writeBlock(data);
+    }
+
+    unsigned long written;
+  };
+}
+
+class TestWritePlan : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestWritePlan);
+  CPPUNIT_TEST(testUnmodified);
+  CPPUNIT_TEST(testWriteBlock);
+  CPPUNIT_TEST(testInsertAndRemove);
+  CPPUNIT_TEST(testTruncate);
+  CPPUNIT_TEST(testRandomChanges);
+  CPPUNIT_TEST(testApplyMovesOnce);
+  CPPUNIT_TEST(testReplaceFile);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static ByteVector readAll(IOStream &stream)
+  {
+    stream.seek(0);
+    return stream.readBlock(stream.length());
+  }
+
+public:
+
+  void testUnmodified()
+  {
+    ByteVector v("abcdefgh");
+    ByteVectorStream stream(v);
+    WritePlan plan(&stream);
+
+    CPPUNIT_ASSERT(!plan.isModified());
+    CPPUNIT_ASSERT_EQUAL(8L, plan.length());
+    plan.seek(2);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("cde"), plan.readBlock(3));
+    CPPUNIT_ASSERT_EQUAL(5L, plan.tell());
+  }
+
+  void testWriteBlock()
+  {
+    ByteVector v("abcdefgh");
+    ByteVectorStream stream(v);
+    WritePlan plan(&stream);
+
+    plan.seek(6);
+    plan.writeBlock("xyz");
+    CPPUNIT_ASSERT(plan.isModified());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdefxyz"), readAll(plan));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdefgh"), *stream.data());
+
+    plan.seek(11);
+    plan.writeBlock("!");
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdefxyz\0\0!", 12), readAll(plan));
+  }
+
+  void testInsertAndRemove()
+  {
+    ByteVector v("abcdefgh");
+    ByteVectorStream stream(v);
+    WritePlan plan(&stream);
+
+    plan.insert("123", 2);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ab123cdefgh"), readAll(plan));
+    plan.insert("X", 4, 3);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ab12Xefgh"), readAll(plan));
+    plan.removeBlock(0, 3);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("2Xefgh"), readAll(plan));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdefgh"), *stream.data());
+
+    plan.apply(&stream);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("2Xefgh"), *stream.data());
+  }
+
+  void testTruncate()
+  {
+    ByteVector v("abcdefgh");
+    ByteVectorStream stream(v);
+    WritePlan plan(&stream);
+
+    plan.truncate(3);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc"), readAll(plan));
+    plan.truncate(5);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc\0\0", 5), readAll(plan));
+
+    plan.apply(&stream);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc\0\0", 5), *stream.data());
+  }
+
+  void testRandomChanges()
+  {
+    srand(1);
+
+    ByteVector original;
+    for(int i = 0; i < 4096; ++i)
+      original.append(static_cast<char>(rand()));
+
+    ByteVectorStream reference(original);
+    ByteVectorStream target(original);
+    WritePlan plan(&target);
+
+    for(int i = 0; i < 500; ++i) {
+      const unsigned long start = rand() % (reference.length() + 16);
+      const unsigned long length = rand() % 300;
+      const ByteVector data(rand() % 300, static_cast<char>('a' + i % 26));
+
+      switch(rand() % 5) {
+      case 0:
+        reference.seek(start);
+        reference.writeBlock(data);
+        plan.seek(start);
+        plan.writeBlock(data);
+        break;
+      case 1:
+        if(start + length > static_cast<unsigned long>(reference.length()))
+          break;
+        reference.insert(data, start, length);
+        plan.insert(data, start, length);
+        break;
+      case 2:
+        if(start + length > static_cast<unsigned long>(reference.length()))
+          break;
+        reference.removeBlock(start, length);
+        plan.removeBlock(start, length);
+        break;
+      case 3:
+        reference.truncate(std::max(0L, reference.length() - static_cast<long>(length / 4)));
+        plan.truncate(std::max(0L, plan.length() - static_cast<long>(length / 4)));
+        break;
+      case 4:
+        reference.seek(start);
+        plan.seek(start);
+        CPPUNIT_ASSERT(reference.readBlock(length) == plan.readBlock(length));
+        break;
+      }
+
+      CPPUNIT_ASSERT_EQUAL(reference.length(), plan.length());
+    }
+
+    CPPUNIT_ASSERT(readAll(reference) == readAll(plan));
+    CPPUNIT_ASSERT(original == *target.data());
+
+    plan.apply(&target);
+    CPPUNIT_ASSERT(*reference.data() == *target.data());
+  }
+
+  void testApplyMovesOnce()
+  {
+    ByteVector original(100000, 'a');
+    ByteVectorStream reference(original);
+    CountingStream stream(original);
+    WritePlan plan(&stream);
+
+    // Like a save that grows a tag at the start and one at the end.
+
+    reference.insert(ByteVector(1000, 'x'), 0, 10);
+    reference.insert(ByteVector(100, 'y'), 99000, 10);
+    plan.insert(ByteVector(1000, 'x'), 0, 10);
+    plan.insert(ByteVector(100, 'y'), 99000, 10);
+
+    plan.apply(&stream);
+    CPPUNIT_ASSERT(*reference.data() == *stream.data());
+    CPPUNIT_ASSERT(stream.written <= 100000 + 1100);
+
+    // An overwrite of the same size moves nothing.
+
+    WritePlan overwrite(&stream);
+    overwrite.seek(500);
+    overwrite.writeBlock(ByteVector(100, 'z'));
+    stream.written = 0;
+    overwrite.apply(&stream);
+    CPPUNIT_ASSERT_EQUAL(100UL, stream.written);
+  }
+
+  void testReplaceFile()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    const string newname = copy.fileName();
+
+    ByteVector expected;
+    {
+      FileStream stream(newname.c_str());
+      WritePlan plan(&stream);
+      plan.insert(ByteVector(10000, 'x'), 100, 50);
+      plan.removeBlock(20000, 1000);
+      expected = readAll(plan);
+
+      CPPUNIT_ASSERT(plan.writeTemporaryFile(newname.c_str()));
+      CPPUNIT_ASSERT(plan.replaceFile());
+    }
+
+    FileStream stream(newname.c_str(), true);
+    CPPUNIT_ASSERT(expected == readAll(stream));
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestWritePlan);
@@ -48,6 +48,7 @@ class TestXiphComment : public CppUnit::TestFixture
   CPPUNIT_TEST(testRemoveFields);
   CPPUNIT_TEST(testPicture);
   CPPUNIT_TEST(testLowercaseFields);
+  CPPUNIT_TEST(testSkipPictures);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -210,6 +211,39 @@ public:
     }
   }
 
+  void testSkipPictures()
+  {
+    Ogg::XiphComment source;
+    source.setTitle("Title");
+    FLAC::Picture *picture = new FLAC::Picture();
+    picture->setType(FLAC::Picture::FrontCover);
+    picture->setMimeType("image/jpeg");
+    picture->setDescription("new image");
+    picture->setData("JPEG data");
+    source.addPicture(picture);
+    const ByteVector data = source.render();
+
+    // Pictures are kept encoded until they are asked for, and rendered as
+    // they were read.
+
+    Ogg::XiphComment cmt(data, File::SkipPictures);
+    CPPUNIT_ASSERT_EQUAL(String("Title"), cmt.title());
+    CPPUNIT_ASSERT_EQUAL(2U, cmt.fieldCount());
+    CPPUNIT_ASSERT(cmt.render() == data);
+
+    List<FLAC::Picture *> lst = cmt.pictureList();
+    CPPUNIT_ASSERT_EQUAL(1U, lst.size());
+    CPPUNIT_ASSERT_EQUAL(String("new image"), lst[0]->description());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("JPEG data"), lst[0]->data());
+    CPPUNIT_ASSERT_EQUAL(2U, cmt.fieldCount());
+    CPPUNIT_ASSERT(cmt.render() == data);
+
+    Ogg::XiphComment cmt2(data, File::SkipPictures);
+    cmt2.removeAllPictures();
+    CPPUNIT_ASSERT_EQUAL(1U, cmt2.fieldCount());
+    CPPUNIT_ASSERT(cmt2.pictureList().isEmpty());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestXiphComment);